@@ -2,18 +2,100 @@ add_custom_target(shaders)
 
 file(MAKE_DIRECTORY "${CMAKE_BINARY_DIR}/bin/shaders")
 
+# Compiles one variant of a shader per combination of preprocessor defines.
+# Axes are given as "NAME=v0,v1,...", variants are named like
+# "color_correction-LUT_TYPE_2-LUT_INTERP_1.ps" in axis order,
+# which is the name Graphics::LoadShader(path, defines) looks up.
+function(vortex_add_shader_permutations SHADER)
+    get_filename_component(SHADER_NAME_FULL ${SHADER} NAME)
+    string(REGEX MATCH "^([^.]+)\\.(.+)\\.hlsl$" SHADER_NAME_MATCH "${SHADER_NAME_FULL}")
+    set(SHADER_STEM "${CMAKE_MATCH_1}")
+    set(SHADER_STAGE "${CMAKE_MATCH_2}")
+    set(SHADER_PATH "${CMAKE_SOURCE_DIR}/${SHADER}")
+
+    # Cartesian product of all axes, each variant is "NAME=v|NAME=v"
+    set(VARIANTS "")
+    foreach(AXIS ${ARGN})
+        string(REPLACE "=" ";" AXIS_PARTS "${AXIS}")
+        list(GET AXIS_PARTS 0 AXIS_NAME)
+        list(GET AXIS_PARTS 1 AXIS_VALUES)
+        string(REPLACE "," ";" AXIS_VALUES "${AXIS_VALUES}")
+
+        set(NEXT_VARIANTS "")
+        foreach(VALUE ${AXIS_VALUES})
+            if(VARIANTS)
+                foreach(VARIANT ${VARIANTS})
+                    list(APPEND NEXT_VARIANTS "${VARIANT}|${AXIS_NAME}=${VALUE}")
+                endforeach()
+            else()
+                list(APPEND NEXT_VARIANTS "${AXIS_NAME}=${VALUE}")
+            endif()
+        endforeach()
+        set(VARIANTS ${NEXT_VARIANTS})
+    endforeach()
+
+    # Variants include the source, so only a reconfigure notices edits to it or to SHADER_HEADERS.
+    # The hash is written into every wrapper, which makes the changed wrappers recompile.
+    set(SHADER_HASHES "")
+    foreach(DEPENDENCY "${SHADER_PATH}" ${SHADER_HEADERS})
+        get_filename_component(DEPENDENCY "${DEPENDENCY}" ABSOLUTE BASE_DIR "${CMAKE_SOURCE_DIR}")
+        set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS "${DEPENDENCY}")
+        file(SHA1 "${DEPENDENCY}" DEPENDENCY_HASH)
+        string(APPEND SHADER_HASHES "${DEPENDENCY_HASH}")
+    endforeach()
+    string(SHA1 SHADER_HASH "${SHADER_HASHES}")
+
+    foreach(VARIANT ${VARIANTS})
+        string(REPLACE "|" ";" DEFINES "${VARIANT}")
+        set(VARIANT_NAME "${SHADER_STEM}")
+        set(VARIANT_DEFINES "")
+        foreach(DEFINE ${DEFINES})
+            string(REPLACE "=" ";" DEFINE_PARTS "${DEFINE}")
+            list(GET DEFINE_PARTS 0 DEFINE_NAME)
+            list(GET DEFINE_PARTS 1 DEFINE_VALUE)
+            string(APPEND VARIANT_NAME "-${DEFINE_NAME}_${DEFINE_VALUE}")
+            string(APPEND VARIANT_DEFINES "#define ${DEFINE_NAME} ${DEFINE_VALUE}\n")
+        endforeach()
+
+        set(VARIANT_SOURCE
+            "${CMAKE_BINARY_DIR}/shaders/permutations/${VARIANT_NAME}.${SHADER_STAGE}.hlsl")
+        file(CONFIGURE OUTPUT "${VARIANT_SOURCE}" CONTENT
+            "// Generated from ${SHADER} (sha1 ${SHADER_HASH})\n${VARIANT_DEFINES}#include \"${SHADER_PATH}\"\n"
+            @ONLY)
+
+        WIS_COMPILE_SHADER(
+            DXC ${DXC_EXECUTABLE}
+            TARGET shaders
+            SHADER ${VARIANT_SOURCE}
+            OUTPUT "${CMAKE_BINARY_DIR}/bin/shaders/${VARIANT_NAME}.${SHADER_STAGE}"
+            SHADER_MODEL "6.3"
+        )
+    endforeach()
+
+    target_sources(shaders PRIVATE ${SHADER})
+    source_group(TREE ${CMAKE_SOURCE_DIR}/src/vortex FILES ${SHADER})
+endfunction()
+
 set(SHADER_SOURCES
 	"src/vortex/shaders/basic.vs.hlsl"
 	"src/vortex/shaders/basic.ps.hlsl"
-	"src/vortex/shaders/video.ps.hlsl"
 	"src/vortex/shaders/transform.ps.hlsl"
 	"src/vortex/shaders/transform.vs.hlsl"
 	"src/vortex/shaders/rgba_to_uyvy.cs.hlsl"
-	"src/vortex/shaders/color_correction.ps.hlsl"
+	"src/vortex/shaders/rgba_to_nv12.cs.hlsl"
+	"src/vortex/shaders/color_correction_baked.ps.hlsl"
+	"src/vortex/shaders/compositor.vs.hlsl"
+	"src/vortex/shaders/compositor.ps.hlsl"
+	"src/vortex/shaders/transition.ps.hlsl"
+)
+
+# Included by the shaders, not compiled on their own
+set(SHADER_HEADERS
+	"src/vortex/shaders/yuv.hlsli"
 )
 
-target_sources(shaders PRIVATE ${SHADER_SOURCES})
-source_group(TREE ${CMAKE_SOURCE_DIR}/src/vortex FILES ${SHADER_SOURCES})
+target_sources(shaders PRIVATE ${SHADER_SOURCES} ${SHADER_HEADERS})
+source_group(TREE ${CMAKE_SOURCE_DIR}/src/vortex FILES ${SHADER_SOURCES} ${SHADER_HEADERS})
 
 # Compile shaders
 foreach(SHADER ${SHADER_SOURCES})
@@ -27,4 +109,18 @@ foreach(SHADER ${SHADER_SOURCES})
         OUTPUT "${CMAKE_BINARY_DIR}/bin/shaders/${SHADER_NAME}"
         SHADER_MODEL "6.3"
     )
-endforeach()
\ No newline at end of file
+endforeach()
+
+# Shaders with compile-time modes, see the #if blocks in the sources
+vortex_add_shader_permutations("src/vortex/shaders/video.ps.hlsl"
+    "COLOR_RANGE=0,1"
+    "COLOR_MATRIX=0,1"
+)
+vortex_add_shader_permutations("src/vortex/shaders/yuv_planar.ps.hlsl"
+    "COLOR_RANGE=0,1"
+    "COLOR_MATRIX=0,1"
+)
+vortex_add_shader_permutations("src/vortex/shaders/color_correction.ps.hlsl"
+    "LUT_TYPE=0,1,2"
+    "LUT_INTERP=0,1,2"
+)
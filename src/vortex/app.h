@@ -5,6 +5,7 @@
 
 #include <vortex/ui/ui_app.h>
 #include <vortex/model.h>
+#include <vortex/nodes/input/stream_input.h>
 #include <vortex/util/lib/SPSC-Queue.h>
 #include <vortex/ui/message_dispatch.h>
 #include <vortex/util/ndi/ndi_library.h>
@@ -43,6 +44,10 @@ public:
         , _exit(AppExitControl::GetInstance())
         , _ui_app(CreateUIApp(args.headless))
     {
+        StreamInputLazy::Configure({
+                .software_decode_threads = args.decode_threads,
+                .force_software_decode = args.software_decode,
+        });
         TerminalHandler::Instance().SetInputHandler(
                 [](std::string_view line, void* p) {
                     return static_cast<App*>(p)->TerminalMessageHandler(line);
@@ -1,4 +1,5 @@
 #include <vortex/codec/ffmpeg/audio_resampler.h>
+#include <algorithm>
 
 std::error_code
 vortex::ffmpeg::AudioResampler::Reset(ResamplerDesc desc) noexcept
@@ -44,6 +45,34 @@ std::error_code vortex::ffmpeg::AudioResampler::Resample(std::span<const std::by
     return {}; // Success
 }
 
+std::error_code vortex::ffmpeg::AudioResampler::SetCompensation(int sample_delta, int distance) noexcept
+{
+    int result = swr_set_compensation(_swr_ctx.get(), sample_delta, distance);
+    if (result < 0) {
+        return ffmpeg::make_ffmpeg_error(result);
+    }
+    return {};
+}
+
+std::expected<int, std::error_code>
+vortex::ffmpeg::AudioResampler::ConvertFrame(const AVFrame& frame, std::span<uint8_t* const> planes, int capacity) noexcept
+{
+    if (planes.size() < std::size_t(desc.dst_layout->nb_channels) || planes.size() > AV_NUM_DATA_POINTERS) {
+        return std::unexpected(ffmpeg::make_ffmpeg_error(AVERROR(EINVAL))); // Plane count does not match
+    }
+    uint8_t* out_data[AV_NUM_DATA_POINTERS]{};
+    std::copy(planes.begin(), planes.end(), out_data);
+    int result = swr_convert(_swr_ctx.get(),
+                             out_data,
+                             capacity,
+                             const_cast<const uint8_t**>(frame.extended_data),
+                             frame.nb_samples);
+    if (result < 0) {
+        return std::unexpected(ffmpeg::make_ffmpeg_error(result));
+    }
+    return result;
+}
+
 std::error_code vortex::ffmpeg::AudioResampler::ResamplePlanar(std::span<const std::byte> samples, std::span<std::span<std::byte>> output) noexcept
 {
     return ffmpeg::make_ffmpeg_error(AVERROR(ENOSYS)); // Not implemented
@@ -44,6 +44,14 @@ public:
         return swr_get_out_samples(_swr_ctx.get(), int(in_samples));
     }
 
+    [[nodiscard]] bool IsInitialized() const noexcept { return bool(_swr_ctx); }
+
+    // Stretches (positive) or shrinks the output by sample_delta samples over the next distance output samples
+    std::error_code SetCompensation(int sample_delta, int distance) noexcept;
+
+    // Converts a whole frame into planar output, returns the number of samples written per plane
+    std::expected<int, std::error_code> ConvertFrame(const AVFrame& frame, std::span<uint8_t* const> planes, int capacity) noexcept;
+
     std::error_code Resample(std::span<const std::byte> samples, std::span<std::byte> output) noexcept;
     std::error_code ResamplePlanar(std::span<const std::byte> samples, std::span<std::span<std::byte>> output) noexcept;
 
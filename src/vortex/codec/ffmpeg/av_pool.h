@@ -0,0 +1,94 @@
+#pragma once
+#include <vortex/codec/ffmpeg/types.h>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace vortex::ffmpeg {
+// Bounded free list of FFmpeg packets or frames. Handles return their object to the pool they
+// were acquired from, unreferenced but still allocated. Objects released into a full pool are freed.
+// Handles keep the pool alive, so they may outlive the stream that produced them.
+template<typename T, auto Alloc, auto Unref, auto Free>
+class av_pool : public std::enable_shared_from_this<av_pool<T, Alloc, Unref, Free>>
+{
+public:
+    struct recycler {
+        std::shared_ptr<av_pool> pool;
+
+        void operator()(T* object) const noexcept
+        {
+            if (pool) {
+                pool->release(object);
+            } else {
+                Free(&object);
+            }
+        }
+    };
+    using handle = std::unique_ptr<T, recycler>;
+
+public:
+    explicit av_pool(std::size_t capacity) noexcept
+        : _capacity(capacity)
+    {
+        _free.reserve(capacity);
+    }
+    ~av_pool()
+    {
+        for (T* object : _free) {
+            Free(&object);
+        }
+    }
+
+public:
+    // Reuses a free object if there is one, allocates otherwise
+    [[nodiscard]] handle acquire() noexcept
+    {
+        T* object = nullptr;
+        {
+            std::scoped_lock lock(_mutex);
+            if (!_free.empty()) {
+                object = _free.back();
+                _free.pop_back();
+            }
+        }
+        if (!object) {
+            object = Alloc();
+        }
+        return handle{ object, recycler{ this->shared_from_this() } };
+    }
+
+    [[nodiscard]] std::size_t capacity() const noexcept { return _capacity; }
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        std::scoped_lock lock(_mutex);
+        return _free.size();
+    }
+
+private:
+    void release(T* object) noexcept
+    {
+        if (!object) {
+            return;
+        }
+        Unref(object); // Drop data references right away, hardware surfaces go back to the decoder
+        {
+            std::scoped_lock lock(_mutex);
+            if (_free.size() < _capacity) {
+                _free.push_back(object);
+                return;
+            }
+        }
+        Free(&object);
+    }
+
+private:
+    mutable std::mutex _mutex;
+    std::vector<T*> _free;
+    std::size_t _capacity = 0;
+};
+
+using packet_pool = av_pool<AVPacket, av_packet_alloc, av_packet_unref, av_packet_free>;
+using frame_pool = av_pool<AVFrame, av_frame_alloc, av_frame_unref, av_frame_free>;
+using pooled_packet = packet_pool::handle;
+using pooled_frame = frame_pool::handle;
+} // namespace vortex::ffmpeg
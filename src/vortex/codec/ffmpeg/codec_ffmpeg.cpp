@@ -29,14 +29,14 @@ int save_frame_as_ppm(AVFrame* frame, const char* filename)
     return 0;
 }
 
-std::expected<vortex::Texture2D, std::error_code> 
-vortex::codec::CodecFFmpeg::LoadTexture(const Graphics& gfx, const std::filesystem::path& path)
+std::expected<vortex::codec::FileDecoder, std::error_code>
+vortex::codec::CodecFFmpeg::OpenFileDecoder(const std::filesystem::path& path)
 {
     using namespace vortex::ffmpeg;
 
     if (!std::filesystem::exists(path)) {
         auto ec = std::make_error_code(std::errc::no_such_file_or_directory);
-        vortex::error("CodecFFmpeg::LoadTextureModern: File does not exist: {}", path.string());
+        vortex::error("CodecFFmpeg::OpenFileDecoder: File does not exist: {}", path.string());
         return std::unexpected(ec);
     }
 
@@ -44,7 +44,7 @@ vortex::codec::CodecFFmpeg::LoadTexture(const Graphics& gfx, const std::filesyst
 
     auto connection_result = ConnectToStream(path.string());
     if (!connection_result) {
-        vortex::error("CodecFFmpeg::LoadTextureModern: Failed to connect to stream: {}", connection_result.error().message());
+        vortex::error("CodecFFmpeg::OpenFileDecoder: Failed to connect to stream: {}", connection_result.error().message());
         return std::unexpected(connection_result.error());
     }
     auto format_context = std::move(connection_result.value());
@@ -53,7 +53,7 @@ vortex::codec::CodecFFmpeg::LoadTexture(const Graphics& gfx, const std::filesyst
     auto best_stream_result = GetBestStream(format_context.get(), AVMEDIA_TYPE_VIDEO);
     if (!best_stream_result) {
         auto& ec = best_stream_result.error();
-        vortex::error("CodecFFmpeg::LoadTextureModern: Could not find a suitable video stream in file: {}. Error: {}",
+        vortex::error("CodecFFmpeg::OpenFileDecoder: Could not find a suitable video stream in file: {}. Error: {}",
                       path.string(), ec.message());
         return std::unexpected(ec);
     }
@@ -63,7 +63,7 @@ vortex::codec::CodecFFmpeg::LoadTexture(const Graphics& gfx, const std::filesyst
     const AVCodec* codec = avcodec_find_decoder(codec_params->codec_id);
     if (!codec) {
         auto ec = make_error_code(ffmpeg_errc::decoder_not_found);
-        vortex::error("CodecFFmpeg::LoadTextureModern: Could not find a suitable codec for file: {}", path.string());
+        vortex::error("CodecFFmpeg::OpenFileDecoder: Could not find a suitable codec for file: {}", path.string());
         return std::unexpected(ec);
     }
 
@@ -71,14 +71,14 @@ vortex::codec::CodecFFmpeg::LoadTexture(const Graphics& gfx, const std::filesyst
     unique_codec_context codec_context{ avcodec_alloc_context3(codec) };
     if (!codec_context) {
         auto ec = std::make_error_code(std::errc::not_enough_memory);
-        vortex::error("CodecFFmpeg::LoadTextureModern: Could not allocate codec context for file: {}", path.string());
+        vortex::error("CodecFFmpeg::OpenFileDecoder: Could not allocate codec context for file: {}", path.string());
         return std::unexpected(ec);
     }
 
     int ret = avcodec_parameters_to_context(codec_context.get(), codec_params);
     if (ret < 0) {
         auto ec = make_ffmpeg_error(ret);
-        vortex::error("CodecFFmpeg::LoadTextureModern: Could not copy codec parameters to context for file: {}. Error: {}",
+        vortex::error("CodecFFmpeg::OpenFileDecoder: Could not copy codec parameters to context for file: {}. Error: {}",
                       path.string(), ec.message());
         return std::unexpected(ec);
     }
@@ -86,158 +86,208 @@ vortex::codec::CodecFFmpeg::LoadTexture(const Graphics& gfx, const std::filesyst
     ret = avcodec_open2(codec_context.get(), codec, nullptr);
     if (ret < 0) {
         auto ec = make_ffmpeg_error(ret);
-        vortex::error("CodecFFmpeg::LoadTextureModern: Could not open codec for file: {}. Error: {}",
+        vortex::error("CodecFFmpeg::OpenFileDecoder: Could not open codec for file: {}. Error: {}",
                       path.string(), ec.message());
         return std::unexpected(ec);
     }
 
-    // Read and decode frames
+    return FileDecoder{ .format_context = std::move(format_context),
+                        .codec_context = std::move(codec_context),
+                        .stream_index = stream->index };
+}
+
+std::expected<vortex::ffmpeg::unique_frame, std::error_code>
+vortex::codec::CodecFFmpeg::DecodeNextFrame(FileDecoder& decoder)
+{
+    using namespace vortex::ffmpeg;
+
+    unique_frame frame{ av_frame_alloc() };
     unique_packet packet{ av_packet_alloc() };
-    while (av_read_frame(format_context.get(), packet.get()) >= 0) {
-        if (packet->stream_index < 0 || packet->stream_index >= format_context->nb_streams) {
-            av_packet_unref(packet.get());
-            continue; // Skip invalid stream index
-        }
+    if (!frame || !packet) {
+        vortex::error("CodecFFmpeg::DecodeNextFrame: Could not allocate frame for decoding");
+        return std::unexpected(std::make_error_code(std::errc::not_enough_memory));
+    }
 
-        // Decode the packet
-        ret = avcodec_send_packet(codec_context.get(), packet.get());
-        if (ret < 0) {
-            auto ec = make_ffmpeg_error(ret);
-            vortex::error("CodecFFmpeg::LoadTextureModern: Error sending packet for decoding: {}", ec.message());
-            av_packet_unref(packet.get());
-            continue; // Try next packet
+    while (true) {
+        int ret = avcodec_receive_frame(decoder.codec_context.get(), frame.get());
+        if (ret >= 0) {
+            return frame;
         }
-
-        unique_frame frame{ av_frame_alloc() };
-        if (!frame) {
-            auto ec = std::make_error_code(std::errc::not_enough_memory);
-            vortex::error("CodecFFmpeg::LoadTextureModern: Could not allocate frame for decoding");
-            return std::unexpected(ec);
+        if (ret != AVERROR(EAGAIN)) {
+            return std::unexpected(make_ffmpeg_error(ret)); // End of file or decoder error
         }
 
-        ret = avcodec_receive_frame(codec_context.get(), frame.get());
+        // Decoder needs more input
+        ret = av_read_frame(decoder.format_context.get(), packet.get());
         if (ret < 0) {
-            if (ret == AVERROR(EAGAIN)) {
-                av_packet_unref(packet.get());
-                continue; // Need more input
+            // End of input, flush the frames the decoder still holds
+            ret = avcodec_send_packet(decoder.codec_context.get(), nullptr);
+            if (ret < 0 && ret != AVERROR_EOF) {
+                return std::unexpected(make_ffmpeg_error(ret));
             }
-            vortex::error("CodecFFmpeg::LoadTextureModern: Error receiving frame from decoder: {}",  ffmpeg_error_string(ret));
+            continue;
+        }
+        if (packet->stream_index != decoder.stream_index) {
             av_packet_unref(packet.get());
-            continue; // Try next packet
+            continue;
         }
 
-        // Convert frame to RGBA if necessary
-        unique_frame final_frame = std::move(frame);
-        if (final_frame->format != AV_PIX_FMT_RGBA) {
-            // Create a SwsContext for resampling
-            unique_swscontext sws_ctx{ sws_getContext(
-                    final_frame->width, final_frame->height, static_cast<AVPixelFormat>(final_frame->format),
-                    final_frame->width, final_frame->height, AV_PIX_FMT_RGBA,
-                    SWS_BILINEAR, nullptr, nullptr, nullptr) };
-            if (!sws_ctx) {
-                auto ec = make_error_code(ffmpeg_errc::invalid_data);
-                vortex::error("CodecFFmpeg::LoadTextureModern: Could not create SwsContext for resampling");
-                return std::unexpected(ec);
-            }
+        ret = avcodec_send_packet(decoder.codec_context.get(), packet.get());
+        av_packet_unref(packet.get());
+        if (ret < 0 && ret != AVERROR(EAGAIN)) {
+            vortex::error("CodecFFmpeg::DecodeNextFrame: Error sending packet for decoding: {}",
+                          ffmpeg_error_string(ret));
+        }
+    }
+}
 
-            // Allocate a new frame for the resampled data
-            unique_frame resampled_frame{ av_frame_alloc() };
-            if (!resampled_frame) {
-                auto ec = std::make_error_code(std::errc::not_enough_memory);
-                vortex::error("CodecFFmpeg::LoadTextureModern: Could not allocate resampled frame");
-                return std::unexpected(ec);
-            }
+bool vortex::codec::CodecFFmpeg::Rewind(FileDecoder& decoder)
+{
+    int ret = av_seek_frame(decoder.format_context.get(), decoder.stream_index, 0, AVSEEK_FLAG_BACKWARD);
+    if (ret < 0) {
+        vortex::error("CodecFFmpeg::Rewind: Failed to seek to the start: {}", ffmpeg_error_string(ret));
+        return false;
+    }
+    avcodec_flush_buffers(decoder.codec_context.get());
+    return true;
+}
 
-            resampled_frame->format = AV_PIX_FMT_RGBA;
-            resampled_frame->width = final_frame->width;
-            resampled_frame->height = final_frame->height;
-            resampled_frame->linesize[0] = final_frame->width * 4; // RGBA has 4 bytes per pixel
+bool vortex::codec::CodecFFmpeg::SeekToKeyframe(FileDecoder& decoder, int64_t timestamp)
+{
+    int ret = avformat_seek_file(decoder.format_context.get(), decoder.stream_index, INT64_MIN, timestamp, timestamp, 0);
+    if (ret < 0) {
+        vortex::error("CodecFFmpeg::SeekToKeyframe: Failed to seek to {}: {}", timestamp, ffmpeg_error_string(ret));
+        return false;
+    }
+    avcodec_flush_buffers(decoder.codec_context.get());
+    return true;
+}
 
-            if (av_frame_get_buffer(resampled_frame.get(), 0) < 0) {
-                auto ec = std::make_error_code(std::errc::not_enough_memory);
-                vortex::error("CodecFFmpeg::LoadTextureModern: Could not allocate buffer for resampled frame");
-                return std::unexpected(ec);
-            }
+std::expected<vortex::ffmpeg::unique_frame, std::error_code>
+vortex::codec::CodecFFmpeg::DecodeImage(const std::filesystem::path& path)
+{
+    auto decoder = OpenFileDecoder(path);
+    if (!decoder) {
+        return std::unexpected(decoder.error()); // Error is logged by OpenFileDecoder
+    }
 
-            // Perform the resampling
-            ret = sws_scale(sws_ctx.get(), final_frame->data, final_frame->linesize,
-                            0, final_frame->height,
-                            resampled_frame->data, resampled_frame->linesize);
+    auto frame = DecodeNextFrame(decoder.value());
+    if (!frame) {
+        vortex::error("CodecFFmpeg::DecodeImage: No frames decoded from file: {}", path.string());
+    }
+    return frame;
+}
 
-            if (ret < 0) {
-                auto ec = make_ffmpeg_error(ret);
-                vortex::error("CodecFFmpeg::LoadTextureModern: Error resampling frame: {}", ec.message());
-                return std::unexpected(ec);
-            }
+std::expected<vortex::Texture2D, std::error_code>
+vortex::codec::CodecFFmpeg::UploadRGBA(const Graphics& gfx, const AVFrame& frame)
+{
+    using namespace vortex::ffmpeg;
+    int ret = 0;
+
+    // Convert frame to RGBA if necessary
+    const AVFrame* final_frame = &frame;
+    unique_frame resampled_frame;
+    if (final_frame->format != AV_PIX_FMT_RGBA) {
+        // Create a SwsContext for resampling
+        unique_swscontext sws_ctx{ sws_getContext(
+                final_frame->width, final_frame->height, static_cast<AVPixelFormat>(final_frame->format),
+                final_frame->width, final_frame->height, AV_PIX_FMT_RGBA,
+                SWS_BILINEAR, nullptr, nullptr, nullptr) };
+        if (!sws_ctx) {
+            auto ec = make_error_code(ffmpeg_errc::invalid_data);
+            vortex::error("CodecFFmpeg::UploadRGBA: Could not create SwsContext for resampling");
+            return std::unexpected(ec);
+        }
 
-            // Use the resampled frame for further processing
-            final_frame = std::move(resampled_frame);
+        // Allocate a new frame for the resampled data
+        resampled_frame = unique_frame{ av_frame_alloc() };
+        if (!resampled_frame) {
+            auto ec = std::make_error_code(std::errc::not_enough_memory);
+            vortex::error("CodecFFmpeg::UploadRGBA: Could not allocate resampled frame");
+            return std::unexpected(ec);
         }
 
-        // Create GPU texture
-        wis::Result result = wis::success;
-        auto& ext_alloc = gfx.GetExtendedAllocation();
-        wis::TextureDesc desc{
-            .format = wis::DataFormat::RGBA8Unorm,
-            .size = { static_cast<uint32_t>(final_frame->linesize[0]/4),
-                     static_cast<uint32_t>(final_frame->height) },
-            .usage = wis::TextureUsage::HostCopy | wis::TextureUsage::ShaderResource
-        };
-
-        wis::Texture texture = ext_alloc.CreateGPUUploadTexture(result, gfx.GetAllocator(), desc);
-        if (!success(result)) {
-            // Map wis::Result to std::error_code (you may want to create a specific mapping function)
-            auto ec = std::make_error_code(std::errc::not_enough_memory); // Simplified mapping
-            vortex::error("CodecFFmpeg::LoadTextureModern: Failed to create texture for file: {}. Error: {}",
-                          path.string(), result.error);
+        resampled_frame->format = AV_PIX_FMT_RGBA;
+        resampled_frame->width = final_frame->width;
+        resampled_frame->height = final_frame->height;
+        resampled_frame->linesize[0] = final_frame->width * 4; // RGBA has 4 bytes per pixel
+
+        if (av_frame_get_buffer(resampled_frame.get(), 0) < 0) {
+            auto ec = std::make_error_code(std::errc::not_enough_memory);
+            vortex::error("CodecFFmpeg::UploadRGBA: Could not allocate buffer for resampled frame");
             return std::unexpected(ec);
         }
 
-        // Copy frame data to texture
-        wis::TextureRegion frame_region{
-            .offset = { 0, 0, 0 },
-            .size = { static_cast<uint32_t>(final_frame->linesize[0]/4),
-                       static_cast<uint32_t>(final_frame->height),
-                       1 },
-            .mip = 0,
-            .array_layer = 0,
-            .format = wis::DataFormat::RGBA8Unorm
-        };
-
-        result = ext_alloc.WriteMemoryToSubresourceDirect(final_frame->data[0], texture, wis::TextureState::Common, frame_region);
-        if (!success(result)) {
-            auto ec = std::make_error_code(std::errc::io_error); // Simplified mapping
-            vortex::error("CodecFFmpeg::LoadTextureModern: Failed to write memory to subresource for file: {}. Error: {}",
-                          path.string(), result.error);
+        // Perform the resampling
+        ret = sws_scale(sws_ctx.get(), final_frame->data, final_frame->linesize,
+                        0, final_frame->height,
+                        resampled_frame->data, resampled_frame->linesize);
+
+        if (ret < 0) {
+            auto ec = make_ffmpeg_error(ret);
+            vortex::error("CodecFFmpeg::UploadRGBA: Error resampling frame: {}", ec.message());
             return std::unexpected(ec);
         }
 
-        // Successfully loaded the texture
-        return vortex::Texture2D(std::move(texture), wis::Size2D{ desc.size.width, desc.size.height }, desc.format);
+        // Use the resampled frame for further processing
+        final_frame = resampled_frame.get();
     }
 
-    // No frames were processed
-    auto ec = make_error_code(ffmpeg_errc::end_of_file);
-    vortex::error("CodecFFmpeg::LoadTextureModern: No frames decoded from file: {}", path.string());
-    return std::unexpected(ec);
-}
+    // Create GPU texture
+    wis::Result result = wis::success;
+    auto& ext_alloc = gfx.GetExtendedAllocation();
+    wis::TextureDesc desc{
+        .format = wis::DataFormat::RGBA8Unorm,
+        .size = { static_cast<uint32_t>(final_frame->linesize[0]/4),
+                 static_cast<uint32_t>(final_frame->height) },
+        .usage = wis::TextureUsage::HostCopy | wis::TextureUsage::ShaderResource
+    };
+
+    wis::Texture texture = ext_alloc.CreateGPUUploadTexture(result, gfx.GetAllocator(), desc);
+    if (!success(result)) {
+        // Map wis::Result to std::error_code (you may want to create a specific mapping function)
+        auto ec = std::make_error_code(std::errc::not_enough_memory); // Simplified mapping
+        vortex::error("CodecFFmpeg::UploadRGBA: Failed to create texture. Error: {}", result.error);
+        return std::unexpected(ec);
+    }
+
+    // Copy frame data to texture
+    wis::TextureRegion frame_region{
+        .offset = { 0, 0, 0 },
+        .size = { static_cast<uint32_t>(final_frame->linesize[0]/4),
+                   static_cast<uint32_t>(final_frame->height),
+                   1 },
+        .mip = 0,
+        .array_layer = 0,
+        .format = wis::DataFormat::RGBA8Unorm
+    };
+
+    result = ext_alloc.WriteMemoryToSubresourceDirect(final_frame->data[0], texture, wis::TextureState::Common, frame_region);
+    if (!success(result)) {
+        auto ec = std::make_error_code(std::errc::io_error); // Simplified mapping
+        vortex::error("CodecFFmpeg::UploadRGBA: Failed to write memory to subresource. Error: {}", result.error);
+        return std::unexpected(ec);
+    }
 
-struct TimeoutCallbackContext {
-    std::chrono::microseconds timeout;
-    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    // Successfully loaded the texture
+    return vortex::Texture2D(std::move(texture), wis::Size2D{ desc.size.width, desc.size.height }, desc.format);
+}
 
-    static int operator()(void* ctx)
-    {
-        auto* self = static_cast<TimeoutCallbackContext*>(ctx);
-        auto elapsed = std::chrono::steady_clock::now() - self->start_time;
-        return elapsed > self->timeout ? 1 : 0; // Return 1 if timeout exceeded, else 0
+std::expected<vortex::Texture2D, std::error_code>
+vortex::codec::CodecFFmpeg::LoadTexture(const Graphics& gfx, const std::filesystem::path& path)
+{
+    auto frame = DecodeImage(path);
+    if (!frame) {
+        return std::unexpected(frame.error());
     }
-};
+    return UploadRGBA(gfx, *frame.value().get());
+}
 
 std::expected<vortex::ffmpeg::unique_context, std::error_code>
 vortex::codec::CodecFFmpeg::ConnectToStream(std::string_view stream_url,
                                             ffmpeg::unique_dictionary context_options,
-                                            std::chrono::microseconds timeout)
+                                            std::chrono::microseconds timeout,
+                                            const std::atomic<bool>* abort)
 {
     ffmpeg::unique_context format_context{ avformat_alloc_context() };
     if (!format_context) {
@@ -246,12 +296,13 @@ vortex::codec::CodecFFmpeg::ConnectToStream(std::string_view stream_url,
         return std::unexpected(ec);
     }
 
-    TimeoutCallbackContext timeout_context{ timeout };
-
-    // Set the interrupt callback for the format context
-    format_context->interrupt_callback.opaque = &timeout_context;
-    format_context->interrupt_callback.callback = TimeoutCallbackContext::operator();
-    format_context->flags |= AVFMT_FLAG_NONBLOCK; // Set non-blocking flag
+    // Connection is bounded by the timeout, afterwards the interrupt only cancels the stream
+    auto interrupt = std::make_unique<ffmpeg::StreamInterrupt>();
+    interrupt->deadline = (std::chrono::steady_clock::now() + timeout).time_since_epoch().count();
+    interrupt->abort = abort;
+    format_context->interrupt_callback.opaque = interrupt.get();
+    format_context->interrupt_callback.callback = ffmpeg::StreamInterrupt::Callback;
+    // Reads block in the protocol until data arrives, so readers wait on the socket instead of polling
 
     int ret = avformat_open_input(format_context.address_of(), stream_url.data(), nullptr, context_options.address_of());
     if (ret < 0) {
@@ -260,6 +311,7 @@ vortex::codec::CodecFFmpeg::ConnectToStream(std::string_view stream_url,
                       stream_url, ec.message());
         return std::unexpected(ec);
     }
+    auto* stream_interrupt = interrupt.release(); // Owned by the context from now on
     ret = avformat_find_stream_info(format_context.get(), nullptr);
     if (ret < 0) {
         auto ec = ffmpeg::make_ffmpeg_error(ret);
@@ -268,9 +320,8 @@ vortex::codec::CodecFFmpeg::ConnectToStream(std::string_view stream_url,
         return std::unexpected(ec);
     }
 
-    // Clean up the interrupt callback
-    format_context->interrupt_callback.opaque = nullptr;
-    format_context->interrupt_callback.callback = nullptr;
+    stream_interrupt->deadline = 0;
+    stream_interrupt->abort = nullptr; // The caller's flag may not outlive the context
     return format_context;
 }
 
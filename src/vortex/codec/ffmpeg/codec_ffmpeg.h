@@ -18,6 +18,13 @@ struct StreamChannels {
     std::vector<AVStream*> audio_channels;
 };
 
+// Demuxer and decoder of the best video stream of a file
+struct FileDecoder {
+    ffmpeg::unique_context format_context;
+    ffmpeg::unique_codec_context codec_context;
+    int stream_index = -1;
+};
+
 // Main codec class - keeping existing interface
 class CodecFFmpeg
 {
@@ -25,10 +32,34 @@ public:
     static std::expected<vortex::Texture2D, std::error_code>
     LoadTexture(const Graphics& gfx, const std::filesystem::path& path);
 
+    // Decodes the first frame of an image file in its native pixel format
+    static std::expected<ffmpeg::unique_frame, std::error_code>
+    DecodeImage(const std::filesystem::path& path);
+
+    // Opens the file and the decoder of its best video stream
+    static std::expected<FileDecoder, std::error_code>
+    OpenFileDecoder(const std::filesystem::path& path);
+
+    // Decodes the next frame in presentation order, drains the decoder at the end of the file
+    static std::expected<ffmpeg::unique_frame, std::error_code>
+    DecodeNextFrame(FileDecoder& decoder);
+
+    // Seeks back to the first frame
+    static bool Rewind(FileDecoder& decoder);
+
+    // Seeks to the keyframe at or before the timestamp, in the time base of the decoded stream
+    static bool SeekToKeyframe(FileDecoder& decoder, int64_t timestamp);
+
+    // Converts the frame to RGBA on the CPU if needed and uploads it
+    static std::expected<vortex::Texture2D, std::error_code>
+    UploadRGBA(const Graphics& gfx, const AVFrame& frame);
+
+    // Opens and probes the stream, abort cancels a connection in progress from another thread
     static std::expected<ffmpeg::unique_context, std::error_code>
     ConnectToStream(std::string_view stream_url,
                     ffmpeg::unique_dictionary context_options = ffmpeg::unique_dictionary{},
-                    std::chrono::microseconds timeout = std::chrono::microseconds{ 5000000 });
+                    std::chrono::microseconds timeout = std::chrono::microseconds{ 5000000 },
+                    const std::atomic<bool>* abort = nullptr);
 
     static std::expected<vortex::codec::StreamChannels, std::error_code>
     GetStreams(const AVFormatContext* context);
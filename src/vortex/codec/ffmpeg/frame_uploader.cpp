@@ -0,0 +1,252 @@
+#include <vortex/codec/ffmpeg/frame_uploader.h>
+#include <vortex/graphics.h>
+#include <vortex/util/log.h>
+#include <cstring>
+
+auto vortex::ffmpeg::FrameUploader::ComputeLayout(uint32_t width, uint32_t height) noexcept -> Layout
+{
+    Layout layout{ .width = width, .height = height };
+    layout.row_pitch = uint32_t(wis::aligned_size(uint64_t(width), uint64_t(UploadRing::row_pitch_alignment)));
+    layout.chroma_height = (height + 1) / 2;
+    layout.chroma_offset = wis::aligned_size(uint64_t(layout.row_pitch) * height, UploadRing::placement_alignment);
+    layout.slot_size = wis::aligned_size(layout.chroma_offset + uint64_t(layout.row_pitch) * layout.chroma_height,
+                                         UploadRing::placement_alignment);
+    return layout;
+}
+
+bool vortex::ffmpeg::FrameUploader::IsDirectFormat(int format) noexcept
+{
+    return format == AV_PIX_FMT_NV12 || format == AV_PIX_FMT_YUV420P || format == AV_PIX_FMT_YUVJ420P;
+}
+
+void vortex::ffmpeg::FrameUploader::WritePlanes(std::span<std::byte> slot,
+                                                const Layout& layout,
+                                                const AVFrame& frame) noexcept
+{
+    std::byte* luma = slot.data();
+    for (uint32_t y = 0; y < layout.height; y++) {
+        std::memcpy(luma + std::size_t(y) * layout.row_pitch,
+                    frame.data[0] + std::ptrdiff_t(y) * frame.linesize[0],
+                    layout.width);
+    }
+
+    uint32_t chroma_width = (layout.width + 1) / 2;
+    std::byte* chroma = slot.data() + layout.chroma_offset;
+    if (frame.format == AV_PIX_FMT_NV12) {
+        for (uint32_t y = 0; y < layout.chroma_height; y++) {
+            std::memcpy(chroma + std::size_t(y) * layout.row_pitch,
+                        frame.data[1] + std::ptrdiff_t(y) * frame.linesize[1],
+                        std::size_t(chroma_width) * 2);
+        }
+        return;
+    }
+
+    // Planar chroma is interleaved while copying, so the shader always samples NV12
+    for (uint32_t y = 0; y < layout.chroma_height; y++) {
+        auto* row = reinterpret_cast<uint8_t*>(chroma + std::size_t(y) * layout.row_pitch);
+        const uint8_t* u = frame.data[1] + std::ptrdiff_t(y) * frame.linesize[1];
+        const uint8_t* v = frame.data[2] + std::ptrdiff_t(y) * frame.linesize[2];
+        for (uint32_t x = 0; x < chroma_width; x++) {
+            row[x * 2] = u[x];
+            row[x * 2 + 1] = v[x];
+        }
+    }
+}
+
+bool vortex::ffmpeg::FrameUploader::Upload(const vortex::Graphics& gfx,
+                                           wis::CommandList& cmd_list,
+                                           const AVFrame& frame)
+{
+    if (frame.width <= 0 || frame.height <= 0) {
+        return false;
+    }
+
+    const AVFrame* source = IsDirectFormat(frame.format) ? &frame : ConvertToNV12(frame);
+    if (!source) {
+        return false;
+    }
+
+    Layout layout = ComputeLayout(uint32_t(frame.width), uint32_t(frame.height));
+    if (layout != _layout) {
+        if (layout == _failed_layout) {
+            return false; // Resizing waits for the GPU, don't stall every frame on a size that failed
+        }
+        if (!Resize(gfx, layout)) {
+            _failed_layout = layout;
+            return false;
+        }
+        _failed_layout = {};
+    }
+
+    auto& current = _slots[_current];
+    if (current.initialized && frame.pts != AV_NOPTS_VALUE && current.pts == frame.pts) {
+        return true; // Frame is held, the planes are still current
+    }
+
+    // Everything that used the current slot is submitted, the signal follows it on the queue
+    if (current.initialized) {
+        auto result = gfx.SignalQueue(_fence, ++_fence_value);
+        if (!vortex::success(result)) {
+            vortex::error("FrameUploader: Failed to signal the upload fence: {}", result.error);
+            return false;
+        }
+        current.fence_value = _fence_value;
+    }
+
+    // Usually long done, only waits when the GPU is a whole ring behind
+    _current = (_current + 1) % upload_slots;
+    auto& slot = _slots[_current];
+    if (auto result = _fence.Wait(slot.fence_value); !vortex::success(result)) {
+        vortex::error("FrameUploader: Failed to wait for the upload fence: {}", result.error);
+        return false;
+    }
+    WritePlanes(_staging.GetSlot(_current), _layout, *source);
+
+    wis::TextureState state_before = slot.initialized ? wis::TextureState::ShaderResource
+                                                      : wis::TextureState::Undefined;
+    for (auto* plane : { &slot.luma, &slot.chroma }) {
+        cmd_list.TextureBarrier(
+                {
+                        .sync_before = slot.initialized ? wis::BarrierSync::Draw : wis::BarrierSync::None,
+                        .sync_after = wis::BarrierSync::Copy,
+                        .access_before = slot.initialized ? wis::ResourceAccess::ShaderResource
+                                                          : wis::ResourceAccess::NoAccess,
+                        .access_after = wis::ResourceAccess::CopyDest,
+                        .state_before = state_before,
+                        .state_after = wis::TextureState::CopyDest,
+                },
+                plane->Get());
+    }
+
+    uint64_t offset = _staging.GetSlotOffset(_current);
+    wis::BufferTextureCopyRegion luma_region{
+        .buffer_offset = offset,
+        .texture = {
+                .offset = { 0, 0, 0 },
+                .size = { _layout.row_pitch, _layout.height, 1 },
+                .mip = 0,
+                .array_layer = 0,
+                .format = wis::DataFormat::R8Unorm,
+        },
+    };
+    wis::BufferTextureCopyRegion chroma_region{
+        .buffer_offset = offset + _layout.chroma_offset,
+        .texture = {
+                .offset = { 0, 0, 0 },
+                .size = { _layout.row_pitch / 2, _layout.chroma_height, 1 },
+                .mip = 0,
+                .array_layer = 0,
+                .format = wis::DataFormat::RG8Unorm,
+        },
+    };
+    cmd_list.CopyBufferToTexture(_staging.GetBuffer(), slot.luma.Get(), &luma_region, 1);
+    cmd_list.CopyBufferToTexture(_staging.GetBuffer(), slot.chroma.Get(), &chroma_region, 1);
+
+    for (auto* plane : { &slot.luma, &slot.chroma }) {
+        cmd_list.TextureBarrier(
+                {
+                        .sync_before = wis::BarrierSync::Copy,
+                        .sync_after = wis::BarrierSync::Draw,
+                        .access_before = wis::ResourceAccess::CopyDest,
+                        .access_after = wis::ResourceAccess::ShaderResource,
+                        .state_before = wis::TextureState::CopyDest,
+                        .state_after = wis::TextureState::ShaderResource,
+                },
+                plane->Get());
+    }
+
+    slot.pts = frame.pts;
+    slot.initialized = true;
+    return true;
+}
+
+bool vortex::ffmpeg::FrameUploader::Resize(const vortex::Graphics& gfx, const Layout& layout)
+{
+    // Previous planes may still be read by frames in flight
+    gfx.WaitForGPU();
+
+    _layout = {};
+    _current = 0;
+    if (!_fence) {
+        wis::Result result = wis::success;
+        _fence = gfx.GetDevice().CreateFence(result);
+        if (!vortex::success(result)) {
+            vortex::error("FrameUploader: Failed to create fence: {}", result.error);
+            return false;
+        }
+    }
+    _staging = vortex::UploadRing(gfx, layout.slot_size, upload_slots);
+    if (!_staging) {
+        return false;
+    }
+
+    auto create_plane = [&gfx](wis::DataFormat format, wis::Size2D size) {
+        wis::Result result = wis::success;
+        wis::TextureDesc desc{
+            .format = format,
+            .size = { size.width, size.height, 1 },
+            .mip_levels = 1,
+            .layout = wis::TextureLayout::Texture2D,
+            .sample_count = wis::SampleRate::S1,
+            .usage = wis::TextureUsage::CopyDst | wis::TextureUsage::ShaderResource,
+        };
+        vortex::Texture2D plane(gfx.GetAllocator().CreateTexture(result, desc, wis::MemoryType::Default),
+                                size,
+                                format);
+        if (!vortex::success(result)) {
+            vortex::error("FrameUploader: Failed to create plane texture: {}", result.error);
+            return vortex::Texture2D{};
+        }
+        return plane;
+    };
+
+    for (auto& slot : _slots) {
+        slot = {};
+        slot.luma = create_plane(wis::DataFormat::R8Unorm, { layout.row_pitch, layout.height });
+        slot.chroma = create_plane(wis::DataFormat::RG8Unorm, { layout.row_pitch / 2, layout.chroma_height });
+        if (!slot.luma || !slot.chroma) {
+            return false;
+        }
+        slot.planes = { slot.luma.CreateShaderResource(gfx), slot.chroma.CreateShaderResource(gfx) };
+    }
+
+    _layout = layout;
+    vortex::info("FrameUploader: Uploading {}x{} frames through {} byte staging slots",
+                 layout.width,
+                 layout.height,
+                 layout.slot_size);
+    return true;
+}
+
+const AVFrame* vortex::ffmpeg::FrameUploader::ConvertToNV12(const AVFrame& frame)
+{
+    _sws_context.reset(sws_getCachedContext(_sws_context.release(),
+                                            frame.width, frame.height, AVPixelFormat(frame.format),
+                                            frame.width, frame.height, AV_PIX_FMT_NV12,
+                                            SWS_BILINEAR, nullptr, nullptr, nullptr));
+    if (!_sws_context) {
+        vortex::error("FrameUploader: Could not convert {} frames",
+                      av_get_pix_fmt_name(AVPixelFormat(frame.format)));
+        return nullptr;
+    }
+
+    if (!_converted) {
+        _converted.reset(av_frame_alloc());
+    }
+    if (_converted->width != frame.width || _converted->height != frame.height) {
+        av_frame_unref(_converted.get());
+        _converted->format = AV_PIX_FMT_NV12;
+        _converted->width = frame.width;
+        _converted->height = frame.height;
+        if (av_frame_get_buffer(_converted.get(), 0) < 0) {
+            vortex::error("FrameUploader: Could not allocate the converted frame");
+            _converted.reset();
+            return nullptr;
+        }
+    }
+
+    sws_scale(_sws_context.get(), frame.data, frame.linesize, 0, frame.height,
+              _converted->data, _converted->linesize);
+    av_frame_copy_props(_converted.get(), &frame);
+    return _converted.get();
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <vortex/codec/ffmpeg/types.h>
+#include <vortex/gfx/texture.h>
+#include <vortex/gfx/upload_ring.h>
+#include <array>
+#include <span>
+
+namespace vortex {
+class Graphics;
+}
+
+namespace vortex::ffmpeg {
+// Uploads software decoded video frames as the NV12 planes video.ps samples.
+// Rows are written to a persistently mapped staging slot and copied to the plane textures on the
+// caller's command list. Slots are taken in turn and tracked with a fence of the uploader, so
+// outputs at different cadences never rewrite a slot the GPU has not copied or sampled yet.
+class FrameUploader
+{
+public:
+    static constexpr uint32_t upload_slots = max_frames_in_flight * 2; // Shared by all outputs
+
+public:
+    // Placement of the planes in a staging slot. Both planes share the row pitch, which is
+    // also the luma texture width, so the copy reads the same rows on every API.
+    struct Layout {
+        uint32_t width = 0; // Visible size of the frame
+        uint32_t height = 0;
+        uint32_t row_pitch = 0;
+        uint32_t chroma_height = 0;
+        uint64_t chroma_offset = 0;
+        uint64_t slot_size = 0;
+
+        // Visible part of the padded planes in texture coordinates
+        std::array<float, 2> UVScale() const noexcept
+        {
+            return { row_pitch ? float(width) / float(row_pitch) : 1.0f, 1.0f };
+        }
+        bool operator==(const Layout&) const noexcept = default;
+    };
+
+public:
+    static Layout ComputeLayout(uint32_t width, uint32_t height) noexcept;
+
+    // NV12 and 8-bit 4:2:0 planar frames are written as they are, the rest go through swscale
+    static bool IsDirectFormat(int format) noexcept;
+
+    // Writes the planes of a direct format frame into a slot, interleaving planar chroma
+    static void WritePlanes(std::span<std::byte> slot, const Layout& layout, const AVFrame& frame) noexcept;
+
+public:
+    /**
+     * Records the upload of the frame into the planes of the next slot on the command list.
+     * Must be recorded outside of a render pass, the planes end in the ShaderResource state.
+     * The last uploaded frame is not uploaded again. Command lists that used the previous slot
+     * must have been submitted, which holds as every output submits before the next one records.
+     * @return false if the frame could not be uploaded.
+     */
+    bool Upload(const vortex::Graphics& gfx, wis::CommandList& cmd_list, const AVFrame& frame);
+
+    // Planes of the last uploaded frame
+    [[nodiscard]] const std::array<wis::ShaderResource, 2>& GetPlanes() const noexcept
+    {
+        return _slots[_current].planes;
+    }
+    [[nodiscard]] std::array<float, 2> GetUVScale() const noexcept { return _layout.UVScale(); }
+
+private:
+    bool Resize(const vortex::Graphics& gfx, const Layout& layout);
+    const AVFrame* ConvertToNV12(const AVFrame& frame);
+
+private:
+    struct Slot {
+        vortex::Texture2D luma;
+        vortex::Texture2D chroma;
+        std::array<wis::ShaderResource, 2> planes; // Y and UV views
+        int64_t pts = AV_NOPTS_VALUE; // Frame currently in the planes
+        uint64_t fence_value = 0; // Signalled once the GPU is done with the slot
+        bool initialized = false; // Planes have been written at least once
+    };
+
+    Layout _layout;
+    Layout _failed_layout; // Not retried every frame, only once the frame size changes
+    vortex::UploadRing _staging;
+    std::array<Slot, upload_slots> _slots;
+    uint32_t _current = 0; // Slot of the last uploaded frame
+    wis::Fence _fence;
+    uint64_t _fence_value = 0;
+
+    ffmpeg::unique_swscontext _sws_context; // Only for formats that can not be written directly
+    ffmpeg::unique_frame _converted;
+};
+} // namespace vortex::ffmpeg
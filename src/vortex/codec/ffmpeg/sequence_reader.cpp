@@ -0,0 +1,530 @@
+#include <vortex/codec/ffmpeg/sequence_reader.h>
+#include <vortex/graphics.h>
+#include <vortex/sync/pts_clock.h>
+#include <vortex/util/log.h>
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <utility>
+
+std::optional<vortex::ffmpeg::SequencePattern>
+vortex::ffmpeg::SequencePattern::Parse(std::string_view filename)
+{
+    SequencePattern pattern;
+    bool found = false;
+    std::string* part = &pattern.prefix;
+    for (size_t i = 0; i < filename.size(); i++) {
+        if (filename[i] != '%') {
+            *part += filename[i];
+            continue;
+        }
+        if (i + 1 < filename.size() && filename[i + 1] == '%') {
+            *part += '%';
+            i++;
+            continue;
+        }
+
+        // %d or %0Nd
+        size_t end = i + 1;
+        while (end < filename.size() && std::isdigit(static_cast<unsigned char>(filename[end]))) {
+            end++;
+        }
+        if (found || end >= filename.size() || filename[end] != 'd') {
+            return std::nullopt; // Second or unsupported specifier
+        }
+        auto digits = filename.substr(i + 1, end - i - 1);
+        if (!digits.empty() && (digits[0] != '0' || digits.size() < 2)) {
+            return std::nullopt; // Only zero padding is supported
+        }
+        if (!digits.empty()) {
+            std::from_chars(digits.data() + 1, digits.data() + digits.size(), pattern.width);
+        }
+        found = true;
+        part = &pattern.suffix;
+        i = end;
+    }
+    return found ? std::optional{ std::move(pattern) } : std::nullopt;
+}
+
+std::string vortex::ffmpeg::SequencePattern::Format(int32_t number) const
+{
+    std::string digits = std::to_string(number);
+    if (digits.size() < size_t(width)) {
+        digits.insert(0, width - digits.size(), '0');
+    }
+    return prefix + digits + suffix;
+}
+
+std::optional<int32_t> vortex::ffmpeg::SequencePattern::Match(std::string_view filename) const
+{
+    if (filename.size() <= prefix.size() + suffix.size() || !filename.starts_with(prefix) ||
+        !filename.ends_with(suffix)) {
+        return std::nullopt;
+    }
+    auto digits = filename.substr(prefix.size(), filename.size() - prefix.size() - suffix.size());
+    if (digits.size() < size_t(width) ||
+        !std::ranges::all_of(digits, [](char c) { return c >= '0' && c <= '9'; })) {
+        return std::nullopt;
+    }
+    int32_t number = 0;
+    auto [ptr, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), number);
+    return ec == std::errc{} ? std::optional{ number } : std::nullopt;
+}
+
+vortex::ffmpeg::SequenceReader::SequenceReader(const vortex::Graphics& gfx, const std::filesystem::path& path)
+    : _gfx(gfx)
+    , _directory(path.has_parent_path() ? path.parent_path() : std::filesystem::path{ "." })
+    , _pattern(SequencePattern::Parse(path.filename().string()))
+{
+    wis::Result result = wis::success;
+    _fence = gfx.GetDevice().CreateFence(result);
+    if (!vortex::success(result)) {
+        vortex::error("SequenceReader: Failed to create fence: {}", result.error);
+        return;
+    }
+
+    if (_pattern) {
+        // Find the range of the sequence on disk, missing files hold the previous frame
+        std::error_code ec;
+        std::optional<int32_t> first, last;
+        for (auto& entry : std::filesystem::directory_iterator(_directory, ec)) {
+            if (auto number = _pattern->Match(entry.path().filename().string())) {
+                first = std::min(first.value_or(*number), *number);
+                last = std::max(last.value_or(*number), *number);
+            }
+        }
+        if (!first) {
+            vortex::error("SequenceReader: No files match the sequence: {}", path.string());
+            return;
+        }
+        _first_number = *first;
+        _frame_count = *last - *first + 1;
+        _frame_count_exact = true;
+
+        // Frames are independent files, two workers keep up with the output rate
+        for (uint32_t i = 0; i < 2; i++) {
+            _workers.emplace_back([this](std::stop_token stop) { SequenceWorker(stop); });
+        }
+        return;
+    }
+
+    auto decoder = codec::CodecFFmpeg::OpenFileDecoder(path);
+    if (!decoder) {
+        return; // Error is logged by the codec
+    }
+    const AVStream* stream = decoder->format_context->streams[decoder->stream_index];
+    _native_rate = { stream->avg_frame_rate.num, stream->avg_frame_rate.den };
+    if (stream->nb_frames > 0) {
+        _frame_count = int32_t(stream->nb_frames);
+    } else if (stream->duration > 0 && _native_rate.num() > 0) {
+        _frame_count = int32_t(av_rescale_q(stream->duration, stream->time_base,
+                                            { _native_rate.denom(), _native_rate.num() }));
+    } else {
+        _frame_count = 1; // Corrected once the end of the clip is reached
+    }
+    // Without timestamps decoded frames can't be placed after a seek
+    _clip_seekable = _native_rate.num() > 0 && stream->time_base.num > 0 &&
+            !(decoder->format_context->iformat->flags & AVFMT_NOTIMESTAMPS);
+    _decoder = std::move(decoder.value());
+
+    // Clips decode sequentially, a single worker owns the decoder
+    _workers.emplace_back([this](std::stop_token stop) { ClipWorker(stop); });
+}
+
+vortex::ffmpeg::SequenceReader::~SequenceReader()
+{
+    _workers.clear(); // Stops and joins, workers may wait on the fence
+
+    // Frames in flight may still sample the textures
+    std::unique_lock lock(_mutex);
+    if (std::ranges::any_of(_slots, &FrameSlot::pending)) {
+        std::ignore = _gfx.SignalQueue(_fence, ++_fence_value);
+    }
+    if (_fence) {
+        std::ignore = _fence.Wait(_fence_value);
+    }
+}
+
+void vortex::ffmpeg::SequenceReader::Seek(int32_t cursor, int32_t first, int32_t last, bool loop)
+{
+    std::vector<int32_t> window;
+    window.reserve(read_ahead_frames);
+    for (int32_t index = cursor; window.size() < read_ahead_frames;) {
+        window.push_back(index);
+        if (++index > last) {
+            if (!loop) {
+                break;
+            }
+            index = first;
+        }
+        if (index == cursor) {
+            break; // Range is shorter than the window
+        }
+    }
+
+    std::unique_lock lock(_mutex);
+    if (window == _window) {
+        return;
+    }
+    _window = std::move(window);
+
+    // Release what the window moved past, the shown frame is held until it is replaced
+    std::vector<int32_t> released;
+    for (auto& [index, slot] : _frames) {
+        if (index != _shown && !InWindow(index)) {
+            released.push_back(index);
+        }
+    }
+    for (int32_t index : released) {
+        FreeFrame(index);
+    }
+    _window_cv.notify_all();
+}
+
+void vortex::ffmpeg::SequenceReader::FreeFrame(int32_t index)
+{
+    auto it = _frames.find(index);
+    if (it == _frames.end()) {
+        return;
+    }
+    if (it->second >= 0) {
+        _slots[it->second].index = -1; // Reused once the GPU is done with it
+    }
+    _frames.erase(it);
+}
+
+const wis::ShaderResource* vortex::ffmpeg::SequenceReader::ShowFrame(const vortex::Graphics& gfx,
+                                                                     wis::CommandList& cmd_list,
+                                                                     int32_t index)
+{
+    std::unique_lock lock(_mutex);
+
+    // Everything recorded by earlier calls is submitted, the signal follows it on the queue
+    if (std::ranges::any_of(_slots, &FrameSlot::pending)) {
+        auto result = gfx.SignalQueue(_fence, ++_fence_value);
+        if (!vortex::success(result)) {
+            vortex::error("SequenceReader: Failed to signal the frame fence: {}", result.error);
+            return nullptr;
+        }
+        for (auto& slot : _slots) {
+            if (std::exchange(slot.pending, false)) {
+                slot.fence_value = _fence_value;
+            }
+        }
+        _window_cv.notify_all(); // Workers may be waiting for a free slot
+    }
+
+    // A frame that is not decoded yet holds the previous one
+    auto it = _frames.find(index);
+    if (it != _frames.end() && it->second >= 0 && index != _shown) {
+        int32_t previous = std::exchange(_shown, index);
+        if (!InWindow(previous)) {
+            FreeFrame(previous);
+        }
+    }
+    it = _frames.find(_shown);
+    if (it == _frames.end() || it->second < 0) {
+        return nullptr;
+    }
+
+    auto& slot = _slots[it->second];
+    if (!slot.copied) {
+        cmd_list.TextureBarrier(
+                {
+                        .sync_before = slot.initialized ? wis::BarrierSync::Draw : wis::BarrierSync::None,
+                        .sync_after = wis::BarrierSync::Copy,
+                        .access_before = slot.initialized ? wis::ResourceAccess::ShaderResource
+                                                          : wis::ResourceAccess::NoAccess,
+                        .access_after = wis::ResourceAccess::CopyDest,
+                        .state_before = slot.initialized ? wis::TextureState::ShaderResource
+                                                         : wis::TextureState::Undefined,
+                        .state_after = wis::TextureState::CopyDest,
+                },
+                slot.texture.Get());
+        wis::BufferTextureCopyRegion region{
+            .buffer_offset = _staging.GetSlotOffset(uint32_t(it->second)),
+            .texture = {
+                    .offset = { 0, 0, 0 },
+                    .size = { _row_pitch, _height, 1 },
+                    .mip = 0,
+                    .array_layer = 0,
+                    .format = wis::DataFormat::RGBA8Unorm,
+            },
+        };
+        cmd_list.CopyBufferToTexture(_staging.GetBuffer(), slot.texture.Get(), &region, 1);
+        cmd_list.TextureBarrier(
+                {
+                        .sync_before = wis::BarrierSync::Copy,
+                        .sync_after = wis::BarrierSync::Draw,
+                        .access_before = wis::ResourceAccess::CopyDest,
+                        .access_after = wis::ResourceAccess::ShaderResource,
+                        .state_before = wis::TextureState::CopyDest,
+                        .state_after = wis::TextureState::ShaderResource,
+                },
+                slot.texture.Get());
+        slot.copied = true;
+        slot.initialized = true;
+    }
+    slot.pending = true;
+    return &slot.srv;
+}
+
+void vortex::ffmpeg::SequenceReader::ReleaseShown()
+{
+    std::unique_lock lock(_mutex);
+    int32_t previous = std::exchange(_shown, -1);
+    if (!InWindow(previous)) {
+        FreeFrame(previous);
+    }
+}
+
+int32_t vortex::ffmpeg::SequenceReader::FrameIndexAt(int64_t elapsed_pts, vortex::ratio32_t rate, int32_t first, int32_t last, bool loop) noexcept
+{
+    if (elapsed_pts <= 0 || rate.num() <= 0 || last <= first) {
+        return first;
+    }
+    int64_t frames = elapsed_pts * rate.num() / (int64_t(rate.denom()) * vortex::sync::PTSClock::timebase_hz);
+    int64_t length = int64_t(last) - first + 1;
+    return first + int32_t(loop ? frames % length : std::min(frames, length - 1));
+}
+
+std::optional<int32_t> vortex::ffmpeg::SequenceReader::NextMissingFrame() const
+{
+    int32_t count = _frame_count.load(std::memory_order_relaxed);
+    for (int32_t index : _window) {
+        if (index < 0 || (_frame_count_exact && index >= count)) {
+            continue; // Past the end of the clip
+        }
+        if (!_frames.contains(index) && !_loading.contains(index)) {
+            return index;
+        }
+    }
+    return std::nullopt;
+}
+
+void vortex::ffmpeg::SequenceReader::SequenceWorker(std::stop_token stop)
+{
+    ffmpeg::unique_swscontext sws;
+    while (!stop.stop_requested()) {
+        std::unique_lock lock(_mutex);
+        std::optional<int32_t> index;
+        if (!_window_cv.wait(lock, stop, [&] { return (index = NextMissingFrame()).has_value(); })) {
+            return; // Stop requested
+        }
+        _loading.insert(*index);
+        lock.unlock();
+
+        auto frame = codec::CodecFFmpeg::DecodeImage(_directory / _pattern->Format(_first_number + *index));
+        StoreFrame(stop, *index, frame ? frame.value().get() : nullptr, sws);
+
+        lock.lock();
+        _loading.erase(*index);
+    }
+}
+
+void vortex::ffmpeg::SequenceReader::ClipWorker(std::stop_token stop)
+{
+    ffmpeg::unique_swscontext sws;
+    while (!stop.stop_requested()) {
+        std::unique_lock lock(_mutex);
+        std::optional<int32_t> index;
+        if (!_window_cv.wait(lock, stop, [&] { return (index = NextMissingFrame()).has_value(); })) {
+            return; // Stop requested
+        }
+        lock.unlock();
+
+        // Decoding only goes forward. Frames behind the decoder, or further ahead than is worth
+        // decoding through such as the in point, seek to the keyframe before them
+        bool far_ahead = *index > std::max(_decode_next, _seek_target) + seek_ahead_frames;
+        if (*index < _decode_next || (_clip_seekable && far_ahead)) {
+            if (!SeekClip(*index)) {
+                return;
+            }
+        }
+
+        auto frame = codec::CodecFFmpeg::DecodeNextFrame(*_decoder);
+        if (!frame) {
+            // End of the clip, now the length is known
+            lock.lock();
+            _frame_count = std::max(_decode_next, 1);
+            _frame_count_exact = true;
+            if (_decode_next == 0) {
+                vortex::error("SequenceReader: Clip has no decodable frames");
+                _frames[0] = -1; // Nothing to wait for
+            }
+            continue;
+        }
+
+        auto position = _clip_seekable ? ClipFrameIndex(*frame.value().get()) : std::nullopt;
+        if (std::exchange(_seeking, false) && (!position || *position > _seek_target)) {
+            // The seek can't be trusted, decode from the start like clips without timestamps
+            vortex::warn("SequenceReader: Seeking is not reliable for this clip, decoding from the start");
+            _clip_seekable = false;
+            if (!SeekClip(0)) {
+                return;
+            }
+            continue;
+        }
+
+        int32_t decoded = position.value_or(_decode_next);
+        _decode_next = decoded + 1;
+        lock.lock();
+        bool wanted = InWindow(decoded) && !_frames.contains(decoded);
+        lock.unlock();
+        if (!wanted) {
+            continue; // Frames before the window are decoded and dropped
+        }
+
+        StoreFrame(stop, decoded, frame.value().get(), sws);
+    }
+}
+
+void vortex::ffmpeg::SequenceReader::StoreFrame(std::stop_token stop,
+                                                int32_t index,
+                                                const AVFrame* frame,
+                                                ffmpeg::unique_swscontext& sws)
+{
+    std::unique_lock lock(_mutex);
+    if (!InWindow(index) || _frames.contains(index)) {
+        return;
+    }
+    if (!frame || frame->width <= 0 || frame->height <= 0 || (!_staging && !CreateRing(frame->width, frame->height))) {
+        _frames[index] = -1; // Failed frames are kept empty, so they are not retried
+        _window_cv.notify_all();
+        return;
+    }
+
+    // Slots free up as the window moves and the outputs signal the fence
+    auto free_slot = [this] {
+        return std::ranges::find_if(_slots, [](const FrameSlot& slot) { return slot.index < 0 && !slot.pending; });
+    };
+    if (!_window_cv.wait(lock, stop, [&] { return free_slot() != _slots.end() || !InWindow(index); }) ||
+        !InWindow(index)) {
+        return;
+    }
+    auto slot = free_slot();
+    uint32_t slot_index = uint32_t(slot - _slots.begin());
+    slot->index = index;
+    slot->copied = false;
+    uint64_t fence_value = slot->fence_value;
+    lock.unlock();
+
+    // Usually long done, only waits when the texture was shown by the last frames in flight
+    bool converted = false;
+    if (auto result = _fence.Wait(fence_value); !vortex::success(result)) {
+        vortex::error("SequenceReader: Failed to wait for the frame fence: {}", result.error);
+    } else {
+        // Frames of another size are scaled to the ring
+        sws.reset(sws_getCachedContext(sws.release(),
+                                       frame->width, frame->height, AVPixelFormat(frame->format),
+                                       int(_width), int(_height), AV_PIX_FMT_RGBA,
+                                       SWS_BILINEAR, nullptr, nullptr, nullptr));
+        if (!sws) {
+            vortex::error("SequenceReader: Could not convert {} frames",
+                          av_get_pix_fmt_name(AVPixelFormat(frame->format)));
+        } else {
+            auto* data = reinterpret_cast<uint8_t*>(_staging.GetSlot(slot_index).data());
+            uint32_t stride = _row_pitch * 4;
+            uint8_t* planes[4] = { data, nullptr, nullptr, nullptr };
+            int strides[4] = { int(stride), 0, 0, 0 };
+            sws_scale(sws.get(), frame->data, frame->linesize, 0, frame->height, planes, strides);
+
+            // Padding repeats the edge, so filtering at the right edge does not bleed black in
+            for (uint32_t y = 0; y < _height && _row_pitch > _width; y++) {
+                uint8_t* row = data + std::size_t(y) * stride;
+                for (uint32_t x = _width; x < _row_pitch; x++) {
+                    std::memcpy(row + x * 4, row + (_width - 1) * 4, 4);
+                }
+            }
+            converted = true;
+        }
+    }
+
+    lock.lock();
+    if (!converted || !InWindow(index)) {
+        slot->index = -1;
+        if (!converted && InWindow(index)) {
+            _frames[index] = -1;
+        }
+    } else {
+        _frames[index] = int32_t(slot_index);
+    }
+    _window_cv.notify_all();
+}
+
+bool vortex::ffmpeg::SequenceReader::CreateRing(uint32_t width, uint32_t height)
+{
+    if (_ring_failed || !_fence) {
+        return false;
+    }
+    _ring_failed = true; // Until everything was created
+
+    _row_pitch = uint32_t(wis::aligned_size(uint64_t(width) * 4, uint64_t(UploadRing::row_pitch_alignment))) / 4;
+    uint64_t slot_size = wis::aligned_size(uint64_t(_row_pitch) * 4 * height, UploadRing::placement_alignment);
+    _staging = vortex::UploadRing(_gfx, slot_size, frame_slots);
+    if (!_staging) {
+        return false;
+    }
+
+    for (auto& slot : _slots) {
+        wis::Result result = wis::success;
+        wis::TextureDesc desc{
+            .format = wis::DataFormat::RGBA8Unorm,
+            .size = { _row_pitch, height, 1 },
+            .mip_levels = 1,
+            .layout = wis::TextureLayout::Texture2D,
+            .sample_count = wis::SampleRate::S1,
+            .usage = wis::TextureUsage::CopyDst | wis::TextureUsage::ShaderResource,
+        };
+        slot = {};
+        slot.texture = vortex::Texture2D(_gfx.GetAllocator().CreateTexture(result, desc, wis::MemoryType::Default),
+                                         { _row_pitch, height },
+                                         wis::DataFormat::RGBA8Unorm);
+        if (!vortex::success(result)) {
+            vortex::error("SequenceReader: Failed to create frame texture: {}", result.error);
+            _staging = {};
+            return false;
+        }
+        slot.srv = slot.texture.CreateShaderResource(_gfx);
+    }
+
+    _width = width;
+    _height = height;
+    _width_scale = float(width) / float(_row_pitch);
+    _ring_failed = false;
+    vortex::info("SequenceReader: Streaming {}x{} frames through {} texture slots", width, height, frame_slots);
+    return true;
+}
+
+bool vortex::ffmpeg::SequenceReader::SeekClip(int32_t target)
+{
+    _seek_target = target;
+    if (!_clip_seekable || target == 0) {
+        _decode_next = 0;
+        return codec::CodecFFmpeg::Rewind(*_decoder);
+    }
+
+    const AVStream* stream = _decoder->format_context->streams[_decoder->stream_index];
+    int64_t start = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+    int64_t timestamp = start + av_rescale_q(target, { _native_rate.denom(), _native_rate.num() }, stream->time_base);
+    if (!codec::CodecFFmpeg::SeekToKeyframe(*_decoder, timestamp)) {
+        return false;
+    }
+    _decode_next = target; // Until the first frame tells where the keyframe is
+    _seeking = true;
+    return true;
+}
+
+std::optional<int32_t> vortex::ffmpeg::SequenceReader::ClipFrameIndex(const AVFrame& frame) const
+{
+    if (frame.best_effort_timestamp == AV_NOPTS_VALUE) {
+        return std::nullopt;
+    }
+    const AVStream* stream = _decoder->format_context->streams[_decoder->stream_index];
+    int64_t start = stream->start_time != AV_NOPTS_VALUE ? stream->start_time : 0;
+    return int32_t(av_rescale_q_rnd(frame.best_effort_timestamp - start,
+                                    stream->time_base,
+                                    { _native_rate.denom(), _native_rate.num() },
+                                    AV_ROUND_NEAR_INF));
+}
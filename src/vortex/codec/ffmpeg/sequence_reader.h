@@ -0,0 +1,147 @@
+#pragma once
+#include <vortex/codec/ffmpeg/codec_ffmpeg.h>
+#include <vortex/gfx/texture.h>
+#include <vortex/gfx/upload_ring.h>
+#include <vortex/util/rational.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace vortex {
+class Graphics;
+}
+
+namespace vortex::ffmpeg {
+// printf style frame number in a file name, e.g. "stinger_%04d.png"
+struct SequencePattern {
+    std::string prefix;
+    std::string suffix;
+    int width = 0; // Zero padded width of the number, 0 for no padding
+
+public:
+    // Exactly one %d or %0Nd is accepted, %% is a literal percent sign
+    static std::optional<SequencePattern> Parse(std::string_view filename);
+
+public:
+    std::string Format(int32_t number) const;
+    std::optional<int32_t> Match(std::string_view filename) const;
+};
+
+// Streams frames of a numbered image sequence or a video clip.
+// Frames ahead of the playback cursor are decoded on worker threads and converted to RGBA straight
+// into the staging slots of a fixed ring, so playback never waits on the disk once the window is filled.
+// A frame is copied to the texture of its slot on the render thread when it is first shown.
+// Slots are reused once the fence of the reader says the GPU is done with them, nothing is
+// allocated per frame once the ring exists.
+class SequenceReader
+{
+public:
+    static constexpr uint32_t read_ahead_frames = 8; // Frames kept resident ahead of the cursor
+    static constexpr int32_t seek_ahead_frames = 32; // Closer clip frames are decoded through instead
+    static constexpr uint32_t frame_slots = read_ahead_frames + max_frames_in_flight * 2; // Window and frames in flight
+
+public:
+    SequenceReader(const vortex::Graphics& gfx, const std::filesystem::path& path);
+    ~SequenceReader();
+
+public:
+    bool IsOpen() const noexcept { return _frame_count.load(std::memory_order_relaxed) > 0; }
+    // Exact for sequences, estimated for clips until the end of the clip was decoded
+    int32_t FrameCount() const noexcept { return _frame_count.load(std::memory_order_relaxed); }
+    // Rate stored in the clip, 0 for image sequences
+    vortex::ratio32_t NativeRate() const noexcept { return _native_rate; }
+
+    /**
+     * Moves the read-ahead window. Frames outside of it are released.
+     * @param cursor Next frame to be shown.
+     * @param first First frame of the playback range.
+     * @param last Last frame of the playback range.
+     * @param loop Whether the window wraps from last to first.
+     */
+    void Seek(int32_t cursor, int32_t first, int32_t last, bool loop);
+
+    /**
+     * Records the copy of the frame into the texture of its slot, if it was not copied yet.
+     * A frame that is not decoded yet holds the last shown one, which stays resident until replaced.
+     * Must be recorded outside of a render pass. Command lists recorded by earlier calls must have
+     * been submitted, which holds as every output submits before the next one records.
+     * @return View of the frame, nullptr if nothing was decoded yet.
+     */
+    const wis::ShaderResource* ShowFrame(const vortex::Graphics& gfx, wis::CommandList& cmd_list, int32_t index);
+    // Lets go of the held frame, so a restart does not show the end of the last playback
+    void ReleaseShown();
+
+    // Visible width of the frame textures over their padded width, 1 until the ring exists
+    float GetWidthScale() const noexcept { return _width_scale.load(std::memory_order_relaxed); }
+
+    // Frame to be shown after elapsed_pts (90kHz) of playback of the range [first, last]
+    static int32_t FrameIndexAt(int64_t elapsed_pts, vortex::ratio32_t rate, int32_t first, int32_t last, bool loop) noexcept;
+
+private:
+    void SequenceWorker(std::stop_token stop);
+    void ClipWorker(std::stop_token stop);
+    std::optional<int32_t> NextMissingFrame() const; // Expects _mutex to be held
+    // Converts a decoded frame into a free slot of the ring, failed frames are stored empty
+    void StoreFrame(std::stop_token stop, int32_t index, const AVFrame* frame, ffmpeg::unique_swscontext& sws);
+    bool CreateRing(uint32_t width, uint32_t height); // Expects _mutex to be held
+    bool InWindow(int32_t index) const { return std::ranges::find(_window, index) != _window.end(); }
+    void FreeFrame(int32_t index); // Expects _mutex to be held
+    bool SeekClip(int32_t target); // Called by the clip worker
+    std::optional<int32_t> ClipFrameIndex(const AVFrame& frame) const;
+
+private:
+    struct FrameSlot {
+        vortex::Texture2D texture;
+        wis::ShaderResource srv;
+        int32_t index = -1; // Frame stored or being written, -1 while free
+        bool copied = false; // Texture holds the frame of the staging slot
+        bool initialized = false; // Texture has been written at least once
+        bool pending = false; // Used by command lists recorded since the last signal
+        uint64_t fence_value = 0; // Signalled once the GPU is done with the staging slot and the texture
+    };
+
+    const vortex::Graphics& _gfx;
+    std::filesystem::path _directory;
+    std::optional<SequencePattern> _pattern; // Empty for clips
+    int32_t _first_number = 0; // Number of the first file of a sequence
+    vortex::ratio32_t _native_rate{ 0, 1 };
+
+    std::atomic<int32_t> _frame_count = 0;
+    bool _frame_count_exact = false; // Set once a clip was decoded to the end
+
+    mutable std::mutex _mutex;
+    std::condition_variable_any _window_cv;
+    std::vector<int32_t> _window; // Wanted frames in playback order
+    std::map<int32_t, int32_t> _frames; // Slots of the decoded frames, -1 if a frame failed
+    std::set<int32_t> _loading; // Frames being decoded by sequence workers
+    int32_t _shown = -1; // Frame held for display, kept outside of the window
+
+    // Ring, created by the first decoded frame
+    std::array<FrameSlot, frame_slots> _slots;
+    vortex::UploadRing _staging;
+    wis::Fence _fence;
+    uint64_t _fence_value = 0;
+    bool _ring_failed = false;
+    uint32_t _width = 0; // Size of the frame textures, frames of another size are scaled
+    uint32_t _height = 0;
+    uint32_t _row_pitch = 0; // Padded width in pixels, also the width of the textures
+    std::atomic<float> _width_scale = 1.0f;
+
+    std::optional<codec::FileDecoder> _decoder; // Clip decoder, owned by the clip worker
+    int32_t _decode_next = 0; // Index of the next frame the clip decoder produces
+    int32_t _seek_target = 0; // Frame the last seek was for
+    bool _seeking = false; // No frame was decoded since the last seek
+    bool _clip_seekable = false; // Frames are placed by timestamp, otherwise counted from the start
+
+    std::vector<std::jthread> _workers; // Declared last, stopped before the ring is destroyed
+};
+} // namespace vortex::ffmpeg
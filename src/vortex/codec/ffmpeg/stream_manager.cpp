@@ -3,6 +3,9 @@
 #include <vortex/util/log_storage.h>
 #include <vortex/graphics.h>
 #include <system_error>
+#include <tuple>
+#include <bit>
+#include <algorithm>
 
 void vortex::ffmpeg::StreamManager::AvLogCallbackThunk(void* ptr, int level, const char* fmt, va_list vargs)
 {
@@ -48,86 +51,296 @@ void vortex::ffmpeg::StreamManager::AvLogCallbackThunk(void* ptr, int level, con
     }
 }
 
-vortex::ffmpeg::StreamManager::StreamManager(const vortex::Graphics& gfx)
+vortex::ffmpeg::StreamManager::StreamManager(const vortex::Graphics& gfx, const StreamManagerDesc& desc)
     : _log(vortex::LogStorage::GetLog(vortex::stream_log_name))
+    , _desc(desc)
 {
+    _desc.max_demux_threads = std::max(_desc.max_demux_threads, 1u);
+    _desc.max_connect_threads = std::max(_desc.max_connect_threads, 1u);
+
     // Set FFmpeg log callback
     av_log_set_callback(AvLogCallbackThunk);
 
-    _va_decode_context = ffmpeg::CreateDecodeContext(gfx.GetDevice()).value();
+    // Without a decode queue every stream is decoded in software
+    if (!_desc.force_software_decode) {
+        auto decode_context = ffmpeg::CreateDecodeContext(gfx.GetDevice());
+        if (decode_context) {
+            _va_decode_context.emplace(std::move(decode_context.value()));
+        } else {
+            _log.warn("Hardware video decoding is unavailable, falling back to software: {}",
+                      decode_context.error().message());
+        }
+    }
 
-    // Start a single packet reading thread
-    _io_threads.emplace_back([this](std::stop_token stop) { PacketLoop(stop); });
+    // Demux threads are started as streams are registered
 
     // Start the IO loop thread
     _io_threads.emplace_back([this](std::stop_token stop) { IOLoop(stop); });
 }
 vortex::ffmpeg::StreamManager::~StreamManager()
 {
+    // Abort pending connections first, a connection that finishes registers a stream
+    {
+        std::scoped_lock lock(_connect_mutex);
+        for (auto& connection : _connections) {
+            connection->cancelled.store(true);
+        }
+    }
+    _connect_threads.clear();
+
     // Stop all IO threads
-    std::unique_lock lock(_streams_mutex);
-    for (auto& thread : _io_threads) {
-        thread.request_stop();
+    {
+        std::unique_lock lock(_streams_mutex);
+        for (auto& thread : _io_threads) {
+            thread.request_stop();
+        }
+        for (auto& [handle, stream] : _streams) {
+            stream->Close(); // Wakes readers blocked in av_read_frame
+        }
     }
+    _demux_threads.clear(); // Requests stop and joins
+    _io_threads.clear();
 }
 
-void vortex::ffmpeg::StreamManager::PacketLoop(std::stop_token stop)
+void vortex::ffmpeg::StreamManager::DemuxLoop(std::stop_token stop)
 {
-    _log.info("Packet thread started.");
-    std::vector<std::shared_ptr<ManagedStream>> streams_to_read;
-    uint64_t last_update_generation = 0;
-
+    _log.info("Demux thread started.");
     while (!stop.stop_requested()) {
-        // In order to stabilize the input stream, we read packets from all streams in a round-robin fashion.
-        uint64_t current_update_generation = _update_generation.load(std::memory_order::acquire);
-        if (current_update_generation != last_update_generation) {
-            std::shared_lock lock(_streams_mutex);
-            streams_to_read.clear();
-            for (const auto& pair : _streams) {
-                streams_to_read.push_back(pair.second);
-            }
-            last_update_generation = current_update_generation;
+        std::unique_lock lock(_demux_mutex);
+        if (!_demux_cv.wait(lock, stop, [this] { return !_demux_tasks.empty(); })) {
+            break; // Stop requested
         }
 
-        if (streams_to_read.empty()) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        // Streams that had nothing to read wait out their delay, without holding up the others
+        auto now = std::chrono::steady_clock::now();
+        auto due = std::ranges::find_if(_demux_tasks, [now](const DemuxTask& task) { return task.not_before <= now; });
+        if (due == _demux_tasks.end()) {
+            _demux_cv.wait_until(lock, std::ranges::min_element(_demux_tasks, {}, &DemuxTask::not_before)->not_before);
             continue;
         }
+        auto task = std::move(*due);
+        _demux_tasks.erase(due);
+        lock.unlock();
 
-        for (const auto& stream : streams_to_read) {
-            ReadStreamPackets(stop, *stream);
+        auto stream = std::move(task.stream);
+        if (stream->closing.load(std::memory_order::relaxed)) {
+            continue; // Unregistered, the last reference may be dropped here
+        }
+
+        // Requeued at the back, so streams are read round-robin across the readers
+        switch (ReadStreamPackets(*stream)) {
+        case ReadResult::packet:
+            ScheduleDemux(std::move(stream), {});
+            break;
+        case ReadResult::retry:
+            ScheduleDemux(std::move(stream), {});
+            break;
+        case ReadResult::error:
+            ScheduleDemux(std::move(stream), std::chrono::steady_clock::now() + ManagedStream::read_error_backoff);
+            break;
+        case ReadResult::finished:
+        case ReadResult::blocked:
+            break;
         }
     }
-    _log.info("Packet thread stopped.");
+    _log.info("Demux thread stopped.");
 }
-bool vortex::ffmpeg::StreamManager::ReadStreamPackets(
-        std::stop_token stop,
-        vortex::ffmpeg::ManagedStream& stream)
+void vortex::ffmpeg::StreamManager::ScheduleDemux(std::shared_ptr<ManagedStream> stream,
+                                                  std::chrono::steady_clock::time_point not_before)
 {
-    ffmpeg::unique_packet packet{ av_packet_alloc() };
-    int ret = av_read_frame(stream.context.get(), packet.get());
-    if (ret == AVERROR(EAGAIN)) {
-        // No packet available right now, try again later
-        return false;
+    {
+        std::scoped_lock lock(_demux_mutex);
+        _demux_tasks.push_back({ std::move(stream), not_before });
     }
-    if (ret >= 0) {
-        if (stream.read_queue.size() == 64) {
-            // Read queue is full, drop the packet
-            _log.warn("Read queue full, force pushing for stream index {}", packet->stream_index);
+    _demux_cv.notify_one();
+}
+void vortex::ffmpeg::StreamManager::GrowDemuxThreads(std::size_t stream_count)
+{
+    // Readers scale with the stream count, up to the cap
+    std::scoped_lock lock(_demux_mutex);
+    if (_demux_threads.size() < std::min<std::size_t>(stream_count, _desc.max_demux_threads)) {
+        _demux_threads.emplace_back([this](std::stop_token stop) { DemuxLoop(stop); });
+    }
+}
+void vortex::ffmpeg::StreamManager::ConnectLoop(std::stop_token stop)
+{
+    while (!stop.stop_requested()) {
+        std::unique_lock lock(_connect_mutex);
+        if (!_connect_cv.wait(lock, stop, [this] { return !_connect_tasks.empty(); })) {
+            break; // Stop requested
         }
 
-        // Successfully read a packet, now dispatch it to the appropriate channel
-        stream.read_queue.force_emplace(std::move(packet)); // Non-blocking enqueue
+        // Connections waiting for the same source to be opened do not hold a thread
+        auto now = std::chrono::steady_clock::now();
+        auto due = std::ranges::find_if(_connect_tasks, [now](const ConnectTask& task) { return task.not_before <= now; });
+        if (due == _connect_tasks.end()) {
+            _connect_cv.wait_until(lock, std::ranges::min_element(_connect_tasks, {}, &ConnectTask::not_before)->not_before);
+            continue;
+        }
+        auto task = std::move(*due);
+        _connect_tasks.erase(due);
+        lock.unlock();
+
+        bool finished = task.connection->cancelled.load(std::memory_order::relaxed) || Connect(*task.connection);
+
+        lock.lock();
+        if (!finished) {
+            // Same source is being opened, join it once it is registered
+            _connect_tasks.push_back({ std::move(task.connection), std::chrono::steady_clock::now() + std::chrono::milliseconds(50) });
+            continue;
+        }
+        std::erase(_connections, task.connection);
+    }
+}
+bool vortex::ffmpeg::StreamManager::Connect(StreamConnection& connection)
+{
+    // Share a stream that is already open for the same source, or wait for one being opened
+    {
+        std::unique_lock lock(_streams_mutex);
+        for (auto& [key, stream] : _streams) {
+            if (stream->key != connection.key || stream->dropped.load(std::memory_order::relaxed)) {
+                continue;
+            }
+            if (StreamHandle handle = AttachConsumer(stream, connection.active_channel_indices)) {
+                _log.info("Sharing stream {} with another consumer", connection.url);
+                connection.channels = codec::CodecFFmpeg::GetStreams(stream->context.get()).value_or(codec::StreamChannels{});
+                connection.handle.store(handle);
+                connection.done.store(true, std::memory_order::release);
+                if (connection.cancelled.load()) {
+                    lock.unlock();
+                    UnregisterStream(connection.handle.exchange(0));
+                }
+                return true;
+            }
+        }
+        if (!_connecting_keys.insert(connection.key).second) {
+            return false; // Opened by another connection, retried once it is registered
+        }
+    }
+    auto finish_connecting = [this, &connection] {
+        std::unique_lock lock(_streams_mutex);
+        _connecting_keys.erase(connection.key);
+    };
+
+    auto context = codec::CodecFFmpeg::ConnectToStream(connection.url,
+                                                       std::move(connection.options),
+                                                       connection.timeout,
+                                                       &connection.cancelled);
+    if (!context) {
+        finish_connecting();
+        connection.error = context.error();
+        connection.done.store(true, std::memory_order::release);
         return true;
     }
+    auto channels = codec::CodecFFmpeg::GetStreams(context->get());
+    if (!channels || channels->video_channels.empty()) {
+        finish_connecting();
+        _log.error("No video stream found in {}", connection.url);
+        connection.error = ffmpeg::make_ffmpeg_error(AVERROR_STREAM_NOT_FOUND);
+        connection.done.store(true, std::memory_order::release);
+        return true;
+    }
+
+    // Decoders are opened here as well, the stream is ready to be consumed once done is set
+    connection.channels = std::move(channels.value());
+    connection.handle.store(RegisterStream(std::move(context.value()), connection.active_channel_indices, connection.key));
+    finish_connecting();
+    connection.done.store(true, std::memory_order::release);
+    if (connection.cancelled.load()) {
+        UnregisterStream(connection.handle.exchange(0)); // Abandoned while the decoders were opened
+    }
+    return true;
+}
+auto vortex::ffmpeg::StreamManager::DropStream(vortex::ffmpeg::ManagedStream& stream, std::string_view reason) -> ReadResult
+{
+    _log.warn("Stream {} dropped: {}", stream.context->url ? stream.context->url : "", reason);
+    stream.dropped.store(true, std::memory_order::relaxed);
+    return ReadResult::finished;
+}
+auto vortex::ffmpeg::StreamManager::ReadStreamPackets(vortex::ffmpeg::ManagedStream& stream) -> ReadResult
+{
+    // A packet held back by a full queue goes first
+    if (stream.held_packet) {
+        return QueuePacket(stream, std::move(stream.held_packet));
+    }
+
+    // Reads block until the source sends data, a live source is interrupted once it stalls
+    if (auto* interrupt = StreamInterrupt::Get(stream.context.get()); interrupt && stream.live) {
+        interrupt->deadline.store((stream.last_read + ManagedStream::stall_timeout).time_since_epoch().count(),
+                                  std::memory_order::relaxed);
+    }
 
+    ffmpeg::pooled_packet packet = stream.packet_pool->acquire();
+    int ret = av_read_frame(stream.context.get(), packet.get());
+    if (ret >= 0) {
+        packet->opaque = HopLatency::Stamp(); // Carried to the decoded frame
+        stream.last_read = std::chrono::steady_clock::now();
+        stream.packets_read.fetch_add(1, std::memory_order::relaxed);
+        stream.bytes_read.fetch_add(uint64_t(packet->size), std::memory_order::relaxed);
+        return QueuePacket(stream, std::move(packet));
+    }
+    if (stream.closing.load(std::memory_order::relaxed)) {
+        return ReadResult::finished; // Read was interrupted by UnregisterStream
+    }
+
+    // A live source that stops sending is gone, whether it says so or not
+    bool stalled = stream.live && std::chrono::steady_clock::now() - stream.last_read > ManagedStream::stall_timeout;
+    if (ret == AVERROR(EAGAIN)) {
+        // Demuxer wants another read, it blocks in the protocol until data arrives
+        return stalled ? DropStream(stream, "no packets received") : ReadResult::retry;
+    }
+    if (ret == AVERROR_EOF && stream.live) {
+        return DropStream(stream, "source closed the connection");
+    }
     if (ret == AVERROR_EOF) {
-        // End of stream, send flush packets to all decoders
-        IOFlushStream(stream);
-        return false;
+        // End of stream, the I/O thread flushes the decoders once the read queue is drained
+        stream.end_of_stream.store(true, std::memory_order::release);
+        _io_wake.notify();
+        return ReadResult::finished;
     }
     _log.error("Error reading frame from stream: {}", ffmpeg::ffmpeg_error_string(ret));
-    return false;
+    stream.read_errors.fetch_add(1, std::memory_order::relaxed);
+    return stalled ? DropStream(stream, ffmpeg::ffmpeg_error_string(ret)) : ReadResult::error;
+}
+
+auto vortex::ffmpeg::StreamManager::QueuePacket(vortex::ffmpeg::ManagedStream& stream,
+                                                ffmpeg::pooled_packet packet) -> ReadResult
+{
+    if (!stream.live) {
+        // Files are read as fast as they are decoded, nothing is lost while waiting
+        if (!stream.read_queue.try_emplace(std::move(packet))) {
+            stream.held_packet = std::move(packet);
+            return stream.BlockDemux() ? ReadResult::blocked : ReadResult::packet;
+        }
+        _io_wake.notify();
+        return ReadResult::packet;
+    }
+
+    // Live sources can not wait. A dropped packet breaks the reference chain of its stream,
+    // so the rest of the segment is dropped as well and decoding resumes on the next keyframe.
+    int index = packet->stream_index;
+    if (std::size_t(index) >= stream.awaiting_keyframe.size()) {
+        stream.awaiting_keyframe.resize(std::size_t(index) + 1, 0);
+    }
+    uint8_t& awaiting = stream.awaiting_keyframe[index];
+    bool keyframe = packet->flags & AV_PKT_FLAG_KEY;
+    if ((awaiting && !keyframe) || !stream.read_queue.try_emplace(std::move(packet))) {
+        if (!awaiting) {
+            stream.dropped_segments.fetch_add(1, std::memory_order::relaxed);
+            _log.warn("Read queue full, dropping stream index {} up to the next keyframe", index);
+        }
+        stream.dropped_packets.fetch_add(1, std::memory_order::relaxed);
+        awaiting = 1;
+        return ReadResult::packet; // Keep reading to stay at the live edge
+    }
+    awaiting = 0;
+    _io_wake.notify();
+    return ReadResult::packet;
+}
+bool vortex::ffmpeg::StreamManager::IsLiveSource(const AVFormatContext* context) noexcept
+{
+    // Network protocols open their own I/O and only seekable I/O can be read at our own pace
+    return !context->pb || !(context->pb->seekable & AVIO_SEEKABLE_NORMAL);
 }
 
 void vortex::ffmpeg::StreamManager::IOLoop(std::stop_token stop)
@@ -135,8 +348,17 @@ void vortex::ffmpeg::StreamManager::IOLoop(std::stop_token stop)
     _log.info("I/O thread started.");
     std::vector<std::shared_ptr<ManagedStream>> streams_to_read;
     uint64_t last_update_generation = 0;
+    std::stop_callback wake_on_stop(stop, [this] { _io_wake.notify(); });
+
+    constexpr auto report_interval = std::chrono::seconds(5);
+    constexpr auto bitrate_interval = std::chrono::seconds(1);
+    auto next_report = std::chrono::steady_clock::now() + report_interval;
+    auto last_bitrate = std::chrono::steady_clock::now();
 
     while (!stop.stop_requested()) {
+        // Observed before looking for work, anything published after that ends the wait below
+        uint32_t observed_wake = _io_wake.value();
+
         // Copy the list of streams to read to minimize lock time
         uint64_t current_update_generation = _update_generation.load(std::memory_order::acquire);
         if (current_update_generation != last_update_generation) {
@@ -149,7 +371,7 @@ void vortex::ffmpeg::StreamManager::IOLoop(std::stop_token stop)
         }
 
         if (streams_to_read.empty()) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            _io_wake.wait(observed_wake);
             continue;
         }
 
@@ -159,28 +381,60 @@ void vortex::ffmpeg::StreamManager::IOLoop(std::stop_token stop)
                 break;
             }
 
-            // Handle pending updates (e.g., changing active sub-streams)
+            // Open or close decoders for the stream indices whose consumers changed
             if (stream->update_pending.exchange(false)) {
-                std::unique_lock lock(_streams_mutex);
-                for (const auto& update : stream->updates) {
-                    if (update.active) {
-                        InitDecoder(*stream, update.stream_index);
-                    } else {
-                        stream->channels.erase(update.stream_index);
-                    }
-                }
+                IOApplyUpdates(*stream);
+            }
+
+            work_done |= IOProcessStream(*stream);
+
+            // Resume a reader held back by a full read queue
+            if (stream->ResumeDemux()) {
+                ScheduleDemux(stream, {});
             }
+        }
 
-            work_done = IOProcessStream(*stream);
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_bitrate >= bitrate_interval) {
+            for (const auto& stream : streams_to_read) {
+                IOUpdateBitrate(*stream, now - last_bitrate);
+            }
+            last_bitrate = now;
+        }
+        if (now >= next_report) {
+            for (const auto& stream : streams_to_read) {
+                IOReportLatency(*stream);
+            }
+            next_report = now + report_interval;
         }
 
-        // If no stream had data, sleep briefly to prevent busy-waiting
+        // Sleep until the demuxers, the consumers or a stream update publish more work
         if (!work_done) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            _io_wake.wait(observed_wake);
         }
     }
     _log.info("I/O thread stopped.");
 }
+void vortex::ffmpeg::StreamManager::IOApplyUpdates(vortex::ffmpeg::ManagedStream& stream)
+{
+    std::vector<int> updates;
+    std::unique_lock lock(_streams_mutex);
+    {
+        std::scoped_lock update_lock(stream.update_mutex);
+        updates.swap(stream.updates);
+    }
+
+    // Changes are applied by the current state, an index toggled back and forth is left as it is
+    for (int index : updates) {
+        bool used = stream.IsChannelUsed(index);
+        bool open = stream.channels.contains(index);
+        if (used && !open && index >= 0 && unsigned(index) < stream.context->nb_streams) {
+            InitDecoder(stream, index);
+        } else if (!used && open) {
+            stream.channels.erase(index);
+        }
+    }
+}
 void vortex::ffmpeg::StreamManager::IOFlushStream(vortex::ffmpeg::ManagedStream& stream)
 {
     for (auto& [index, channel] : stream.channels) {
@@ -188,8 +442,8 @@ void vortex::ffmpeg::StreamManager::IOFlushStream(vortex::ffmpeg::ManagedStream&
             continue;
         }
 
-        // Enqueue a flush packet for the decoder
-        channel.SendPacket(nullptr, _log);
+        // Enqueue a flush packet for the decoder, after the held packets
+        channel.QueuePacket(nullptr, _log);
     }
 }
 bool vortex::ffmpeg::StreamManager::IOProcessStream(vortex::ffmpeg::ManagedStream& stream)
@@ -200,24 +454,27 @@ bool vortex::ffmpeg::StreamManager::IOProcessStream(vortex::ffmpeg::ManagedStrea
     }
 
     // Check if any decoder is overloaded with sent packets
+    bool work_done = false;
     while (true) {
         for (auto& [index, channel] : stream.channels) {
             // Try to send queued packets to free up space
             bool ok = channel.SendQueuedPackets(_log);
+            if (ok) {
+                work_done |= channel.SendHeldPackets(_log);
+            }
             if (!ok && channel.IsOverflown()) {
                 _log.warn("Decoder for stream {} is overloaded and cannot send queued packets.", index);
-                return false; // If sending queued packets failed, skip reading new packets
+                return work_done; // If sending queued packets failed, skip reading new packets
             }
         }
 
-        // This is the core of the non-blocking read. av_read_frame will return
-        // after a timeout (set in StreamInput::initialize_stream) or when a packet arrives.
-
-        ffmpeg::unique_packet packet;
+        // Packets are pushed by the demux threads, which wake this thread
+        ffmpeg::pooled_packet packet;
         bool got_packet = stream.read_queue.try_pop(packet);
         if (!got_packet || !packet) {
-            return false; // No more packets to process right now
+            break; // No more packets to process right now
         }
+        stream.queue_latency.Record(packet->opaque);
 
         // Successfully read a packet, now dispatch it to the appropriate channel
         auto it = stream.channels.find(packet->stream_index);
@@ -227,9 +484,51 @@ bool vortex::ffmpeg::StreamManager::IOProcessStream(vortex::ffmpeg::ManagedStrea
         }
         auto& channel = it->second;
 
-        bool ok = channel.SendPacket(std::move(packet), _log);
+        channel.QueuePacket(std::move(packet), _log);
+        work_done = true;
+    }
+
+    if (stream.end_of_stream.load(std::memory_order::acquire) && stream.read_queue.empty()) {
+        stream.end_of_stream.store(false, std::memory_order::relaxed);
+        IOFlushStream(stream);
+        work_done = true;
+    }
+
+    // Take out finished frames right away, not when the decoder pushes back on the next packet
+    for (auto& [index, channel] : stream.channels) {
+        while (channel.TryDecodeFrame()) {
+            work_done = true;
+        }
+        channel.PublishQueueDepth();
+    }
+    return work_done;
+}
+void vortex::ffmpeg::StreamManager::IOUpdateBitrate(vortex::ffmpeg::ManagedStream& stream,
+                                                    std::chrono::steady_clock::duration elapsed)
+{
+    uint64_t bytes = stream.bytes_read.load(std::memory_order::relaxed);
+    int64_t elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    if (elapsed_us > 0) {
+        stream.bitrate.store(int64_t(bytes - stream.bitrate_bytes) * 8 * 1'000'000 / elapsed_us, std::memory_order::relaxed);
+    }
+    stream.bitrate_bytes = bytes;
+}
+void vortex::ffmpeg::StreamManager::IOReportLatency(vortex::ffmpeg::ManagedStream& stream)
+{
+    auto queue = stream.queue_latency.Take();
+    for (auto& [index, channel] : stream.channels) {
+        auto decode = channel.decode_latency.Take();
+        auto consume = channel.consume_latency.Take();
+        if (decode.count == 0 && consume.count == 0) {
+            continue;
+        }
+        _log.debug("Stream {} #{} latency avg/max: queue {}/{} us, decode {}/{} us, consume {}/{} us ({} frames)",
+                   stream.context->url ? stream.context->url : "", index,
+                   queue.average_us, queue.peak_us,
+                   decode.average_us, decode.peak_us,
+                   consume.average_us, consume.peak_us,
+                   consume.count);
     }
-    return true;
 }
 
 bool vortex::ffmpeg::StreamManager::InitVideoDecoder(vortex::ffmpeg::ManagedStream& stream, int channel)
@@ -241,53 +540,87 @@ bool vortex::ffmpeg::StreamManager::InitVideoDecoder(vortex::ffmpeg::ManagedStre
         return false;
     }
 
-    ffmpeg::unique_codec_context decoder_ctx{ avcodec_alloc_context3(codec) };
+    // Prefer the decode queue, a hardware decoder that fails to open falls back to software
+    bool hardware = SupportsHardwareDecode(codec);
+    auto decoder_ctx = OpenVideoDecoder(codec, *codec_params, channel, hardware);
+    if (!decoder_ctx && hardware) {
+        _log.warn("Hardware decoder for stream {} failed to open, falling back to software", channel);
+        hardware = false;
+        decoder_ctx = OpenVideoDecoder(codec, *codec_params, channel, hardware);
+    }
     if (!decoder_ctx) {
-        _log.error("Failed to allocate decoder context for stream {}: {}", channel, *codec_params);
         stream.channels.erase(channel);
         return false;
     }
-    if (avcodec_parameters_to_context(decoder_ctx.get(), codec_params) < 0) {
-        _log.error("Failed to copy codec parameters to context for stream {}: {}", channel, *codec_params);
-        stream.channels.erase(channel);
+    _log.info("Initialized {} decoder for stream {}: {}", hardware ? "hardware" : "software", channel, *codec_params);
+    stream.channels.try_emplace(channel, std::move(decoder_ctx), _io_wake, stream.consumer_mask);
+    return true;
+}
+bool vortex::ffmpeg::StreamManager::SupportsHardwareDecode(const AVCodec* codec) const noexcept
+{
+    if (!_va_decode_context) {
         return false;
     }
+    auto* device = reinterpret_cast<const AVHWDeviceContext*>(_va_decode_context->GetHWDeviceContext()->data);
+    for (int i = 0; const AVCodecHWConfig* config = avcodec_get_hw_config(codec, i); i++) {
+        if (config->device_type == device->type &&
+            (config->methods & (AV_CODEC_HW_CONFIG_METHOD_HW_FRAMES_CTX | AV_CODEC_HW_CONFIG_METHOD_HW_DEVICE_CTX))) {
+            return true;
+        }
+    }
+    return false;
+}
+vortex::ffmpeg::unique_codec_context
+vortex::ffmpeg::StreamManager::OpenVideoDecoder(const AVCodec* codec, const AVCodecParameters& codec_params, int channel, bool hardware)
+{
+    ffmpeg::unique_codec_context decoder_ctx{ avcodec_alloc_context3(codec) };
+    if (!decoder_ctx) {
+        _log.error("Failed to allocate decoder context for stream {}: {}", channel, codec_params);
+        return {};
+    }
+    if (avcodec_parameters_to_context(decoder_ctx.get(), &codec_params) < 0) {
+        _log.error("Failed to copy codec parameters to context for stream {}: {}", channel, codec_params);
+        return {};
+    }
 
-    // Setup hardware acceleration context
-    decoder_ctx->hw_device_ctx = av_buffer_ref(_va_decode_context.GetHWDeviceContext());
-    auto frames_ctx_result = _va_decode_context.CreateHWFramesContext(
-            decoder_ctx->width,
-            decoder_ctx->height,
-            AV_PIX_FMT_NV12);
+    unique_dictionary opts;
+    if (hardware) {
+        // Setup hardware acceleration context
+        decoder_ctx->hw_device_ctx = av_buffer_ref(_va_decode_context->GetHWDeviceContext());
+        auto frames_ctx_result = _va_decode_context->CreateHWFramesContext(
+                decoder_ctx->width,
+                decoder_ctx->height,
+                AV_PIX_FMT_NV12);
 
-    if (!frames_ctx_result) {
-        _log.error("Failed to create HW frames context for stream {}: {}", channel, frames_ctx_result.error().message());
-        stream.channels.erase(channel);
-        return false;
+        if (!frames_ctx_result) {
+            _log.error("Failed to create HW frames context for stream {}: {}", channel, frames_ctx_result.error().message());
+            return {};
+        }
+        decoder_ctx->hw_frames_ctx = frames_ctx_result.value().release();
+        decoder_ctx->thread_count = 1; // Use single-threaded decoding for hardware acceleration
+        decoder_ctx->thread_type = FF_THREAD_FRAME;
+
+        av_dict_set(opts.address_of(), "extra_hw_frames", "16", 0); // Extra surfaces for reference frames
+        av_dict_set(opts.address_of(), "async_depth", "8", 0); // Async decode depth
+    } else {
+        // Frames come out in system memory and are uploaded by the consumer
+        decoder_ctx->thread_count = int(_desc.software_decode_threads);
+        decoder_ctx->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
     }
-    decoder_ctx->hw_frames_ctx = frames_ctx_result.value().release();
-    decoder_ctx->thread_count = 1; // Use single-threaded decoding for hardware acceleration
-    decoder_ctx->thread_type = FF_THREAD_FRAME;
 
-    // Configure decoder for better hardware acceleration compatibility
+    // Keep decoding through damaged input, live sources drop packets
     decoder_ctx->flags |= AV_CODEC_FLAG_OUTPUT_CORRUPT; // Handle corrupted frames gracefully
+    decoder_ctx->flags |= AV_CODEC_FLAG_COPY_OPAQUE; // Frames keep the read time of their packet
     decoder_ctx->flags2 |= AV_CODEC_FLAG2_FAST; // Prioritize speed over quality
 
     decoder_ctx->error_concealment = FF_EC_GUESS_MVS | FF_EC_DEBLOCK;
     decoder_ctx->err_recognition = AV_EF_CAREFUL | AV_EF_COMPLIANT | AV_EF_AGGRESSIVE;
 
-    unique_dictionary opts;
-    av_dict_set(opts.address_of(), "extra_hw_frames", "16", 0); // Extra surfaces for reference frames
-    av_dict_set(opts.address_of(), "async_depth", "8", 0); // Async decode depth
-
     if (avcodec_open2(decoder_ctx.get(), codec, opts.address_of()) < 0) {
-        _log.error("Failed to open codec for stream {}: {}", channel, *codec_params);
-        stream.channels.erase(channel);
-        return false;
+        _log.error("Failed to open codec for stream {}: {}", channel, codec_params);
+        return {};
     }
-    _log.info("Initialized decoder for stream {}: {}", channel, *codec_params);
-    stream.channels.emplace(channel, std::move(decoder_ctx));
-    return true;
+    return decoder_ctx;
 }
 bool vortex::ffmpeg::StreamManager::InitAudioDecoder(vortex::ffmpeg::ManagedStream& stream, int channel)
 {
@@ -309,13 +642,14 @@ bool vortex::ffmpeg::StreamManager::InitAudioDecoder(vortex::ffmpeg::ManagedStre
         stream.channels.erase(channel);
         return false;
     }
+    decoder_ctx->flags |= AV_CODEC_FLAG_COPY_OPAQUE; // Frames keep the read time of their packet
     if (avcodec_open2(decoder_ctx.get(), codec, nullptr) < 0) {
         _log.error("Failed to open codec for stream {}: {}", channel, *codec_params);
         stream.channels.erase(channel);
         return false;
     }
     _log.info("Initialized decoder for stream {}: {}", channel, *codec_params);
-    stream.channels.emplace(channel, std::move(decoder_ctx)); // Ensure the channel entry exists
+    stream.channels.try_emplace(channel, std::move(decoder_ctx), _io_wake, stream.consumer_mask); // Ensure the channel entry exists
     return true;
 }
 void vortex::ffmpeg::StreamManager::InitDecoder(vortex::ffmpeg::ManagedStream& stream, int channel)
@@ -336,10 +670,13 @@ void vortex::ffmpeg::StreamManager::InitDecoder(vortex::ffmpeg::ManagedStream& s
 }
 
 vortex::ffmpeg::StreamManager::StreamHandle
-vortex::ffmpeg::StreamManager::RegisterStream(ffmpeg::unique_context context, std::span<int> active_channel_indices)
+vortex::ffmpeg::StreamManager::RegisterStream(ffmpeg::unique_context context, std::span<int> active_channel_indices, std::string key)
 {
     auto stream = std::make_shared<ManagedStream>();
     stream->context = std::move(context);
+    stream->key = std::move(key);
+    stream->live = IsLiveSource(stream->context.get());
+    stream->last_read = std::chrono::steady_clock::now();
     bool activate_all = active_channel_indices.size() == 1 && active_channel_indices[0] == -1;
     if (activate_all) {
         stream->channels.reserve(stream->context->nb_streams);
@@ -354,30 +691,170 @@ vortex::ffmpeg::StreamManager::RegisterStream(ffmpeg::unique_context context, st
     }
 
     std::unique_lock lock(_streams_mutex);
-    StreamHandle handle = std::bit_cast<StreamHandle>(stream.get());
-    _streams[handle] = std::move(stream);
+    _streams[stream.get()] = stream;
+    StreamHandle handle = AttachConsumer(stream, active_channel_indices);
     _update_generation.fetch_add(1, std::memory_order::relaxed);
+    _io_wake.notify();
+
+    GrowDemuxThreads(_streams.size());
+    ScheduleDemux(std::move(stream), {});
+    return handle;
+}
+auto vortex::ffmpeg::StreamManager::AttachConsumer(const std::shared_ptr<ManagedStream>& stream,
+                                                   std::span<const int> active_channel_indices) -> StreamHandle
+{
+    // Called with the streams lock held, so the I/O thread is not changing the channels
+    uint32_t mask = stream->consumer_mask.load(std::memory_order::relaxed);
+    uint32_t slot = uint32_t(std::countr_one(mask));
+    if (slot >= ChannelStorage::max_consumers) {
+        return 0;
+    }
+    for (auto& [index, channel] : stream->channels) {
+        channel.ResetConsumer(slot);
+    }
+    stream->consumer_mask.store(mask | (1u << slot), std::memory_order::release);
+
+    // Decoders the stream does not run yet are opened by the I/O thread
+    bool activate_all = active_channel_indices.size() == 1 && active_channel_indices[0] == -1;
+    bool changed = false;
+    if (activate_all) {
+        for (int i = 0; i < int(stream->context->nb_streams); i++) {
+            changed |= stream->SetChannelConsumer(i, slot, true);
+        }
+    } else {
+        for (int index : active_channel_indices) {
+            changed |= stream->SetChannelConsumer(index, slot, true);
+        }
+    }
+    if (changed) {
+        _io_wake.notify();
+    }
+
+    auto consumer = std::make_unique<StreamConsumer>(stream, slot);
+    StreamHandle handle = std::bit_cast<StreamHandle>(consumer.get());
+    _consumers[handle] = std::move(consumer);
     return handle;
 }
+auto vortex::ffmpeg::StreamManager::FindConsumer(StreamHandle handle) const -> StreamConsumer*
+{
+    auto it = _consumers.find(handle);
+    return it != _consumers.end() ? it->second.get() : nullptr;
+}
+auto vortex::ffmpeg::StreamManager::FindStream(StreamHandle handle) const -> ManagedStream*
+{
+    auto* consumer = FindConsumer(handle);
+    return consumer ? consumer->stream.get() : nullptr;
+}
+std::string vortex::ffmpeg::StreamManager::MakeStreamKey(std::string_view url, const AVDictionary* options)
+{
+    std::string key{ url };
+    char* buffer = nullptr;
+    if (av_dict_get_string(options, &buffer, '=', ';') >= 0 && buffer) {
+        key.append("|").append(buffer);
+    }
+    av_freep(&buffer);
+    return key;
+}
+std::shared_ptr<vortex::ffmpeg::StreamConnection>
+vortex::ffmpeg::StreamManager::ConnectStream(std::string url,
+                                             ffmpeg::unique_dictionary options,
+                                             std::span<const int> active_channel_indices)
+{
+    auto connection = std::make_shared<StreamConnection>();
+    connection->key = MakeStreamKey(url, options.get());
+    connection->url = std::move(url);
+    connection->options = std::move(options);
+    connection->active_channel_indices.assign(active_channel_indices.begin(), active_channel_indices.end());
+
+    // Opening blocks until the source answers or times out, every pending connection gets
+    // a thread of its own so an unreachable source does not hold up the others
+    {
+        std::scoped_lock lock(_connect_mutex);
+        _connections.push_back(connection);
+        _connect_tasks.push_back({ connection, {} });
+        if (_connect_threads.size() < std::min<std::size_t>(_connections.size(), _desc.max_connect_threads)) {
+            _connect_threads.emplace_back([this](std::stop_token stop) { ConnectLoop(stop); });
+        }
+    }
+    _connect_cv.notify_one();
+    return connection;
+}
+auto vortex::ffmpeg::StreamManager::TakeConnection(StreamConnection& connection) noexcept -> StreamHandle
+{
+    if (!connection.done.load(std::memory_order::acquire)) {
+        return 0;
+    }
+    return connection.handle.exchange(0);
+}
+void vortex::ffmpeg::StreamManager::CancelConnection(StreamConnection& connection)
+{
+    // Either this or the connecting thread sees the other's store and unregisters
+    connection.cancelled.store(true);
+    if (connection.done.load()) {
+        UnregisterStream(connection.handle.exchange(0));
+    }
+}
+bool vortex::ffmpeg::StreamManager::IsStreamDropped(StreamHandle handle)
+{
+    std::shared_lock lock(_streams_mutex);
+    if (auto* stream = FindStream(handle)) {
+        return stream->dropped.load(std::memory_order::relaxed);
+    }
+    return false;
+}
 void vortex::ffmpeg::StreamManager::UnregisterStream(StreamHandle handle)
 {
     if (!handle) {
         return;
     }
     std::unique_lock lock(_streams_mutex);
-    _streams.erase(handle);
-    _update_generation.fetch_add(1, std::memory_order::relaxed);
+    auto it = _consumers.find(handle);
+    if (it == _consumers.end()) {
+        return;
+    }
+    auto stream = std::move(it->second->stream);
+    uint32_t slot = it->second->slot;
+    _consumers.erase(it);
+
+    uint32_t mask = stream->consumer_mask.load(std::memory_order::relaxed) & ~(1u << slot);
+    stream->consumer_mask.store(mask, std::memory_order::release);
+    if (mask != 0) {
+        // Frames still queued for the consumer go back to the pool, they may hold decoder surfaces
+        for (auto& [index, channel] : stream->channels) {
+            channel.ResetConsumer(slot);
+        }
+
+        // Decoders only this consumer used are closed
+        std::vector<int> indices;
+        {
+            std::scoped_lock update_lock(stream->update_mutex);
+            for (auto& [index, consumers] : stream->channel_consumers) {
+                if (consumers & (1u << slot)) {
+                    indices.push_back(index);
+                }
+            }
+        }
+        for (int index : indices) {
+            stream->SetChannelConsumer(index, slot, false);
+        }
+    } else {
+        stream->Close(); // A reader may still hold the stream, make it let go
+        _streams.erase(stream.get());
+        _update_generation.fetch_add(1, std::memory_order::relaxed);
+    }
+    _io_wake.notify();
 }
 void vortex::ffmpeg::StreamManager::SetChannelActive(StreamHandle handle, int stream_index, bool active)
 {
     if (!handle) {
         return;
     }
+    // Only the consumer's own use of the index changes, other consumers of a shared stream keep the decoder
     std::shared_lock lock(_streams_mutex);
-    if (auto it = _streams.find(handle); it != _streams.end()) {
-        auto& stream = it->second;
-        stream->updates.emplace_back(stream_index, active);
-        stream->update_pending.store(true, std::memory_order::relaxed);
+    if (auto* consumer = FindConsumer(handle)) {
+        if (consumer->stream->SetChannelConsumer(stream_index, consumer->slot, active)) {
+            _io_wake.notify();
+        }
     }
 }
 void vortex::ffmpeg::StreamManager::ActivateChannels(StreamHandle handle, std::span<int> active_stream_indices)
@@ -386,12 +863,14 @@ void vortex::ffmpeg::StreamManager::ActivateChannels(StreamHandle handle, std::s
         return;
     }
     std::shared_lock lock(_streams_mutex);
-    if (auto it = _streams.find(handle); it != _streams.end()) {
-        auto& stream = it->second;
+    if (auto* consumer = FindConsumer(handle)) {
+        bool changed = false;
         for (int index : active_stream_indices) {
-            stream->updates.emplace_back(index, 1);
+            changed |= consumer->stream->SetChannelConsumer(index, consumer->slot, true);
+        }
+        if (changed) {
+            _io_wake.notify();
         }
-        stream->update_pending.store(true, std::memory_order::relaxed);
     }
 }
 void vortex::ffmpeg::StreamManager::DeactivateChannels(StreamHandle handle, std::span<int> inactive_stream_indices)
@@ -400,23 +879,68 @@ void vortex::ffmpeg::StreamManager::DeactivateChannels(StreamHandle handle, std:
         return;
     }
     std::shared_lock lock(_streams_mutex);
-    if (auto it = _streams.find(handle); it != _streams.end()) {
-        auto& stream = it->second;
+    if (auto* consumer = FindConsumer(handle)) {
+        bool changed = false;
         for (int index : inactive_stream_indices) {
-            stream->updates.emplace_back(index, 0);
+            changed |= consumer->stream->SetChannelConsumer(index, consumer->slot, false);
         }
-        stream->update_pending.store(true, std::memory_order::relaxed);
+        if (changed) {
+            _io_wake.notify();
+        }
+    }
+}
+auto vortex::ffmpeg::StreamManager::MakeStats(const ManagedStream& stream) -> StreamStats
+{
+    StreamStats stats{
+        .url = stream.context && stream.context->url ? stream.context->url : "",
+        .live = stream.live,
+        .dropped = stream.dropped.load(std::memory_order::relaxed),
+        .consumers = uint32_t(std::popcount(stream.consumer_mask.load(std::memory_order::relaxed))),
+        .packets_read = stream.packets_read.load(std::memory_order::relaxed),
+        .bytes_read = stream.bytes_read.load(std::memory_order::relaxed),
+        .bitrate = stream.bitrate.load(std::memory_order::relaxed),
+        .read_queue_depth = uint32_t(stream.read_queue.size()),
+        .read_errors = stream.read_errors.load(std::memory_order::relaxed),
+        .dropped_packets = stream.dropped_packets.load(std::memory_order::relaxed),
+        .dropped_segments = stream.dropped_segments.load(std::memory_order::relaxed),
+    };
+    stats.channels.reserve(stream.channels.size());
+    for (auto& [index, channel] : stream.channels) {
+        stats.channels.push_back(channel.GetStats(index));
+    }
+    std::ranges::sort(stats.channels, {}, &ChannelStats::stream_index);
+    return stats;
+}
+auto vortex::ffmpeg::StreamManager::GetStats(StreamHandle handle) -> std::optional<StreamStats>
+{
+    // The lock keeps the I/O thread from changing the channels, the counters are read lock-free
+    std::shared_lock lock(_streams_mutex);
+    if (auto* stream = FindStream(handle)) {
+        return MakeStats(*stream);
     }
+    return std::nullopt;
+}
+auto vortex::ffmpeg::StreamManager::GetAllStats() -> std::vector<StreamStats>
+{
+    std::shared_lock lock(_streams_mutex);
+    std::vector<StreamStats> stats;
+    stats.reserve(_streams.size());
+    for (auto& [key, stream] : _streams) {
+        stats.push_back(MakeStats(*stream));
+    }
+    return stats;
 }
 
-auto vortex::ffmpeg::ChannelStorage::Decode() noexcept -> std::expected<vortex::ffmpeg::unique_frame, vortex::ffmpeg::ffmpeg_errc>
+auto vortex::ffmpeg::ChannelStorage::Decode() noexcept -> std::expected<vortex::ffmpeg::pooled_frame, vortex::ffmpeg::ffmpeg_errc>
 {
-    ffmpeg::unique_frame frame{ av_frame_alloc() };
+    ffmpeg::pooled_frame frame = _frame_pool->acquire(); // Goes back to the pool if nothing is received
     AVCodecContext* ctx = _decoder_ctx.get();
     AVFrame* raw_frame = frame.get();
     int ret = 0;
 
+    auto start = std::chrono::steady_clock::now();
     ret = avcodec_receive_frame(ctx, raw_frame);
+    _decode_time_ns.fetch_add((std::chrono::steady_clock::now() - start).count(), std::memory_order::relaxed);
     if (ret == AVERROR(EAGAIN)) {
         return std::unexpected{ ffmpeg_errc::not_enough_data };
     }
@@ -425,9 +949,12 @@ auto vortex::ffmpeg::ChannelStorage::Decode() noexcept -> std::expected<vortex::
     }
     if (ret < 0) {
         vortex::error("Error during decoding video frame: {}", ffmpeg::ffmpeg_error_string(ret));
+        _decoder_errors.fetch_add(1, std::memory_order::relaxed);
         return std::unexpected{ ffmpeg::ffmpeg_errc(ret) };
     }
-    return std::expected<ffmpeg::unique_frame, ffmpeg::ffmpeg_errc>(std::move(frame)); // Successfully received a frame
+    _frames_decoded.fetch_add(1, std::memory_order::relaxed);
+    decode_latency.Record(frame->opaque);
+    return std::expected<ffmpeg::pooled_frame, ffmpeg::ffmpeg_errc>(std::move(frame)); // Successfully received a frame
 }
 auto vortex::ffmpeg::ChannelStorage::SendQueuedPackets(vortex::LogView log) noexcept -> bool
 {
@@ -440,7 +967,7 @@ auto vortex::ffmpeg::ChannelStorage::SendQueuedPackets(vortex::LogView log) noex
     // If there are queued packets, send them first
     while (!_packets.empty()) {
         auto& queued_packet = _packets.front();
-        int result = avcodec_send_packet(_decoder_ctx.get(), queued_packet.get());
+        int result = DecoderSend(queued_packet.get());
         switch (result) {
         case 0:
             break; // Successfully sent
@@ -459,17 +986,17 @@ auto vortex::ffmpeg::ChannelStorage::SendQueuedPackets(vortex::LogView log) noex
             return false; // Decoder flushed
         default:
             log.error("Error sending queued packet to decoder: {}", ffmpeg::ffmpeg_error_string(result));
+            _decoder_errors.fetch_add(1, std::memory_order::relaxed);
             return false; // Problem sending packet. Stop processing.
         }
         _packets.pop();
     }
     return true;
 }
-auto vortex::ffmpeg::ChannelStorage::SendPacket(ffmpeg::unique_packet packet, vortex::LogView log) noexcept -> bool
+auto vortex::ffmpeg::ChannelStorage::SendPacket(ffmpeg::pooled_packet packet, vortex::LogView log) noexcept -> bool
 {
     // We have the semaphore, send the packet
-    int result = avcodec_send_packet(_decoder_ctx.get(), packet.get());
-    auto pts = packet->pts;
+    int result = DecoderSend(packet.get());
     switch (result) {
     case 0:
         return true; // Successfully sent
@@ -482,23 +1009,101 @@ auto vortex::ffmpeg::ChannelStorage::SendPacket(ffmpeg::unique_packet packet, vo
         return false; // Decoder flushed
     default:
         log.error("Error sending packet to decoder: {}", ffmpeg::ffmpeg_error_string(result));
+        _decoder_errors.fetch_add(1, std::memory_order::relaxed);
         return false; // Problem sending packet. Stop processing.
     }
 }
-auto vortex::ffmpeg::ChannelStorage::GetDecodedFrame() noexcept -> std::optional<ffmpeg::unique_frame>
+auto vortex::ffmpeg::ChannelStorage::DecoderSend(const AVPacket* packet) noexcept -> int
+{
+    auto start = std::chrono::steady_clock::now();
+    int result = avcodec_send_packet(_decoder_ctx.get(), packet);
+    _decode_time_ns.fetch_add((std::chrono::steady_clock::now() - start).count(), std::memory_order::relaxed);
+    if (result == 0 && packet) {
+        _packets_sent.fetch_add(1, std::memory_order::relaxed);
+    }
+    return result;
+}
+auto vortex::ffmpeg::ChannelStorage::GetStats(int stream_index) const noexcept -> ChannelStats
 {
-    ffmpeg::unique_frame frame;
-    auto sz = _frames.size();
+    ChannelStats stats{
+        .stream_index = stream_index,
+        .media_type = _decoder_ctx ? _decoder_ctx->codec_type : AVMEDIA_TYPE_UNKNOWN,
+        .packets = _packets_sent.load(std::memory_order::relaxed),
+        .frames = _frames_decoded.load(std::memory_order::relaxed),
+        .dropped_frames = _dropped_frames.load(std::memory_order::relaxed),
+        .decoder_errors = _decoder_errors.load(std::memory_order::relaxed),
+        .packet_queue_depth = _packet_queue_depth.load(std::memory_order::relaxed),
+    };
+    uint32_t mask = _consumer_mask->load(std::memory_order::acquire);
+    for (uint32_t slot = 0; slot < max_consumers; slot++) {
+        if (mask & (1u << slot)) {
+            stats.frame_queue_depth = std::max(stats.frame_queue_depth, uint32_t(_consumers[slot].frames.size()));
+        }
+    }
+    int64_t decode_ns = _decode_time_ns.load(std::memory_order::relaxed);
+    stats.decode_time_us = stats.frames ? decode_ns / int64_t(stats.frames) / 1000 : 0;
+    return stats;
+}
+void vortex::ffmpeg::ChannelStorage::SetSendHorizon(uint32_t consumer, int64_t dts) noexcept
+{
+    _consumers[consumer].send_horizon.store(dts, std::memory_order::relaxed);
+    if (_next_held_dts.load(std::memory_order::relaxed) <= dts) {
+        _io_wake->notify(); // Held packets became due
+    }
+}
+auto vortex::ffmpeg::ChannelStorage::SendHorizon() const noexcept -> int64_t
+{
+    int64_t horizon = unset_horizon;
+    uint32_t mask = _consumer_mask->load(std::memory_order::acquire);
+    for (uint32_t slot = 0; slot < max_consumers; slot++) {
+        if (mask & (1u << slot)) {
+            horizon = std::max(horizon, _consumers[slot].send_horizon.load(std::memory_order::relaxed));
+        }
+    }
+    return horizon == unset_horizon ? no_horizon : horizon;
+}
+auto vortex::ffmpeg::ChannelStorage::QueuePacket(ffmpeg::pooled_packet packet, vortex::LogView log) noexcept -> bool
+{
+    if (_held.empty() && _packets.empty() && PacketDts(packet.get()) <= SendHorizon()) {
+        return SendPacket(std::move(packet), log);
+    }
+    _held.push_back(std::move(packet));
+    _next_held_dts.store(PacketDts(_held.front().get()), std::memory_order::relaxed);
+    return true;
+}
+auto vortex::ffmpeg::ChannelStorage::SendHeldPackets(vortex::LogView log) noexcept -> bool
+{
+    bool sent = false;
+    int64_t horizon = SendHorizon();
+    while (!_held.empty() && _packets.empty() &&
+           (PacketDts(_held.front().get()) <= horizon || _held.size() > max_held_packets)) {
+        auto packet = std::move(_held.front());
+        _held.pop_front();
+        SendPacket(std::move(packet), log);
+        sent = true;
+    }
+    _next_held_dts.store(_held.empty() ? no_horizon : PacketDts(_held.front().get()), std::memory_order::relaxed);
+    return sent;
+}
+auto vortex::ffmpeg::ChannelStorage::GetDecodedFrame(uint32_t consumer) noexcept -> std::optional<ffmpeg::pooled_frame>
+{
+    auto& frames = _consumers[consumer].frames;
+    ffmpeg::pooled_frame frame;
+    bool was_full = frames.size() == max_frames;
 
-    if (_frames.try_pop(frame)) {
-        return std::optional<ffmpeg::unique_frame>{ std::move(frame) };
+    if (frames.try_pop(frame)) {
+        consume_latency.Record(frame->opaque);
+        if (was_full) {
+            _io_wake->notify(); // The I/O thread may be waiting for room to decode into
+        }
+        return std::optional<ffmpeg::pooled_frame>{ std::move(frame) };
     }
     return std::nullopt;
 }
 auto vortex::ffmpeg::ChannelStorage::TryDecodeFrame() noexcept -> bool
 {
     if (IsFrameQueueFull()) {
-        return false; // Frame queue is full, cannot decode more frames
+        return false; // Frame queues are full, cannot decode more frames
     }
 
     auto decode_result = Decode();
@@ -509,5 +1114,36 @@ auto vortex::ffmpeg::ChannelStorage::TryDecodeFrame() noexcept -> bool
         }
         return false; // Decoder not ready, try again later
     }
-    return _frames.try_push(std::move(decode_result.value()));
+
+    // Consumers with room get the frame, the last one takes the decoded frame itself
+    std::array<uint32_t, max_consumers> targets;
+    std::size_t count = 0;
+    uint32_t mask = _consumer_mask->load(std::memory_order::acquire);
+    for (uint32_t slot = 0; slot < max_consumers; slot++) {
+        if ((mask & (1u << slot)) && _consumers[slot].frames.size() < max_frames) {
+            targets[count++] = slot;
+        }
+    }
+    std::size_t consumers = std::size_t(std::popcount(mask));
+    if (count < consumers) {
+        _dropped_frames.fetch_add(consumers - count, std::memory_order::relaxed); // Queues that are full
+    }
+    for (std::size_t i = 0; i + 1 < count; i++) {
+        ffmpeg::pooled_frame copy = _frame_pool->acquire();
+        if (av_frame_ref(copy.get(), decode_result->get()) < 0) {
+            _dropped_frames.fetch_add(1, std::memory_order::relaxed);
+            continue;
+        }
+        std::ignore = _consumers[targets[i]].frames.try_push(std::move(copy));
+    }
+    if (count > 0) {
+        std::ignore = _consumers[targets[count - 1]].frames.try_push(std::move(decode_result.value()));
+    }
+    return true;
+}
+void vortex::ffmpeg::ChannelStorage::ResetConsumer(uint32_t consumer) noexcept
+{
+    ffmpeg::pooled_frame frame;
+    while (_consumers[consumer].frames.try_pop(frame)) { }
+    _consumers[consumer].send_horizon.store(unset_horizon, std::memory_order::relaxed);
 }
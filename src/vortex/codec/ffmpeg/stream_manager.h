@@ -1,33 +1,112 @@
 #pragma once
 #include <vortex/codec/ffmpeg/hw_decoder.h>
+#include <vortex/codec/ffmpeg/av_pool.h>
+#include <vortex/codec/ffmpeg/codec_ffmpeg.h>
 #include <vortex/util/lib/SPSC-Queue.h>
 #include <vortex/util/log.h>
+#include <vortex/util/wake_signal.h>
 
 #include <unordered_map>
+#include <unordered_set>
 #include <shared_mutex>
+#include <mutex>
+#include <condition_variable>
 #include <thread>
 #include <chrono>
 #include <queue>
+#include <deque>
+#include <optional>
+#include <limits>
+#include <string>
+#include <vector>
+#include <span>
+#include <utility>
 
 namespace vortex {
 class Graphics;
 }
 
 namespace vortex::ffmpeg {
+// Latency of one pipeline hop, measured from the time the packet was read.
+// Recorded from any thread, summarized and reset by the I/O thread.
+struct HopLatency {
+    struct Summary {
+        uint32_t count = 0;
+        int64_t average_us = 0;
+        int64_t peak_us = 0;
+    };
+
+    static int64_t Now() noexcept { return std::chrono::steady_clock::now().time_since_epoch().count(); }
+
+    // Read time is carried in AVPacket::opaque, and copied to AVFrame::opaque by the decoder
+    static void* Stamp() noexcept { return reinterpret_cast<void*>(static_cast<intptr_t>(Now())); }
+    void Record(const void* stamp) noexcept
+    {
+        int64_t since = static_cast<int64_t>(reinterpret_cast<intptr_t>(stamp));
+        if (since == 0) {
+            return; // Not stamped
+        }
+        int64_t latency = std::chrono::duration_cast<std::chrono::microseconds>(
+                                  std::chrono::steady_clock::duration(Now() - since))
+                                  .count();
+        total.fetch_add(latency, std::memory_order::relaxed);
+        count.fetch_add(1, std::memory_order::relaxed);
+        int64_t current = peak.load(std::memory_order::relaxed);
+        while (latency > current && !peak.compare_exchange_weak(current, latency, std::memory_order::relaxed)) { }
+    }
+    Summary Take() noexcept
+    {
+        Summary summary;
+        summary.count = count.exchange(0, std::memory_order::relaxed);
+        int64_t sum = total.exchange(0, std::memory_order::relaxed);
+        summary.peak_us = peak.exchange(0, std::memory_order::relaxed);
+        summary.average_us = summary.count ? sum / summary.count : 0;
+        return summary;
+    }
+
+    std::atomic<int64_t> total{ 0 };
+    std::atomic<int64_t> peak{ 0 };
+    std::atomic<uint32_t> count{ 0 };
+};
+
+// Snapshot of a decoder's counters, counts are totals since the stream was opened
+struct ChannelStats {
+    int stream_index = -1;
+    AVMediaType media_type = AVMEDIA_TYPE_UNKNOWN;
+    uint64_t packets = 0; // Sent to the decoder
+    uint64_t frames = 0; // Decoded
+    uint64_t dropped_frames = 0; // Missed by a consumer whose queue was full
+    uint64_t decoder_errors = 0;
+    uint32_t packet_queue_depth = 0; // Held for the send horizon or waiting for the decoder
+    uint32_t frame_queue_depth = 0; // Deepest consumer queue
+    int64_t decode_time_us = 0; // Average time spent in the decoder per frame
+};
+
+// Decoder of one stream index. Decoded frames are fanned out to a queue per consumer,
+// consumers past the first get a new reference to the same frame data.
 struct ChannelStorage {
     static constexpr std::size_t max_packets = 32; // Max packets sent without receiving frames
     static constexpr std::size_t max_frames = 16; // Max packets to queue for decoding
+    static constexpr std::size_t max_held_packets = 2048; // Past this the send horizon is ignored
+    static constexpr std::size_t max_consumers = 8; // Consumers sharing one decoder
+    static constexpr int64_t no_horizon = std::numeric_limits<int64_t>::max();
+    static constexpr int64_t unset_horizon = std::numeric_limits<int64_t>::min(); // Consumer did not ask for a horizon yet
 
 public:
-    ChannelStorage(vortex::ffmpeg::unique_codec_context decoder_ctx) noexcept
+    ChannelStorage(vortex::ffmpeg::unique_codec_context decoder_ctx,
+                   vortex::wake_signal& io_wake,
+                   const std::atomic<uint32_t>& consumer_mask) noexcept
         : _decoder_ctx(std::move(decoder_ctx))
+        , _frame_pool(std::make_shared<ffmpeg::frame_pool>(max_frames * max_consumers))
+        , _io_wake(&io_wake)
+        , _consumer_mask(&consumer_mask)
     {
     }
 
 public:
     /// @brief Attempts to decode a frame and returns the result or an error code.
     /// @return A std::expected containing a unique decoded frame on success, or an ffmpeg error code on failure.
-    auto Decode() noexcept -> std::expected<ffmpeg::unique_frame, ffmpeg::ffmpeg_errc>;
+    auto Decode() noexcept -> std::expected<ffmpeg::pooled_frame, ffmpeg::ffmpeg_errc>;
 
     /// @brief Attempts to send all packets currently queued for transmission.
     /// @param log A LogView object used to record logging information during the operation.
@@ -38,16 +117,45 @@ public:
     /// @param packet A unique FFmpeg packet to be sent.
     /// @param log A logging view used to record information or errors during the send operation.
     /// @return True if the packet was sent successfully; otherwise, false.
-    bool SendPacket(ffmpeg::unique_packet packet, vortex::LogView log) noexcept;
+    bool SendPacket(ffmpeg::pooled_packet packet, vortex::LogView log) noexcept;
+
+    /// @brief Holds packets with a decode timestamp past the horizon until the consumer needs them.
+    /// Lets the playout delay be buffered as packets, the decoded frames only cover the lookahead.
+    /// The furthest horizon of all consumers is used, so none of them is starved.
+    /// @param consumer Slot of the consumer.
+    /// @param dts Decode timestamp in the stream time base, no_horizon sends everything right away.
+    void SetSendHorizon(uint32_t consumer, int64_t dts) noexcept;
+
+    /// @brief Queues a packet behind the held ones, or sends it if the horizon allows.
+    /// @return True if the packet was held or sent successfully; otherwise, false.
+    bool QueuePacket(ffmpeg::pooled_packet packet, vortex::LogView log) noexcept;
+
+    /// @brief Sends the held packets that are within the send horizon.
+    /// @return true if any packet was released to the decoder.
+    bool SendHeldPackets(vortex::LogView log) noexcept;
 
     /// @brief Retrieves a decoded video frame, if available.
+    /// @param consumer Slot of the consumer, each consumer receives every frame.
     /// @return An optional containing a unique decoded frame if one is available; otherwise, an empty optional.
-    auto GetDecodedFrame() noexcept -> std::optional<ffmpeg::unique_frame>;
+    auto GetDecodedFrame(uint32_t consumer) noexcept -> std::optional<ffmpeg::pooled_frame>;
 
-    /// @brief Attempts to decode a frame and add it to the frame queue if possible.
-    /// @return true if a frame was successfully decoded and added to the queue; false otherwise (e.g., if the queue is full or decoding failed).
+    /// @brief Attempts to decode a frame and add it to the frame queues if possible.
+    /// A consumer whose queue is full misses the frame, decoding only waits if all queues are full.
+    /// @return true if a frame was successfully decoded and added to the queues; false otherwise (e.g., if the queues are full or decoding failed).
     bool TryDecodeFrame() noexcept;
 
+    /// @brief Prepares the slot for a new consumer, dropping what the previous one left behind.
+    void ResetConsumer(uint32_t consumer) noexcept;
+
+    /// @brief Publishes the depth of the packet queues, called by the I/O thread after it changed them.
+    void PublishQueueDepth() noexcept
+    {
+        _packet_queue_depth.store(uint32_t(_packets.size() + _held.size()), std::memory_order::relaxed);
+    }
+
+    /// @brief Reads the counters, safe from any thread.
+    ChannelStats GetStats(int stream_index) const noexcept;
+
     /// @brief Checks if the decoder context is valid and properly initialized.
     /// @return true if the decoder context exists and has a valid codec; false otherwise.
     auto IsValid() const noexcept -> bool
@@ -62,79 +170,328 @@ public:
         return _packets.size() == max_packets;
     }
 
-    /// @brief Checks if the frame queue has reached its maximum capacity.
-    /// @return true if the frame queue is full; false otherwise.
+    /// @brief Checks if the frame queues of all consumers have reached their maximum capacity.
+    /// @return true if there is no room for another frame; false otherwise.
     bool IsFrameQueueFull() const noexcept
     {
-        return _frames.size() == max_frames;
+        uint32_t mask = _consumer_mask->load(std::memory_order::acquire);
+        for (uint32_t slot = 0; slot < max_consumers; slot++) {
+            if ((mask & (1u << slot)) && _consumers[slot].frames.size() < max_frames) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    struct ConsumerQueue {
+        dro::SPSCQueue<ffmpeg::pooled_frame, max_frames> frames; // Frames decoded and ready for consumption
+        std::atomic<int64_t> send_horizon{ unset_horizon };
+    };
+
+    // Furthest horizon asked for by a consumer, everything is sent until one asks
+    int64_t SendHorizon() const noexcept;
+    // Sends the packet and accounts the time spent in the decoder
+    int DecoderSend(const AVPacket* packet) noexcept;
+
+    // Packets without timestamps and flush packets are never held back
+    static int64_t PacketDts(const AVPacket* packet) noexcept
+    {
+        if (!packet) {
+            return std::numeric_limits<int64_t>::min();
+        }
+        return packet->dts != AV_NOPTS_VALUE ? packet->dts
+                : packet->pts != AV_NOPTS_VALUE ? packet->pts
+                                                : std::numeric_limits<int64_t>::min();
     }
 
 private:
-    std::queue<ffmpeg::unique_packet> _packets; // This does not need to be thread-safe, only accessed from I/O thread
-    dro::SPSCQueue<ffmpeg::unique_frame, max_frames> _frames; // Frames decoded and ready for consumption
+    std::queue<ffmpeg::pooled_packet> _packets; // This does not need to be thread-safe, only accessed from I/O thread
+    std::array<ConsumerQueue, max_consumers> _consumers; // Indexed by consumer slot
     vortex::ffmpeg::unique_codec_context _decoder_ctx;
+    std::shared_ptr<ffmpeg::frame_pool> _frame_pool; // Frames released by consumers are reused for decoding
+    vortex::wake_signal* _io_wake; // Wakes the I/O thread when a full frame queue drains
+    const std::atomic<uint32_t>* _consumer_mask; // Slots in use, owned by the stream
+
+    std::deque<ffmpeg::pooled_packet> _held; // Waiting for the send horizon, only accessed from I/O thread
+    std::atomic<int64_t> _next_held_dts{ no_horizon }; // Lets the consumer skip waking the I/O thread
+
+    // Counters, written by the I/O thread only and read by GetStats
+    std::atomic<uint64_t> _packets_sent{ 0 };
+    std::atomic<uint64_t> _frames_decoded{ 0 };
+    std::atomic<uint64_t> _dropped_frames{ 0 };
+    std::atomic<uint64_t> _decoder_errors{ 0 };
+    std::atomic<int64_t> _decode_time_ns{ 0 };
+    std::atomic<uint32_t> _packet_queue_depth{ 0 };
+
+public:
+    ffmpeg::HopLatency decode_latency; // Read until decoded
+    ffmpeg::HopLatency consume_latency; // Read until taken by the consumer
 };
 
 // Represents a stream being read by the StreamManager
 struct ManagedStream {
-    struct UpdateRequest {
-        uint32_t stream_index : 31;
-        uint32_t active : 1; // 1 for activate, 0 for deactivate
-    };
+    static constexpr std::size_t read_queue_size = 64;
+    static constexpr std::chrono::seconds stall_timeout{ 5 }; // Live sources without packets for this long are dropped
+    static constexpr std::chrono::milliseconds read_error_backoff{ 100 }; // Failing reads are not retried sooner
+
+    std::string key; // Source and options, consumers asking for the same key share the stream, empty if never shared
+    std::atomic<uint32_t> consumer_mask{ 0 }; // Slots of the attached consumers, changed under the streams lock
 
     // Only accessed from the I/O thread
     ffmpeg::unique_context context;
+    ffmpeg::HopLatency queue_latency; // Read until sent to the decoder
     std::unordered_map<int, ChannelStorage> channels;
-    dro::SPSCQueue<ffmpeg::unique_packet, 64> read_queue; // Packets read from the stream, to be sent to decoders
+    dro::SPSCQueue<ffmpeg::pooled_packet, read_queue_size> read_queue; // Packets read from the stream, to be sent to decoders
 
-    // Modifiable from outside the I/O thread
+    // Packets in flight are either in the read queue or queued on a channel
+    std::shared_ptr<ffmpeg::packet_pool> packet_pool = std::make_shared<ffmpeg::packet_pool>(
+            read_queue_size + ChannelStorage::max_packets);
+
+    // Modifiable from outside the I/O thread. A decoder runs while any consumer uses its stream index,
+    // the I/O thread opens or closes it for the indices in updates.
     std::atomic<bool> update_pending{ false };
-    std::vector<UpdateRequest> updates;
+    std::mutex update_mutex; // Taken after the streams lock when both are held
+    std::unordered_map<int, uint32_t> channel_consumers; // Consumer slots using each stream index, guarded by update_mutex
+    std::vector<int> updates; // Stream indices that gained their first or lost their last consumer, guarded by update_mutex
+
+    // Set once the stream is unregistered, aborts a blocking read through the interrupt callback
+    std::atomic<bool> closing{ false };
+    std::atomic<bool> end_of_stream{ false }; // Set by the reader, decoders are flushed after the last packet
+    std::atomic<bool> dropped{ false }; // Live source ended or stalled, not read anymore, the consumer reconnects
+    std::chrono::steady_clock::time_point last_read; // Last packet read, only touched by the reader
+
+    // Backpressure on a full read queue. Files hold the packet and stop reading until the
+    // I/O thread drains the queue, live sources drop packets up to the next keyframe instead.
+    bool live = false;
+    ffmpeg::pooled_packet held_packet; // Read while the queue was full, only touched by the reader
+    std::vector<uint8_t> awaiting_keyframe; // Per stream index, only touched by the reader
+    std::atomic<bool> demux_blocked{ false };
+    std::atomic<uint64_t> dropped_packets{ 0 };
+    std::atomic<uint64_t> dropped_segments{ 0 }; // Runs of packets dropped up to a keyframe
+
+    // Ingest counters, written by the reader
+    std::atomic<uint64_t> packets_read{ 0 };
+    std::atomic<uint64_t> bytes_read{ 0 };
+    std::atomic<uint64_t> read_errors{ 0 };
+    std::atomic<int64_t> bitrate{ 0 }; // Bits per second over the last second, updated by the I/O thread
+    uint64_t bitrate_bytes = 0; // Bytes read at the last bitrate update, only touched by the I/O thread
+
+    // Hands a blocked reader back to the demux pool once the queue has room
+    bool ResumeDemux() noexcept
+    {
+        std::atomic_thread_fence(std::memory_order::seq_cst); // Pairs with the fence in BlockDemux
+        return demux_blocked.load(std::memory_order::relaxed) &&
+                read_queue.size() < read_queue_size &&
+                demux_blocked.exchange(false, std::memory_order::relaxed);
+    }
+    // Returns false if the queue drained meanwhile and the reader should keep going
+    bool BlockDemux() noexcept
+    {
+        demux_blocked.store(true, std::memory_order::relaxed);
+        std::atomic_thread_fence(std::memory_order::seq_cst);
+        return read_queue.size() == read_queue_size || !demux_blocked.exchange(false, std::memory_order::relaxed);
+    }
+
+    // Returns true if the decoder of the index has to be opened or closed
+    bool SetChannelConsumer(int index, uint32_t slot, bool active)
+    {
+        std::scoped_lock lock(update_mutex);
+        uint32_t& mask = channel_consumers[index];
+        uint32_t previous = std::exchange(mask, active ? mask | (1u << slot) : mask & ~(1u << slot));
+        if ((previous == 0) == (mask == 0)) {
+            return false;
+        }
+        updates.push_back(index);
+        update_pending.store(true, std::memory_order::relaxed);
+        return true;
+    }
+    bool IsChannelUsed(int index)
+    {
+        std::scoped_lock lock(update_mutex);
+        auto it = channel_consumers.find(index);
+        return it != channel_consumers.end() && it->second != 0;
+    }
+
+    void Close() noexcept
+    {
+        closing.store(true, std::memory_order::relaxed);
+        if (auto* interrupt = ffmpeg::StreamInterrupt::Get(context.get())) {
+            interrupt->cancelled.store(true, std::memory_order::relaxed);
+        }
+    }
+};
+
+// One consumer of a possibly shared stream, StreamManager handles point to it
+struct StreamConsumer {
+    std::shared_ptr<ManagedStream> stream;
+    uint32_t slot = 0; // Frame queues and send horizon of this consumer in every channel
+
+    // Decoder of the stream index, null if it has none
+    ChannelStorage* FindChannel(int index) const noexcept
+    {
+        auto it = stream->channels.find(index);
+        return it != stream->channels.end() ? &it->second : nullptr;
+    }
+};
+
+// Connection opened on a connection thread. The stream is registered with its decoders initialized
+// before done is published, the consumer takes the handle or cancels the connection.
+struct StreamConnection {
+    // Request, only read by the connecting thread
+    std::string url;
+    ffmpeg::unique_dictionary options;
+    std::vector<int> active_channel_indices;
+    std::string key; // Shared with a stream already open for the same key
+    std::chrono::microseconds timeout{ 5'000'000 }; // Bounds opening and probing the stream
+
+    std::atomic<bool> cancelled{ false }; // Aborts the connection, a finished one is unregistered
+    std::atomic<bool> done{ false };
+    std::atomic<uintptr_t> handle{ 0 }; // Taken once, by the consumer or by the cancellation
+
+    // Result, valid once done
+    codec::StreamChannels channels; // Streams of the registered context
+    std::error_code error;
+};
+
+// Snapshot of a stream's counters, counts are totals since the stream was opened
+struct StreamStats {
+    std::string url;
+    bool live = false;
+    bool dropped = false; // Ended or stalled, the consumers are reconnecting
+    uint32_t consumers = 0;
+    uint64_t packets_read = 0;
+    uint64_t bytes_read = 0;
+    int64_t bitrate = 0; // Bits per second over the last second
+    uint32_t read_queue_depth = 0; // Read but not dispatched to the decoders yet
+    uint64_t read_errors = 0;
+    uint64_t dropped_packets = 0; // Dropped by the live backpressure policy
+    uint64_t dropped_segments = 0; // Runs of packets dropped up to a keyframe
+    std::vector<ChannelStats> channels;
+};
+
+struct StreamManagerDesc {
+    uint32_t max_demux_threads = 8; // Demux threads are started per stream up to this count
+    uint32_t max_connect_threads = 16; // Connection threads are started per pending connection up to this count
+    uint32_t software_decode_threads = 0; // Threads per software video decoder, 0 lets FFmpeg decide
+    bool force_software_decode = false; // Skip hardware decoding, for machines without a video queue
 };
 
 // Manages all stream I/O in a dedicated thread pool.
+// Demuxing runs on a pool of reader threads that grows with the stream count up to a cap,
+// so a stream blocked in av_read_frame only holds up its own reader.
+// Connections are opened on a separate pool, a source that does not answer never takes a reader.
+// Video is decoded on the GPU decode queue when there is one and the codec supports it,
+// otherwise in software with frame and slice threading.
 class StreamManager
 {
 public:
-    using StreamHandle = uintptr_t;
+    using StreamHandle = uintptr_t; // Points to the StreamConsumer
 
 public:
-    StreamManager(const vortex::Graphics& gfx);
+    StreamManager(const vortex::Graphics& gfx, const StreamManagerDesc& desc = {});
     ~StreamManager();
 
 public:
     bool InitVideoDecoder(vortex::ffmpeg::ManagedStream& stream, int channel);
     bool InitAudioDecoder(vortex::ffmpeg::ManagedStream& stream, int channel);
     void InitDecoder(vortex::ffmpeg::ManagedStream& stream, int i);
-    StreamHandle RegisterStream(ffmpeg::unique_context context, std::span<int> active_channel_indices);
+    // Registers the stream with its first consumer, a non-empty key lets later connections share it
+    StreamHandle RegisterStream(ffmpeg::unique_context context, std::span<int> active_channel_indices, std::string key = {});
+    // Detaches the consumer, the stream is closed with its last consumer
     void UnregisterStream(StreamHandle handle);
 
+    // Connects, probes and registers the stream on a connection thread, so an unreachable source
+    // never blocks the caller. Poll done, then take the handle with TakeConnection.
+    // Connections to a source that is already open with the same options share its demuxer and decoders.
+    std::shared_ptr<StreamConnection> ConnectStream(std::string url,
+                                                    ffmpeg::unique_dictionary options,
+                                                    std::span<const int> active_channel_indices);
+    // Handle of a finished connection, 0 while in progress or if it failed
+    static StreamHandle TakeConnection(StreamConnection& connection) noexcept;
+    // Aborts the connection, or unregisters the stream if it finished and was not taken
+    void CancelConnection(StreamConnection& connection);
+    // A live stream that ended or stalled is not read anymore and has to be connected again
+    bool IsStreamDropped(StreamHandle handle);
+
     void SetChannelActive(StreamHandle handle, int stream_index, bool active);
     void ActivateChannels(StreamHandle handle, std::span<int> active_channel_indices);
     void DeactivateChannels(StreamHandle handle, std::span<int> inactive_channel_indices);
 
+    // Ingest counters of the stream the consumer reads, empty for an unknown handle
+    std::optional<StreamStats> GetStats(StreamHandle handle);
+    // Ingest counters of every open stream, to find the one that is struggling
+    std::vector<StreamStats> GetAllStats();
+
 private:
-    void PacketLoop(std::stop_token stop);
-    bool ReadStreamPackets(std::stop_token stop, vortex::ffmpeg::ManagedStream& stream);
+    enum class ReadResult {
+        packet, // Packet was queued, the stream can be read again right away
+        retry, // Nothing read, the next read waits for data in the protocol
+        error, // Read failed, try again after read_error_backoff
+        finished, // End of stream or closed, the stream is not read anymore
+        blocked, // Read queue is full, the I/O thread resumes the stream once it drains
+    };
+    struct DemuxTask {
+        std::shared_ptr<ManagedStream> stream;
+        std::chrono::steady_clock::time_point not_before;
+    };
+    struct ConnectTask {
+        std::shared_ptr<StreamConnection> connection;
+        std::chrono::steady_clock::time_point not_before;
+    };
 
+    void DemuxLoop(std::stop_token stop);
+    void ScheduleDemux(std::shared_ptr<ManagedStream> stream, std::chrono::steady_clock::time_point not_before);
+    void GrowDemuxThreads(std::size_t stream_count);
+    void ConnectLoop(std::stop_token stop);
+    bool Connect(StreamConnection& connection);
+    StreamHandle AttachConsumer(const std::shared_ptr<ManagedStream>& stream, std::span<const int> active_channel_indices);
+    StreamConsumer* FindConsumer(StreamHandle handle) const;
+    void IOApplyUpdates(vortex::ffmpeg::ManagedStream& stream);
+    ManagedStream* FindStream(StreamHandle handle) const;
+    static std::string MakeStreamKey(std::string_view url, const AVDictionary* options);
+    ReadResult ReadStreamPackets(vortex::ffmpeg::ManagedStream& stream);
+    ReadResult DropStream(vortex::ffmpeg::ManagedStream& stream, std::string_view reason);
+    ReadResult QueuePacket(vortex::ffmpeg::ManagedStream& stream, ffmpeg::pooled_packet packet);
+    static bool IsLiveSource(const AVFormatContext* context) noexcept;
 
-    void VideoDecodeLoop(std::stop_token stop);
-    void AudioDecodeLoop(std::stop_token stop);
+    bool SupportsHardwareDecode(const AVCodec* codec) const noexcept;
+    ffmpeg::unique_codec_context OpenVideoDecoder(const AVCodec* codec, const AVCodecParameters& codec_params, int channel, bool hardware);
 
     void IOLoop(std::stop_token stop);
     void IOFlushStream(vortex::ffmpeg::ManagedStream& stream);
     bool IOProcessStream(vortex::ffmpeg::ManagedStream& stream);
+    void IOReportLatency(vortex::ffmpeg::ManagedStream& stream);
+    void IOUpdateBitrate(vortex::ffmpeg::ManagedStream& stream, std::chrono::steady_clock::duration elapsed);
+    static StreamStats MakeStats(const ManagedStream& stream);
 
     static void AvLogCallbackThunk(void* ptr, int level, const char* fmt, va_list vargs);
 
     vortex::LogView _log;
+    vortex::wake_signal _io_wake; // Packets, stream updates or drained frame queues for the I/O thread
     std::vector<std::jthread> _io_threads;
 
     // Control for unpdating streams
     std::atomic<uint64_t> _update_generation{ 0 };
     std::shared_mutex _streams_mutex;
-    std::unordered_map<StreamHandle, std::shared_ptr<ManagedStream>> _streams;
+    std::unordered_map<const ManagedStream*, std::shared_ptr<ManagedStream>> _streams;
+    std::unordered_map<StreamHandle, std::unique_ptr<StreamConsumer>> _consumers;
+    std::unordered_set<std::string> _connecting_keys; // Sources being opened, later connections wait and share
+
+    // Streams waiting for a reader, each stream is queued at most once
+    StreamManagerDesc _desc;
+    std::mutex _demux_mutex;
+    std::condition_variable_any _demux_cv;
+    std::deque<DemuxTask> _demux_tasks;
+    std::vector<std::jthread> _demux_threads;
+
+    // Connections being opened, each pending connection gets a thread up to the cap
+    std::mutex _connect_mutex;
+    std::condition_variable_any _connect_cv;
+    std::deque<ConnectTask> _connect_tasks;
+    std::vector<std::shared_ptr<StreamConnection>> _connections; // Pending, cancelled on shutdown
+    std::vector<std::jthread> _connect_threads;
 
-    ffmpeg::VADecodeContext _va_decode_context; // Shared hardware decode context for Wisdom VK/DX12
+    std::optional<ffmpeg::VADecodeContext> _va_decode_context; // Shared hardware decode context for Wisdom VK/DX12, empty when unavailable
 };
 } // namespace vortex::ffmpeg
\ No newline at end of file
@@ -0,0 +1,264 @@
+#include <vortex/codec/ffmpeg/synthetic_source.h>
+#include <vortex/codec/ffmpeg/error.h>
+#include <vortex/util/log.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <format>
+
+extern "C" {
+#include <libavutil/pixdesc.h>
+}
+
+namespace {
+constexpr uint64_t stamp_mask = (uint64_t(1) << 48) - 1;
+
+// 3x5 glyphs of 0-9 and ':', top row in the highest bits
+constexpr std::array<uint16_t, 11> font = {
+    0b111'101'101'101'111, 0b010'110'010'010'111, 0b111'001'111'100'111, 0b111'001'111'001'111,
+    0b101'101'111'001'001, 0b111'100'111'001'111, 0b111'100'111'101'111, 0b111'001'001'001'001,
+    0b111'101'111'101'111, 0b111'101'111'001'111, 0b000'010'000'010'000,
+};
+
+// 75% bars, BT.601 limited range
+struct YUV {
+    uint8_t y, u, v;
+};
+constexpr std::array<YUV, 7> bars = { {
+    { 180, 128, 128 }, // White
+    { 162, 44, 142 }, // Yellow
+    { 131, 156, 44 }, // Cyan
+    { 112, 72, 58 }, // Green
+    { 84, 184, 198 }, // Magenta
+    { 65, 100, 212 }, // Red
+    { 35, 212, 114 }, // Blue
+} };
+constexpr YUV black = { 16, 128, 128 };
+constexpr YUV white = { 235, 128, 128 };
+
+// 8-bit luma in the first plane, the stamp is read from any such format
+bool HasLumaPlane(const AVFrame& frame) noexcept
+{
+    auto* desc = av_pix_fmt_desc_get(AVPixelFormat(frame.format));
+    return desc && !(desc->flags & AV_PIX_FMT_FLAG_RGB) && desc->comp[0].depth == 8 && frame.data[0];
+}
+// Planar 8-bit YUV, the pattern is drawn into those only
+bool IsPlanarYUV(const AVFrame& frame) noexcept
+{
+    auto* desc = av_pix_fmt_desc_get(AVPixelFormat(frame.format));
+    return HasLumaPlane(frame) && (desc->flags & AV_PIX_FMT_FLAG_PLANAR) && desc->nb_components >= 3;
+}
+
+void Fill(AVFrame& frame, int x, int y, int w, int h, YUV color) noexcept
+{
+    int x0 = std::clamp(x, 0, frame.width);
+    int y0 = std::clamp(y, 0, frame.height);
+    int x1 = std::clamp(x + w, 0, frame.width);
+    int y1 = std::clamp(y + h, 0, frame.height);
+    if (x0 >= x1 || y0 >= y1) {
+        return;
+    }
+    for (int row = y0; row < y1; row++) {
+        std::fill_n(frame.data[0] + ptrdiff_t(row) * frame.linesize[0] + x0, x1 - x0, color.y);
+    }
+
+    auto* desc = av_pix_fmt_desc_get(AVPixelFormat(frame.format));
+    int cx0 = x0 >> desc->log2_chroma_w, cx1 = -((-x1) >> desc->log2_chroma_w);
+    int cy0 = y0 >> desc->log2_chroma_h, cy1 = -((-y1) >> desc->log2_chroma_h);
+    for (int row = cy0; row < cy1; row++) {
+        std::fill_n(frame.data[1] + ptrdiff_t(row) * frame.linesize[1] + cx0, cx1 - cx0, color.u);
+        std::fill_n(frame.data[2] + ptrdiff_t(row) * frame.linesize[2] + cx0, cx1 - cx0, color.v);
+    }
+}
+
+int StampHeight(const AVFrame& frame) noexcept
+{
+    return std::max(8, frame.height / 32) & ~1;
+}
+uint16_t StampCheck(uint64_t stamp) noexcept
+{
+    return uint16_t((stamp ^ (stamp >> 16) ^ (stamp >> 32)) & 0xFFFF) ^ 0x5A5A;
+}
+int64_t NowUs() noexcept
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+} // namespace
+
+void vortex::ffmpeg::SyntheticPattern::Draw(AVFrame& frame, int64_t index, vortex::ratio32_t rate) noexcept
+{
+    if (!IsPlanarYUV(frame)) {
+        return;
+    }
+
+    // Bars below the stamp band
+    int band = StampHeight(frame);
+    for (int i = 0; i < int(bars.size()); i++) {
+        int x0 = frame.width * i / int(bars.size());
+        int x1 = frame.width * (i + 1) / int(bars.size());
+        Fill(frame, x0, band, x1 - x0, frame.height - band, bars[i]);
+    }
+
+    // Box sweeping across and back in two seconds, shows dropped and repeated frames
+    int box = std::max(frame.height / 6, 2) & ~1;
+    int travel = std::max(frame.width - box, 1);
+    int fps = std::max<int>((rate.numerator + rate.denominator - 1) / rate.denominator, 1);
+    int position = int(index % (2 * fps) * travel / fps);
+    int x = position < travel ? position : 2 * travel - position;
+    Fill(frame, x & ~1, (frame.height - box) / 2 & ~1, box, box, white);
+
+    // Timecode on a black plate in the lower third
+    auto timecode = Timecode(index, rate);
+    int scale = std::max(frame.height / 72, 2) & ~1;
+    int text_width = (int(timecode.size()) * 4 - 1) * scale;
+    int text_x = (frame.width - text_width) / 2 & ~1;
+    int text_y = frame.height * 3 / 4 & ~1;
+    Fill(frame, text_x - scale, text_y - scale, text_width + 2 * scale, 7 * scale, black);
+    for (std::size_t c = 0; c < timecode.size(); c++) {
+        char ch = timecode[c];
+        uint16_t glyph = ch == ':' ? font[10] : font[std::clamp(ch - '0', 0, 9)];
+        for (int bit = 0; bit < 15; bit++) {
+            if (glyph & (1 << (14 - bit))) {
+                int gx = text_x + (int(c) * 4 + bit % 3) * scale;
+                int gy = text_y + (bit / 3) * scale;
+                Fill(frame, gx, gy, scale, scale, white);
+            }
+        }
+    }
+}
+
+void vortex::ffmpeg::SyntheticPattern::WriteStamp(AVFrame& frame, int64_t stamp_us) noexcept
+{
+    int cell = frame.width / stamp_cells;
+    if (!IsPlanarYUV(frame) || cell < min_cell_width) {
+        return;
+    }
+    uint64_t stamp = uint64_t(stamp_us) & stamp_mask;
+    uint64_t bits = stamp << 16 | StampCheck(stamp);
+    int band = StampHeight(frame);
+    for (int i = 0; i < stamp_cells; i++) {
+        bool set = bits & (uint64_t(1) << (stamp_cells - 1 - i));
+        Fill(frame, i * cell, 0, cell, band, set ? white : black);
+    }
+}
+
+std::optional<int64_t> vortex::ffmpeg::SyntheticPattern::ReadStamp(const AVFrame& frame) noexcept
+{
+    int cell = frame.width / stamp_cells;
+    if (!HasLumaPlane(frame) || cell < min_cell_width || frame.height < StampHeight(frame)) {
+        return std::nullopt;
+    }
+
+    // Middle of each cell, away from the ringing at the block edges
+    const uint8_t* row = frame.data[0] + ptrdiff_t(StampHeight(frame) / 2) * frame.linesize[0];
+    uint64_t bits = 0;
+    for (int i = 0; i < stamp_cells; i++) {
+        int sum = 0;
+        int x0 = i * cell + cell / 4;
+        int x1 = i * cell + cell - cell / 4;
+        for (int x = x0; x < x1; x++) {
+            sum += row[x];
+        }
+        bits = bits << 1 | uint64_t(sum > (x1 - x0) * 126);
+    }
+
+    uint64_t stamp = bits >> 16;
+    if (uint16_t(bits & 0xFFFF) != StampCheck(stamp)) {
+        return std::nullopt; // Not stamped or damaged by the encoder
+    }
+    return int64_t(stamp);
+}
+
+std::optional<int64_t> vortex::ffmpeg::SyntheticPattern::StampAge(const AVFrame& frame) noexcept
+{
+    auto stamp = ReadStamp(frame);
+    if (!stamp) {
+        return std::nullopt;
+    }
+    // Sign extended difference of the 48 bit times
+    int64_t age = int64_t(((uint64_t(NowUs()) - uint64_t(*stamp)) & stamp_mask) << 16) >> 16;
+    return age;
+}
+
+std::string vortex::ffmpeg::SyntheticPattern::Timecode(int64_t index, vortex::ratio32_t rate)
+{
+    int64_t fps = std::max<int64_t>((rate.numerator + rate.denominator - 1) / rate.denominator, 1);
+    int64_t seconds = index / fps;
+    return std::format("{:02}:{:02}:{:02}:{:02}",
+                       seconds / 3600 % 24, seconds / 60 % 60, seconds % 60, index % fps);
+}
+
+vortex::ffmpeg::SyntheticSource::SyntheticSource(const SyntheticSourceDesc& desc)
+    : _desc(desc)
+{
+}
+
+std::expected<std::unique_ptr<vortex::ffmpeg::SyntheticSource>, std::error_code>
+vortex::ffmpeg::SyntheticSource::Start(const SyntheticSourceDesc& desc)
+{
+    std::unique_ptr<SyntheticSource> source{ new SyntheticSource(desc) };
+
+    // Hardware encoder sessions are limited on consumer cards, benchmarks run many sources
+    auto encoder = VideoEncoder::Open({
+            .url = desc.url,
+            .format = desc.format,
+            .width = desc.width,
+            .height = desc.height,
+            .rate = desc.rate,
+            .bitrate = desc.bitrate,
+            .codec = desc.codec,
+            .input_format = AV_PIX_FMT_YUV420P,
+            .color_space = AVCOL_SPC_SMPTE170M, // Bars are BT.601
+            .kind = EncoderKind::Software,
+    });
+    if (!encoder) {
+        vortex::error("SyntheticSource: Could not start sending to {}", desc.url);
+        return std::unexpected(encoder.error());
+    }
+    source->_encoder = std::move(encoder.value());
+
+    source->_frame = unique_frame{ av_frame_alloc() };
+    if (!source->_frame) {
+        return std::unexpected(std::make_error_code(std::errc::not_enough_memory));
+    }
+    source->_frame->format = AV_PIX_FMT_YUV420P;
+    source->_frame->width = int(desc.width) & ~1;
+    source->_frame->height = int(desc.height) & ~1;
+    int ret = av_frame_get_buffer(source->_frame.get(), 0);
+    if (ret < 0) {
+        return std::unexpected(make_ffmpeg_error(ret));
+    }
+
+    source->_thread = std::jthread([self = source.get()](std::stop_token stop) { self->Run(stop); });
+    return source;
+}
+
+void vortex::ffmpeg::SyntheticSource::Run(std::stop_token stop)
+{
+    using namespace std::chrono;
+    auto start = steady_clock::now();
+    for (int64_t index = 0; !stop.stop_requested(); index++) {
+        if (_desc.frame_count > 0 && index >= _desc.frame_count) {
+            break;
+        }
+        if (_desc.realtime) {
+            auto due = duration<double>(double(index) * _desc.rate.denominator / _desc.rate.numerator);
+            std::this_thread::sleep_until(start + duration_cast<steady_clock::duration>(due));
+        }
+
+        // The encoder may still reference the previous picture
+        if (av_frame_make_writable(_frame.get()) < 0) {
+            break;
+        }
+        SyntheticPattern::Draw(*_frame, index, _desc.rate);
+        SyntheticPattern::WriteStamp(*_frame, NowUs()); // Glass to glass starts here
+        _frame->pts = index;
+        if (!_encoder->Encode(*_frame)) {
+            break;
+        }
+        _frames_sent.fetch_add(1, std::memory_order::relaxed);
+    }
+
+    std::ignore = _encoder->Finish();
+    _finished.store(true, std::memory_order::release);
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <vortex/codec/ffmpeg/types.h>
+#include <vortex/codec/ffmpeg/video_encoder.h>
+#include <vortex/util/rational.h>
+#include <atomic>
+#include <expected>
+#include <memory>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <thread>
+
+namespace vortex::ffmpeg {
+// Moving test pattern for 8-bit YUV 4:2:0 frames: color bars, a sweeping box, a burnt-in
+// timecode and a send stamp across the top rows. The stamp is drawn in blocks wide enough
+// to survive lossy coding, so a receiver can read it back from the decoded picture.
+struct SyntheticPattern {
+    static constexpr int stamp_cells = 64; // 48 bits of stamp and 16 bits of check
+    static constexpr int min_cell_width = 4;
+
+    static void Draw(AVFrame& frame, int64_t index, vortex::ratio32_t rate) noexcept;
+
+    // Stamp is a steady_clock time in microseconds, only the low 48 bits are kept
+    static void WriteStamp(AVFrame& frame, int64_t stamp_us) noexcept;
+    static std::optional<int64_t> ReadStamp(const AVFrame& frame) noexcept;
+    // Microseconds since the stamp was written, on the same machine
+    static std::optional<int64_t> StampAge(const AVFrame& frame) noexcept;
+
+    // Non-drop timecode of the frame, HH:MM:SS:FF
+    static std::string Timecode(int64_t index, vortex::ratio32_t rate);
+};
+
+struct SyntheticSourceDesc {
+    std::string url = "udp://127.0.0.1:5000?pkt_size=1316"; // udp://, rtp://, pipe:1 or a file path
+    std::string format; // Muxer, empty to pick one from the url
+    uint32_t width = 1280;
+    uint32_t height = 720;
+    vortex::ratio32_t rate{ 30, 1 };
+    int64_t bitrate = 4'000'000;
+    AVCodecID codec = AV_CODEC_ID_H264; // Falls back to MPEG-2 when there is no encoder for it
+    bool realtime = true; // Paced at the frame rate, files can be written as fast as the encoder goes
+    int64_t frame_count = 0; // Frames to send, 0 to send until stopped
+};
+
+// Encodes the synthetic pattern and writes it to a local output on its own thread,
+// so ingest can be tested and benchmarked on localhost without cameras or files.
+class SyntheticSource
+{
+public:
+    static std::expected<std::unique_ptr<SyntheticSource>, std::error_code>
+    Start(const SyntheticSourceDesc& desc);
+
+    SyntheticSource(const SyntheticSource&) = delete;
+    SyntheticSource& operator=(const SyntheticSource&) = delete;
+    ~SyntheticSource() = default;
+
+public:
+    bool IsRunning() const noexcept { return !_finished.load(std::memory_order::acquire); }
+    uint64_t FramesSent() const noexcept { return _frames_sent.load(std::memory_order::relaxed); }
+    uint64_t BytesSent() const noexcept { return _encoder->GetBytesWritten(); }
+
+private:
+    SyntheticSource(const SyntheticSourceDesc& desc);
+
+    void Run(std::stop_token stop);
+
+private:
+    SyntheticSourceDesc _desc;
+    std::unique_ptr<ffmpeg::VideoEncoder> _encoder;
+    ffmpeg::unique_frame _frame;
+
+    std::atomic<uint64_t> _frames_sent{ 0 };
+    std::atomic<bool> _finished{ false };
+    std::jthread _thread; // Declared last, stopped before the encoder is freed
+};
+} // namespace vortex::ffmpeg
@@ -1,6 +1,8 @@
 #pragma once
 #include <vortex/util/unique_any.h>
 #include <vortex/util/lib/reflect.h>
+#include <atomic>
+#include <chrono>
 #include <format>
 
 extern "C" {
@@ -11,8 +13,50 @@ extern "C" {
 }
 
 namespace vortex::ffmpeg {
+// Interrupt state of a format context. Protocols copy the callback when they are opened,
+// so the state is owned by the context and released only after the context is closed.
+struct StreamInterrupt {
+    std::atomic<bool> cancelled{ false }; // Aborts any blocking I/O of the context
+    std::atomic<int64_t> deadline{ 0 }; // steady_clock ticks, 0 for no deadline
+    const std::atomic<bool>* abort = nullptr; // Set by the caller while connecting, cleared before the context is handed on
+
+    static int Callback(void* opaque) noexcept
+    {
+        auto* self = static_cast<StreamInterrupt*>(opaque);
+        if (self->cancelled.load(std::memory_order::relaxed) ||
+            (self->abort && self->abort->load(std::memory_order::relaxed))) {
+            return 1;
+        }
+        int64_t deadline = self->deadline.load(std::memory_order::relaxed);
+        return deadline != 0 && std::chrono::steady_clock::now().time_since_epoch().count() > deadline;
+    }
+    static StreamInterrupt* Get(const AVFormatContext* context) noexcept
+    {
+        return context && context->interrupt_callback.callback == &Callback
+                ? static_cast<StreamInterrupt*>(context->interrupt_callback.opaque)
+                : nullptr;
+    }
+};
+
+inline void CloseInput(AVFormatContext** context) noexcept
+{
+    auto* interrupt = StreamInterrupt::Get(*context);
+    avformat_close_input(context);
+    delete interrupt;
+}
+
+inline void CloseOutput(AVFormatContext** context) noexcept
+{
+    if (*context && !((*context)->oformat->flags & AVFMT_NOFILE)) {
+        avio_closep(&(*context)->pb);
+    }
+    avformat_free_context(*context);
+    *context = nullptr;
+}
+
 // RAII wrappers for the most common FFmpeg types
-using unique_context = vortex::unique_any<AVFormatContext*, avformat_close_input>;
+using unique_context = vortex::unique_any<AVFormatContext*, CloseInput>;
+using unique_output_context = vortex::unique_any<AVFormatContext*, CloseOutput>;
 using unique_codec_context = vortex::unique_any<AVCodecContext*, avcodec_free_context>;
 using unique_frame = vortex::unique_any<AVFrame*, av_frame_free>;
 using unique_swscontext = vortex::unique_any<SwsContext*, sws_freeContext>;
@@ -0,0 +1,282 @@
+#include <vortex/codec/ffmpeg/video_encoder.h>
+#include <vortex/codec/ffmpeg/error.h>
+#include <vortex/util/log.h>
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <iterator>
+#include <span>
+#include <tuple>
+#include <vector>
+
+extern "C" {
+#include <libavutil/opt.h>
+}
+
+namespace {
+struct EncoderCandidate {
+    const AVCodec* codec;
+    AVPixelFormat format;
+    bool hardware;
+};
+
+// Input format of the encoder, preferring the one frames arrive in
+AVPixelFormat PickFormat(const AVCodec& codec, AVPixelFormat preferred) noexcept
+{
+    const void* configs = nullptr;
+    int count = 0;
+    if (avcodec_get_supported_config(nullptr, &codec, AV_CODEC_CONFIG_PIX_FORMAT, 0, &configs, &count) < 0) {
+        return AV_PIX_FMT_NONE;
+    }
+    if (!configs) {
+        return preferred; // Takes any format
+    }
+    std::span formats{ static_cast<const AVPixelFormat*>(configs), std::size_t(count) };
+    for (auto format : { preferred, AV_PIX_FMT_NV12, AV_PIX_FMT_YUV420P }) {
+        if (std::ranges::find(formats, format) != formats.end()) {
+            return format;
+        }
+    }
+    return AV_PIX_FMT_NONE; // Only takes hardware frames or formats we do not produce
+}
+
+// Encoders of the codec that take system memory frames, hardware ones first
+std::vector<EncoderCandidate> FindEncoders(AVCodecID id, AVPixelFormat preferred, vortex::ffmpeg::EncoderKind kind)
+{
+    std::vector<EncoderCandidate> candidates;
+    void* iterator = nullptr;
+    while (const AVCodec* codec = av_codec_iterate(&iterator)) {
+        if (codec->id != id || !av_codec_is_encoder(codec) || (codec->capabilities & AV_CODEC_CAP_EXPERIMENTAL)) {
+            continue;
+        }
+        bool hardware = codec->capabilities & (AV_CODEC_CAP_HARDWARE | AV_CODEC_CAP_HYBRID);
+        if ((kind == vortex::ffmpeg::EncoderKind::Software && hardware) ||
+            (kind == vortex::ffmpeg::EncoderKind::Hardware && !hardware)) {
+            continue;
+        }
+        if (auto format = PickFormat(*codec, preferred); format != AV_PIX_FMT_NONE) {
+            candidates.push_back({ codec, format, hardware });
+        }
+    }
+    std::ranges::stable_partition(candidates, std::identity{}, &EncoderCandidate::hardware);
+    return candidates;
+}
+
+// Wrapper defaults are tuned for offline encoding, these keep the delay to a frame or two
+void SetLowLatencyOptions(const AVCodec& codec, AVDictionary** options) noexcept
+{
+    std::string_view name = codec.name;
+    if (name == "libx264" || name == "libx265") {
+        av_dict_set(options, "preset", "veryfast", 0);
+        av_dict_set(options, "tune", "zerolatency", 0);
+    } else if (name.ends_with("_nvenc")) {
+        av_dict_set(options, "preset", "p4", 0);
+        av_dict_set(options, "tune", "ll", 0);
+    } else if (name.ends_with("_qsv")) {
+        av_dict_set(options, "preset", "veryfast", 0);
+        av_dict_set(options, "async_depth", "1", 0);
+    } else if (name.ends_with("_amf")) {
+        av_dict_set(options, "usage", "lowlatency", 0);
+    } else if (name.ends_with("_videotoolbox")) {
+        av_dict_set(options, "realtime", "1", 0);
+    }
+}
+} // namespace
+
+const char* vortex::ffmpeg::VideoEncoder::GuessFormat(std::string_view url) noexcept
+{
+    if (url.starts_with("rtp://")) {
+        return "rtp_mpegts"; // Static payload type, receivers need no session description
+    }
+    if (url.starts_with("udp://") || url.starts_with("srt://") || url.starts_with("tcp://") || url.starts_with("pipe:")) {
+        return "mpegts";
+    }
+    return nullptr;
+}
+
+vortex::ffmpeg::VideoEncoder::VideoEncoder(const VideoEncoderDesc& desc)
+    : _desc(desc)
+    , _finished(true) // Until the header is written
+{
+}
+
+vortex::ffmpeg::VideoEncoder::~VideoEncoder()
+{
+    std::ignore = Finish();
+}
+
+std::expected<std::unique_ptr<vortex::ffmpeg::VideoEncoder>, std::error_code>
+vortex::ffmpeg::VideoEncoder::Open(const VideoEncoderDesc& desc)
+{
+    std::unique_ptr<VideoEncoder> encoder{ new VideoEncoder(desc) };
+
+    const char* format = desc.format.empty() ? GuessFormat(desc.url) : desc.format.c_str();
+    int ret = avformat_alloc_output_context2(encoder->_output.address_of(), nullptr, format, desc.url.c_str());
+    if (ret < 0) {
+        vortex::error("VideoEncoder: Could not create output for {}: {}", desc.url, ffmpeg_error_string(ret));
+        return std::unexpected(make_ffmpeg_error(ret));
+    }
+    AVFormatContext* output = encoder->_output.get();
+
+    // Hardware encoders are listed even when the device is missing, so each is tried in turn
+    auto candidates = FindEncoders(desc.codec, desc.input_format, desc.kind);
+    if (desc.kind != EncoderKind::Hardware && desc.codec != AV_CODEC_ID_MPEG2VIDEO) {
+        std::ranges::copy(FindEncoders(AV_CODEC_ID_MPEG2VIDEO, desc.input_format, EncoderKind::Software),
+                          std::back_inserter(candidates));
+    }
+    for (auto& candidate : candidates) {
+        if (candidate.codec->id != desc.codec) {
+            vortex::warn("VideoEncoder: No {} encoder could be opened, falling back to {}",
+                         avcodec_get_name(desc.codec), candidate.codec->name);
+        }
+        if (encoder->OpenEncoder(candidate.codec, candidate.format)) {
+            encoder->_hardware = candidate.hardware;
+            break;
+        }
+    }
+    if (!encoder->_encoder) {
+        vortex::error("VideoEncoder: No encoder available for {}", avcodec_get_name(desc.codec));
+        return std::unexpected(make_error_code(ffmpeg_errc::encoder_not_found));
+    }
+    AVCodecContext* context = encoder->_encoder.get();
+
+    encoder->_stream = avformat_new_stream(output, nullptr);
+    if (!encoder->_stream) {
+        return std::unexpected(std::make_error_code(std::errc::not_enough_memory));
+    }
+    encoder->_stream->time_base = context->time_base;
+    ret = avcodec_parameters_from_context(encoder->_stream->codecpar, context);
+    if (ret < 0) {
+        return std::unexpected(make_ffmpeg_error(ret));
+    }
+
+    if (!(output->oformat->flags & AVFMT_NOFILE)) {
+        ret = avio_open2(&output->pb, desc.url.c_str(), AVIO_FLAG_WRITE, nullptr, nullptr);
+        if (ret < 0) {
+            vortex::error("VideoEncoder: Could not open {}: {}", desc.url, ffmpeg_error_string(ret));
+            return std::unexpected(make_ffmpeg_error(ret));
+        }
+    }
+    ret = avformat_write_header(output, nullptr);
+    if (ret < 0) {
+        vortex::error("VideoEncoder: Could not write header to {}: {}", desc.url, ffmpeg_error_string(ret));
+        return std::unexpected(make_ffmpeg_error(ret));
+    }
+
+    encoder->_packet = unique_packet{ av_packet_alloc() };
+    if (!encoder->_packet) {
+        return std::unexpected(std::make_error_code(std::errc::not_enough_memory));
+    }
+    if (context->pix_fmt != desc.input_format) {
+        encoder->_converter = unique_swscontext{ sws_getContext(context->width, context->height, desc.input_format,
+                                                                context->width, context->height, context->pix_fmt,
+                                                                SWS_BILINEAR, nullptr, nullptr, nullptr) };
+        encoder->_converted = unique_frame{ av_frame_alloc() };
+        if (!encoder->_converter || !encoder->_converted) {
+            return std::unexpected(std::make_error_code(std::errc::not_enough_memory));
+        }
+        encoder->_converted->format = context->pix_fmt;
+        encoder->_converted->width = context->width;
+        encoder->_converted->height = context->height;
+        ret = av_frame_get_buffer(encoder->_converted.get(), 0);
+        if (ret < 0) {
+            return std::unexpected(make_ffmpeg_error(ret));
+        }
+    }
+
+    encoder->_finished = false; // Trailer is written from here on
+    vortex::info("VideoEncoder: Encoding {}x{} with {} to {} ({})", context->width, context->height,
+                 context->codec->name, desc.url, output->oformat->name);
+    return encoder;
+}
+
+bool vortex::ffmpeg::VideoEncoder::OpenEncoder(const AVCodec* codec, AVPixelFormat format) noexcept
+{
+    unique_codec_context encoder{ avcodec_alloc_context3(codec) };
+    if (!encoder) {
+        return false;
+    }
+    encoder->width = int(_desc.width) & ~1;
+    encoder->height = int(_desc.height) & ~1;
+    encoder->pix_fmt = format;
+    encoder->time_base = { int(_desc.rate.denominator), int(_desc.rate.numerator) };
+    encoder->framerate = { int(_desc.rate.numerator), int(_desc.rate.denominator) };
+    encoder->bit_rate = _desc.bitrate;
+    encoder->gop_size = std::max<int>((_desc.rate.numerator + _desc.rate.denominator - 1) / _desc.rate.denominator, 1); // Receivers join within a second
+    encoder->max_b_frames = 0; // No reordering delay
+    encoder->color_range = AVCOL_RANGE_MPEG;
+    encoder->colorspace = _desc.color_space;
+    if (_desc.color_space == AVCOL_SPC_BT709) {
+        encoder->color_primaries = AVCOL_PRI_BT709;
+        encoder->color_trc = AVCOL_TRC_BT709;
+    }
+    if (_output->oformat->flags & AVFMT_GLOBALHEADER) {
+        encoder->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+    }
+
+    unique_dictionary options;
+    SetLowLatencyOptions(*codec, options.address_of());
+    int ret = avcodec_open2(encoder.get(), codec, options.address_of());
+    if (ret < 0) {
+        vortex::warn("VideoEncoder: Could not open encoder {}: {}", codec->name, ffmpeg_error_string(ret));
+        return false;
+    }
+    _encoder = std::move(encoder);
+    return true;
+}
+
+bool vortex::ffmpeg::VideoEncoder::Encode(AVFrame& frame) noexcept
+{
+    if (_finished) {
+        return false;
+    }
+    AVFrame* input = &frame;
+    if (_converter) {
+        // The encoder may still reference the previous picture
+        int ret = av_frame_make_writable(_converted.get());
+        if (ret >= 0) {
+            ret = sws_scale_frame(_converter.get(), _converted.get(), &frame);
+        }
+        if (ret < 0) {
+            vortex::error("VideoEncoder: Error converting frame: {}", ffmpeg_error_string(ret));
+            return false;
+        }
+        _converted->pts = frame.pts;
+        input = _converted.get();
+    }
+    return Send(input);
+}
+
+bool vortex::ffmpeg::VideoEncoder::Finish() noexcept
+{
+    if (_finished) {
+        return true;
+    }
+    _finished = true;
+    bool drained = Send(nullptr);
+    int ret = av_write_trailer(_output.get());
+    if (ret < 0) {
+        vortex::error("VideoEncoder: Error finishing {}: {}", _desc.url, ffmpeg_error_string(ret));
+    }
+    return drained && ret >= 0;
+}
+
+bool vortex::ffmpeg::VideoEncoder::Send(AVFrame* frame) noexcept
+{
+    int ret = avcodec_send_frame(_encoder.get(), frame);
+    if (ret < 0 && ret != AVERROR_EOF) {
+        vortex::error("VideoEncoder: Error encoding frame: {}", ffmpeg_error_string(ret));
+        return false;
+    }
+    while ((ret = avcodec_receive_packet(_encoder.get(), _packet.get())) >= 0) {
+        av_packet_rescale_ts(_packet.get(), _encoder->time_base, _stream->time_base);
+        _packet->stream_index = _stream->index;
+        _bytes_written.fetch_add(uint64_t(_packet->size), std::memory_order::relaxed);
+        ret = av_interleaved_write_frame(_output.get(), _packet.get()); // Takes the packet data
+        if (ret < 0) {
+            vortex::error("VideoEncoder: Error writing to {}: {}", _desc.url, ffmpeg_error_string(ret));
+            return false;
+        }
+    }
+    return ret == AVERROR(EAGAIN) || ret == AVERROR_EOF;
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <vortex/codec/ffmpeg/types.h>
+#include <vortex/util/rational.h>
+#include <atomic>
+#include <expected>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace vortex::ffmpeg {
+enum class EncoderKind {
+    Any, // Hardware first, software when no hardware encoder opens
+    Software,
+    Hardware,
+};
+
+struct VideoEncoderDesc {
+    std::string url; // File path, udp://, rtp:// or pipe:1
+    std::string format; // Muxer, empty to pick one from the url
+    uint32_t width = 1920;
+    uint32_t height = 1080;
+    vortex::ratio32_t rate{ 60, 1 };
+    int64_t bitrate = 8'000'000;
+    AVCodecID codec = AV_CODEC_ID_H264;
+    AVPixelFormat input_format = AV_PIX_FMT_NV12; // Format of the frames passed to Encode
+    AVColorSpace color_space = AVCOL_SPC_BT709; // Matrix the frames were converted with, limited range
+    EncoderKind kind = EncoderKind::Any;
+};
+
+// Opens the best encoder available for a codec and muxes its packets into a file or a
+// network output. Frames are encoded for low latency: no B-frames and a key frame every second.
+// Not thread safe, a single thread is expected to feed and finish the encoder.
+class VideoEncoder
+{
+public:
+    static std::expected<std::unique_ptr<VideoEncoder>, std::error_code>
+    Open(const VideoEncoderDesc& desc);
+    // mpegts for network outputs, rtp_mpegts for rtp://, nullptr to guess from the file extension
+    static const char* GuessFormat(std::string_view url) noexcept;
+
+    VideoEncoder(const VideoEncoder&) = delete;
+    VideoEncoder& operator=(const VideoEncoder&) = delete;
+    ~VideoEncoder();
+
+public:
+    // Frame of the input format at the encoder size (rounded down to even), pts counted in frames of the rate
+    bool Encode(AVFrame& frame) noexcept;
+    // Drains the encoder and writes the trailer, files are not playable without it
+    bool Finish() noexcept;
+
+    std::string_view GetEncoderName() const noexcept { return _encoder->codec->name; }
+    bool IsHardware() const noexcept { return _hardware; }
+    uint64_t GetBytesWritten() const noexcept { return _bytes_written.load(std::memory_order::relaxed); }
+
+private:
+    VideoEncoder(const VideoEncoderDesc& desc);
+
+    bool OpenEncoder(const AVCodec* codec, AVPixelFormat format) noexcept;
+    bool Send(AVFrame* frame) noexcept;
+
+private:
+    VideoEncoderDesc _desc;
+    ffmpeg::unique_output_context _output;
+    ffmpeg::unique_codec_context _encoder;
+    ffmpeg::unique_swscontext _converter; // When the encoder does not take the input format
+    ffmpeg::unique_frame _converted;
+    ffmpeg::unique_packet _packet;
+    AVStream* _stream = nullptr;
+    bool _hardware = false;
+    bool _finished = false;
+
+    std::atomic<uint64_t> _bytes_written{ 0 };
+};
+} // namespace vortex::ffmpeg
@@ -0,0 +1,280 @@
+#include <vortex/codec/ffmpeg/yuv_converter.h>
+#include <vortex/gfx/descriptor_buffer.h>
+#include <vortex/graphics.h>
+#include <vortex/util/log.h>
+
+extern "C" {
+#include <libavutil/pixdesc.h>
+}
+
+// Push constant structure matching the shader
+struct PlaneConstants {
+    float luma_scale; // Visible width / uploaded width of the luma plane
+    float chroma_scale; // Visible width / uploaded width of the chroma planes
+    float padding[2];
+};
+
+vortex::ffmpeg::YUVConverter::YUVConverter(const vortex::Graphics& gfx)
+{
+    auto& device = gfx.GetDevice();
+    wis::Result result = wis::success;
+
+    wis::DescriptorTableEntry entries_desc[] = {
+        { .type = wis::DescriptorType::Texture, .bind_register = 0, .binding = 0, .count = 1 },
+        { .type = wis::DescriptorType::Texture, .bind_register = 1, .binding = 1, .count = 1 },
+        { .type = wis::DescriptorType::Texture, .bind_register = 2, .binding = 2, .count = 1 },
+    };
+    wis::DescriptorTableEntry entries_samp[] = {
+        { .type = wis::DescriptorType::Sampler, .bind_register = 0, .binding = 0, .count = 1 },
+    };
+    wis::DescriptorTable tables[] = {
+        { .type = wis::DescriptorHeapType::Descriptor,
+         .entries = entries_desc,
+         .entry_count = std::size(entries_desc),
+         .stage = wis::ShaderStages::Pixel },
+        {    .type = wis::DescriptorHeapType::Sampler,
+         .entries = entries_samp,
+         .entry_count = std::size(entries_samp),
+         .stage = wis::ShaderStages::Pixel },
+    };
+    wis::PushConstant push_constants[] = {
+        { .stage = wis::ShaderStages::Pixel,
+         .size_bytes = sizeof(PlaneConstants),
+         .bind_register = 0 },
+    };
+    _root_signature = gfx.GetDescriptorBufferExtension().CreateRootSignature(result,
+                                                                             push_constants,
+                                                                             1,
+                                                                             nullptr,
+                                                                             0,
+                                                                             tables,
+                                                                             std::size(tables));
+    if (!vortex::success(result)) {
+        vortex::error("YUVConverter: Failed to create root signature: {}", result.error);
+        return;
+    }
+
+    auto vertex_shader = gfx.LoadShader("shaders/basic.vs");
+
+    wis::GraphicsPipelineDesc pipeline_desc{
+        .root_signature = _root_signature,
+        .shaders = {
+                .vertex = vertex_shader,
+        },
+        .attachments = {
+                .attachment_formats = { wis::DataFormat::RGBA8Unorm }, .attachments_count = 1,
+                .depth_attachment = wis::DataFormat::Unknown, // No depth attachment
+        },
+        .flags = wis::PipelineFlags::DescriptorBuffer,
+    };
+    for (uint32_t i = 0; i < _pipeline_states.size(); i++) {
+        vortex::ShaderDefine defines[] = {
+            { "COLOR_RANGE", i / 2 },
+            { "COLOR_MATRIX", i % 2 },
+        };
+        auto pixel_shader = gfx.LoadShader("shaders/yuv_planar.ps", defines);
+        pipeline_desc.shaders.pixel = pixel_shader;
+        _pipeline_states[i] = device.CreateGraphicsPipeline(result, pipeline_desc);
+        if (!vortex::success(result)) {
+            vortex::error("YUVConverter: Failed to create pipeline state: {}", result.error);
+            return;
+        }
+    }
+
+    wis::SamplerDesc sampler_desc{
+        .min_filter = wis::Filter::Linear,
+        .mag_filter = wis::Filter::Linear,
+        .mip_filter = wis::Filter::Point,
+        .anisotropic = false,
+        .max_anisotropy = 1,
+        .address_u = wis::AddressMode::ClampToEdge,
+        .address_v = wis::AddressMode::ClampToEdge,
+        .address_w = wis::AddressMode::ClampToEdge,
+        .min_lod = 0.f,
+        .max_lod = 1.f,
+        .mip_lod_bias = 0.f,
+        .comparison_op = wis::Compare::None,
+    };
+    _sampler = device.CreateSampler(result, sampler_desc);
+    if (!vortex::success(result)) {
+        vortex::error("YUVConverter: Failed to create sampler: {}", result.error);
+    }
+}
+
+bool vortex::ffmpeg::YUVConverter::IsSupported(const AVFrame& frame) noexcept
+{
+    const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(AVPixelFormat(frame.format));
+    if (!desc || desc->nb_components != 3 || (desc->flags & AV_PIX_FMT_FLAG_RGB) ||
+        !(desc->flags & AV_PIX_FMT_FLAG_PLANAR)) {
+        return false;
+    }
+    for (int i = 0; i < 3; i++) {
+        if (desc->comp[i].depth != 8 || desc->comp[i].plane != i || frame.linesize[i] <= 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+vortex::Texture2D vortex::ffmpeg::YUVConverter::Convert(const vortex::Graphics& gfx,
+                                                        const AVFrame& frame) const
+{
+    const AVPixFmtDescriptor* pix_desc = av_pix_fmt_desc_get(AVPixelFormat(frame.format));
+    auto& device = gfx.GetDevice();
+    auto& ext_alloc = gfx.GetExtendedAllocation();
+    wis::Result result = wis::success;
+
+    uint32_t width = uint32_t(frame.width);
+    uint32_t height = uint32_t(frame.height);
+    uint32_t chroma_width = uint32_t(AV_CEIL_RSHIFT(frame.width, pix_desc->log2_chroma_w));
+    uint32_t chroma_height = uint32_t(AV_CEIL_RSHIFT(frame.height, pix_desc->log2_chroma_h));
+
+    // Upload the planes with their padded rows, the shader scales the coordinates instead
+    std::array<vortex::Texture2D, 3> planes;
+    std::array<wis::ShaderResource, 3> plane_srvs;
+    for (uint32_t i = 0; i < planes.size(); i++) {
+        wis::TextureDesc desc{
+            .format = wis::DataFormat::R8Unorm,
+            .size = { uint32_t(frame.linesize[i]), i == 0 ? height : chroma_height },
+            .usage = wis::TextureUsage::HostCopy | wis::TextureUsage::ShaderResource,
+        };
+        wis::Texture texture = ext_alloc.CreateGPUUploadTexture(result, gfx.GetAllocator(), desc);
+        if (!vortex::success(result)) {
+            vortex::error("YUVConverter: Failed to create plane texture: {}", result.error);
+            return {};
+        }
+
+        wis::TextureRegion region{
+            .offset = { 0, 0, 0 },
+            .size = { desc.size.width, desc.size.height, 1 },
+            .mip = 0,
+            .array_layer = 0,
+            .format = wis::DataFormat::R8Unorm,
+        };
+        result = ext_alloc.WriteMemoryToSubresourceDirect(frame.data[i],
+                                                          texture,
+                                                          wis::TextureState::Common,
+                                                          region);
+        if (!vortex::success(result)) {
+            vortex::error("YUVConverter: Failed to write plane {}: {}", i, result.error);
+            return {};
+        }
+        planes[i] = vortex::Texture2D(std::move(texture),
+                                      { desc.size.width, desc.size.height },
+                                      desc.format);
+        plane_srvs[i] = planes[i].CreateShaderResource(gfx);
+    }
+
+    wis::TextureDesc output_desc{
+        .format = wis::DataFormat::RGBA8Unorm,
+        .size = { width, height, 1 },
+        .mip_levels = 1,
+        .layout = wis::TextureLayout::Texture2D,
+        .sample_count = wis::SampleRate::S1,
+        .usage = wis::TextureUsage::RenderTarget | wis::TextureUsage::ShaderResource,
+    };
+    vortex::Texture2D output(gfx.GetAllocator().CreateTexture(result,
+                                                              output_desc,
+                                                              wis::MemoryType::Default),
+                             { width, height },
+                             output_desc.format);
+    if (!vortex::success(result)) {
+        vortex::error("YUVConverter: Failed to create output texture: {}", result.error);
+        return {};
+    }
+    wis::RenderTarget rtv = output.CreateRenderTarget(gfx);
+
+    auto cmd_list = device.CreateCommandList(result, wis::QueueType::Graphics);
+    if (!vortex::success(result)) {
+        vortex::error("YUVConverter: Failed to create command list: {}", result.error);
+        return {};
+    }
+    auto fence = device.CreateFence(result);
+    if (!vortex::success(result)) {
+        vortex::error("YUVConverter: Failed to create fence: {}", result.error);
+        return {};
+    }
+
+    // One table of each kind, only used by this conversion
+    vortex::DescriptorBuffer descriptors(gfx, uint32_t(planes.size()), 1);
+    auto desc_table = descriptors.DescBufferView(0).SuballocateTable(uint32_t(planes.size()));
+    auto sampler_table = descriptors.SamplerBufferView(0).SuballocateTable(1);
+    for (uint32_t i = 0; i < planes.size(); i++) {
+        desc_table.WriteTexture(i, plane_srvs[i]);
+    }
+    sampler_table.WriteSampler(0, _sampler);
+
+    std::ignore = cmd_list.Reset();
+    descriptors.BindBuffers(gfx, cmd_list);
+    for (auto& plane : planes) {
+        cmd_list.TextureBarrier(
+                {
+                        .sync_before = wis::BarrierSync::None,
+                        .sync_after = wis::BarrierSync::Draw,
+                        .access_before = wis::ResourceAccess::NoAccess,
+                        .access_after = wis::ResourceAccess::ShaderResource,
+                        .state_before = wis::TextureState::Common,
+                        .state_after = wis::TextureState::ShaderResource,
+                },
+                plane.Get());
+    }
+    cmd_list.TextureBarrier(
+            {
+                    .sync_before = wis::BarrierSync::None,
+                    .sync_after = wis::BarrierSync::RenderTarget,
+                    .access_before = wis::ResourceAccess::NoAccess,
+                    .access_after = wis::ResourceAccess::RenderTarget,
+                    .state_before = wis::TextureState::Undefined,
+                    .state_after = wis::TextureState::RenderTarget,
+            },
+            output.Get());
+
+    wis::RenderPassRenderTargetDesc target_desc{
+        .target = rtv,
+        .load_op = wis::LoadOperation::DontCare,
+        .store_op = wis::StoreOperation::Store,
+    };
+    wis::RenderPassDesc pass_desc{
+        .target_count = 1,
+        .targets = &target_desc,
+    };
+
+    // JPEG stores BT.601 and rarely tags it, so untagged images are treated as BT.601
+    bool full_range = frame.color_range == AVCOL_RANGE_JPEG || frame.format == AV_PIX_FMT_YUVJ420P ||
+            frame.format == AV_PIX_FMT_YUVJ422P || frame.format == AV_PIX_FMT_YUVJ444P ||
+            frame.format == AV_PIX_FMT_YUVJ440P || frame.format == AV_PIX_FMT_YUVJ411P;
+    bool bt709 = frame.colorspace == AVCOL_SPC_BT709;
+    PlaneConstants constants{
+        .luma_scale = float(width) / float(frame.linesize[0]),
+        .chroma_scale = float(chroma_width) / float(frame.linesize[1]),
+    };
+
+    cmd_list.BeginRenderPass(pass_desc);
+    cmd_list.SetPipelineState(_pipeline_states[size_t(full_range) * 2 + size_t(!bt709)]);
+    cmd_list.SetRootSignature(_root_signature);
+    cmd_list.SetPushConstants(&constants, sizeof(constants) / 4, 0, wis::ShaderStages::Pixel);
+    desc_table.BindOffset(gfx, cmd_list, _root_signature, 0);
+    sampler_table.BindOffset(gfx, cmd_list, _root_signature, 1);
+    cmd_list.RSSetScissor({ 0, 0, int(width), int(height) });
+    cmd_list.RSSetViewport({ 0.f, 0.f, float(width), float(height), 0.f, 1.f });
+    cmd_list.IASetPrimitiveTopology(wis::PrimitiveTopology::TriangleList);
+    cmd_list.DrawInstanced(3);
+    cmd_list.EndRenderPass();
+
+    cmd_list.TextureBarrier(
+            {
+                    .sync_before = wis::BarrierSync::RenderTarget,
+                    .sync_after = wis::BarrierSync::Draw,
+                    .access_before = wis::ResourceAccess::RenderTarget,
+                    .access_after = wis::ResourceAccess::ShaderResource,
+                    .state_before = wis::TextureState::RenderTarget,
+                    .state_after = wis::TextureState::ShaderResource,
+            },
+            output.Get());
+    cmd_list.Close();
+
+    // The planes and descriptors must outlive the GPU work
+    std::ignore = gfx.Submit({ cmd_list }, fence, 1);
+    std::ignore = fence.Wait(1);
+    return output;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <vortex/codec/ffmpeg/types.h>
+#include <vortex/gfx/texture.h>
+#include <array>
+
+namespace vortex {
+class Graphics;
+}
+
+namespace vortex::ffmpeg {
+// Converts decoded planar YUV images to RGBA on the GPU.
+// The planes are uploaded as the decoder produced them, no CPU pass touches the pixels.
+class YUVConverter
+{
+public:
+    explicit YUVConverter(const vortex::Graphics& gfx);
+
+public:
+    // 8-bit 3-plane YUV, any chroma subsampling
+    static bool IsSupported(const AVFrame& frame) noexcept;
+
+    /**
+     * Uploads the planes of the frame and converts them to an RGBA texture.
+     * Blocks the calling thread until the GPU is done, meant for loader threads.
+     * @return RGBA texture in the ShaderResource state, empty on failure.
+     */
+    vortex::Texture2D Convert(const vortex::Graphics& gfx, const AVFrame& frame) const;
+
+private:
+    wis::RootSignature _root_signature;
+    std::array<wis::PipelineState, 4> _pipeline_states; // Indexed by COLOR_RANGE * 2 + COLOR_MATRIX
+    wis::Sampler _sampler;
+};
+} // namespace vortex::ffmpeg
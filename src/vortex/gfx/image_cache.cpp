@@ -0,0 +1,75 @@
+#include <vortex/gfx/image_cache.h>
+#include <algorithm>
+
+vortex::ImageCache::ImageCache(const vortex::Graphics& gfx)
+    : _loader(gfx)
+{
+    // Decoding is CPU bound, a few workers are enough to load a whole template in parallel
+    uint32_t worker_count = std::clamp(std::thread::hardware_concurrency() / 2, 1u, 4u);
+    for (uint32_t i = 0; i < worker_count; i++) {
+        _workers.emplace_back([this](std::stop_token stop) { WorkerLoop(stop); });
+    }
+}
+
+std::shared_future<vortex::ImageHandle>
+vortex::ImageCache::Load(const std::filesystem::path& path)
+{
+    std::error_code ec;
+    auto mtime = std::filesystem::last_write_time(path, ec);
+    auto key = std::filesystem::weakly_canonical(path, ec).string();
+
+    std::unique_lock lock(_mutex);
+
+    // Drop entries nobody uses anymore
+    std::erase_if(_entries, [](const auto& pair) {
+        return !pair.second.pending.valid() && pair.second.image.expired();
+    });
+
+    auto& entry = _entries[key];
+    if (entry.mtime == mtime) {
+        if (entry.pending.valid()) {
+            return entry.pending; // Already loading
+        }
+        if (auto image = entry.image.lock()) {
+            std::promise<ImageHandle> ready;
+            ready.set_value(std::move(image));
+            return ready.get_future().share();
+        }
+    }
+
+    // New file, or the file changed on disk
+    std::promise<ImageHandle> promise;
+    entry = { .mtime = mtime, .pending = promise.get_future().share(), .image = {} };
+    _jobs.push_back({ .key = std::move(key),
+                      .path = path,
+                      .mtime = mtime,
+                      .promise = std::move(promise) });
+    _jobs_cv.notify_one();
+    return entry.pending;
+}
+
+void vortex::ImageCache::WorkerLoop(std::stop_token stop)
+{
+    while (!stop.stop_requested()) {
+        std::unique_lock lock(_mutex);
+        if (!_jobs_cv.wait(lock, stop, [this] { return !_jobs.empty(); })) {
+            return; // Stop requested
+        }
+        Job job = std::move(_jobs.front());
+        _jobs.pop_front();
+        lock.unlock();
+
+        ImageHandle image = _loader.Load(job.path);
+
+        // Hand the image over to a weak reference before resolving,
+        // so the last node releasing it frees the texture
+        lock.lock();
+        if (auto it = _entries.find(job.key); it != _entries.end() && it->second.mtime == job.mtime) {
+            it->second.pending = {};
+            it->second.image = image;
+        }
+        lock.unlock();
+
+        job.promise.set_value(std::move(image));
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <vortex/gfx/image_loader.h>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace vortex {
+// Loads images on a pool of worker threads and shares the textures between all users of a file.
+// Entries are keyed by path and modification time and live as long as any handle to them does.
+class ImageCache
+{
+public:
+    explicit ImageCache(const vortex::Graphics& gfx);
+
+public:
+    /**
+     * Starts loading the image, or joins the load that is already running for the same file.
+     * @param path Path to the image file.
+     * @return Future of the image, resolves to an empty handle if the image failed to load.
+     */
+    std::shared_future<ImageHandle> Load(const std::filesystem::path& path);
+
+private:
+    struct Job {
+        std::string key;
+        std::filesystem::path path;
+        std::filesystem::file_time_type mtime;
+        std::promise<ImageHandle> promise;
+    };
+    struct Entry {
+        std::filesystem::file_time_type mtime;
+        std::shared_future<ImageHandle> pending; // Reset once loaded, the cache does not own images
+        std::weak_ptr<const CachedImage> image;
+    };
+
+private:
+    void WorkerLoop(std::stop_token stop);
+
+private:
+    vortex::ImageLoader _loader;
+
+    std::mutex _mutex;
+    std::condition_variable_any _jobs_cv;
+    std::deque<Job> _jobs;
+    std::unordered_map<std::string, Entry> _entries;
+
+    std::vector<std::jthread> _workers; // Declared last, stopped before the queue is destroyed
+};
+} // namespace vortex
@@ -0,0 +1,71 @@
+#include <vortex/gfx/image_loader.h>
+#include <vortex/codec/ffmpeg/codec_ffmpeg.h>
+#include <vortex/graphics.h>
+#include <vortex/util/log.h>
+
+vortex::ImageLoader::ImageLoader(const vortex::Graphics& gfx)
+    : _gfx(gfx)
+    , _converter(gfx)
+{
+}
+
+vortex::ImageHandle vortex::ImageLoader::Load(const std::filesystem::path& path) const
+{
+    auto frame = codec::CodecFFmpeg::DecodeImage(path);
+    if (!frame) {
+        return {}; // Error is logged by the codec
+    }
+    return Upload(*frame.value().get());
+}
+
+vortex::ImageHandle vortex::ImageLoader::Upload(const AVFrame& frame) const
+{
+    // Planar YUV is converted on the GPU, everything else is converted by swscale
+    auto image = std::make_shared<CachedImage>();
+    if (ffmpeg::YUVConverter::IsSupported(frame)) {
+        image->texture = _converter.Convert(_gfx, frame);
+    }
+    if (!image->texture) {
+        auto result = codec::CodecFFmpeg::UploadRGBA(_gfx, frame);
+        if (!result || !TransitionToShaderResource(result.value())) {
+            return {};
+        }
+        image->texture = std::move(result.value());
+    }
+    image->srv = image->texture.CreateShaderResource(_gfx);
+    return image;
+}
+
+bool vortex::ImageLoader::TransitionToShaderResource(const vortex::Texture2D& texture) const
+{
+    // Done here with a private fence, so the render loop never waits
+    wis::Result res = wis::success;
+    auto& device = _gfx.GetDevice();
+    auto cmd_list = device.CreateCommandList(res, wis::QueueType::Graphics);
+    if (!vortex::success(res)) {
+        vortex::error("ImageLoader: Failed to create command list: {}", res.error);
+        return false;
+    }
+    auto fence = device.CreateFence(res);
+    if (!vortex::success(res)) {
+        vortex::error("ImageLoader: Failed to create fence: {}", res.error);
+        return false;
+    }
+
+    std::ignore = cmd_list.Reset();
+    cmd_list.TextureBarrier(
+            {
+                    .sync_before = wis::BarrierSync::None,
+                    .sync_after = wis::BarrierSync::None,
+                    .access_before = wis::ResourceAccess::NoAccess,
+                    .access_after = wis::ResourceAccess::NoAccess,
+                    .state_before = wis::TextureState::Undefined,
+                    .state_after = wis::TextureState::ShaderResource,
+            },
+            texture.Get());
+    cmd_list.Close();
+
+    std::ignore = _gfx.Submit({ cmd_list }, fence, 1);
+    std::ignore = fence.Wait(1);
+    return true;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <vortex/gfx/texture.h>
+#include <vortex/codec/ffmpeg/yuv_converter.h>
+#include <filesystem>
+#include <memory>
+
+namespace vortex {
+class Graphics;
+
+// Decoded image, resident on the GPU and ready to be sampled
+struct CachedImage {
+    vortex::Texture2D texture;
+    wis::ShaderResource srv;
+};
+using ImageHandle = std::shared_ptr<const CachedImage>;
+
+// Turns decoded frames into sampled textures. Blocks the calling thread until the GPU is done,
+// so it is meant for loader threads. Safe to use from several threads at once.
+class ImageLoader
+{
+public:
+    explicit ImageLoader(const vortex::Graphics& gfx);
+
+public:
+    // Decodes the first frame of the file and uploads it, empty handle on failure
+    ImageHandle Load(const std::filesystem::path& path) const;
+
+    // Uploads a decoded frame, empty handle on failure
+    ImageHandle Upload(const AVFrame& frame) const;
+
+private:
+    bool TransitionToShaderResource(const vortex::Texture2D& texture) const;
+
+private:
+    const vortex::Graphics& _gfx;
+    ffmpeg::YUVConverter _converter; // Converts planar YUV images on the GPU
+};
+} // namespace vortex
@@ -42,6 +42,14 @@ private:
     }
 
 public:
+    UseTextureView(const UseTextureView&) = delete;
+    UseTextureView& operator=(const UseTextureView&) = delete;
+    UseTextureView(UseTextureView&& other) noexcept
+        : texture_index(std::exchange(other.texture_index, std::uint32_t(npos)))
+        , previous_gen(other.previous_gen)
+        , parent_entry(other.parent_entry)
+    {
+    }
     ~UseTextureView() noexcept;
     operator bool() const noexcept { return texture_index != npos; }
 
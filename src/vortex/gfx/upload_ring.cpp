@@ -0,0 +1,22 @@
+#include <vortex/gfx/upload_ring.h>
+#include <vortex/graphics.h>
+#include <vortex/util/log.h>
+
+vortex::UploadRing::UploadRing(const vortex::Graphics& gfx, uint64_t slot_size, uint32_t slot_count)
+    : _slot_size(wis::aligned_size(slot_size, placement_alignment))
+    , _slot_count(slot_count)
+{
+    wis::Result result = wis::success;
+    _buffer = gfx.GetAllocator().CreateBuffer(result,
+                                              _slot_size * _slot_count,
+                                              wis::BufferUsage::CopySrc,
+                                              wis::MemoryType::Upload,
+                                              wis::MemoryFlags::Mapped);
+    if (!vortex::success(result)) {
+        vortex::error("UploadRing: Failed to create upload buffer: {}", result.error);
+        _slot_size = 0;
+        _slot_count = 0;
+        return;
+    }
+    _mapped = _buffer.Map<std::byte>();
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <wisdom/wisdom.hpp>
+#include <vortex/consts.h>
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <utility>
+
+namespace vortex {
+class Graphics;
+
+// Persistently mapped upload buffer split into equal slots, one per frame in flight by default.
+// The owner decides when a slot may be rewritten, e.g. when its frame index comes around again
+// and the output has waited for the GPU to finish reading it.
+class UploadRing
+{
+public:
+    static constexpr uint64_t placement_alignment = 512; // Texture copies on D3D12 start at 512 bytes
+    static constexpr uint32_t row_pitch_alignment = 256; // and read rows at 256 byte strides
+
+public:
+    UploadRing() = default;
+    UploadRing(const vortex::Graphics& gfx, uint64_t slot_size, uint32_t slot_count = max_frames_in_flight);
+    UploadRing(const UploadRing&) = delete;
+    UploadRing& operator=(const UploadRing&) = delete;
+    UploadRing(UploadRing&& other) noexcept
+        : _buffer(std::move(other._buffer))
+        , _mapped(std::exchange(other._mapped, nullptr))
+        , _slot_size(std::exchange(other._slot_size, 0))
+        , _slot_count(std::exchange(other._slot_count, 0))
+    {
+    }
+    UploadRing& operator=(UploadRing&& other) noexcept
+    {
+        if (this != &other) {
+            Unmap();
+            _buffer = std::move(other._buffer);
+            _mapped = std::exchange(other._mapped, nullptr);
+            _slot_size = std::exchange(other._slot_size, 0);
+            _slot_count = std::exchange(other._slot_count, 0);
+        }
+        return *this;
+    }
+    ~UploadRing() { Unmap(); }
+
+    explicit operator bool() const noexcept { return _mapped != nullptr; }
+
+public:
+    [[nodiscard]] uint64_t GetSlotSize() const noexcept { return _slot_size; }
+    [[nodiscard]] uint32_t GetSlotCount() const noexcept { return _slot_count; }
+    [[nodiscard]] uint64_t GetSlotOffset(uint32_t index) const noexcept
+    {
+        assert(index < _slot_count);
+        return _slot_size * index;
+    }
+    [[nodiscard]] std::span<std::byte> GetSlot(uint32_t index) noexcept
+    {
+        return { _mapped + GetSlotOffset(index), std::size_t(_slot_size) };
+    }
+    [[nodiscard]] wis::BufferView GetBuffer() const noexcept { return _buffer; }
+
+private:
+    void Unmap() noexcept
+    {
+        if (_mapped) {
+            _buffer.Unmap();
+            _mapped = nullptr;
+        }
+    }
+
+private:
+    wis::Buffer _buffer;
+    std::byte* _mapped = nullptr;
+    uint64_t _slot_size = 0;
+    uint32_t _slot_count = 0;
+};
+} // namespace vortex
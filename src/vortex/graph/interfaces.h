@@ -3,6 +3,7 @@
 #include <vortex/graph/ports.h>
 #include <vortex/util/reflection.h>
 #include <vortex/properties/type_traits.h>
+#include <vortex/util/rect.h>
 
 namespace vortex {
 class Graphics; // Forward declaration of Graphics class
@@ -42,6 +43,41 @@ struct alignas(16) INode {
         return false;
     };
     virtual void EvaluateAudio(AudioProbe& probe) { };
+    // Called instead of Evaluate for inputs that are connected but not rendered this frame.
+    // Nodes keep their state current without drawing, so they can be shown without a hitch.
+    virtual void EvaluateStandby(const vortex::Graphics& gfx, RenderProbe& probe)
+    {
+        for (auto& sink : GetSinks()) {
+            if (sink) {
+                sink.source_node->EvaluateStandby(gfx, probe);
+            }
+        }
+    }
+    // Returns true if the node leaves its first input unchanged with the current properties.
+    // Pass-through nodes are skipped by EvaluateThrough, their input renders into the target.
+    virtual bool IsPassThrough() const noexcept { return false; }
+    // Evaluates the node into the target, or the first node below a chain of pass-through nodes.
+    // Consumers evaluate their inputs through it.
+    bool EvaluateThrough(const vortex::Graphics& gfx,
+                         RenderProbe& probe,
+                         const RenderPassForwardDesc* output_info = nullptr)
+    {
+        INode* node = this;
+        while (node->IsPassThrough()) {
+            auto sinks = node->GetSinks();
+            if (sinks.empty() || !sinks[0]) {
+                return false;
+            }
+            node = sinks[0].source_node;
+        }
+        return node->Evaluate(gfx, probe, output_info);
+    }
+    // Normalized region of an output of the given size the node draws with the current
+    // properties, everything outside stays transparent. Consumers scissor their passes to it.
+    virtual DirectX::XMFLOAT4 GetOutputBounds(wis::Size2D output_size) noexcept
+    {
+        return full_rect;
+    }
     virtual void SetPropertyUpdateNotifier(UpdateNotifier notifier) { }
     constexpr virtual NodeType GetType() const noexcept
     {
@@ -74,6 +110,10 @@ struct alignas(16) INode {
     {
         return {}; // Default implementation returns empty span
     }
+    virtual std::span<Sink> ReserveSinks(std::size_t)
+    {
+        return GetSinks(); // Fixed sink count by default
+    }
 };
 struct IOutput : public INode {
     virtual vortex::ratio32_t GetOutputFPS() const noexcept = 0; ///< Get the output FPS
@@ -100,11 +140,13 @@ struct NodeImpl : public Base, public Properties {
     static constexpr bool has_lazy_data = requires {
         CRTP::LazyData;
     }; ///< Check if the CRTP class has LazyData
+    static constexpr bool has_dynamic_sinks = sinks == dynamic_ports;
     static constexpr StaticNodeInfo static_info = {
-        .sinks = sinks,
+        .sinks = has_dynamic_sinks ? 0 : sinks,
         .sources = sources,
+        .dynamic_sinks = has_dynamic_sinks,
     };
-    using Sinks = SinkArray<sinks>;
+    using Sinks = SinkStorage<sinks>;
     using Sources = SourceArray<sources>;
     using ImplClass = NodeImpl<CRTP, Properties, sinks, sources, strategy, Base>;
 
@@ -184,6 +226,14 @@ public:
     }
     virtual std::span<Sink> GetSinks() noexcept override { return _sinks.GetSinks(); }
     virtual std::span<Source> GetSources() noexcept override { return _sources.GetSources(); }
+    virtual std::span<Sink> ReserveSinks(std::size_t count) override
+    {
+        if constexpr (has_dynamic_sinks) {
+            return _sinks.ReserveSinks(count);
+        } else {
+            return _sinks.GetSinks();
+        }
+    }
 
     // Called from the node factory to initialize the node
     void SetInitialized() noexcept { _initialized = true; }
@@ -2,6 +2,7 @@
 #include <limits>
 #include <span>
 #include <array>
+#include <vector>
 #include <unordered_set>
 #include <vortex/consts.h>
 #include <bitset>
@@ -25,6 +26,10 @@ enum class RenderStrategy {
     Bypass, // Bypass this source entirely
 };
 
+// Port count marker for nodes with a variable number of ports (grows on connection)
+inline constexpr std::uint32_t dynamic_ports = std::numeric_limits<std::uint32_t>::max();
+inline constexpr std::uint32_t max_dynamic_ports = 64; // Upper bound for dynamic port growth
+
 struct Sink {
     static constexpr std::size_t dynamic_index = std::numeric_limits<std::size_t>::max(); // Invalid index for sink
 
@@ -59,6 +64,14 @@ struct SinkArray<Sink::dynamic_index> {
     {
         return sinks;
     }
+    // Grows the sink list to at least count entries, existing connections are preserved
+    std::span<Sink> ReserveSinks(std::size_t count)
+    {
+        if (count > sinks.size() && count <= max_dynamic_ports) {
+            sinks.resize(count);
+        }
+        return sinks;
+    }
 };
 
 template<>
@@ -71,6 +84,9 @@ struct SinkArray<0> {
 using EmptySinks = SinkArray<0>; // Empty sink array specialization
 using SinkVector = SinkArray<Sink::dynamic_index>;
 
+template<std::uint32_t N>
+using SinkStorage = SinkArray<N == dynamic_ports ? Sink::dynamic_index : std::size_t(N)>;
+
 struct SourceTarget {
     std::size_t sink_index = 0; // Index of the source in the node
     INode* sink_node = nullptr; // Pointer to the node that is the source
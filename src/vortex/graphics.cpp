@@ -64,6 +64,23 @@ wis::Shader vortex::Graphics::LoadShader(std::filesystem::path path) const
     return result_shader;
 }
 
+wis::Shader vortex::Graphics::LoadShader(std::filesystem::path path,
+                                         std::span<const ShaderDefine> defines) const
+{
+    // Insert the defines between the name and the stage, "video.ps" -> "video-COLOR_RANGE_1.ps"
+    std::string filename = path.filename().string();
+    size_t stage = filename.find('.');
+    std::string name = filename.substr(0, stage);
+    for (const auto& define : defines) {
+        name += std::format("-{}_{}", define.name, define.value);
+    }
+    if (stage != std::string::npos) {
+        name += filename.substr(stage);
+    }
+    path.replace_filename(name);
+    return LoadShader(std::move(path));
+}
+
 void vortex::Graphics::CreateDevice(bool debug_extension)
 {
     wis::Result result = wis::success;
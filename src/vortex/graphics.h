@@ -4,8 +4,17 @@
 #include <wisdom/wisdom_extended_allocation.hpp>
 #include <vortex/util/log_storage.h>
 #include <vortex/platform.h>
+#include <mutex>
+#include <span>
+#include <string_view>
 
 namespace vortex {
+// Compile-time define of a shader permutation, see vortex_add_shader_permutations
+struct ShaderDefine {
+    std::string_view name;
+    uint32_t value = 0;
+};
+
 class Debug
 {
     static void DebugCallback(wis::Severity severity, const char* message, void* user_data)
@@ -42,6 +51,8 @@ public:
 public:
     const wis::Device& GetDevice() const noexcept { return _device; }
     const vortex::PlatformExtension& GetPlatform() const noexcept { return _platform; }
+    // Shared by the render loop and the loader threads. Submit through the functions below,
+    // anything else that touches the queue (swapchain present, resize) must hold LockMainQueue.
     const wis::CommandQueue& GetMainQueue() const noexcept { return _main_queue; }
     const wis::ResourceAllocator& GetAllocator() const noexcept { return _allocator; }
     const wis::ExtendedAllocation& GetExtendedAllocation() const noexcept
@@ -55,17 +66,46 @@ public:
 
 public:
     wis::Shader LoadShader(std::filesystem::path path) const;
+    // Loads the variant compiled with the defines, given in the order of the permutation axes.
+    // "shaders/video.ps" with { COLOR_RANGE, 1 } loads "shaders/video-COLOR_RANGE_1.ps"
+    wis::Shader LoadShader(std::filesystem::path path, std::span<const ShaderDefine> defines) const;
     void Throttle() const
     {
-        auto& q = GetMainQueue();
-        std::ignore = q.SignalQueue(_fence, ++_fence_value);
-        std::ignore = _fence.Wait(_fence_value);
+        uint64_t value = 0;
+        {
+            std::scoped_lock lock{ _queue_mutex };
+            value = ++_fence_value;
+            std::ignore = _main_queue.SignalQueue(_fence, value);
+        }
+        std::ignore = _fence.Wait(value);
     }
     void WaitForGPU() const { Throttle(); }
     void ExecuteCommandLists(std::initializer_list<wis::CommandListView> lists) const
     {
+        std::scoped_lock lock{ _queue_mutex };
         _main_queue.ExecuteCommandLists(lists.begin(), lists.size());
     }
+    wis::Result SignalQueue(const wis::Fence& fence, uint64_t value) const
+    {
+        std::scoped_lock lock{ _queue_mutex };
+        return _main_queue.SignalQueue(fence, value);
+    }
+    wis::Result WaitQueue(const wis::Fence& fence, uint64_t value) const
+    {
+        std::scoped_lock lock{ _queue_mutex };
+        return _main_queue.WaitQueue(fence, value);
+    }
+    // Executes the lists and signals the fence once they are done, for threads that wait on their own fence
+    wis::Result Submit(std::initializer_list<wis::CommandListView> lists, const wis::Fence& fence, uint64_t value) const
+    {
+        std::scoped_lock lock{ _queue_mutex };
+        _main_queue.ExecuteCommandLists(lists.begin(), lists.size());
+        return _main_queue.SignalQueue(fence, value);
+    }
+    [[nodiscard]] std::unique_lock<std::mutex> LockMainQueue() const
+    {
+        return std::unique_lock{ _queue_mutex };
+    }
 
 private:
     void CreateDevice(bool debug_extension);
@@ -75,6 +115,7 @@ private:
     Debug _debug;
     wis::Device _device;
     wis::CommandQueue _main_queue;
+    mutable std::mutex _queue_mutex; // Vulkan queues are externally synchronized
     wis::ResourceAllocator _allocator;
 
     vortex::PlatformExtension _platform;
@@ -146,6 +146,9 @@ bool vortex::graph::GraphModel::ConnectNodes(uintptr_t node_ptr_from,
         vortex::error("Invalid output index {} for node {}", output_index, from_node->GetInfo());
         return false; // Invalid output index
     }
+    if (input_index >= static_cast<int32_t>(to_sinks.size())) {
+        to_sinks = to_node->ReserveSinks(input_index + 1); // Nodes with dynamic sinks grow here
+    }
     if (input_index < 0 || input_index >= static_cast<int32_t>(to_sinks.size())) {
         vortex::error("Invalid input index {} for node {}", input_index, to_node->GetInfo());
         return false; // Invalid input index
@@ -71,6 +71,12 @@ constexpr size_t blend_desc_count = std::size(blend_descs);
 static_assert(blend_desc_count == vortex::BlendLazy::hw_blend_mode_count,
               "Blend desc count mismatch");
 
+const wis::BlendAttachmentDesc& vortex::BlendLazy::GetBlendDesc(BlendMode mode) noexcept
+{
+    uint32_t index = static_cast<uint32_t>(mode);
+    return blend_descs[index < blend_desc_count ? index : 0]; // Default to Normal if out of range
+}
+
 vortex::BlendLazy::BlendLazy(const vortex::Graphics& gfx)
 {
     auto& device = gfx.GetDevice();
@@ -164,6 +170,17 @@ vortex::Blend::Blend(const vortex::Graphics& gfx, SerializedProperties props)
 {
 }
 
+DirectX::XMFLOAT4 vortex::Blend::GetOutputBounds(wis::Size2D output_size) noexcept
+{
+    DirectX::XMFLOAT4 bounds = empty_rect;
+    for (auto& sink : GetSinks()) {
+        if (sink) {
+            bounds = UnionRect(bounds, sink.source_node->GetOutputBounds(output_size));
+        }
+    }
+    return bounds;
+}
+
 bool vortex::Blend::Evaluate(const vortex::Graphics& gfx,
                              RenderProbe& probe,
                              const RenderPassForwardDesc* output_info)
@@ -173,7 +190,7 @@ bool vortex::Blend::Evaluate(const vortex::Graphics& gfx,
     bool source_valid = false;
 
     if (input_base) {
-        input_base.source_node->Evaluate(gfx, probe, output_info);
+        input_base.source_node->EvaluateThrough(gfx, probe, output_info);
         // Block the texture used by the base input to avoid overwriting
         probe.texture_pool.BlockTexture(output_info->rt_index);
         source_valid = true;
@@ -185,6 +202,13 @@ bool vortex::Blend::Evaluate(const vortex::Graphics& gfx,
         return source_valid; // No overlay image, nothing to blend
     }
 
+    // Only pixels the overlay draws are blended, e.g. a lower third over a full frame
+    auto overlay_bounds = IntersectRect(output_info->clip_rect,
+                                        input_overlay.source_node->GetOutputBounds(output_info->output_size));
+    if (IsEmptyRect(overlay_bounds)) {
+        return source_valid;
+    }
+
     auto view = probe.texture_pool.AcquireTexture(gfx,
                                                   output_info->depth,
                                                   output_info->rt_generation);
@@ -202,7 +226,7 @@ bool vortex::Blend::Evaluate(const vortex::Graphics& gfx,
         .depth = output_info->depth + 1,
     };
 
-    input_overlay.source_node->Evaluate(gfx, probe, &info);
+    input_overlay.source_node->EvaluateThrough(gfx, probe, &info);
 
     auto root = _lazy_data.uget().GetRootSignature();
     auto pipeline = _lazy_data.uget().GetPipelineState(GetBlendMode());
@@ -236,8 +260,7 @@ bool vortex::Blend::Evaluate(const vortex::Graphics& gfx,
     desc_table.BindOffset(gfx, cmd, _lazy_data.uget().GetRootSignature(), 0);
     samp_table.WriteSampler(0, _lazy_data.uget().GetSampler());
     samp_table.BindOffset(gfx, cmd, _lazy_data.uget().GetRootSignature(), 1);
-    cmd.RSSetScissor(
-            { 0, 0, int(output_info->output_size.width), int(output_info->output_size.height) });
+    cmd.RSSetScissor(output_info->GetScissor(overlay_bounds));
     cmd.RSSetViewport({ 0.f,
                         0.f,
                         float(output_info->output_size.width),
@@ -14,6 +14,8 @@ public:
     BlendLazy(const vortex::Graphics& gfx);
 
 public:
+    // Hardware blend state for the mode, shared with other nodes that blend layers
+    static const wis::BlendAttachmentDesc& GetBlendDesc(BlendMode mode) noexcept;
     wis::RootSignatureView GetRootSignature() const noexcept { return _root_signature; }
     wis::PipelineView GetPipelineState(BlendMode mode) const noexcept
     {
@@ -42,6 +44,7 @@ public:
     virtual bool Evaluate(const vortex::Graphics& gfx,
                           RenderProbe& probe,
                           const RenderPassForwardDesc* output_info = nullptr) override;
+    DirectX::XMFLOAT4 GetOutputBounds(wis::Size2D output_size) noexcept override;
 
 private:
     [[no_unique_address]] lazy_ptr<BlendLazy> _lazy_data; // Lazy data for static resources
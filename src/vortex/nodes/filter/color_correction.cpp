@@ -3,10 +3,12 @@
 #include <vortex/probe.h>
 
 struct ColorCorrectionConstants {
-    vortex::LUTInterp interp_mode;
     float brightness;
     float contrast;
     float saturation;
+    float padding;
+    DirectX::XMFLOAT4 domain_min; // LUT input domain, xyz used
+    DirectX::XMFLOAT4 domain_scale; // 1 / (domain_max - domain_min), xyz used
 };
 
 vortex::ColorCorrectionLazy::ColorCorrectionLazy(const vortex::Graphics& gfx)
@@ -55,9 +57,8 @@ vortex::ColorCorrectionLazy::ColorCorrectionLazy(const vortex::Graphics& gfx)
 
     // Load shaders
     auto vertex_shader = gfx.LoadShader("shaders/basic.vs");
-    auto pixel_shader = gfx.LoadShader("shaders/color_correction.ps");
 
-    // Create pipeline
+    // Create pipelines, one per LUT type and interpolation permutation
     wis::BlendStateDesc blend_desc{
         .attachment_count = 1,
     };
@@ -65,7 +66,6 @@ vortex::ColorCorrectionLazy::ColorCorrectionLazy(const vortex::Graphics& gfx)
         .root_signature = _root_signature,
         .shaders = {
             .vertex = vertex_shader,
-            .pixel = pixel_shader,
         },
         .attachments = {
             .attachment_formats = { wis::DataFormat::RGBA8Unorm },
@@ -74,9 +74,29 @@ vortex::ColorCorrectionLazy::ColorCorrectionLazy(const vortex::Graphics& gfx)
         },
         .blend = &blend_desc,
     };
-    _pipeline_state = device.CreateGraphicsPipeline(result, pipeline_desc);
+    for (size_t type = 0; type < lut_type_count; type++) {
+        for (size_t interp = 0; interp < lut_interp_count; interp++) {
+            vortex::ShaderDefine defines[] = {
+                { "LUT_TYPE", uint32_t(type) },
+                { "LUT_INTERP", uint32_t(interp) },
+            };
+            auto pixel_shader = gfx.LoadShader("shaders/color_correction.ps", defines);
+            pipeline_desc.shaders.pixel = pixel_shader;
+            _pipeline_states[type * lut_interp_count + interp] =
+                    device.CreateGraphicsPipeline(result, pipeline_desc);
+            if (!vortex::success(result)) {
+                vortex::error("ColorCorrection: Failed to create pipeline state: {}",
+                              result.error);
+                return;
+            }
+        }
+    }
+
+    auto baked_pixel_shader = gfx.LoadShader("shaders/color_correction_baked.ps");
+    pipeline_desc.shaders.pixel = baked_pixel_shader;
+    _pipeline_state_baked = device.CreateGraphicsPipeline(result, pipeline_desc);
     if (!vortex::success(result)) {
-        vortex::error("ColorCorrection: Failed to create pipeline state: {}", result.error);
+        vortex::error("ColorCorrection: Failed to create baked pipeline state: {}", result.error);
         return;
     }
 
@@ -126,6 +146,12 @@ vortex::ColorCorrection::ColorCorrection(const vortex::Graphics& gfx, Serialized
     : ImplClass(props)
     , _lazy_data(gfx)
 {
+    wis::Result result = wis::success;
+    _fence = gfx.GetDevice().CreateFence(result);
+    if (!vortex::success(result)) {
+        vortex::error("ColorCorrection: Failed to create fence: {}", result.error);
+    }
+
     if (!lut.empty()) {
         _lut_changed = true;
     }
@@ -147,11 +173,84 @@ void vortex::ColorCorrection::SetLut(std::string_view path, bool notify)
 
 void vortex::ColorCorrection::Update(const vortex::Graphics& gfx)
 {
+    FreeRetiredLUTs();
+    UpdateBakedLUT(gfx);
+
+    // Keep rendering with the current LUT until the new one is completely uploaded
+    if (_lut_job.valid()) {
+        if (_lut_job.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            return;
+        }
+        auto lut = _lut_job.get();
+        if (!_lut_changed) { // Drop the result if the path changed again while loading
+            SwapLUT(gfx, _lut, std::move(lut));
+        }
+    }
+
     if (_lut_changed) {
-        auto lut_path = GetLut();
-        LoadLUT(gfx, lut_path);
         _lut_changed = false;
+        std::filesystem::path lut_path = GetLut();
+        if (lut_path.empty()) {
+            SwapLUT(gfx, _lut, {});
+            return;
+        }
+        _lut_job = std::async(std::launch::async, [&gfx, lut_path = std::move(lut_path)]() {
+            return LoadLUT(gfx, lut_path);
+        });
+    }
+}
+
+void vortex::ColorCorrection::UpdateBakedLUT(const vortex::Graphics& gfx)
+{
+    if (_bake_job.valid()) {
+        if (_bake_job.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            return;
+        }
+        auto baked = _bake_job.get();
+        _baked_adjustments = _bake_job_adjustments;
+        SwapLUT(gfx, _baked_lut, std::move(baked));
+    }
+
+    // Animated adjustments change every frame, they stay on the arithmetic path
+    auto adjustments = GetAdjustments();
+    _stable_updates = adjustments == _last_adjustments ? _stable_updates + 1 : 0;
+    _last_adjustments = adjustments;
+
+    // A failed bake is not retried until the LUT or the adjustments change
+    constexpr uint32_t bake_after_updates = 3;
+    bool attempted = _baked_lut.source == _lut.source && _baked_adjustments == adjustments;
+    if (!_lut.source || _stable_updates < bake_after_updates || attempted) {
+        return;
     }
+    _bake_job_adjustments = adjustments;
+    _bake_job = std::async(std::launch::async, [&gfx, source = _lut.source, adjustments]() {
+        return BakeLUT(gfx, std::move(source), adjustments);
+    });
+}
+
+void vortex::ColorCorrection::SwapLUT(const vortex::Graphics& gfx, LutResource& target, LutResource lut)
+{
+    LutResource retired = std::exchange(target, std::move(lut));
+    if (retired.type == LutType::Undefined) {
+        return; // Nothing was sampled
+    }
+
+    // Frames that sampled it are submitted before the update, the signal follows them on the queue
+    if (!_fence || !vortex::success(gfx.SignalQueue(_fence, ++_fence_value))) {
+        vortex::error("ColorCorrection: Failed to signal the LUT fence, waiting for the GPU");
+        gfx.WaitForGPU();
+        return;
+    }
+    _retired_luts.push_back({ std::move(retired), _fence_value });
+}
+
+void vortex::ColorCorrection::FreeRetiredLUTs() noexcept
+{
+    if (_retired_luts.empty()) {
+        return;
+    }
+    uint64_t completed = _fence.GetCompletedValue();
+    std::erase_if(_retired_luts, [completed](const RetiredLUT& retired) { return retired.fence_value <= completed; });
 }
 
 bool vortex::ColorCorrection::Evaluate(const vortex::Graphics& gfx,
@@ -164,16 +263,12 @@ bool vortex::ColorCorrection::Evaluate(const vortex::Graphics& gfx,
         return false;
     }
 
-    // Check if we need to do any processing at all
-    bool has_lut = (_lut_type != LutType::Undefined);
-    bool has_adjustments = (GetBrightness() != 0.0f || 
-                           GetContrast() != 1.0f || 
-                           GetSaturation() != 1.0f);
-    
-    // If no LUT and no adjustments, just pass through
-    if (!has_lut && !has_adjustments) {
-        return input_base.source_node->Evaluate(gfx, probe, output_info);
+    // If no LUT and no adjustments, the input renders straight into our target
+    if (IsPassThrough()) {
+        return input_base.source_node->EvaluateThrough(gfx, probe, output_info);
     }
+    bool has_lut = (_lut.type != LutType::Undefined);
+    bool baked = has_lut && IsBakedLUTCurrent();
 
     // Render input to intermediate texture
     auto view = probe.texture_pool.AcquireTexture(gfx, output_info->depth, output_info->rt_generation);
@@ -190,7 +285,7 @@ bool vortex::ColorCorrection::Evaluate(const vortex::Graphics& gfx,
         .rt_generation = output_info->depth, // new RT, make it dependent
         .depth = output_info->depth + 1,
     };
-    bool eval = input_base.source_node->Evaluate(gfx, probe, &info);
+    bool eval = input_base.source_node->EvaluateThrough(gfx, probe, &info);
     if (!eval) {
         return false;
     }
@@ -207,7 +302,8 @@ bool vortex::ColorCorrection::Evaluate(const vortex::Graphics& gfx,
 
     // Apply color correction
     auto root = _lazy_data.uget().GetRootSignature();
-    auto pipeline = _lazy_data.uget().GetPipelineState();
+    auto interp = GetLutInterp();
+    auto pipeline = _lazy_data.uget().GetPipelineState(_lut.type, interp);
     auto desc_table = probe.descriptor_buffer.SuballocateTable(2);
     auto samp_table = probe.sampler_buffer.SuballocateTable(2);
 
@@ -223,34 +319,34 @@ bool vortex::ColorCorrection::Evaluate(const vortex::Graphics& gfx,
         .targets = &target_desc,
     };
     cmd.BeginRenderPass(pass_desc);
-    cmd.SetPipelineState(pipeline);
+    cmd.SetPipelineState(baked ? _lazy_data.uget().GetBakedPipelineState() : pipeline);
     cmd.SetRootSignature(root);
 
     // Bind descriptors
-    // If no LUT, bind the input texture to both slots (shader will detect 1D vs 3D)
-    desc_table.WriteTexture(0, has_lut ? _lut_srv : sr); // LUT texture (or dummy)
+    // If no LUT, bind the input texture to both slots, the no-LUT permutation never reads slot 0
+    desc_table.WriteTexture(0, baked ? _baked_lut.srv : has_lut ? _lut.srv : sr); // LUT (or dummy)
     desc_table.WriteTexture(1, sr); // Input texture
     desc_table.BindOffset(gfx, cmd, root, 0);
 
-    // Choose sampler based on LUT type and interpolation mode
-    auto interp = GetLutInterp();
-
-    // Bind samplers
-    samp_table.WriteSampler(0, _lazy_data.uget().GetSampler(interp));
+    // Bind samplers, the baked LUT is always filtered by hardware
+    samp_table.WriteSampler(0, _lazy_data.uget().GetSampler(baked ? LUTInterp::Trilinear : interp));
     samp_table.WriteSampler(1, _lazy_data.uget().GetSampler(LUTInterp::Trilinear));
     samp_table.BindOffset(gfx, cmd, root, 1);
 
     // Push constants
     ColorCorrectionConstants constants{
-        .interp_mode = interp,
         .brightness = GetBrightness(),
         .contrast = GetContrast(),
         .saturation = GetSaturation(),
+        .domain_min = { _lut.domain_min[0], _lut.domain_min[1], _lut.domain_min[2], 0.0f },
+        .domain_scale = { 1.0f / (_lut.domain_max[0] - _lut.domain_min[0]),
+                          1.0f / (_lut.domain_max[1] - _lut.domain_min[1]),
+                          1.0f / (_lut.domain_max[2] - _lut.domain_min[2]),
+                          0.0f },
     };
     cmd.SetPushConstants(&constants, sizeof(constants) / 4, 0, wis::ShaderStages::Pixel);
 
-    cmd.RSSetScissor(
-            { 0, 0, int(output_info->output_size.width), int(output_info->output_size.height) });
+    cmd.RSSetScissor(output_info->GetScissor());
     cmd.RSSetViewport({ 0.f,
                         0.f,
                         float(output_info->output_size.width),
@@ -275,42 +371,40 @@ bool vortex::ColorCorrection::Evaluate(const vortex::Graphics& gfx,
     return true;
 }
 
-void vortex::ColorCorrection::LoadLUT(const vortex::Graphics& gfx,
-                                      const std::filesystem::path& path)
+auto vortex::ColorCorrection::LoadLUT(const vortex::Graphics& gfx,
+                                      const std::filesystem::path& path) -> LutResource
 {
-    if (path.empty()) {
-        _lut_type = LutType::Undefined;
-        return;
-    }
-
     try {
         auto lut_data = LutLoader::LoadLut(path);
         if (lut_data.type == LutType::Undefined) {
             vortex::error("ColorCorrection: Failed to load LUT from: {}", path.string());
-            _lut_type = LutType::Undefined;
-            return;
+            return {};
         }
-        _lut_type = lut_data.type;
 
         // Make a texture for the LUT
-        CreateLUTTexture(gfx, lut_data);
-        vortex::info("ColorCorrection: Loaded {} LUT (size: {}) from: {}",
-                     _lut_type == LutType::Lut1D ? "1D" : "3D",
-                     lut_data.stride,
-                     path.string());
-
+        auto lut = CreateLUTTexture(gfx, lut_data);
+        if (lut.type != LutType::Undefined) {
+            vortex::info("ColorCorrection: Loaded {} LUT (size: {}) from: {}",
+                         lut.type == LutType::Lut1D ? "1D" : "3D",
+                         lut_data.stride,
+                         path.string());
+            lut.source = std::make_shared<const LutData>(std::move(lut_data));
+        }
+        return lut;
     } catch (const std::exception& e) {
         vortex::error("ColorCorrection: Exception loading LUT: {}", e.what());
-        _lut_type = LutType::Undefined;
+        return {};
     }
 }
 
-void vortex::ColorCorrection::CreateLUTTexture(const vortex::Graphics& gfx, const LutData& lut_data)
+auto vortex::ColorCorrection::CreateLUTTexture(const vortex::Graphics& gfx,
+                                               const LutData& lut_data) -> LutResource
 {
     auto& device = gfx.GetDevice();
     auto& upload_ext = gfx.GetExtendedAllocation();
     auto& allocator = gfx.GetAllocator();
 
+    LutResource lut;
     wis::Result result = wis::success;
     wis::TextureDesc tex_desc{
         .format = wis::DataFormat::RGBA32Float,
@@ -323,22 +417,23 @@ void vortex::ColorCorrection::CreateLUTTexture(const vortex::Graphics& gfx, cons
         .usage = wis::TextureUsage::ShaderResource | wis::TextureUsage::CopyDst |
                 wis::TextureUsage::HostCopy,
     };
-    _lut_texture = upload_ext.CreateGPUUploadTexture(result, allocator, tex_desc);
+    lut.texture = upload_ext.CreateGPUUploadTexture(result, allocator, tex_desc);
     if (!vortex::success(result)) {
         vortex::error("ColorCorrection: Failed to create LUT texture: {}", result.error);
-        return;
+        return {};
     }
-    // Upload data
+    // Upload data, the write is done by the host and is complete when the call returns
     wis::TextureRegion region{
         .size = { tex_desc.size.width, tex_desc.size.height, tex_desc.size.depth_or_layers },
         .format = tex_desc.format
     };
     result = upload_ext.WriteMemoryToSubresourceDirect(lut_data.data.get(),
-                                                       _lut_texture,
+                                                       lut.texture,
                                                        wis::TextureState::Common,
                                                        region);
     if (!vortex::success(result)) {
         vortex::error("ColorCorrection: Failed to upload LUT data: {}", result.error);
+        return {};
     }
 
     // Create SRV
@@ -352,8 +447,22 @@ void vortex::ColorCorrection::CreateLUTTexture(const vortex::Graphics& gfx, cons
             .layer_count = 1,
         },
     };
-    _lut_srv = device.CreateShaderResource(result, _lut_texture, srv_desc);
+    lut.srv = device.CreateShaderResource(result, lut.texture, srv_desc);
     if (!vortex::success(result)) {
         vortex::error("ColorCorrection: Failed to create LUT SRV: {}", result.error);
+        return {};
     }
+    lut.type = lut_data.type;
+    lut.domain_min = lut_data.domain_min;
+    lut.domain_max = lut_data.domain_max;
+    return lut;
+}
+
+auto vortex::ColorCorrection::BakeLUT(const vortex::Graphics& gfx,
+                                      std::shared_ptr<const LutData> source,
+                                      ColorAdjustments adjustments) -> LutResource
+{
+    auto lut = CreateLUTTexture(gfx, LutSampler::Bake(*source, adjustments));
+    lut.source = std::move(source);
+    return lut;
 }
@@ -2,9 +2,12 @@
 #include <vortex/graph/interfaces.h>
 #include <vortex/properties/props.hpp>
 #include <vortex/util/lazy.h>
-#include <vortex/util/lut_loader.h>
+#include <vortex/util/lut_sampler.h>
 #include <wisdom/wisdom.hpp>
+#include <array>
 #include <filesystem>
+#include <future>
+#include <vector>
 
 namespace vortex {
 struct ColorCorrectionLazy {
@@ -13,19 +16,39 @@ public:
 
 public:
     wis::RootSignatureView GetRootSignature() const noexcept { return _root_signature; }
-    wis::PipelineView GetPipelineState() const noexcept { return _pipeline_state; }
+    // Shader permutation for the LUT type and interpolation, no mode branches in the shader
+    wis::PipelineView GetPipelineState(LutType type, LUTInterp interp) const noexcept
+    {
+        return _pipeline_states[size_t(type) * lut_interp_count + size_t(interp)];
+    }
+    wis::PipelineView GetBakedPipelineState() const noexcept { return _pipeline_state_baked; }
     wis::SamplerView GetSampler(LUTInterp interp) const noexcept
     {
         return (interp == LUTInterp::Trilinear) ? _sampler_linear : _sampler_point;
     }
 
+public:
+    static constexpr size_t lut_type_count = 3; // Undefined (no LUT), 1D, 3D
+    static constexpr size_t lut_interp_count = std::size(enum_traits<LUTInterp>::strings);
+
 private:
     wis::RootSignature _root_signature;
-    wis::PipelineState _pipeline_state;
+    std::array<wis::PipelineState, lut_type_count * lut_interp_count> _pipeline_states;
+    wis::PipelineState _pipeline_state_baked; // Single fetch from a baked LUT
     wis::Sampler _sampler_linear; // Linear sampling for texture
     wis::Sampler _sampler_point; // Point sampling for 1D LUT
 };
 
+// GPU resources of a loaded LUT
+struct LutResource {
+    wis::Texture texture;
+    wis::ShaderResource srv;
+    LutType type = LutType::Undefined;
+    std::array<float, 3> domain_min{ 0.0f, 0.0f, 0.0f };
+    std::array<float, 3> domain_max{ 1.0f, 1.0f, 1.0f };
+    std::shared_ptr<const LutData> source; // CPU data of the loaded LUT, used for baking
+};
+
 // Color correction node applies LUT-based color grading
 class ColorCorrection : public vortex::graph::FilterImpl<ColorCorrection,
                                                          ColorCorrectionProperties,
@@ -42,20 +65,63 @@ public:
     virtual bool Evaluate(const vortex::Graphics& gfx,
                           RenderProbe& probe,
                           const RenderPassForwardDesc* output_info = nullptr) override;
+    DirectX::XMFLOAT4 GetOutputBounds(wis::Size2D output_size) noexcept override
+    {
+        auto& input_base = GetSinks()[0];
+        return input_base ? input_base.source_node->GetOutputBounds(output_size) : empty_rect;
+    }
+    bool IsPassThrough() const noexcept override
+    {
+        return _lut.type == LutType::Undefined && GetBrightness() == 0.0f &&
+                GetContrast() == 1.0f && GetSaturation() == 1.0f;
+    }
 
     // Property change handlers
     void SetLut(std::string_view path, bool notify = true);
 
 private:
-    void LoadLUT(const vortex::Graphics& gfx, const std::filesystem::path& path);
-    void CreateLUTTexture(const vortex::Graphics& gfx, const LutData& lut_data);
+    // Run on a worker thread, the result is swapped in by Update once it is ready
+    static LutResource LoadLUT(const vortex::Graphics& gfx, const std::filesystem::path& path);
+    static LutResource CreateLUTTexture(const vortex::Graphics& gfx, const LutData& lut_data);
+    static LutResource BakeLUT(const vortex::Graphics& gfx,
+                               std::shared_ptr<const LutData> source,
+                               ColorAdjustments adjustments);
+
+    // The replaced LUT is freed once the frames submitted before the swap are done with it
+    void SwapLUT(const vortex::Graphics& gfx, LutResource& target, LutResource lut);
+    void FreeRetiredLUTs() noexcept;
+    void UpdateBakedLUT(const vortex::Graphics& gfx);
+
+    ColorAdjustments GetAdjustments() const noexcept
+    {
+        return { GetBrightness(), GetContrast(), GetSaturation(), GetLutInterp() };
+    }
+    bool IsBakedLUTCurrent() const noexcept
+    {
+        return _baked_lut.type != LutType::Undefined && _baked_lut.source == _lut.source &&
+                _baked_adjustments == GetAdjustments();
+    }
 
 private:
     [[no_unique_address]] lazy_ptr<ColorCorrectionLazy> _lazy_data;
 
-    wis::Texture _lut_texture;
-    wis::ShaderResource _lut_srv;
-    LutType _lut_type = LutType::Undefined;
+    LutResource _lut; // LUT used for rendering
+    struct RetiredLUT {
+        LutResource lut;
+        uint64_t fence_value = 0; // Signalled after the last frame that could sample it
+    };
+    std::vector<RetiredLUT> _retired_luts; // Still in flight
+    wis::Fence _fence; // Signalled on the main queue when a LUT is retired
+    uint64_t _fence_value = 0;
+    std::future<LutResource> _lut_job; // Pending background load
     bool _lut_changed = false;
+
+    // LUT with the adjustments baked in, replaces the arithmetic while they are not animated
+    LutResource _baked_lut;
+    ColorAdjustments _baked_adjustments;
+    std::future<LutResource> _bake_job; // Pending background bake
+    ColorAdjustments _bake_job_adjustments;
+    ColorAdjustments _last_adjustments; // Adjustments seen by the previous Update
+    uint32_t _stable_updates = 0; // Updates since the adjustments last changed
 };
 } // namespace vortex
@@ -0,0 +1,391 @@
+#include <vortex/nodes/filter/compositor.h>
+#include <vortex/graphics.h>
+#include <vortex/probe.h>
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+// Push constant structures matching the shaders
+struct LayerTransformConstants {
+    DirectX::XMFLOAT2 translation; // Translation (normalized)
+    DirectX::XMFLOAT2 scale; // Scale factors
+    DirectX::XMFLOAT2 pivot; // Pivot point (normalized 0-1)
+    float rotation; // Rotation angle in radians
+    float aspect_ratio; // Width / Height of the output
+};
+
+struct LayerConstants {
+    uint32_t texture_index; // Index of the layer in the bound texture table
+    float opacity; // Layer opacity
+    float neutral; // Color that leaves the destination unchanged for the blend mode
+    uint32_t alpha_blend; // 1 - opacity goes to alpha, 0 - color is faded to neutral
+    DirectX::XMFLOAT4 fill; // Written instead of a texture when texture_index is fill_index
+};
+static constexpr uint32_t fill_index = ~0u;
+
+// Non-alpha blend modes can't fade by alpha, so the color is faded towards the value that leaves
+// the destination unchanged for the mode
+static float NeutralColor(vortex::BlendMode mode) noexcept
+{
+    switch (mode) {
+    case vortex::BlendMode::Multiply:
+    case vortex::BlendMode::Darken:
+        return 1.0f;
+    default:
+        return 0.0f;
+    }
+}
+
+vortex::CompositorLazy::CompositorLazy(const vortex::Graphics& gfx)
+{
+    auto& device = gfx.GetDevice();
+    auto& desc_ext = gfx.GetDescriptorBufferExtension();
+    wis::Result result = wis::success;
+
+    wis::DescriptorTableEntry entries_desc[] = {
+        { .type = wis::DescriptorType::Texture,
+         .bind_register = 0,
+         .binding = 0,
+         .count = max_batch_layers }
+    };
+    wis::DescriptorTableEntry entries_samp[] = {
+        { .type = wis::DescriptorType::Sampler, .bind_register = 0, .binding = 0, .count = 1 },
+    };
+    wis::DescriptorTable tables[] = {
+        { .type = wis::DescriptorHeapType::Descriptor,
+         .entries = entries_desc,
+         .entry_count = 1,
+         .stage = wis::ShaderStages::Pixel },
+        {    .type = wis::DescriptorHeapType::Sampler,
+         .entries = entries_samp,
+         .entry_count = 1,
+         .stage = wis::ShaderStages::Pixel },
+    };
+    wis::PushConstant push_constants[] = {
+        { .stage = wis::ShaderStages::Vertex,
+         .size_bytes = sizeof(LayerTransformConstants),
+         .bind_register = 0 },
+        {  .stage = wis::ShaderStages::Pixel,
+         .size_bytes = sizeof(LayerConstants),
+         .bind_register = 0 }
+    };
+
+    _root_signature = desc_ext.CreateRootSignature(result,
+                                                   push_constants,
+                                                   std::size(push_constants),
+                                                   nullptr,
+                                                   0,
+                                                   tables,
+                                                   std::size(tables));
+    if (!vortex::success(result)) {
+        vortex::error("Compositor: Failed to create root signature: {}", result.error);
+        return;
+    }
+
+    auto vertex_shader = gfx.LoadShader("shaders/compositor.vs");
+    auto pixel_shader = gfx.LoadShader("shaders/compositor.ps");
+
+    wis::BlendStateDesc blend_desc{
+        .attachment_count = 1,
+    };
+    wis::GraphicsPipelineDesc pipeline_desc{
+        .root_signature = _root_signature,
+        .shaders = {
+                .vertex = vertex_shader,
+                .pixel = pixel_shader,
+        },
+        .attachments = {
+                .attachment_formats = { wis::DataFormat::RGBA8Unorm }, .attachments_count = 1,
+                .depth_attachment = wis::DataFormat::Unknown, // No depth attachment
+        },
+        .blend = &blend_desc,
+        .flags = wis::PipelineFlags::DescriptorBuffer,
+    };
+
+    // One pipeline per hardware blend mode, same states as the Blend node
+    for (uint32_t i = 0; i < BlendLazy::hw_blend_mode_count; i++) {
+        blend_desc.attachments[0] = BlendLazy::GetBlendDesc(static_cast<BlendMode>(i));
+        _pipeline_states[i] = device.CreateGraphicsPipeline(result, pipeline_desc);
+        if (!vortex::success(result)) {
+            vortex::error("Compositor: Failed to create pipeline state: {}", result.error);
+            return;
+        }
+    }
+    blend_desc.attachments[0] = { .blend_enable = false, .color_write_mask = wis::ColorComponents::All };
+    _fill_pipeline_state = device.CreateGraphicsPipeline(result, pipeline_desc);
+    if (!vortex::success(result)) {
+        vortex::error("Compositor: Failed to create fill pipeline state: {}", result.error);
+        return;
+    }
+
+    wis::SamplerDesc sampler_desc{
+        .min_filter = wis::Filter::Linear,
+        .mag_filter = wis::Filter::Linear,
+        .mip_filter = wis::Filter::Linear,
+        .anisotropic = false,
+        .max_anisotropy = 1,
+        .address_u = wis::AddressMode::ClampToBorder,
+        .address_v = wis::AddressMode::ClampToBorder,
+        .address_w = wis::AddressMode::ClampToBorder,
+        .min_lod = 0.f,
+        .max_lod = 1.f,
+        .mip_lod_bias = 0.f,
+        .comparison_op = wis::Compare::None,
+        .border_color = { 0.f, 0.f, 0.f, 0.f }, // Transparent border color
+    };
+
+    _sampler = device.CreateSampler(result, sampler_desc);
+    if (!vortex::success(result)) {
+        vortex::error("Compositor: Failed to create sampler: {}", result.error);
+    }
+}
+
+vortex::Compositor::Compositor(const vortex::Graphics& gfx, SerializedProperties props)
+    : ImplClass(props)
+    , _lazy_data(gfx)
+{
+}
+
+auto vortex::Compositor::GetLayerSettings(std::size_t index) const noexcept -> CompositorLayer
+{
+    // Members holding the properties of each layer slot
+    struct LayerMembers {
+        DirectX::XMFLOAT2 CompositorProperties::* translation;
+        DirectX::XMFLOAT2 CompositorProperties::* scale;
+        float CompositorProperties::* rotation;
+        float CompositorProperties::* opacity;
+        BlendMode CompositorProperties::* blend_mode;
+    };
+    static constexpr LayerMembers slots[] = {
+        { &CompositorProperties::layer0_translation, &CompositorProperties::layer0_scale,
+         &CompositorProperties::layer0_rotation, &CompositorProperties::layer0_opacity,
+         &CompositorProperties::layer0_blend_mode },
+        { &CompositorProperties::layer1_translation, &CompositorProperties::layer1_scale,
+         &CompositorProperties::layer1_rotation, &CompositorProperties::layer1_opacity,
+         &CompositorProperties::layer1_blend_mode },
+        { &CompositorProperties::layer2_translation, &CompositorProperties::layer2_scale,
+         &CompositorProperties::layer2_rotation, &CompositorProperties::layer2_opacity,
+         &CompositorProperties::layer2_blend_mode },
+        { &CompositorProperties::layer3_translation, &CompositorProperties::layer3_scale,
+         &CompositorProperties::layer3_rotation, &CompositorProperties::layer3_opacity,
+         &CompositorProperties::layer3_blend_mode },
+    };
+    static_assert(std::size(slots) == max_layer_settings);
+
+    if (index >= max_layer_settings) {
+        return {};
+    }
+    auto& slot = slots[index];
+    return {
+        .translation = this->*slot.translation,
+        .scale = this->*slot.scale,
+        .rotation = this->*slot.rotation,
+        .opacity = std::clamp(this->*slot.opacity, 0.0f, 1.0f),
+        .blend_mode = this->*slot.blend_mode,
+    };
+}
+
+// Vertex constants of a layer quad, shared by the bounds and the draw
+static LayerTransformConstants MakeLayerTransform(const vortex::CompositorLayer& layer,
+                                                  wis::Size2D output_size) noexcept
+{
+    float width = static_cast<float>(output_size.width);
+    float height = static_cast<float>(output_size.height);
+    return {
+        .translation = { layer.translation.x / width, layer.translation.y / height },
+        .scale = layer.scale,
+        .pivot = { 0.5f, 0.5f },
+        .rotation = layer.rotation * std::numbers::pi_v<float> / 180.0f,
+        .aspect_ratio = width / height,
+    };
+}
+
+DirectX::XMFLOAT4 vortex::Compositor::GetOutputBounds(wis::Size2D output_size) noexcept
+{
+    if (GetBackground().w > 0.0f) {
+        return full_rect; // The background covers the frame
+    }
+
+    auto sinks = GetSinks();
+    DirectX::XMFLOAT4 bounds = empty_rect;
+    for (uint32_t i = 0; i < sinks.size(); i++) {
+        if (!sinks[i]) {
+            continue;
+        }
+        auto transform = MakeLayerTransform(GetLayerSettings(i), output_size);
+        bounds = UnionRect(bounds,
+                           TransformRect(sinks[i].source_node->GetOutputBounds(output_size),
+                                         transform.translation,
+                                         transform.scale,
+                                         transform.pivot,
+                                         transform.rotation,
+                                         transform.aspect_ratio));
+    }
+    return bounds;
+}
+
+bool vortex::Compositor::Evaluate(const vortex::Graphics& gfx,
+                                  RenderProbe& probe,
+                                  const RenderPassForwardDesc* output_info)
+{
+    auto sinks = GetSinks();
+    auto& cmd = *probe.command_list;
+
+    // With a transparent background an unchanged bottom layer renders straight into the target,
+    // like the base of the Blend node, and the rest are drawn over it
+    bool direct = false;
+    uint32_t first = 0;
+    while (first < sinks.size() && !sinks[first]) {
+        first++;
+    }
+    if (first < sinks.size() && GetBackground().w <= 0.0f && GetLayerSettings(first).IsIdentity()) {
+        direct = sinks[first].source_node->EvaluateThrough(gfx, probe, output_info);
+        if (direct) {
+            probe.texture_pool.BlockTexture(output_info->rt_index); // Keep it from the layers above
+        }
+        first++;
+    }
+
+    // Every other layer is rendered into its own texture first, they are all sampled in one pass
+    _layer_views.clear();
+    _layer_indices.clear();
+    for (uint32_t i = first; i < sinks.size(); i++) {
+        if (!sinks[i]) {
+            continue;
+        }
+        auto view = probe.texture_pool.AcquireTexture(gfx,
+                                                      output_info->depth,
+                                                      output_info->rt_generation);
+        RenderPassForwardDesc info{
+            .current_rt_view = view.GetRTV(),
+            .output_size = output_info->output_size,
+            .rt_index = view.GetIndex(),
+            .rt_generation = output_info->depth,
+            .depth = output_info->depth + 1,
+        };
+        if (!sinks[i].source_node->EvaluateThrough(gfx, probe, &info)) {
+            continue; // Nothing rendered, the texture is released with the view
+        }
+        _layer_views.emplace_back(std::move(view));
+        _layer_indices.push_back(i);
+    }
+
+    if (_layer_views.empty()) {
+        return direct;
+    }
+
+    wis::TextureBarrier before{
+        .sync_before = wis::BarrierSync::RenderTarget,
+        .sync_after = wis::BarrierSync::PixelShading,
+        .access_before = wis::ResourceAccess::RenderTarget,
+        .access_after = wis::ResourceAccess::ShaderResource,
+        .state_before = wis::TextureState::RenderTarget,
+        .state_after = wis::TextureState::ShaderResource,
+    };
+    for (auto& view : _layer_views) {
+        cmd.TextureBarrier(before, view.GetTexture());
+    }
+
+    auto& lazy = _lazy_data.uget();
+    auto root = lazy.GetRootSignature();
+
+    float width = static_cast<float>(output_info->output_size.width);
+    float height = static_cast<float>(output_info->output_size.height);
+
+    // Outside the clip stays transparent, the background is then drawn inside the clip scissor
+    auto background = GetBackground();
+    bool clipped = output_info->IsClipped();
+    auto clear = clipped ? DirectX::XMFLOAT4{ 0.f, 0.f, 0.f, 0.f } : background;
+    wis::RenderPassRenderTargetDesc target_desc{
+        .target = output_info->current_rt_view,
+        .load_op = direct ? wis::LoadOperation::Load : wis::LoadOperation::Clear,
+        .store_op = wis::StoreOperation::Store,
+        .clear_value = { clear.x, clear.y, clear.z, clear.w },
+    };
+    wis::RenderPassDesc pass_desc{
+        .target_count = 1,
+        .targets = &target_desc,
+    };
+    cmd.BeginRenderPass(pass_desc);
+    cmd.SetRootSignature(root);
+    cmd.RSSetScissor(output_info->GetScissor(GetOutputBounds(output_info->output_size)));
+    cmd.RSSetViewport({ 0.f, 0.f, width, height, 0.f, 1.f });
+    cmd.IASetPrimitiveTopology(wis::PrimitiveTopology::TriangleList);
+
+    auto samp_table = probe.sampler_buffer.SuballocateTable(1);
+    samp_table.WriteSampler(0, lazy.GetSampler());
+    samp_table.BindOffset(gfx, cmd, root, 1);
+
+    // The scissor is the clip scissor when there is a background, see GetOutputBounds
+    if (clipped && background.w > 0.0f && !direct) {
+        LayerTransformConstants transform_constants{
+            .scale = { 1.0f, 1.0f },
+            .pivot = { 0.5f, 0.5f },
+            .aspect_ratio = width / height,
+        };
+        LayerConstants fill_constants{ .texture_index = fill_index, .fill = background };
+        cmd.SetPipelineState(lazy.GetFillPipelineState());
+        cmd.SetPushConstants(&transform_constants,
+                             sizeof(LayerTransformConstants) / 4,
+                             0,
+                             wis::ShaderStages::Vertex);
+        cmd.SetPushConstants(&fill_constants, sizeof(LayerConstants) / 4, 0, wis::ShaderStages::Pixel);
+        cmd.DrawInstanced(6);
+    }
+
+    // Layers are drawn bottom to top as transformed quads, the pipeline only changes with the
+    // blend mode and the texture table is rebound once per batch
+    BlendMode current_mode = static_cast<BlendMode>(-1);
+    for (std::size_t batch = 0; batch < _layer_views.size();
+         batch += CompositorLazy::max_batch_layers) {
+        std::size_t batch_size = std::min<std::size_t>(CompositorLazy::max_batch_layers,
+                                                       _layer_views.size() - batch);
+        auto desc_table = probe.descriptor_buffer.SuballocateTable(
+                CompositorLazy::max_batch_layers);
+        for (std::size_t i = 0; i < batch_size; i++) {
+            desc_table.WriteTexture(uint32_t(i), _layer_views[batch + i].GetSRV());
+        }
+        desc_table.BindOffset(gfx, cmd, root, 0);
+
+        for (std::size_t i = 0; i < batch_size; i++) {
+            auto layer = GetLayerSettings(_layer_indices[batch + i]);
+            if (layer.blend_mode != current_mode) {
+                current_mode = layer.blend_mode;
+                cmd.SetPipelineState(lazy.GetPipelineState(current_mode));
+            }
+
+            auto transform_constants = MakeLayerTransform(layer, output_info->output_size);
+            LayerConstants layer_constants{
+                .texture_index = uint32_t(i),
+                .opacity = layer.opacity,
+                .neutral = NeutralColor(layer.blend_mode),
+                .alpha_blend = layer.blend_mode == BlendMode::Normal ||
+                        static_cast<uint32_t>(layer.blend_mode) >= BlendLazy::hw_blend_mode_count,
+            };
+            cmd.SetPushConstants(&transform_constants,
+                                 sizeof(LayerTransformConstants) / 4,
+                                 0,
+                                 wis::ShaderStages::Vertex);
+            cmd.SetPushConstants(&layer_constants,
+                                 sizeof(LayerConstants) / 4,
+                                 0,
+                                 wis::ShaderStages::Pixel);
+            cmd.DrawInstanced(6);
+        }
+    }
+    cmd.EndRenderPass();
+
+    wis::TextureBarrier after{
+        .sync_before = wis::BarrierSync::Draw,
+        .sync_after = wis::BarrierSync::RenderTarget,
+        .access_before = wis::ResourceAccess::ShaderResource,
+        .access_after = wis::ResourceAccess::RenderTarget,
+        .state_before = wis::TextureState::ShaderResource,
+        .state_after = wis::TextureState::RenderTarget,
+    };
+    for (auto& view : _layer_views) {
+        cmd.TextureBarrier(after, view.GetTexture());
+    }
+    _layer_views.clear(); // Return the layer textures to the pool
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+#include <vortex/graph/interfaces.h>
+#include <vortex/gfx/texture_pool.h>
+#include <vortex/nodes/filter/blend.h>
+#include <vortex/properties/props.hpp>
+#include <vortex/util/lazy.h>
+#include <wisdom/wisdom.hpp>
+#include <array>
+#include <vector>
+
+namespace vortex {
+class CompositorLazy
+{
+public:
+    static constexpr uint32_t max_batch_layers = 8; // Layers sampled from one descriptor table
+public:
+    CompositorLazy(const vortex::Graphics& gfx);
+
+public:
+    wis::RootSignatureView GetRootSignature() const noexcept { return _root_signature; }
+    wis::PipelineView GetPipelineState(BlendMode mode) const noexcept
+    {
+        uint32_t index = static_cast<uint32_t>(mode);
+        if (index >= BlendLazy::hw_blend_mode_count) {
+            index = 0; // Default to Normal if out of range
+        }
+        return _pipeline_states[index];
+    }
+    wis::PipelineView GetFillPipelineState() const noexcept { return _fill_pipeline_state; }
+    wis::SamplerView GetSampler() const noexcept { return _sampler; }
+
+private:
+    std::array<wis::PipelineState, BlendLazy::hw_blend_mode_count> _pipeline_states = {};
+    wis::PipelineState _fill_pipeline_state; // Writes the background without blending
+    wis::RootSignature _root_signature;
+    wis::Sampler _sampler;
+};
+
+// Settings of a single compositor layer, read from its typed layer properties
+struct CompositorLayer {
+    DirectX::XMFLOAT2 translation{ 0.0f, 0.0f }; // Translation in pixels
+    DirectX::XMFLOAT2 scale{ 1.0f, 1.0f }; // Scale factors around the layer center
+    float rotation = 0.0f; // Rotation angle in degrees
+    float opacity = 1.0f; // Layer opacity [0,1]
+    BlendMode blend_mode = BlendMode::Normal; // Blend mode against the layers below
+
+public:
+    // Drawn unchanged, so the source can render straight into the target
+    bool IsIdentity() const noexcept
+    {
+        return translation.x == 0.0f && translation.y == 0.0f && scale.x == 1.0f &&
+                scale.y == 1.0f && rotation == 0.0f && opacity == 1.0f &&
+                blend_mode == BlendMode::Normal;
+    }
+};
+
+// Compositor stacks any number of inputs in a single render pass.
+// Sinks are added on connection, sink 0 is the bottom layer.
+class Compositor
+    : public vortex::graph::FilterImpl<Compositor, CompositorProperties, graph::dynamic_ports, 1>
+{
+public:
+    Compositor(const vortex::Graphics& gfx, SerializedProperties props);
+
+public:
+    static constexpr uint32_t max_layer_settings = 4; // Layers with their own properties
+
+public:
+    // Layers above max_layer_settings are drawn unchanged
+    CompositorLayer GetLayerSettings(std::size_t index) const noexcept;
+
+public:
+    virtual bool Evaluate(const vortex::Graphics& gfx,
+                          RenderProbe& probe,
+                          const RenderPassForwardDesc* output_info = nullptr) override;
+    DirectX::XMFLOAT4 GetOutputBounds(wis::Size2D output_size) noexcept override;
+
+private:
+    [[no_unique_address]] lazy_ptr<CompositorLazy> _lazy_data; // Lazy data for static resources
+    std::vector<UseTextureView> _layer_views; // Layer textures held for the current frame
+    std::vector<uint32_t> _layer_indices; // Sink index of each held layer texture
+};
+} // namespace vortex
\ No newline at end of file
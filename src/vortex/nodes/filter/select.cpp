@@ -0,0 +1,300 @@
+#include <vortex/nodes/filter/select.h>
+#include <vortex/graphics.h>
+#include <vortex/probe.h>
+#include <vortex/sync/pts_clock.h>
+
+// Push constant structure matching the shader
+struct TransitionConstants {
+    float progress; // Transition progress [0,1]
+    uint32_t type; // TransitionType enum
+    float softness; // Width of the wipe edge (normalized)
+    float padding;
+};
+
+static constexpr float wipe_softness = 0.02f; // Soft edge of the wipe, 2% of the width
+
+vortex::SelectLazy::SelectLazy(const vortex::Graphics& gfx)
+{
+    auto& device = gfx.GetDevice();
+    wis::Result result = wis::success;
+
+    wis::DescriptorTableEntry entries_desc[] = {
+        { .type = wis::DescriptorType::Texture, .bind_register = 0, .binding = 0, .count = 1 },
+        { .type = wis::DescriptorType::Texture, .bind_register = 1, .binding = 1, .count = 1 },
+    };
+    wis::DescriptorTableEntry entries_samp[] = {
+        { .type = wis::DescriptorType::Sampler, .bind_register = 0, .binding = 0, .count = 1 },
+    };
+    wis::DescriptorTable tables[] = {
+        { .type = wis::DescriptorHeapType::Descriptor,
+         .entries = entries_desc,
+         .entry_count = 2,
+         .stage = wis::ShaderStages::Pixel },
+        {    .type = wis::DescriptorHeapType::Sampler,
+         .entries = entries_samp,
+         .entry_count = 1,
+         .stage = wis::ShaderStages::Pixel },
+    };
+    wis::PushConstant push_constants[] = {
+        { .stage = wis::ShaderStages::Pixel,
+         .size_bytes = sizeof(TransitionConstants),
+         .bind_register = 0 },
+    };
+    _root_signature = gfx.GetDescriptorBufferExtension().CreateRootSignature(result,
+                                                                             push_constants,
+                                                                             1,
+                                                                             nullptr,
+                                                                             0,
+                                                                             tables,
+                                                                             std::size(tables));
+    if (!vortex::success(result)) {
+        vortex::error("Select: Failed to create root signature: {}", result.error);
+        return;
+    }
+
+    auto vertex_shader = gfx.LoadShader("shaders/basic.vs");
+    auto pixel_shader = gfx.LoadShader("shaders/transition.ps");
+
+    wis::GraphicsPipelineDesc pipeline_desc{
+        .root_signature = _root_signature,
+        .shaders = {
+                .vertex = vertex_shader,
+                .pixel = pixel_shader,
+        },
+        .attachments = {
+                .attachment_formats = { wis::DataFormat::RGBA8Unorm }, .attachments_count = 1,
+                .depth_attachment = wis::DataFormat::Unknown, // No depth attachment
+        },
+        .flags = wis::PipelineFlags::DescriptorBuffer,
+    };
+    _pipeline_state = device.CreateGraphicsPipeline(result, pipeline_desc);
+    if (!vortex::success(result)) {
+        vortex::error("Select: Failed to create pipeline state: {}", result.error);
+        return;
+    }
+
+    wis::SamplerDesc sampler_desc{
+        .min_filter = wis::Filter::Point,
+        .mag_filter = wis::Filter::Point,
+        .mip_filter = wis::Filter::Point,
+        .anisotropic = false,
+        .max_anisotropy = 1,
+        .address_u = wis::AddressMode::ClampToEdge,
+        .address_v = wis::AddressMode::ClampToEdge,
+        .address_w = wis::AddressMode::ClampToEdge,
+        .min_lod = 0.f,
+        .max_lod = 1.f,
+        .mip_lod_bias = 0.f,
+        .comparison_op = wis::Compare::None,
+        .border_color = { 0.f, 0.f, 0.f, 0.f },
+    };
+    _sampler = device.CreateSampler(result, sampler_desc);
+    if (!vortex::success(result)) {
+        vortex::error("Select: Failed to create sampler: {}", result.error);
+    }
+}
+
+bool vortex::Select::Evaluate(const vortex::Graphics& gfx,
+                              RenderProbe& probe,
+                              const RenderPassForwardDesc* output_info)
+{
+    auto sinks = GetSinks();
+    if (sinks.empty()) {
+        return false;
+    }
+
+    // Outputs at other PTS see the switch at their own time, so each one keeps its own program
+    auto& state = _programs[probe.output];
+    uint32_t index = static_cast<uint32_t>(
+            std::clamp(GetInputIndex(), 0, static_cast<int32_t>(sinks.size()) - 1));
+    if (index != state.program_index) {
+        // Only transition away from an input that is still connected
+        bool can_transition = GetTransition() != TransitionType::Cut &&
+                GetTransitionDuration() > 0 && state.program_index < sinks.size() &&
+                sinks[state.program_index];
+        state.from_index = can_transition ? state.program_index : no_input;
+        state.transition_start_pts = probe.current_pts;
+        state.program_index = index;
+    }
+
+    float progress = TransitionProgress(state, probe.current_pts);
+    if (progress >= 1.0f) {
+        state.from_index = no_input; // Transition finished
+    }
+
+    // Inputs that are not visible are kept in standby, so switching to them is instant
+    for (uint32_t i = 0; i < sinks.size(); i++) {
+        if (sinks[i] && i != state.program_index && i != state.from_index) {
+            sinks[i].source_node->EvaluateStandby(gfx, probe);
+        }
+    }
+
+    if (state.from_index != no_input) {
+        return EvaluateTransition(gfx, probe, output_info, state, progress);
+    }
+
+    if (EvaluateInput(gfx, probe, output_info, state.program_index)) {
+        state.last_rendered_index = state.program_index;
+        return true;
+    }
+
+    // The new input has no frame yet, keep showing the previous one instead of a blank frame
+    if (state.last_rendered_index != state.program_index) {
+        return EvaluateInput(gfx, probe, output_info, state.last_rendered_index);
+    }
+    return false;
+}
+
+DirectX::XMFLOAT4 vortex::Select::GetOutputBounds(wis::Size2D output_size) noexcept
+{
+    auto sinks = GetSinks();
+    if (sinks.empty()) {
+        return empty_rect;
+    }
+
+    // Asked before Evaluate and not per output, so the input may switch this frame.
+    // Cover every input that can be shown on any output.
+    uint32_t requested = static_cast<uint32_t>(
+            std::clamp(GetInputIndex(), 0, static_cast<int32_t>(sinks.size()) - 1));
+    DirectX::XMFLOAT4 bounds = empty_rect;
+    auto add_input = [&](uint32_t index) {
+        if (index < sinks.size() && sinks[index]) {
+            bounds = UnionRect(bounds, sinks[index].source_node->GetOutputBounds(output_size));
+        }
+    };
+    add_input(requested);
+    for (auto& [output, state] : _programs) {
+        for (uint32_t index : { state.program_index, state.from_index, state.last_rendered_index }) {
+            add_input(index);
+        }
+    }
+    return bounds;
+}
+
+bool vortex::Select::EvaluateInput(const vortex::Graphics& gfx,
+                                   RenderProbe& probe,
+                                   const RenderPassForwardDesc* output_info,
+                                   uint32_t index)
+{
+    auto sinks = GetSinks();
+    if (index >= sinks.size() || !sinks[index]) {
+        return false;
+    }
+    return sinks[index].source_node->EvaluateThrough(gfx, probe, output_info);
+}
+
+float vortex::Select::TransitionProgress(const ProgramState& state, int64_t pts) const noexcept
+{
+    if (state.from_index == no_input || state.transition_start_pts == invalid_pts || pts == invalid_pts) {
+        return 1.0f;
+    }
+    int64_t duration_pts = int64_t(GetTransitionDuration()) * sync::PTSClock::timebase_hz / 1000;
+    if (duration_pts <= 0) {
+        return 1.0f;
+    }
+    return std::clamp(float(pts - state.transition_start_pts) / float(duration_pts), 0.0f, 1.0f);
+}
+
+bool vortex::Select::EvaluateTransition(const vortex::Graphics& gfx,
+                                        RenderProbe& probe,
+                                        const RenderPassForwardDesc* output_info,
+                                        ProgramState& state,
+                                        float progress)
+{
+    // Render both inputs, then combine them in a single pass
+    auto view_from = probe.texture_pool.AcquireTexture(gfx,
+                                                       output_info->depth,
+                                                       output_info->rt_generation);
+    auto view_to = probe.texture_pool.AcquireTexture(gfx,
+                                                     output_info->depth,
+                                                     output_info->rt_generation);
+
+    RenderPassForwardDesc info_from{
+        .current_rt_view = view_from.GetRTV(),
+        .output_size = output_info->output_size,
+        .rt_index = view_from.GetIndex(),
+        .rt_generation = output_info->depth,
+        .depth = output_info->depth + 1,
+    };
+    RenderPassForwardDesc info_to = info_from;
+    info_to.current_rt_view = view_to.GetRTV();
+    info_to.rt_index = view_to.GetIndex();
+
+    bool from_valid = EvaluateInput(gfx, probe, &info_from, state.from_index);
+    bool to_valid = EvaluateInput(gfx, probe, &info_to, state.program_index);
+    if (!from_valid && !to_valid) {
+        return false;
+    }
+    if (to_valid) {
+        state.last_rendered_index = state.program_index;
+    }
+
+    // Hold the side that has a frame until the other one catches up
+    TransitionConstants constants{
+        .progress = !to_valid ? 0.0f : !from_valid ? 1.0f : progress,
+        .type = static_cast<uint32_t>(GetTransition()),
+        .softness = wipe_softness,
+    };
+
+    auto& cmd = *probe.command_list;
+    wis::TextureBarrier before{
+        .sync_before = wis::BarrierSync::RenderTarget,
+        .sync_after = wis::BarrierSync::PixelShading,
+        .access_before = wis::ResourceAccess::RenderTarget,
+        .access_after = wis::ResourceAccess::ShaderResource,
+        .state_before = wis::TextureState::RenderTarget,
+        .state_after = wis::TextureState::ShaderResource,
+    };
+    cmd.TextureBarrier(before, view_from.GetTexture());
+    cmd.TextureBarrier(before, view_to.GetTexture());
+
+    auto& lazy = _lazy_data.uget();
+    auto root = lazy.GetRootSignature();
+    auto desc_table = probe.descriptor_buffer.SuballocateTable(2);
+    auto samp_table = probe.sampler_buffer.SuballocateTable(1);
+
+    wis::RenderPassRenderTargetDesc target_desc{
+        .target = output_info->current_rt_view,
+        .load_op = output_info->GetClipLoadOperation(),
+        .store_op = wis::StoreOperation::Store,
+        .clear_value = { 0.f, 0.f, 0.f, 0.f },
+    };
+    wis::RenderPassDesc pass_desc{
+        .target_count = 1,
+        .targets = &target_desc,
+    };
+    cmd.BeginRenderPass(pass_desc);
+    cmd.SetPipelineState(lazy.GetPipelineState());
+    cmd.SetRootSignature(root);
+    cmd.SetPushConstants(&constants,
+                         sizeof(TransitionConstants) / 4,
+                         0,
+                         wis::ShaderStages::Pixel);
+    desc_table.WriteTexture(0, view_from.GetSRV());
+    desc_table.WriteTexture(1, view_to.GetSRV());
+    desc_table.BindOffset(gfx, cmd, root, 0);
+    samp_table.WriteSampler(0, lazy.GetSampler());
+    samp_table.BindOffset(gfx, cmd, root, 1);
+    cmd.RSSetScissor(output_info->GetScissor());
+    cmd.RSSetViewport({ 0.f,
+                        0.f,
+                        float(output_info->output_size.width),
+                        float(output_info->output_size.height),
+                        0.f,
+                        1.f });
+    cmd.IASetPrimitiveTopology(wis::PrimitiveTopology::TriangleList);
+    cmd.DrawInstanced(3);
+    cmd.EndRenderPass();
+
+    wis::TextureBarrier after{
+        .sync_before = wis::BarrierSync::Draw,
+        .sync_after = wis::BarrierSync::RenderTarget,
+        .access_before = wis::ResourceAccess::ShaderResource,
+        .access_after = wis::ResourceAccess::RenderTarget,
+        .state_before = wis::TextureState::ShaderResource,
+        .state_after = wis::TextureState::RenderTarget,
+    };
+    cmd.TextureBarrier(after, view_from.GetTexture());
+    cmd.TextureBarrier(after, view_to.GetTexture());
+    return true;
+}
\ No newline at end of file
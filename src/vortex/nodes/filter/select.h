@@ -1,30 +1,71 @@
 #pragma once
 #include <vortex/graph/interfaces.h>
 #include <vortex/properties/props.hpp>
+#include <vortex/util/lazy.h>
+#include <wisdom/wisdom.hpp>
+#include <unordered_map>
 
 namespace vortex {
-// Blend node is a filter that blends colors with a specified factor or a mask.
-class Select : public vortex::graph::FilterImpl<Select, SelectProperties, 2, 1>
+class SelectLazy
 {
+public:
+    SelectLazy(const vortex::Graphics& gfx);
+
+public:
+    wis::RootSignatureView GetRootSignature() const noexcept { return _root_signature; }
+    wis::PipelineView GetPipelineState() const noexcept { return _pipeline_state; }
+    wis::SamplerView GetSampler() const noexcept { return _sampler; }
+
+private:
+    wis::RootSignature _root_signature; // Root signature for the transition pass
+    wis::PipelineState _pipeline_state; // Pipeline state for the transition pass
+    wis::Sampler _sampler; // Sampler for both inputs
+};
+
+// Select is an N-input switcher. Sinks are added on connection, the selected input is passed
+// through and the rest are kept in standby. Changing the input can mix or wipe over time.
+// Every output runs its own transition on its own PTS.
+class Select : public vortex::graph::FilterImpl<Select, SelectProperties, graph::dynamic_ports, 1>
+{
+    static constexpr uint32_t no_input = std::numeric_limits<uint32_t>::max();
+
 public:
     Select(const vortex::Graphics& gfx, SerializedProperties props)
         : ImplClass(props)
+        , _lazy_data(gfx)
     {
-
     }
 
 public:
-    // Override the Evaluate method to perform blending
     virtual bool Evaluate(const vortex::Graphics& gfx,
-        RenderProbe& probe,
-        const RenderPassForwardDesc* output_info = nullptr) override
-    {
-        uint32_t index = static_cast<uint32_t>(std::clamp(input_index, 0, 1));
-        if (auto& sink = GetSinks()[index]; sink)
-        {
-            return sink.source_node->Evaluate(gfx, probe, output_info);
-        }
-        return false;
-    }
+                          RenderProbe& probe,
+                          const RenderPassForwardDesc* output_info = nullptr) override;
+    DirectX::XMFLOAT4 GetOutputBounds(wis::Size2D output_size) noexcept override;
+
+private:
+    // Program of one output
+    struct ProgramState {
+        uint32_t program_index = no_input; // Input currently on program
+        uint32_t from_index = no_input; // Outgoing input while a transition is running
+        uint32_t last_rendered_index = no_input; // Last input that produced a frame
+        int64_t transition_start_pts = invalid_pts; // PTS at which the running transition started
+    };
+
+private:
+    bool EvaluateInput(const vortex::Graphics& gfx,
+                       RenderProbe& probe,
+                       const RenderPassForwardDesc* output_info,
+                       uint32_t index);
+    bool EvaluateTransition(const vortex::Graphics& gfx,
+                            RenderProbe& probe,
+                            const RenderPassForwardDesc* output_info,
+                            ProgramState& state,
+                            float progress);
+    float TransitionProgress(const ProgramState& state, int64_t pts) const noexcept;
+
+private:
+    [[no_unique_address]] lazy_ptr<SelectLazy> _lazy_data; // Lazy data for static resources
+
+    std::unordered_map<const void*, ProgramState> _programs; // Keyed by RenderProbe::output
 };
-}
\ No newline at end of file
+} // namespace vortex
\ No newline at end of file
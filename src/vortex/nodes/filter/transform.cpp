@@ -1,7 +1,10 @@
 #include <vortex/nodes/filter/transform.h>
 #include <vortex/graphics.h>
 #include <vortex/probe.h>
+#include <array>
+#include <cmath>
 #include <numbers>
+#include <optional>
 
 // Push constant structures matching the shaders
 struct TransformConstants {
@@ -14,8 +17,78 @@ struct TransformConstants {
 
 struct CropConstants {
     DirectX::XMFLOAT4 crop_rect; // x, y, width, height (normalized 0-1)
+    DirectX::XMFLOAT2 uv_scale{ 1.0f, 1.0f }; // Part of the texture the source occupies
+    DirectX::XMFLOAT2 uv_max{ 1.0f, 1.0f }; // Clamp for the sample position
 };
 
+// Vertex constants of the transform, shared by the bounds and the draw
+static TransformConstants MakeTransformConstants(const vortex::Transform& node,
+                                                 wis::Size2D output_size) noexcept
+{
+    // Translation goes from pixels to normalized coordinates, rotation from degrees to radians
+    float width = static_cast<float>(output_size.width);
+    float height = static_cast<float>(output_size.height);
+    auto translation = node.GetTranslation();
+    return {
+        .translation = { translation.x / width, translation.y / height },
+        .scale = node.GetScale(),
+        .pivot = node.GetPivot(),
+        .rotation = node.GetRotation() * std::numbers::pi_v<float> / 180.0f,
+        .aspect_ratio = width / height,
+    };
+}
+
+// Draws the source through the transform pipeline into the top left viewport of the target
+static void DrawTransformed(const vortex::Graphics& gfx,
+                            vortex::RenderProbe& probe,
+                            const vortex::TransformLazy& lazy,
+                            wis::RenderTargetView target,
+                            wis::ShaderResourceView source,
+                            wis::Size2D viewport,
+                            wis::Scissor scissor,
+                            const TransformConstants& transform_constants,
+                            const CropConstants& crop_constants)
+{
+    auto& cmd = *probe.command_list;
+    auto root = lazy.GetRootSignature();
+    auto desc_table = probe.descriptor_buffer.SuballocateTable(1);
+    auto samp_table = probe.sampler_buffer.SuballocateTable(1);
+
+    wis::RenderPassRenderTargetDesc target_desc{
+        .target = target,
+        .load_op = wis::LoadOperation::Clear,
+        .store_op = wis::StoreOperation::Store,
+        .clear_value = { 0.f, 0.f, 0.f, 0.f }
+    };
+    wis::RenderPassDesc pass_desc{
+        .target_count = 1,
+        .targets = &target_desc,
+    };
+    cmd.BeginRenderPass(pass_desc);
+    cmd.SetPipelineState(lazy.GetPipelineState());
+    cmd.SetRootSignature(root);
+
+    // Set push constants for vertex shader (transform)
+    cmd.SetPushConstants(&transform_constants,
+                         sizeof(TransformConstants) / 4,
+                         0,
+                         wis::ShaderStages::Vertex);
+
+    // Set push constants for pixel shader (crop)
+    cmd.SetPushConstants(&crop_constants, sizeof(CropConstants) / 4, 0, wis::ShaderStages::Pixel);
+
+    desc_table.WriteTexture(0, source);
+    desc_table.BindOffset(gfx, cmd, root, 0);
+    samp_table.WriteSampler(0, lazy.GetSampler());
+    samp_table.BindOffset(gfx, cmd, root, 1);
+
+    cmd.RSSetScissor(scissor);
+    cmd.RSSetViewport({ 0.f, 0.f, float(viewport.width), float(viewport.height), 0.f, 1.f });
+    cmd.IASetPrimitiveTopology(wis::PrimitiveTopology::TriangleList);
+    cmd.DrawInstanced(3);
+    cmd.EndRenderPass();
+}
+
 vortex::TransformLazy::TransformLazy(const vortex::Graphics& gfx)
 {
     auto& device = gfx.GetDevice();
@@ -110,6 +183,27 @@ vortex::TransformLazy::TransformLazy(const vortex::Graphics& gfx)
     }
 }
 
+DirectX::XMFLOAT4 vortex::Transform::GetOutputBounds(wis::Size2D output_size) noexcept
+{
+    auto& input_base = GetSinks()[0];
+    if (!input_base) {
+        return empty_rect;
+    }
+
+    // The quad samples the input 1:1 in texture space, the crop applies before the transform
+    auto bounds = IntersectRect(input_base.source_node->GetOutputBounds(output_size), GetCropRect());
+    if (IsGeometryIdentity()) {
+        return bounds;
+    }
+    auto transform = MakeTransformConstants(*this, output_size);
+    return TransformRect(bounds,
+                         transform.translation,
+                         transform.scale,
+                         transform.pivot,
+                         transform.rotation,
+                         transform.aspect_ratio);
+}
+
 bool vortex::Transform::Evaluate(const vortex::Graphics& gfx,
                                  RenderProbe& probe,
                                  const RenderPassForwardDesc* output_info)
@@ -120,6 +214,17 @@ bool vortex::Transform::Evaluate(const vortex::Graphics& gfx,
         return false;
     }
 
+    // Without geometry changes the input renders straight into our target,
+    // a crop is folded into the clip rect instead of a separate masking pass
+    if (IsGeometryIdentity()) {
+        if (!HasCrop()) {
+            return input_base.source_node->EvaluateThrough(gfx, probe, output_info);
+        }
+        RenderPassForwardDesc info = *output_info;
+        info.ClipTo(GetCropRect());
+        return input_base.source_node->EvaluateThrough(gfx, probe, &info);
+    }
+
     auto view = probe.texture_pool.AcquireTexture(gfx,
                                                   output_info->depth,
                                                   output_info->rt_generation);
@@ -136,7 +241,7 @@ bool vortex::Transform::Evaluate(const vortex::Graphics& gfx,
     };
 
     auto& cmd = *probe.command_list;
-    bool eval = input_base.source_node->Evaluate(gfx, probe, &info);
+    bool eval = input_base.source_node->EvaluateThrough(gfx, probe, &info);
 
     // Allocated textures are always in RenderTarget state, transition to ShaderResource
     wis::TextureBarrier before{
@@ -154,72 +259,57 @@ bool vortex::Transform::Evaluate(const vortex::Graphics& gfx,
         return false;
     }
 
-    auto root = _lazy_data.uget().GetRootSignature();
-    auto pipeline = _lazy_data.uget().GetPipelineState();
-    auto desc_table = probe.descriptor_buffer.SuballocateTable(1);
-    auto samp_table = probe.sampler_buffer.SuballocateTable(1);
+    wis::Size2D output_size = output_info->output_size;
+    auto scale = GetScale();
 
-    // Prepare transform constants
-    TransformConstants transform_constants{};
+    // Heavy scale-downs would alias when sampled directly. Halve the input until the final
+    // pass minifies by less than 2x; each level is a 2x2 box filter from a single bilinear tap,
+    // rendered into the top left corner of a pooled texture.
+    float footprint = std::max(std::abs(scale.x), std::abs(scale.y));
+    uint32_t level_count = 0;
+    while (footprint < 0.5f && level_count < max_downscale_levels) {
+        footprint *= 2.0f;
+        level_count++;
+    }
 
-    // Convert translation from pixels to normalized coordinates
-    float width = static_cast<float>(output_info->output_size.width);
-    float height = static_cast<float>(output_info->output_size.height);
-    auto translation = GetTranslation();
-    transform_constants.translation = DirectX::XMFLOAT2{ translation.x / width,
-                                                         translation.y / height };
+    // Only the part of the input that is drawn is filtered
+    auto input_bounds = IntersectRect(input_base.source_node->GetOutputBounds(output_size), GetCropRect());
 
-    transform_constants.scale = GetScale();
-    transform_constants.pivot = GetPivot();
+    std::array<std::optional<vortex::UseTextureView>, max_downscale_levels> levels;
+    wis::ShaderResourceView source = sr;
+    wis::Size2D source_size = output_size;
+    CropConstants sample_constants{ .crop_rect = { 0.0f, 0.0f, 1.0f, 1.0f } };
+    TransformConstants identity{ .scale = { 1.0f, 1.0f }, .aspect_ratio = 1.0f };
+    for (uint32_t i = 0; i < level_count; i++) {
+        auto& level = levels[i].emplace(probe.texture_pool.AcquireTexture(gfx,
+                                                                          output_info->depth,
+                                                                          output_info->rt_generation));
+        if (!*level) {
+            break; // Out of textures, sample the last level that was made
+        }
+        wis::Size2D level_size{ std::max((source_size.width + 1) / 2, 1u),
+                                std::max((source_size.height + 1) / 2, 1u) };
+        RenderPassForwardDesc level_info{ .output_size = level_size };
+        DrawTransformed(gfx, probe, _lazy_data.uget(), level->GetRTV(), source, level_size,
+                        level_info.GetScissor(input_bounds), identity, sample_constants);
+        cmd.TextureBarrier(before, level->GetTexture());
 
-    // Convert rotation from degrees to radians
-    transform_constants.rotation = GetRotation() * std::numbers::pi_v<float> / 180.0f;
-    transform_constants.aspect_ratio = width / height;
+        source = level->GetSRV();
+        source_size = level_size;
+        sample_constants.uv_scale = { float(source_size.width) / float(output_size.width),
+                                      float(source_size.height) / float(output_size.height) };
+        sample_constants.uv_max = { (float(source_size.width) - 0.5f) / float(output_size.width),
+                                    (float(source_size.height) - 0.5f) / float(output_size.height) };
+    }
 
     // Prepare crop constants
-    CropConstants crop_constants{};
+    CropConstants crop_constants = sample_constants;
     crop_constants.crop_rect = GetCropRect();
 
     // Now render with transformation
-    wis::RenderPassRenderTargetDesc target_desc{
-        .target = output_info->current_rt_view,
-        .load_op = wis::LoadOperation::Clear,
-        .store_op = wis::StoreOperation::Store,
-        .clear_value = { 0.f, 0.f, 0.f, 0.f }
-    };
-    wis::RenderPassDesc pass_desc{
-        .target_count = 1,
-        .targets = &target_desc,
-    };
-    cmd.BeginRenderPass(pass_desc);
-    cmd.SetPipelineState(pipeline);
-    cmd.SetRootSignature(root);
-
-    // Set push constants for vertex shader (transform)
-    cmd.SetPushConstants(&transform_constants,
-                         sizeof(TransformConstants) / 4,
-                         0,
-                         wis::ShaderStages::Vertex);
-
-    // Set push constants for pixel shader (crop)
-    cmd.SetPushConstants(&crop_constants, sizeof(CropConstants) / 4, 0, wis::ShaderStages::Pixel);
-
-    desc_table.WriteTexture(0, sr);
-    desc_table.BindOffset(gfx, cmd, root, 0);
-    samp_table.WriteSampler(0, _lazy_data.uget().GetSampler());
-    samp_table.BindOffset(gfx, cmd, root, 1);
-
-    cmd.RSSetScissor(
-            { 0, 0, int(output_info->output_size.width), int(output_info->output_size.height) });
-    cmd.RSSetViewport({ 0.f,
-                        0.f,
-                        float(output_info->output_size.width),
-                        float(output_info->output_size.height),
-                        0.f,
-                        1.f });
-    cmd.IASetPrimitiveTopology(wis::PrimitiveTopology::TriangleList);
-    cmd.DrawInstanced(3);
-    cmd.EndRenderPass();
+    DrawTransformed(gfx, probe, _lazy_data.uget(), output_info->current_rt_view, source,
+                    output_size, output_info->GetScissor(GetOutputBounds(output_size)),
+                    MakeTransformConstants(*this, output_size), crop_constants);
 
     wis::TextureBarrier after{
         .sync_before = wis::BarrierSync::Draw,
@@ -230,6 +320,10 @@ bool vortex::Transform::Evaluate(const vortex::Graphics& gfx,
         .state_after = wis::TextureState::RenderTarget,
     };
     cmd.TextureBarrier(after, tex);
-
+    for (auto& level : levels) {
+        if (level && *level) {
+            cmd.TextureBarrier(after, level->GetTexture());
+        }
+    }
     return true;
 }
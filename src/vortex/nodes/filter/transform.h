@@ -23,6 +23,8 @@ private:
 // Transform node is a filter that applies 2D transformations (translate, rotate, scale) to an image
 class Transform : public vortex::graph::FilterImpl<Transform, TransformProperties, 1, 1>
 {
+    static constexpr uint32_t max_downscale_levels = 5; // Down to 1/32 before the final pass
+
 public:
     Transform(const vortex::Graphics& gfx, SerializedProperties props)
         : ImplClass(props)
@@ -35,6 +37,23 @@ public:
     virtual bool Evaluate(const vortex::Graphics& gfx,
                           RenderProbe& probe,
                           const RenderPassForwardDesc* output_info = nullptr) override;
+    bool IsPassThrough() const noexcept override { return IsGeometryIdentity() && !HasCrop(); }
+    DirectX::XMFLOAT4 GetOutputBounds(wis::Size2D output_size) noexcept override;
+
+private:
+    // No translation, scale or rotation, output pixels map 1:1 to input pixels
+    bool IsGeometryIdentity() const noexcept
+    {
+        auto translation = GetTranslation();
+        auto scale = GetScale();
+        return translation.x == 0.0f && translation.y == 0.0f && scale.x == 1.0f &&
+                scale.y == 1.0f && GetRotation() == 0.0f;
+    }
+    bool HasCrop() const noexcept
+    {
+        auto crop = GetCropRect();
+        return crop.x > 0.0f || crop.y > 0.0f || crop.x + crop.z < 1.0f || crop.y + crop.w < 1.0f;
+    }
 
 private:
     [[no_unique_address]] lazy_ptr<TransformLazy> _lazy_data; // Lazy data for static resources
@@ -4,6 +4,7 @@
 #include <vortex/graphics.h>
 
 vortex::ImageInputLazy::ImageInputLazy(const vortex::Graphics& gfx)
+    : _cache(gfx)
 {
     wis::Result result = wis::success;
 
@@ -65,55 +66,53 @@ vortex::ImageInputLazy::ImageInputLazy(const vortex::Graphics& gfx)
 
 void vortex::ImageInput::Update(const vortex::Graphics& gfx)
 {
-    // Load the texture from the image path if it has changed
-    if (path_changed && !image_path.empty()) {
-        wis::Result res = wis::success;
-        auto result = codec::CodecFFmpeg::LoadTexture(gfx, image_path);
-        if (!result) {
-            vortex::error("ImageInput: Failed to load texture from path: {}. Error: {}", image_path, result.error().message());
-            image_path = ""; // Clear the path if loading failed
-            path_changed = false; // Reset the path changed flag
-            return; // Skip rendering if texture loading failed
+    // Start loading the new image, the previous one is shown until it is ready
+    if (std::exchange(path_changed, false)) {
+        if (image_path.empty()) {
+            // Cleared, a load still in flight must not bring the old image back
+            _pending_image = {};
+            ShowImage({});
+            return;
         }
+        _pending_image = _lazy_data.uget()._cache.Load(image_path);
+    }
+
+    if (!_pending_image.valid() ||
+        _pending_image.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return;
+    }
 
-        _texture = std::move(result.value()); // Store the loaded texture
-        _texture_resource = _texture.CreateShaderResource(gfx);
-
-        auto cmd_list = gfx.GetDevice().CreateCommandList(res, wis::QueueType::Graphics);
-        // Update state to shader resource
-        std::ignore = cmd_list.Reset();
-        cmd_list.TextureBarrier({
-                                        .sync_before = wis::BarrierSync::None,
-                                        .sync_after = wis::BarrierSync::None,
-                                        .access_before = wis::ResourceAccess::NoAccess,
-                                        .access_after = wis::ResourceAccess::NoAccess,
-                                        .state_before = wis::TextureState::Undefined,
-                                        .state_after = wis::TextureState::ShaderResource,
-                                },
-                                _texture.Get());
-
-        cmd_list.Close();
-        wis::CommandListView views[]{ cmd_list };
-        gfx.GetMainQueue().ExecuteCommandLists(views, 1);
-        gfx.WaitForGPU(); // Ensure the texture is ready for rendering
-
-        path_changed = false; // Reset the path changed flag after loading
+    auto image = _pending_image.get();
+    _pending_image = {};
+    if (!image) {
+        vortex::error("ImageInput: Failed to load texture from path: {}", image_path);
+        image_path = ""; // Clear the path if loading failed
+    }
+    ShowImage(std::move(image));
+}
+
+void vortex::ImageInput::ShowImage(vortex::ImageHandle image)
+{
+    if (_image) {
+        _retired_images[_retired_index] = std::move(_image);
+        _retired_index = (_retired_index + 1) % _retired_images.size();
     }
+    _image = std::move(image);
 }
 
 bool vortex::ImageInput::Evaluate(const vortex::Graphics& gfx, vortex::RenderProbe& probe, const vortex::RenderPassForwardDesc* output_info)
 {
     // Check if the texture is valid before rendering
-    if (!_texture || _texture.GetSize().width == 0 || _texture.GetSize().height == 0) {
+    if (!_image || _image->texture.GetSize().width == 0 || _image->texture.GetSize().height == 0) {
         //vortex::info("ImageInput: Texture is not valid or has zero size.");
         return false; // Skip rendering if texture is not valid
     }
 
     wis::RenderPassRenderTargetDesc target_desc{
         .target = output_info->current_rt_view,
-        .load_op = wis::LoadOperation::Clear,
+        .load_op = output_info->GetClipLoadOperation(), // The draw covers the clip rect
         .store_op = wis::StoreOperation::Store,
-        .clear_value = { 0.f, 0.f, 0.f, 1.f } // Clear to transparent black
+        .clear_value = { 0.f, 0.f, 0.f, 0.f } // Outside the clip stays transparent
     };
     wis::RenderPassDesc pass_desc{
         .target_count = 1,
@@ -126,13 +125,13 @@ bool vortex::ImageInput::Evaluate(const vortex::Graphics& gfx, vortex::RenderPro
     cmd_list.BeginRenderPass(pass_desc);
     cmd_list.SetPipelineState(_lazy_data.uget()._pipeline_state);
     cmd_list.SetRootSignature(_lazy_data.uget()._root_signature);
-    cmd_list.RSSetScissor({ 0, 0, int(output_info->output_size.width), int(output_info->output_size.height) });
+    cmd_list.RSSetScissor(output_info->GetScissor());
     cmd_list.RSSetViewport({ 0.f, 0.f, float(output_info->output_size.width), float(output_info->output_size.height), 0.f, 1.f });
     cmd_list.IASetPrimitiveTopology(wis::PrimitiveTopology::TriangleList);
 
     auto desc_table = probe.descriptor_buffer.SuballocateTable(1);
     auto sampler_table = probe.sampler_buffer.SuballocateTable(1);
-    desc_table.WriteTexture(0, _texture_resource);
+    desc_table.WriteTexture(0, _image->srv);
     sampler_table.WriteSampler(0, _lazy_data.uget()._sampler);
     desc_table.BindOffset(gfx, cmd_list, _lazy_data.uget()._root_signature, 0);
     sampler_table.BindOffset(gfx, cmd_list, _lazy_data.uget()._root_signature, 1);
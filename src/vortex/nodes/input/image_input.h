@@ -1,7 +1,7 @@
 #pragma once
 #include <vortex/graph/interfaces.h>
 #include <vortex/probe.h>
-#include <vortex/codec/ffmpeg/codec_ffmpeg.h>
+#include <vortex/gfx/image_cache.h>
 #include <vortex/util/reflection.h>
 #include <DirectXMath.h>
 
@@ -18,6 +18,7 @@ public:
     wis::Sampler _sampler; // Sampler for the texture
     wis::RootSignature _root_signature; // Root signature for the image input node
     wis::PipelineState _pipeline_state; // Pipeline state for rendering the image
+    vortex::ImageCache _cache; // Images shared by all image input nodes
 };
 
 // Rendering a texture from an image input node onto a 2D plane in the scene graph.
@@ -41,10 +42,16 @@ public:
 public:
     void SetImagePath(std::string_view path, bool notify = true);
 
+private:
+    // Replaces the shown image, the previous one may still be sampled by frames in flight
+    void ShowImage(vortex::ImageHandle image);
+
 private:
     lazy_ptr<ImageInputLazy> _lazy_data; // Lazy data for static resources
-    vortex::Texture2D _texture; // Texture loaded from the image file
-    wis::ShaderResource _texture_resource; // Shader resource for the texture
+    vortex::ImageHandle _image; // Image being shown, kept until the next one is loaded
+    std::shared_future<vortex::ImageHandle> _pending_image; // Image being loaded
+    std::array<vortex::ImageHandle, vortex::max_frames_in_flight> _retired_images; // Still in flight
+    uint32_t _retired_index = 0;
     bool path_changed = false; // Flag to check if the node has been initialized
 };
 } // namespace vortex
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include <vortex/nodes/input/sequence_input.h>
+#include <vortex/gfx/descriptor_buffer.h>
+
+#include <vortex/graphics.h>
+#include <vortex/sync/pts_clock.h>
+#include <ranges>
+
+void vortex::SequenceInput::Update(const vortex::Graphics& gfx)
+{
+    if (!path_changed) {
+        return;
+    }
+    path_changed = false;
+    _reader.reset(); // Waits for the frames in flight
+    _cursors.clear();
+    if (sequence_path.empty()) {
+        return;
+    }
+
+    _reader = std::make_unique<ffmpeg::SequenceReader>(gfx, sequence_path);
+    if (!_reader->IsOpen()) {
+        vortex::error("SequenceInput: Failed to open sequence: {}", sequence_path);
+        _reader.reset();
+    }
+}
+
+int32_t vortex::SequenceInput::UpdatePlayback(const vortex::RenderProbe& probe)
+{
+    if (!_reader) {
+        return -1;
+    }
+
+    int32_t count = _reader->FrameCount();
+    int32_t first = std::clamp(in_point, 0, count - 1);
+    int32_t last = out_point < 0 ? count - 1 : std::clamp(out_point, first, count - 1);
+    vortex::ratio32_t rate = _reader->NativeRate().num() > 0 ? _reader->NativeRate() : framerate;
+
+    if (!playing) {
+        // Keep the start of the range resident, so the next trigger shows its first frame at once
+        _cursors.clear();
+        _reader->Seek(first, first, last, loop);
+        return -1;
+    }
+
+    auto& cursor = _cursors[probe.output];
+    if (cursor.start_pts == invalid_pts) {
+        cursor.start_pts = probe.current_pts;
+    }
+    cursor.elapsed_pts = probe.current_pts - cursor.start_pts;
+    cursor.last_pts = probe.current_pts;
+
+    // Outputs that stopped rendering would hold the window back
+    constexpr int64_t stale_pts = vortex::sync::PTSClock::timebase_hz;
+    std::erase_if(_cursors, [&](const auto& pair) { return pair.second.last_pts < probe.current_pts - stale_pts; });
+
+    // Outputs at different PTS all read from one window, so it follows the output furthest behind
+    // and only moves forward with it. Outputs ahead are covered by the read-ahead frames.
+    int64_t behind = std::ranges::min(_cursors | std::views::values, {}, &PlaybackCursor::elapsed_pts).elapsed_pts;
+    _reader->Seek(ffmpeg::SequenceReader::FrameIndexAt(behind, rate, first, last, loop), first, last, loop);
+    return ffmpeg::SequenceReader::FrameIndexAt(cursor.elapsed_pts, rate, first, last, loop);
+}
+
+void vortex::SequenceInput::EvaluateStandby(const vortex::Graphics& gfx, vortex::RenderProbe& probe)
+{
+    // Playback runs on the output clock, keep following it while hidden
+    UpdatePlayback(probe);
+}
+
+bool vortex::SequenceInput::Evaluate(const vortex::Graphics& gfx, vortex::RenderProbe& probe, const vortex::RenderPassForwardDesc* output_info)
+{
+    int32_t index = UpdatePlayback(probe);
+    if (index < 0) {
+        if (_reader) {
+            _reader->ReleaseShown(); // The slot is reused once the frames in flight are done
+        }
+        return false;
+    }
+
+    auto& cmd_list = *probe.command_list;
+    const wis::ShaderResource* frame = _reader->ShowFrame(gfx, cmd_list, index);
+    if (!frame) {
+        return false;
+    }
+
+    wis::RenderPassRenderTargetDesc target_desc{
+        .target = output_info->current_rt_view,
+        .load_op = output_info->GetClipLoadOperation(), // The draw covers the clip rect
+        .store_op = wis::StoreOperation::Store,
+        .clear_value = { 0.f, 0.f, 0.f, 0.f } // Outside the clip stays transparent
+    };
+    wis::RenderPassDesc pass_desc{
+        .target_count = 1,
+        .targets = &target_desc,
+    };
+
+    auto& image_data = _image_data.uget();
+
+    cmd_list.BeginRenderPass(pass_desc);
+    cmd_list.SetPipelineState(image_data._pipeline_state);
+    cmd_list.SetRootSignature(image_data._root_signature);
+    cmd_list.RSSetScissor(output_info->GetScissor());
+    // Frame textures are padded to the row pitch, the padding is stretched past the right edge
+    float width = float(output_info->output_size.width) / _reader->GetWidthScale();
+    cmd_list.RSSetViewport({ 0.f, 0.f, width, float(output_info->output_size.height), 0.f, 1.f });
+    cmd_list.IASetPrimitiveTopology(wis::PrimitiveTopology::TriangleList);
+
+    auto desc_table = probe.descriptor_buffer.SuballocateTable(1);
+    auto sampler_table = probe.sampler_buffer.SuballocateTable(1);
+    desc_table.WriteTexture(0, *frame);
+    sampler_table.WriteSampler(0, image_data._sampler);
+    desc_table.BindOffset(gfx, cmd_list, image_data._root_signature, 0);
+    sampler_table.BindOffset(gfx, cmd_list, image_data._root_signature, 1);
+
+    // Draw a quad that covers the viewport
+    cmd_list.DrawInstanced(3, 1, 0, 0);
+    cmd_list.EndRenderPass();
+    return true;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <vortex/graph/interfaces.h>
+#include <vortex/probe.h>
+#include <vortex/codec/ffmpeg/sequence_reader.h>
+#include <vortex/nodes/input/image_input.h>
+
+#include <vortex/properties/props.hpp>
+#include <vortex/util/lazy.h>
+#include <unordered_map>
+
+namespace vortex {
+// Plays a numbered image sequence or a clip, e.g. a stinger, from the output PTS.
+// The first frames are prefetched while stopped, so playback starts without a hitch.
+// Every output keeps its own playback cursor, the read-ahead window follows the one furthest behind.
+class SequenceInput : public vortex::graph::NodeImpl<SequenceInput, SequenceInputProperties, 0, 1>
+{
+public:
+    SequenceInput(const vortex::Graphics& gfx, SerializedProperties props)
+        : ImplClass(props), _image_data(gfx)
+    {
+    }
+
+public:
+    void Update(const vortex::Graphics& gfx) override;
+    bool Evaluate(const vortex::Graphics& gfx, vortex::RenderProbe& probe, const vortex::RenderPassForwardDesc* output_info = nullptr) override;
+    void EvaluateStandby(const vortex::Graphics& gfx, vortex::RenderProbe& probe) override;
+
+public:
+    void SetSequencePath(std::string_view path, bool notify = false)
+    {
+        SequenceInputProperties::SetSequencePath(path, notify);
+        path_changed = true;
+    }
+
+private:
+    // Advances the cursor of the output of the probe and moves the read-ahead window,
+    // returns the frame to show or -1 when stopped
+    int32_t UpdatePlayback(const vortex::RenderProbe& probe);
+
+private:
+    struct PlaybackCursor {
+        int64_t start_pts = invalid_pts; // PTS at which playback started on the output
+        int64_t elapsed_pts = 0; // Playback time at the last frame of the output
+        int64_t last_pts = invalid_pts; // PTS of the last frame of the output
+    };
+
+    [[no_unique_address]] lazy_ptr<ImageInputLazy> _image_data; // Frames are drawn like images
+
+    std::unique_ptr<ffmpeg::SequenceReader> _reader;
+    std::unordered_map<const void*, PlaybackCursor> _cursors; // Keyed by RenderProbe::output
+    bool path_changed = true; // Flag to reopen the sequence
+};
+} // namespace vortex
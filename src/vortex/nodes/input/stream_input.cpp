@@ -2,14 +2,22 @@
 #include <vortex/graphics.h>
 #include <vortex/codec/ffmpeg/error.h>
 #include <vortex/gfx/descriptor_buffer.h>
+#include <vortex/sync/pts_clock.h>
 
-uint64_t TimeToPts(AVRational timebase, uint64_t time_ms)
+// Matches PlaneConstants in video.ps
+struct VideoConstants {
+    std::array<float, 2> uv_scale; // Visible part of the planes
+    float padding[2];
+};
+
+// Steady clock ticks in microseconds, frames carry the time their packet was read in opaque
+static int64_t SteadyMicroseconds(int64_t ticks)
 {
-    return av_rescale_q(time_ms, { 1, 1000 }, timebase);
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::duration(ticks)).count();
 }
 
 vortex::StreamInputLazy::StreamInputLazy(const vortex::Graphics& gfx)
-    : _manager(gfx)
+    : _manager(gfx, manager_desc)
 {
     wis::Result result = wis::success;
 
@@ -28,9 +36,14 @@ vortex::StreamInputLazy::StreamInputLazy(const vortex::Graphics& gfx)
          .entry_count = 1,
          .stage = wis::ShaderStages::Pixel },
     };
+    wis::PushConstant push_constants[] = {
+        { .stage = wis::ShaderStages::Pixel,
+         .size_bytes = sizeof(VideoConstants),
+         .bind_register = 0 },
+    };
     _root_signature = gfx.GetDescriptorBufferExtension().CreateRootSignature(result,
-                                                                             nullptr,
-                                                                             0,
+                                                                             push_constants,
+                                                                             1,
                                                                              nullptr,
                                                                              0,
                                                                              tables,
@@ -42,14 +55,12 @@ vortex::StreamInputLazy::StreamInputLazy(const vortex::Graphics& gfx)
 
     // Load shaders for the image input node
     auto vertex_shader = gfx.LoadShader("shaders/basic.vs");
-    auto pixel_shader = gfx.LoadShader("shaders/video.ps");
 
-    // Create a pipeline state for the image input node
+    // Create a pipeline state per range and matrix permutation
     wis::GraphicsPipelineDesc pipeline_desc{
         .root_signature = _root_signature,
         .shaders = {
                 .vertex = vertex_shader,
-                .pixel = pixel_shader,
         },
         .attachments = {
                 .attachment_formats = { wis::DataFormat::RGBA8Unorm }, .attachments_count = 1,
@@ -58,10 +69,18 @@ vortex::StreamInputLazy::StreamInputLazy(const vortex::Graphics& gfx)
         .flags = wis::PipelineFlags::DescriptorBuffer,
     };
 
-    _pipeline_state = gfx.GetDevice().CreateGraphicsPipeline(result, pipeline_desc);
-    if (!vortex::success(result)) {
-        vortex::error("ImageInput: Failed to create graphics pipeline: {}", result.error);
-        return;
+    for (uint32_t i = 0; i < _pipeline_states.size(); i++) {
+        vortex::ShaderDefine defines[] = {
+            { "COLOR_RANGE", i / 2 },
+            { "COLOR_MATRIX", i % 2 },
+        };
+        auto pixel_shader = gfx.LoadShader("shaders/video.ps", defines);
+        pipeline_desc.shaders.pixel = pixel_shader;
+        _pipeline_states[i] = gfx.GetDevice().CreateGraphicsPipeline(result, pipeline_desc);
+        if (!vortex::success(result)) {
+            vortex::error("ImageInput: Failed to create graphics pipeline: {}", result.error);
+            return;
+        }
     }
     wis::SamplerDesc sampler_desc{
         .min_filter = wis::Filter::Linear,
@@ -82,23 +101,83 @@ vortex::StreamInputLazy::StreamInputLazy(const vortex::Graphics& gfx)
     _sampler = gfx.GetDevice().CreateSampler(result, sampler_desc);
 }
 
+vortex::StreamInput::~StreamInput()
+{
+    CancelConnection();
+}
+
 void vortex::StreamInput::Update(const vortex::Graphics& gfx)
 {
     // Check if the stream URL has changed
-    if (url_changed && !stream_url.empty()) {
-        InitializeStream();
+    if (url_changed) {
         url_changed = false;
+        CancelConnection();
+        _stream_handle.reset();
+        _video_frames.clear(); // Black until the new source delivers
+        _audio_frames.clear();
+        _connect_attempts = 0;
+        _next_connect = {};
+        SetConnectionState(stream_url.empty() ? StreamState::Idle : StreamState::Connecting);
+    }
+    UpdateConnection();
+
+    // Restart from the configured delay when the buffering changes
+    if (stream_buffering != _applied_buffering) {
+        _jitter.Reset(int64_t(std::max(stream_buffering, 0)) * 1000);
+        _applied_buffering = stream_buffering;
     }
 
     // Decode new frames from the stream
     DecodeStreamFrames(gfx);
 }
-void vortex::StreamInput::InitializeStream()
+void vortex::StreamInput::UpdateConnection()
 {
     if (stream_url.empty()) {
         return;
     }
+    auto& manager = lazy_ptr<StreamInputLazy>::uget()._manager;
+
+    // The newest frame is held while the stream is reconnected
+    if (_stream_handle) {
+        if (!manager.IsStreamDropped(_stream_handle.get())) {
+            return;
+        }
+        vortex::warn("StreamInput: Lost {}, reconnecting", stream_url);
+        _stream_handle.reset();
+        _connect_attempts = 0;
+        _next_connect = {}; // First attempt right away, a restarted source is usually back at once
+        SetConnectionState(StreamState::Reconnecting);
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (!_connection) {
+        if (now >= _next_connect) {
+            Connect();
+        }
+        return;
+    }
+    if (!_connection->done.load(std::memory_order::acquire)) {
+        return; // Still connecting on a connection thread
+    }
+
+    auto connection = std::move(_connection);
+    if (auto handle = ffmpeg::StreamManager::TakeConnection(*connection)) {
+        AdoptStream(handle, connection->channels);
+        _connect_attempts = 0;
+        SetConnectionState(StreamState::Connected);
+        return;
+    }
 
+    // Exponential backoff, so an offline source is not hammered
+    auto delay = std::min(reconnect_max_delay, reconnect_min_delay * (1u << std::min(_connect_attempts, 16u)));
+    _connect_attempts++;
+    _next_connect = now + delay;
+    vortex::warn("StreamInput: Could not connect to {}: {}. Retrying in {} ms",
+                 stream_url, connection->error.message(), delay.count());
+    SetConnectionState(StreamState::Reconnecting);
+}
+void vortex::StreamInput::Connect()
+{
     // Optimized settings for low latency and reduced buffering
     ffmpeg::unique_dictionary options;
     av_dict_set(options.address_of(), "timeout", "10000000", 0); // 5 second timeout
@@ -109,24 +188,38 @@ void vortex::StreamInput::InitializeStream()
     av_dict_set(options.address_of(), "rtbufsize", "1048576", 0); // 1MB buffer
     av_dict_set(options.address_of(), "max_delay", "500000", 0); // 0.5 second max delay
 
-    auto context_result = codec::CodecFFmpeg::ConnectToStream(stream_url, std::move(options));
-    if (!context_result) {
-        return;
+    // Opened, probed and decoders initialized on a connection thread, picked up by UpdateConnection
+    std::array<int, 1> active_indices = { -1 };
+    _connection = lazy_ptr<StreamInputLazy>::uget()._manager.ConnectStream(stream_url, std::move(options), active_indices);
+}
+void vortex::StreamInput::CancelConnection() noexcept
+{
+    if (_connection) {
+        lazy_ptr<StreamInputLazy>::uget()._manager.CancelConnection(*_connection);
+        _connection.reset();
     }
-
-    auto& context = context_result.value();
-
-    auto channels_result = codec::CodecFFmpeg::GetStreams(context.get());
-    if (!channels_result) {
-        return;
+}
+void vortex::StreamInput::AdoptStream(ffmpeg::StreamManager::StreamHandle handle, const codec::StreamChannels& channels)
+{
+    _stream_handle = unique_stream{ handle };
+    _stream_indices[0] = channels.video_channels[0]->index;
+    _video_time_base = channels.video_channels[0]->time_base;
+    _stream_indices[1] = channels.audio_channels.empty() ? -1 : channels.audio_channels[0]->index;
+    _audio_time_base = channels.audio_channels.empty() ? AVRational{ 0, 1 } : channels.audio_channels[0]->time_base;
+
+    // A new connection starts a new timeline, frames of the previous one are released
+    _video_frames.clear();
+    _audio_frames.clear();
+    _jitter.Reset(int64_t(std::max(stream_buffering, 0)) * 1000);
+    _origin_us = invalid_pts;
+    _playout_us = invalid_pts;
+    _audio_source = {}; // Resampler is set up again from the first frame
+}
+void vortex::StreamInput::SetConnectionState(StreamState state)
+{
+    if (stream_state != state) {
+        SetStreamState(state, true); // Reported to the UI
     }
-
-    _stream_collection = std::move(channels_result.value());
-    _stream_indices[0] = _stream_collection.video_channels[0]->index;
-    _stream_indices[1] = _stream_collection.audio_channels[0]->index;
-
-    std::array<int, 1> active_indices = { -1 };
-    _stream_handle = MakeUniqueStream(std::move(context), active_indices);
 }
 void vortex::StreamInput::DecodeStreamFrames(const vortex::Graphics& gfx)
 {
@@ -134,74 +227,91 @@ void vortex::StreamInput::DecodeStreamFrames(const vortex::Graphics& gfx)
         return;
     }
 
-    // TODO: make this less ugly
-    auto& stream = *std::bit_cast<ffmpeg::ManagedStream*>(_stream_handle.get());
-    auto& video_channel = stream.channels.at(_stream_indices[0]);
-    auto& audio_channel = stream.channels.at(_stream_indices[1]);
-
-    DecodeVideoFrames(video_channel);
-    DecodeAudioFrames(audio_channel);
+    // The stream may be shared with other nodes, frames and horizon are this node's own
+    auto& consumer = *std::bit_cast<ffmpeg::StreamConsumer*>(_stream_handle.get());
+    auto* video_channel = consumer.FindChannel(int(_stream_indices[0]));
+    auto* audio_channel = consumer.FindChannel(int(_stream_indices[1]));
+    if (!video_channel) {
+        return; // Decoder failed to open
+    }
 
-    // Remove old video frames (keep only the latest 16 frames)
-    while (_video_frames.size() > 16) {
-        _video_frames.erase(_video_frames.begin());
+    // The rings evict the oldest frames once full
+    DecodeVideoFrames(*video_channel, consumer.slot);
+    if (audio_channel) {
+        DecodeAudioFrames(*audio_channel, consumer.slot);
+    }
+    if (!_jitter.Started()) {
+        return;
     }
-    // Remove old audio frames (keep only the latest 16 frames)
-    while (_audio_frames.size() > 16) {
-        _audio_frames.erase(_audio_frames.begin());
+
+    // The delay moves once per frame on the steady clock, outputs only look the position up
+    _playout_now_us = SteadyMicroseconds(ffmpeg::HopLatency::Now());
+    _playout_us = _jitter.Playout(_playout_now_us);
+    _jitter.Present(_video_frames.lower_bound(ToPts(_playout_us, _video_time_base)) < _video_frames.size());
+
+    // Packets past the lookahead stay in the stream manager, so the delay is not bound by the rings
+    video_channel->SetSendHorizon(consumer.slot, ToPts(_playout_us + decode_lookahead_us, _video_time_base));
+    if (audio_channel) {
+        audio_channel->SetSendHorizon(consumer.slot, ToPts(_playout_us + decode_lookahead_us, _audio_time_base));
     }
 }
 
-bool vortex::StreamInput::Evaluate(const vortex::Graphics& gfx,
-                                   vortex::RenderProbe& probe,
-                                   const vortex::RenderPassForwardDesc* output_info)
+int64_t vortex::StreamInput::PlayoutAt(int64_t master_pts) noexcept
 {
-    // Check if the texture is valid before rendering
-    if (_video_frames.empty()) {
-        // vortex::info("ImageInput: Texture is not valid or has zero size.");
-        return false; // Skip rendering if texture is not valid
+    if (master_pts == invalid_pts) {
+        return _playout_us; // Not driven by an output, use the time of the update
     }
 
-    auto now = std::chrono::steady_clock::now();
-    if (_first_video_pts == invalid_pts) {
-        return false;
+    // The master clock runs on the steady clock, latch the offset once so the output cadence is kept
+    int64_t master_us = av_rescale_q(master_pts, { 1, int(sync::PTSClock::timebase_hz) }, { 1, 1'000'000 });
+    if (_master_offset_us == invalid_pts || std::abs(_playout_now_us - master_us - _master_offset_us) > master_resync_us) {
+        _master_offset_us = _playout_now_us - master_us;
     }
+    return _jitter.MediaAt(_master_offset_us + master_us);
+}
+int64_t vortex::StreamInput::ToMediaTime(int64_t pts, AVRational time_base) const noexcept
+{
+    return av_rescale_q(pts, time_base, { 1, 1'000'000 }) - _origin_us;
+}
+int64_t vortex::StreamInput::ToPts(int64_t media_us, AVRational time_base) const noexcept
+{
+    return av_rescale_q(media_us + _origin_us, { 1, 1'000'000 }, time_base);
+}
 
-    static std::streamsize frames_available = 0;
-    uint64_t elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now -
-                                                                                _start_time_video)
-                                  .count();
-    uint64_t current_video_pts = _first_video_pts +
-            TimeToPts(_stream_collection.video_channels[0]->time_base, elapsed_ms);
-    // adjust for some latency
-    current_video_pts = std::max<int64_t>(_first_video_pts, current_video_pts - 2000);
-    auto it = _video_frames.lower_bound(current_video_pts);
-    if (it == _video_frames.end()) {
-        return false; // No frames ready to be played
+void vortex::StreamInput::EvaluateStandby(const vortex::Graphics& gfx, vortex::RenderProbe& probe)
+{
+    if (!_jitter.Started() || _video_frames.empty()) {
+        return;
     }
 
-    AVFrame* frame = it->second.get();
+    // Frames are still decoded by Update, only release the ones that can no longer be shown,
+    // so the decoder surfaces are returned and the stream stays at the live edge.
+    std::size_t index = _video_frames.lower_bound(ToPts(PlayoutAt(probe.current_pts), _video_time_base));
+    if (index > 0) {
+        _video_frames.pop_front(index - 1);
+    }
+}
 
+bool vortex::StreamInput::BindHardwareFrame(const vortex::Graphics& gfx, const AVFrame& frame, uint32_t slot)
+{
     // Get D3D12 texture from the frame
-    auto result_texture = ffmpeg::GetTextureFromFrame(*frame);
+    auto result_texture = ffmpeg::GetTextureFromFrame(frame);
     if (!result_texture) {
         vortex::warn("StreamInput: Failed to get texture from frame: {}",
                      result_texture.error().message());
         return false;
     }
-    auto& texture = _textures[probe.frame_number % vortex::max_frames_in_flight] = std::move(
-            result_texture.value());
+    auto& texture = _textures[slot] = std::move(result_texture.value());
 
-    auto result_fence = ffmpeg::GetFenceFromFrame(*frame);
+    auto result_fence = ffmpeg::GetFenceFromFrame(frame);
     if (!result_fence) {
         vortex::warn("StreamInput: Failed to get fence from frame: {}",
                      result_fence.error().message());
         return false;
     }
-    auto& fence = _fences[probe.frame_number % vortex::max_frames_in_flight] = std::move(
-            result_fence.value());
+    auto& fence = _fences[slot] = std::move(result_fence.value());
 
-    auto fence_value = ffmpeg::GetFenceValueFromFrame(*frame);
+    auto fence_value = ffmpeg::GetFenceValueFromFrame(frame);
     if (!fence_value) {
         vortex::warn("StreamInput: Failed to get fence value from frame: {}",
                      fence_value.error().message());
@@ -209,10 +319,6 @@ bool vortex::StreamInput::Evaluate(const vortex::Graphics& gfx,
     }
     uint64_t value = fence_value.value();
 
-    // Suballocate a table
-    auto desc_table = probe.descriptor_buffer.SuballocateTable(2);
-    auto sampler_table = probe.sampler_buffer.SuballocateTable(1);
-
     // Create shader resource
     auto& device = gfx.GetDevice();
     wis::Result res = wis::success;
@@ -225,43 +331,81 @@ bool vortex::StreamInput::Evaluate(const vortex::Graphics& gfx,
          .subresource_range = { 0, 1, 0, 1 } }
     };
 
-    _shader_resources[probe.frame_number %
-                      vortex::max_frames_in_flight] = vortex::ffmpeg::DX12CreateSRVNV12(res,
-                                                                                        device,
-                                                                                        texture,
-                                                                                        descs);
-
-    std::ignore = gfx.GetMainQueue().WaitQueue(fence, value); // Wait for the frame to be ready
-
-    // Bind the texture and sampler to the command list
-    desc_table.WriteTexture(
-            0,
-            _shader_resources[probe.frame_number % vortex::max_frames_in_flight][0]); // Y plane
-    desc_table.WriteTexture(
-            1,
-            _shader_resources[probe.frame_number % vortex::max_frames_in_flight][1]); // UV plane
+    _shader_resources[slot] = vortex::ffmpeg::DX12CreateSRVNV12(res, device, texture, descs);
+
+    std::ignore = gfx.WaitQueue(fence, value); // Wait for the frame to be ready
+    return true;
+}
+
+bool vortex::StreamInput::Evaluate(const vortex::Graphics& gfx,
+                                   vortex::RenderProbe& probe,
+                                   const vortex::RenderPassForwardDesc* output_info)
+{
+    // Check if the texture is valid before rendering
+    if (_video_frames.empty()) {
+        // vortex::info("ImageInput: Texture is not valid or has zero size.");
+        return false; // Skip rendering if texture is not valid
+    }
+
+    if (!_jitter.Started()) {
+        return false;
+    }
+
+    // Frames are picked by the output's time, so a drifting source repeats or skips a frame
+    // Decoder is behind, hold the newest frame instead of a blank one
+    std::size_t next = _video_frames.lower_bound(ToPts(PlayoutAt(probe.current_pts), _video_time_base));
+    std::size_t index = std::min(next, _video_frames.size() - 1);
+    AVFrame* frame = _video_frames[index].value.get();
+
+    auto& cmd_list = *probe.command_list;
+    uint32_t slot = probe.frame_number % vortex::max_frames_in_flight;
+    VideoConstants constants{ .uv_scale = { 1.f, 1.f } };
+
+    // Suballocate a table
+    auto desc_table = probe.descriptor_buffer.SuballocateTable(2);
+    auto sampler_table = probe.sampler_buffer.SuballocateTable(1);
+
+    if (frame->hw_frames_ctx) {
+        if (!BindHardwareFrame(gfx, *frame, slot)) {
+            return false;
+        }
+        desc_table.WriteTexture(0, _shader_resources[slot][0]); // Y plane
+        desc_table.WriteTexture(1, _shader_resources[slot][1]); // UV plane
+    } else {
+        // Software decoded, the copy is recorded before the pass
+        if (!_uploader.Upload(gfx, cmd_list, *frame)) {
+            return false;
+        }
+        auto& planes = _uploader.GetPlanes();
+        desc_table.WriteTexture(0, planes[0]); // Y plane
+        desc_table.WriteTexture(1, planes[1]); // UV plane
+        constants.uv_scale = _uploader.GetUVScale();
+    }
     sampler_table.WriteSampler(0, _lazy_data.uget()._sampler);
 
     wis::RenderPassRenderTargetDesc target_desc{
         .target = output_info->current_rt_view,
-        .load_op = wis::LoadOperation::Clear,
+        .load_op = output_info->GetClipLoadOperation(), // The draw covers the clip rect
         .store_op = wis::StoreOperation::Store,
-        .clear_value = { 0.f, 0.f, 0.f, 1.f }  // Clear to transparent black
+        .clear_value = { 0.f, 0.f, 0.f, 0.f } // Outside the clip stays transparent
     };
     wis::RenderPassDesc pass_desc{
         .target_count = 1,
         .targets = &target_desc,
     };
 
-    auto& cmd_list = *probe.command_list;
     auto& root = _lazy_data.uget()._root_signature;
 
+    // Unspecified color spaces are treated as BT.709 limited range
+    bool full_range = frame->color_range == AVCOL_RANGE_JPEG;
+    bool bt601 = frame->colorspace == AVCOL_SPC_BT470BG || frame->colorspace == AVCOL_SPC_SMPTE170M;
+
     // Begin the render pass
     cmd_list.BeginRenderPass(pass_desc);
-    cmd_list.SetPipelineState(_lazy_data.uget()._pipeline_state);
+    cmd_list.SetPipelineState(_lazy_data.uget().GetPipelineState(full_range, bt601));
     cmd_list.SetRootSignature(root);
-    cmd_list.RSSetScissor(
-            { 0, 0, int(output_info->output_size.width), int(output_info->output_size.height) });
+    cmd_list.SetPushConstants(&constants, sizeof(constants) / 4, 0, wis::ShaderStages::Pixel);
+    cmd_list.RSSetScissor(output_info->GetScissor());
     cmd_list.RSSetViewport({ 0.f,
                              0.f,
                              float(output_info->output_size.width),
@@ -279,107 +423,148 @@ bool vortex::StreamInput::Evaluate(const vortex::Graphics& gfx,
     return true;
 }
 
-void vortex::StreamInput::EvaluateAudio(vortex::AudioProbe& probe)
+bool vortex::StreamInput::ResetAudioResampler(const AVFrame& frame, uint32_t sample_rate) noexcept
 {
-    auto now = std::chrono::steady_clock::now();
-    if (_first_audio_pts == invalid_pts) {
-        return;
+    std::array<int, 3> source{ frame.format, frame.sample_rate, frame.ch_layout.nb_channels };
+    if (source == _audio_source && _audio_resampler.IsInitialized()) {
+        return true;
     }
 
-    static std::streamsize samples_available = 0;
+    ffmpeg::ResamplerDesc desc;
+    desc.src_format = AVSampleFormat(frame.format);
+    desc.src_rate = frame.sample_rate;
+    desc.dst_rate = int(sample_rate);
+    if (av_channel_layout_copy(desc.src_layout.address_of(), &frame.ch_layout) < 0) {
+        return false;
+    }
+    if (auto error = _audio_resampler.Reset(std::move(desc))) {
+        vortex::error("StreamInput: Failed to create audio resampler: {}", error.message());
+        _audio_source = {};
+        return false;
+    }
+    _audio_source = source;
+    return true;
+}
 
-    uint64_t elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now -
-                                                                                _start_time_audio)
-                                  .count();
-    int64_t current_audio_pts = _first_audio_pts +
-            TimeToPts(_stream_collection.audio_channels[0]->time_base, elapsed_ms);
+void vortex::StreamInput::EvaluateAudio(vortex::AudioProbe& probe)
+{
+    if (!_jitter.Started() || _audio_frames.empty()) {
+        return;
+    }
 
-    int64_t pick_pts = std::max(current_audio_pts, probe.last_audio_pts);
-    if (current_audio_pts > probe.last_audio_pts) {
-        vortex::warn("StreamInput: Audio is lagging behind by {} ms",
-                     (current_audio_pts - probe.last_audio_pts) *
-                             _stream_collection.audio_channels[0]->time_base.num /
-                             _stream_collection.audio_channels[0]->time_base.den * 1000);
+    // Audio follows the same playout position as video, at the output's time
+    AVRational time_base = _audio_time_base;
+    int64_t target_us = PlayoutAt(probe.current_pts);
+    int64_t target_pts = ToPts(target_us, time_base);
+
+    // Continue where the output left off, unless it is too far off to be pulled back by resampling
+    int64_t from_pts = probe.last_audio_pts;
+    int64_t error_us = from_pts == invalid_pts ? 0 : ToMediaTime(from_pts, time_base) - target_us;
+    if (from_pts == invalid_pts || std::abs(error_us) > audio_resync_us) {
+        if (from_pts != invalid_pts) {
+            vortex::warn("StreamInput: Audio is {} ms off the playout position, resyncing", error_us / 1000);
+        }
+        from_pts = target_pts;
+        error_us = 0;
     }
 
-    // Get all audio frames that are ready to be played
-    auto it = _audio_frames.lower_bound(pick_pts);
-    if (it == _audio_frames.end()) {
+    // Frames that are due by the output's time
+    std::size_t first = _audio_frames.lower_bound(from_pts);
+    std::size_t last = std::min(_audio_frames.lower_bound(target_pts + 1), first + 3); // Limit to 3 frames to avoid excessive latency
+    if (first >= last) {
         return; // No frames ready to be played
     }
 
-    std::size_t frames = std::distance(it, _audio_frames.end());
-    if (frames > 3) {
-        frames = 3; // Limit to 3 frames to avoid excessive latency
+    const AVFrame& head = *_audio_frames[first].value.get();
+    if (!ResetAudioResampler(head, probe.audio_sample_rate)) {
+        return;
     }
 
-    AVFrame* frame = it->second.get();
-    probe.first_audio_pts = it->first;
+    // A slow sender is stretched to fill real time, audio queued ahead of the playout position is shrunk,
+    // by at most 0.5% so the pitch change stays inaudible
+    int in_samples = 0;
+    for (std::size_t i = first; i < last; ++i) {
+        in_samples += _audio_frames[i].value.get()->nb_samples;
+    }
+    int out_samples = int(av_rescale(in_samples, probe.audio_sample_rate, head.sample_rate));
+    int delta = int(double(out_samples) * (1.0 / _jitter.GetStats().clock_rate - 1.0)) -
+            int(av_rescale(error_us, probe.audio_sample_rate, 1'000'000));
+    delta = std::clamp(delta, -out_samples / audio_max_correction, out_samples / audio_max_correction);
+    if (auto error = _audio_resampler.SetCompensation(delta, std::max(out_samples, 1))) {
+        vortex::warn("StreamInput: Failed to set audio drift compensation: {}", error.message());
+    }
 
-    auto& data = probe.audio_data;
-    data.resize(frame->ch_layout.nb_channels * frame->nb_samples * frames);
-    auto delta = frame->nb_samples * frames;
-
-    for (std::size_t i = 0; i < frames; ++i) {
-        AVFrame* frame = it->second.get();
-        // MOCK: assume the audio is already in float format and has stereo planar layout
-        if (frame->format == AV_SAMPLE_FMT_FLTP && frame->ch_layout.nb_channels == 2) {
-            std::memcpy(data.data() + frame->nb_samples * i,
-                        frame->data[0],
-                        frame->nb_samples * sizeof(float)); // Left channel
-            std::memcpy(data.data() + delta + frame->nb_samples * i,
-                        frame->data[1],
-                        frame->nb_samples * sizeof(float)); // Right channel
-        } else {
-            vortex::warn("StreamInput: Unsupported audio format or channel count. Expected float "
-                         "planar stereo.");
+    int capacity = int(_audio_resampler.GetOutputSampleCount(in_samples)) + std::abs(delta);
+    for (auto& plane : _audio_planes) {
+        plane.resize(capacity);
+    }
+    std::array<uint8_t*, 2> planes{ reinterpret_cast<uint8_t*>(_audio_planes[0].data()),
+                                    reinterpret_cast<uint8_t*>(_audio_planes[1].data()) };
+
+    int written = 0;
+    for (std::size_t i = first; i < last; ++i) {
+        auto& entry = _audio_frames[i];
+        if (entry.value.get()->sample_rate != head.sample_rate || entry.value.get()->format != head.format) {
+            break; // Format changed mid stream, picked up by the next output frame
+        }
+        auto result = _audio_resampler.ConvertFrame(*entry.value.get(), planes, capacity - written);
+        if (!result) {
+            vortex::warn("StreamInput: Failed to resample audio: {}", result.error().message());
+            break;
         }
-        probe.last_audio_pts = it->first + frame->duration;
-        it = std::next(it);
+        written += *result;
+        for (auto& plane : planes) {
+            plane += *result * sizeof(float);
+        }
+        probe.last_audio_pts = entry.pts + entry.value.get()->duration;
+    }
+    if (written == 0) {
+        return;
     }
 
-    // probe.last_audio_pts = it->first + frame->duration;
+    // Planar stereo, left samples followed by right ones
+    probe.first_audio_pts = _audio_frames[first].pts;
+    auto& data = probe.audio_data;
+    data.resize(std::size_t(written) * 2);
+    std::copy_n(_audio_planes[0].begin(), written, data.begin());
+    std::copy_n(_audio_planes[1].begin(), written, data.begin() + written);
 }
 
-void vortex::StreamInput::DecodeVideoFrames(vortex::ffmpeg::ChannelStorage& video_channel)
+void vortex::StreamInput::DecodeVideoFrames(vortex::ffmpeg::ChannelStorage& video_channel, uint32_t consumer)
 {
     static int64_t last_pts = invalid_pts;
 
     // try read frames from atomic queue
-    while (auto frame = video_channel.GetDecodedFrame()) {
-        // if first audio frame, set the first audio pts
-        if (_first_video_pts == invalid_pts) {
-            _start_time_video = std::chrono::steady_clock::now();
-            _first_video_pts = _first_video_pts == invalid_pts ? frame->get()->pts
-                                                               : _first_video_pts;
+    auto time_base = _video_time_base;
+    while (auto frame = video_channel.GetDecodedFrame(consumer)) {
+        AVFrame* raw_frame = frame->get();
+        if (_origin_us == invalid_pts) {
+            _origin_us = av_rescale_q(raw_frame->pts, time_base, { 1, 1'000'000 });
         }
 
-        AVFrame* raw_frame = frame->get();
+        // Jitter is measured on the time the packet was read, not when it was decoded
+        int64_t read_ticks = static_cast<int64_t>(reinterpret_cast<intptr_t>(raw_frame->opaque));
+        _jitter.Arrive(ToMediaTime(raw_frame->pts, time_base),
+                       SteadyMicroseconds(read_ticks ? read_ticks : ffmpeg::HopLatency::Now()));
+
         // vortex::info("Drained audio frame with PTS: {}, nb_samples: {}, dpts: {}",
         // raw_frame->pts, raw_frame->nb_samples, raw_frame->pts - last_pts);
         last_pts = raw_frame->pts;
 
-        _video_frames[raw_frame->pts] = std::move(frame.value());
+        _video_frames.push(raw_frame->pts, std::move(frame.value()));
     }
 }
-void vortex::StreamInput::DecodeAudioFrames(vortex::ffmpeg::ChannelStorage& audio_channel)
+void vortex::StreamInput::DecodeAudioFrames(vortex::ffmpeg::ChannelStorage& audio_channel, uint32_t consumer)
 {
     static int64_t last_pts = invalid_pts;
 
     // try read frames from atomic queue
-    while (auto frame = audio_channel.GetDecodedFrame()) {
-        // if first audio frame, set the first audio pts
-        if (_first_audio_pts == invalid_pts) {
-            _start_time_audio = std::chrono::steady_clock::now();
-            _first_audio_pts = _first_audio_pts == invalid_pts ? frame->get()->pts
-                                                               : _first_audio_pts;
-        }
-
+    while (auto frame = audio_channel.GetDecodedFrame(consumer)) {
         AVFrame* raw_frame = frame->get();
         // vortex::info("Drained audio frame with PTS: {}, nb_samples: {}, dpts: {}",
         // raw_frame->pts, raw_frame->nb_samples, raw_frame->pts - last_pts);
         last_pts = raw_frame->pts;
 
-        _audio_frames[raw_frame->pts] = std::move(frame.value());
+        _audio_frames.push(raw_frame->pts, std::move(frame.value()));
     }
 }
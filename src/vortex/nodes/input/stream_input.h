@@ -6,8 +6,11 @@
 
 #include <vortex/properties/props.hpp>
 #include <vortex/util/lazy.h>
+#include <vortex/util/pts_ring.h>
 #include <vortex/codec/ffmpeg/stream_manager.h>
 #include <vortex/codec/ffmpeg/audio_resampler.h>
+#include <vortex/codec/ffmpeg/frame_uploader.h>
+#include <vortex/sync/jitter_buffer.h>
 
 namespace vortex {
 // Will hold static data for the image input node
@@ -15,26 +18,39 @@ struct StreamInputLazy {
 public:
     StreamInputLazy(const vortex::Graphics& gfx);
 
+    // Settings of the shared stream manager, must be set before the first stream input is created
+    static void Configure(const ffmpeg::StreamManagerDesc& desc) noexcept { manager_desc = desc; }
+
+public:
+    // Shader permutation for the range and matrix of the frame
+    wis::PipelineView GetPipelineState(bool full_range, bool bt601) const noexcept
+    {
+        return _pipeline_states[size_t(full_range) * 2 + size_t(bt601)];
+    }
+
 public:
     wis::Sampler _sampler; // Sampler for the texture
     wis::RootSignature _root_signature; // Root signature for the image input node
-    wis::PipelineState _pipeline_state; // Pipeline state for rendering the image
+    std::array<wis::PipelineState, 4> _pipeline_states; // Indexed by COLOR_RANGE * 2 + COLOR_MATRIX
+    static inline ffmpeg::StreamManagerDesc manager_desc;
     ffmpeg::StreamManager _manager; // Stream manager for handling streams
 };
 
 // Rendering a texture from an image input node onto a 2D plane in the scene graph.
 class StreamInput : public vortex::graph::NodeImpl<StreamInput, StreamInputProperties, 0, 2>
 {
+    static constexpr std::size_t frame_ring_size = 16; // Newest decoded frames kept per channel
+    static constexpr int64_t decode_lookahead_us = 200'000; // Decoded ahead of playout, the rest of the delay is held as packets
+    static constexpr int64_t master_resync_us = 1'000'000; // Master timeline jumps past this re-anchor the playout
+    static constexpr int64_t audio_resync_us = 200'000; // Audio drifted further than this restarts at the playout position
+    static constexpr int audio_max_correction = 200; // Audio is stretched by at most 1/200 of its samples (0.5%)
+
 private:
     static void UnregisterStream(ffmpeg::StreamManager::StreamHandle handle) noexcept
     {
         lazy_ptr<StreamInputLazy>::uget()._manager.UnregisterStream(handle);
     }
     using unique_stream = vortex::unique_any<ffmpeg::StreamManager::StreamHandle, UnregisterStream>;
-    unique_stream MakeUniqueStream(ffmpeg::unique_context context, std::span<int> active_channel_indices) noexcept
-    {
-        return unique_stream{ lazy_ptr<StreamInputLazy>::uget()._manager.RegisterStream(std::move(context), active_channel_indices) };
-    }
 
 public:
     StreamInput(const vortex::Graphics& gfx, SerializedProperties props)
@@ -42,10 +58,12 @@ public:
     {
         _sources.sources[1].type = graph::SourceType::Audio; // Second source is audio
     }
+    ~StreamInput() override;
 
 public:
     void Update(const vortex::Graphics& gfx) override;
     bool Evaluate(const vortex::Graphics& gfx, vortex::RenderProbe& probe, const vortex::RenderPassForwardDesc* output_info = nullptr) override;
+    void EvaluateStandby(const vortex::Graphics& gfx, vortex::RenderProbe& probe) override;
 
     vortex::graph::NodeExecution Validate(const vortex::Graphics& gfx, const vortex::RenderProbe& probe)
     {
@@ -59,38 +77,72 @@ public:
         url_changed = true;
     }
 
+    // Playout delay, buffer depth, underruns and late frames
+    const sync::JitterBuffer::Stats& GetBufferStats() const noexcept { return _jitter.GetStats(); }
+    // Read rate, decoder and queue counters of the connected stream, empty while not connected
+    std::optional<ffmpeg::StreamStats> GetIngestStats() const
+    {
+        if (!_stream_handle) {
+            return std::nullopt;
+        }
+        return lazy_ptr<StreamInputLazy>::uget()._manager.GetStats(_stream_handle.get());
+    }
+
 private:
-    void InitializeStream();
+    void Connect();
+    void UpdateConnection();
+    void CancelConnection() noexcept;
+    void AdoptStream(ffmpeg::StreamManager::StreamHandle handle, const codec::StreamChannels& channels);
+    void SetConnectionState(StreamState state);
+    int64_t PlayoutAt(int64_t master_pts) noexcept;
+    bool ResetAudioResampler(const AVFrame& frame, uint32_t sample_rate) noexcept;
+    int64_t ToMediaTime(int64_t pts, AVRational time_base) const noexcept;
+    int64_t ToPts(int64_t media_us, AVRational time_base) const noexcept;
+    bool BindHardwareFrame(const vortex::Graphics& gfx, const AVFrame& frame, uint32_t slot);
     void DecodeStreamFrames(const vortex::Graphics& gfx);
     void EvaluateAudio(vortex::AudioProbe& probe) override;
 
-    void DecodeVideoFrames(vortex::ffmpeg::ChannelStorage& video_channel);
-    void DecodeAudioFrames(vortex::ffmpeg::ChannelStorage& audio_channel);
+    void DecodeVideoFrames(vortex::ffmpeg::ChannelStorage& video_channel, uint32_t consumer);
+    void DecodeAudioFrames(vortex::ffmpeg::ChannelStorage& audio_channel, uint32_t consumer);
 
 private:
     [[no_unique_address]] lazy_ptr<StreamInputLazy> _lazy_data; // Lazy data for static resources
     std::array<wis::ShaderResource, 2> _shader_resources[vortex::max_frames_in_flight]; // Shader resource for the texture
     wis::Texture _textures[vortex::max_frames_in_flight]; // Textures for each frame in flight
     wis::Fence _fences[vortex::max_frames_in_flight]; // Fences for each frame in flight
+    ffmpeg::FrameUploader _uploader; // Planes of software decoded frames
 
     // Stream related data
-    codec::StreamChannels _stream_collection; // Collection of streams
+    AVRational _video_time_base{ 0, 1 }; // Kept past the stream, held frames are still timed by it
+    AVRational _audio_time_base{ 0, 1 };
 
-    std::map<int64_t, ffmpeg::unique_frame> _video_frames; // Map of video frames by pts
-    std::map<int64_t, ffmpeg::unique_frame> _audio_frames; // Map of audio frames by pts
-    std::array<int64_t, 2> _stream_indices{}; // Indices of the video and audio streams
+    pts_ring<ffmpeg::pooled_frame, frame_ring_size> _video_frames; // Video frames by pts
+    pts_ring<ffmpeg::pooled_frame, frame_ring_size> _audio_frames; // Audio frames by pts
+    std::array<int64_t, 2> _stream_indices{ -1, -1 }; // Indices of the video and audio streams, -1 if absent
 
     unique_stream _stream_handle; // Handle to the stream managed by StreamManager
     ffmpeg::unique_swscontext _sws_context;
     ffmpeg::unique_swrcontext _swr_context;
     bool url_changed = true; // Flag to check if the node has been initialized
 
-private: // Stream synchronization
-    int64_t _first_video_pts{ invalid_pts }; // First video PTS for synchronization
-    int64_t _first_audio_pts{ invalid_pts }; // First audio PTS for synchronization
-    std::chrono::steady_clock::time_point _start_time_video;
-    std::chrono::steady_clock::time_point _start_time_audio;
+private: // Stream connection
+    static constexpr std::chrono::milliseconds reconnect_min_delay{ 500 }; // First retry after a failed attempt
+    static constexpr std::chrono::milliseconds reconnect_max_delay{ 30'000 }; // Backoff doubles up to this
+
+    std::shared_ptr<ffmpeg::StreamConnection> _connection; // Connection in progress on a connection thread
+    std::chrono::steady_clock::time_point _next_connect{}; // Not attempted again before this
+    uint32_t _connect_attempts = 0; // Failed attempts since the last connection
 
-    ffmpeg::AudioResampler _audio_resampler; // Resampler for audio frames
+private: // Stream synchronization
+    sync::JitterBuffer _jitter; // Playout delay, starts at stream_buffering
+    int32_t _applied_buffering = -1; // stream_buffering the jitter buffer was reset to
+    int64_t _origin_us{ invalid_pts }; // Media time zero, the first video frame
+    int64_t _playout_us{ invalid_pts }; // Media time played out this frame
+    int64_t _playout_now_us{ 0 }; // Steady clock time _playout_us was taken at
+    int64_t _master_offset_us{ invalid_pts }; // Steady clock minus master timeline, latched on first use
+
+    ffmpeg::AudioResampler _audio_resampler; // Resampler for audio frames, also absorbs the clock drift
+    std::array<int, 3> _audio_source{}; // Sample format, rate and channels the resampler was set up for
+    std::array<std::vector<float>, 2> _audio_planes; // Resampled stereo planes of the output frame
 };
 } // namespace vortex
\ No newline at end of file
@@ -5,12 +5,15 @@
 #endif // NDI_AVAILABLE
 
 #include <vortex/nodes/output/window_output.h>
+#include <vortex/nodes/output/encoder_output.h>
 #include <vortex/nodes/input/image_input.h>
 #include <vortex/nodes/input/stream_input.h>
+#include <vortex/nodes/input/sequence_input.h>
 #include <vortex/nodes/filter/blend.h>
 #include <vortex/nodes/filter/select.h>
 #include <vortex/nodes/filter/transform.h>
 #include <vortex/nodes/filter/color_correction.h>
+#include <vortex/nodes/filter/compositor.h>
 
 void vortex::RegisterHardwareNodes()
 {
@@ -19,10 +22,13 @@ void vortex::RegisterHardwareNodes()
 #endif // NDI_AVAILABLE
 
     vortex::WindowOutput::RegisterNode();
+    vortex::EncoderOutput::RegisterNode();
     vortex::ImageInput::RegisterNode();
     vortex::StreamInput::RegisterNode();
+    vortex::SequenceInput::RegisterNode();
     vortex::Blend::RegisterNode();
     vortex::Select::RegisterNode();
     vortex::Transform::RegisterNode();
     vortex::ColorCorrection::RegisterNode();
+    vortex::Compositor::RegisterNode();
 }
@@ -0,0 +1,500 @@
+#include <vortex/nodes/output/encoder_output.h>
+#include <vortex/graphics.h>
+#include <vortex/probe.h>
+#include <vortex/sync/pts_clock.h>
+#include <vortex/util/log.h>
+#include <algorithm>
+#include <bit>
+
+extern "C" {
+#include <libavutil/imgutils.h>
+}
+
+namespace {
+constexpr uint64_t readback_timeout_ns = 1'000'000'000;
+
+AVCodecID GetCodecID(vortex::VideoCodec codec) noexcept
+{
+    switch (codec) {
+    case vortex::VideoCodec::HEVC:
+        return AV_CODEC_ID_HEVC;
+    case vortex::VideoCodec::H264:
+    default:
+        return AV_CODEC_ID_H264;
+    }
+}
+vortex::ffmpeg::EncoderKind GetEncoderKind(vortex::EncoderBackend backend) noexcept
+{
+    switch (backend) {
+    case vortex::EncoderBackend::Software:
+        return vortex::ffmpeg::EncoderKind::Software;
+    case vortex::EncoderBackend::Hardware:
+        return vortex::ffmpeg::EncoderKind::Hardware;
+    case vortex::EncoderBackend::Auto:
+    default:
+        return vortex::ffmpeg::EncoderKind::Any;
+    }
+}
+
+// Copies the padded rows of the readback into the frame
+void CopyReadback(const uint8_t* data, const vortex::NV12Layout& layout, AVFrame& frame) noexcept
+{
+    av_image_copy_plane(frame.data[0], frame.linesize[0], data, int(layout.row_pitch), int(layout.width), int(layout.height));
+    av_image_copy_plane(frame.data[1], frame.linesize[1], data + ptrdiff_t(layout.row_pitch) * layout.height,
+                        int(layout.row_pitch), int(layout.width), int(layout.height / 2));
+}
+} // namespace
+
+vortex::EncoderOutput::EncoderOutput(const vortex::Graphics& gfx, SerializedProperties props)
+    : ImplClass(props)
+    , _lazy_data(gfx)
+    , _desc_buffer(gfx, 256, 32)
+    , _texture_pool(gfx,
+                    {
+                            .format = format,
+                            .size = { window_size.x, window_size.y },
+                    })
+{
+    wis::Result result = wis::success;
+    auto& device = gfx.GetDevice();
+    for (auto& cmd_list : _command_lists) {
+        cmd_list = device.CreateCommandList(result, wis::QueueType::Graphics);
+        if (!vortex::success(result)) {
+            vortex::error("Failed to create command list for EncoderOutput: {}", result.error);
+            return;
+        }
+    }
+    _command_list_aux = device.CreateCommandList(result, wis::QueueType::Graphics);
+    if (!vortex::success(result)) {
+        vortex::error("Failed to create auxiliary command list for EncoderOutput: {}", result.error);
+        return;
+    }
+
+    _fence = device.CreateFence(result);
+    if (!vortex::success(result)) {
+        vortex::error("Failed to create fence for EncoderOutput: {}", result.error);
+        return;
+    }
+    CreateResources(gfx);
+    _settings_changed = false; // Started by the first update when encoding is set
+}
+
+void vortex::EncoderOutput::Update(const vortex::Graphics& gfx)
+{
+    // Slots and frames are sized for the running encoder, it is finished before they change
+    if (_resized || _settings_changed) {
+        StopEncoding();
+        if (_resized) {
+            Throttle(_fence_value - 1); // Textures of both frames in flight are replaced
+            CreateResources(gfx);
+            _resized = false;
+        }
+        _settings_changed = false;
+    }
+
+    // A failed encoder is kept until encoding is toggled or the settings change
+    bool running = _encode_thread.joinable();
+    bool wanted = encoding && !output_url.empty() && _layout.width > 0;
+    if (wanted && !running) {
+        StartEncoding();
+    } else if (!wanted && running) {
+        StopEncoding();
+    }
+
+    auto state = _state.load(std::memory_order::acquire);
+    if (encoder_state != state) {
+        SetEncoderState(state, true); // Reported to the UI
+    }
+}
+
+bool vortex::EncoderOutput::Evaluate(const vortex::Graphics& gfx, int64_t pts)
+{
+    auto sink = _sinks.sinks[0];
+    if (!sink || _state.load(std::memory_order::acquire) != EncoderState::Encoding) {
+        return false; // Rendered only while the encoder is open
+    }
+
+    // Frames are numbered on the output framerate from the first one sent
+    if (_first_pts == invalid_pts) {
+        _first_pts = pts;
+    }
+    int64_t frame = av_rescale(pts - _first_pts, int64_t(framerate.numerator), int64_t(framerate.denominator) * int64_t(sync::PTSClock::timebase_hz));
+    if (frame <= _last_frame) {
+        return false; // Same frame of the encoder timeline
+    }
+    _last_frame = frame;
+
+    // The encoder still holds the slot, it fell behind and the frame is dropped instead of waiting
+    auto& slot = _slots[_slot_index];
+    if (slot.busy.load(std::memory_order::acquire)) {
+        if (std::has_single_bit(++_frames_dropped)) {
+            vortex::warn("EncoderOutput: Encoder is behind, {} frames dropped", _frames_dropped);
+        }
+        return false;
+    }
+
+    // Resources of the frame in flight are reused once the GPU is done, the encoder is never waited on
+    Throttle(_fence_values[_frame_index]);
+
+    RenderProbe probe{
+        .descriptor_buffer = _desc_buffer.DescBufferView(_frame_index),
+        .sampler_buffer = _desc_buffer.SamplerBufferView(_frame_index),
+        .texture_pool = _texture_pool,
+        .command_list = &_command_lists[_frame_index],
+        .frame_number = _frame_index,
+        .output_framerate = GetFramerate(),
+
+        // PTS timing information (90kHz timebase)
+        .current_pts = pts,
+        .output_base_pts = GetBasePTS(),
+        .output = this,
+    };
+
+    // Pass to the sink nodes for post-order processing
+    RenderPassForwardDesc desc{
+        .current_rt_view = _render_targets[_frame_index],
+        .output_size = { window_size.x, window_size.y },
+        .rt_generation = invalid_generation,
+        .depth = 1, // send +1
+    };
+
+    // Barrier to ensure the render target is ready for rendering
+    auto& cmd_list = *probe.command_list;
+    std::ignore = cmd_list.Reset();
+    _desc_buffer.BindBuffers(gfx, cmd_list);
+    cmd_list.TextureBarrier(
+            {
+                    .sync_before = wis::BarrierSync::Compute,
+                    .sync_after = wis::BarrierSync::RenderTarget,
+                    .access_before = wis::ResourceAccess::ShaderResource,
+                    .access_after = wis::ResourceAccess::RenderTarget,
+                    .state_before = wis::TextureState::ShaderResource,
+                    .state_after = wis::TextureState::RenderTarget,
+            },
+            _textures[_frame_index]);
+
+    if (!sink.source_node->EvaluateThrough(gfx, probe, &desc)) {
+        return false; // Nothing to do
+    }
+    ConvertToNV12(gfx, cmd_list, probe.descriptor_buffer, slot);
+
+    // End the command list
+    if (!cmd_list.Close()) {
+        vortex::error("Failed to close command list for EncoderOutput");
+        return false;
+    }
+    auto result = gfx.Submit({ cmd_list }, _fence, _fence_value);
+    if (!vortex::success(result)) {
+        vortex::error("Failed to signal fence for EncoderOutput: {}", result.error);
+        return false;
+    }
+
+    // The encode thread waits for the readback, the render loop moves on
+    slot.busy.store(true, std::memory_order::relaxed); // Published by the push
+    std::ignore = _jobs.try_push(EncodeJob{ .slot = _slot_index, .fence_value = _fence_value, .frame_index = frame });
+    _jobs_signal.notify();
+
+    _fence_values[_frame_index] = _fence_value++;
+    _frame_index = (_frame_index + 1) % vortex::max_frames_in_flight;
+    _slot_index = (_slot_index + 1) % readback_slots;
+    _texture_pool.SwapFrame(); // Swap the texture pool frame
+    return true;
+}
+
+void vortex::EncoderOutput::Throttle(uint64_t fence_value) const
+{
+    wis::Result res = _fence.Wait(fence_value, readback_timeout_ns);
+    if (res.status == wis::Status::Timeout) {
+        vortex::warn("EncoderOutput: Timeout while waiting for fence in Throttle(). The GPU may be "
+                     "unresponsive.");
+    } else if (!vortex::success(res)) {
+        vortex::error("EncoderOutput: Failed to wait for fence in Throttle(): {}", res.error);
+    }
+}
+
+bool vortex::EncoderOutput::CreateResources(const vortex::Graphics& gfx)
+{
+    for (auto& slot : _slots) {
+        if (slot.data) {
+            slot.buffer.Unmap();
+        }
+        slot.buffer = {};
+        slot.data = nullptr;
+    }
+    _layout = {};
+
+    auto layout = NV12Layout::FromSize(window_size.x, window_size.y);
+    if (layout.width == 0 || layout.height == 0) {
+        vortex::error("EncoderOutput: Resolution {}x{} is too small to encode", window_size.x, window_size.y);
+        return false;
+    }
+
+    auto& allocator = gfx.GetAllocator();
+    auto& device = gfx.GetDevice();
+    wis::Result result = wis::success;
+    wis::TextureDesc desc{
+        .format = format,
+        .size = { window_size.x, window_size.y },
+        .layout = wis::TextureLayout::Texture2D,
+        .usage = wis::TextureUsage::RenderTarget | wis::TextureUsage::ShaderResource,
+    };
+    wis::ShaderResourceDesc srv_desc{
+        .format = format,
+        .view_type = wis::TextureViewType::Texture2D,
+        .component_mapping = {},
+        .subresource_range = { .base_mip_level = 0,
+                              .level_count = 1,
+                              .base_array_layer = 0,
+                              .layer_count = 1 }
+    };
+
+    for (uint32_t i = 0; i < vortex::max_frames_in_flight; ++i) {
+        _textures[i] = allocator.CreateTexture(result, desc);
+        if (!vortex::success(result)) {
+            vortex::error("Failed to create EncoderOutput texture: {}", result.error);
+            return false;
+        }
+        _render_targets[i] = device.CreateRenderTarget(result, _textures[i], wis::RenderTargetDesc{ .format = format });
+        if (!vortex::success(result)) {
+            vortex::error("Failed to create render target for EncoderOutput: {}", result.error);
+            return false;
+        }
+        _srvs[i] = device.CreateShaderResource(result, _textures[i], srv_desc);
+        if (!vortex::success(result)) {
+            vortex::error("Failed to create EncoderOutput texture SRV: {}", result.error);
+            return false;
+        }
+        _nv12_buffers[i] = allocator.CreateBuffer(result,
+                                                  layout.SizeBytes(),
+                                                  wis::BufferUsage::StorageBuffer | wis::BufferUsage::CopySrc,
+                                                  wis::MemoryType::DeviceLocal,
+                                                  wis::MemoryFlags::None);
+        if (!vortex::success(result)) {
+            vortex::error("Failed to create EncoderOutput conversion buffer: {}", result.error);
+            return false;
+        }
+    }
+
+    for (auto& slot : _slots) {
+        slot.buffer = allocator.CreateBuffer(result,
+                                             layout.SizeBytes(),
+                                             wis::BufferUsage::CopyDst,
+                                             wis::MemoryType::Readback,
+                                             wis::MemoryFlags::Mapped);
+        if (!vortex::success(result)) {
+            vortex::error("Failed to create EncoderOutput readback buffer: {}", result.error);
+            return false;
+        }
+        slot.data = slot.buffer.Map<uint8_t>();
+    }
+
+    // Textures start as shader resources, each frame transitions them to render targets
+    wis::TextureBarrier2 barriers[vortex::max_frames_in_flight];
+    for (uint32_t i = 0; i < vortex::max_frames_in_flight; ++i) {
+        barriers[i] = {
+            .barrier = {
+                    .sync_before = wis::BarrierSync::None,
+                    .sync_after = wis::BarrierSync::None,
+                    .access_before = wis::ResourceAccess::NoAccess,
+                    .access_after = wis::ResourceAccess::NoAccess,
+                    .state_before = wis::TextureState::Undefined,
+                    .state_after = wis::TextureState::ShaderResource,
+            },
+            .texture = _textures[i],
+        };
+    }
+    std::ignore = _command_list_aux.Reset();
+    _command_list_aux.TextureBarriers(barriers, vortex::max_frames_in_flight);
+    _command_list_aux.Close();
+
+    gfx.ExecuteCommandLists({ _command_list_aux });
+    gfx.WaitForGPU();
+
+    _layout = layout;
+    return true;
+}
+
+void vortex::EncoderOutput::ConvertToNV12(const vortex::Graphics& gfx,
+                                          wis::CommandList& cmd_list,
+                                          vortex::DescriptorBufferView dbv,
+                                          ReadbackSlot& slot)
+{
+    auto& resources = _lazy_data.uget();
+    auto& nv12_buffer = _nv12_buffers[_frame_index];
+
+    // Close the render target
+    cmd_list.TextureBarrier(
+            {
+                    .sync_before = wis::BarrierSync::RenderTarget,
+                    .sync_after = wis::BarrierSync::Compute,
+                    .access_before = wis::ResourceAccess::RenderTarget,
+                    .access_after = wis::ResourceAccess::ShaderResource,
+                    .state_before = wis::TextureState::RenderTarget,
+                    .state_after = wis::TextureState::ShaderResource,
+            },
+            _textures[_frame_index]);
+
+    cmd_list.SetComputeRootSignature(resources._root_signature);
+    cmd_list.SetPipelineState(resources._pipeline_state);
+
+    auto table = dbv.SuballocateTable(2);
+    table.WriteTexture(0, _srvs[_frame_index]);
+    table.WriteRWBuffer(1, nv12_buffer, 4, _layout.SizeBytes() / 4);
+    table.BindComputeOffset(gfx, cmd_list, resources._root_signature, 0);
+
+    // Each thread converts a 4x2 block, thread group size is 16x16
+    // So each thread group covers 64x32 pixels
+    uint32_t groups_x = (_layout.row_pitch / 4 + 15) / 16;
+    uint32_t groups_y = (_layout.height / 2 + 15) / 16;
+    cmd_list.Dispatch(groups_x, groups_y, 1);
+
+    cmd_list.BufferBarrier(
+            {
+                    .sync_before = wis::BarrierSync::Compute,
+                    .sync_after = wis::BarrierSync::Copy,
+                    .access_before = wis::ResourceAccess::Common,
+                    .access_after = wis::ResourceAccess::Common,
+            },
+            nv12_buffer);
+
+    wis::BufferRegion region = { .size_bytes = _layout.SizeBytes() };
+    cmd_list.CopyBuffer(nv12_buffer, slot.buffer, region);
+}
+
+void vortex::EncoderOutput::StartEncoding()
+{
+    ffmpeg::VideoEncoderDesc desc{
+        .url = output_url,
+        .width = _layout.width,
+        .height = _layout.height,
+        .rate = framerate,
+        .bitrate = int64_t(std::max(bitrate, 1)) * 1000,
+        .codec = GetCodecID(video_codec),
+        .input_format = AV_PIX_FMT_NV12,
+        .color_space = AVCOL_SPC_BT709, // Matches the conversion shader
+        .kind = GetEncoderKind(encoder_backend),
+    };
+
+    _first_pts = invalid_pts;
+    _last_frame = -1;
+    _frames_dropped = 0;
+    _frames_encoded.store(0, std::memory_order::relaxed);
+    _state.store(EncoderState::Starting, std::memory_order::release);
+    _encode_thread = std::jthread([this, desc, layout = _layout](std::stop_token stop) {
+        EncodeLoop(stop, desc, layout);
+    });
+}
+
+void vortex::EncoderOutput::StopEncoding()
+{
+    if (!_encode_thread.joinable()) {
+        return;
+    }
+    // Frames already read back are encoded before the output is finished
+    _encode_thread.request_stop();
+    _encode_thread.join();
+    vortex::info("EncoderOutput: Stopped {}, {} frames encoded, {} dropped",
+                 output_url, _frames_encoded.load(std::memory_order::relaxed), _frames_dropped);
+    _state.store(EncoderState::Stopped, std::memory_order::release);
+}
+
+void vortex::EncoderOutput::EncodeLoop(std::stop_token stop, ffmpeg::VideoEncoderDesc desc, NV12Layout layout)
+{
+    std::stop_callback wake_on_stop(stop, [this] { _jobs_signal.notify(); });
+
+    // Opened here, hardware encoders and network outputs can take a while to start
+    std::unique_ptr<ffmpeg::VideoEncoder> encoder;
+    ffmpeg::unique_frame frame{ av_frame_alloc() };
+    if (auto opened = ffmpeg::VideoEncoder::Open(desc); opened && frame) {
+        frame->format = AV_PIX_FMT_NV12;
+        frame->width = int(layout.width);
+        frame->height = int(layout.height);
+        if (av_frame_get_buffer(frame.get(), 0) >= 0) {
+            encoder = std::move(opened.value());
+        }
+    }
+    _state.store(encoder ? EncoderState::Encoding : EncoderState::Failed, std::memory_order::release);
+
+    while (true) {
+        uint32_t observed = _jobs_signal.value();
+        EncodeJob job;
+        if (!_jobs.try_pop(job)) {
+            if (stop.stop_requested()) {
+                break; // Drained
+            }
+            _jobs_signal.wait(observed);
+            continue;
+        }
+
+        auto& slot = _slots[job.slot];
+        wis::Result result = _fence.Wait(job.fence_value, readback_timeout_ns);
+        bool ready = vortex::success(result);
+        if (!ready) {
+            vortex::error("EncoderOutput: Readback of frame {} did not complete: {}", job.frame_index, result.error);
+        }
+
+        // The slot is handed back as soon as the frame is copied out, encoding runs after
+        bool copied = ready && encoder && av_frame_make_writable(frame.get()) >= 0;
+        if (copied) {
+            CopyReadback(slot.data, layout, *frame);
+        }
+        slot.busy.store(false, std::memory_order::release);
+        if (!copied) {
+            continue;
+        }
+
+        frame->pts = job.frame_index;
+        if (!encoder->Encode(*frame)) {
+            encoder.reset(); // Finished, remaining frames are released without encoding
+            _state.store(EncoderState::Failed, std::memory_order::release);
+            continue;
+        }
+        _frames_encoded.fetch_add(1, std::memory_order::relaxed);
+    }
+
+    if (encoder) {
+        std::ignore = encoder->Finish();
+    }
+}
+
+//-----------------------------------------------------------------------------
+vortex::EncoderOutputLazy::EncoderOutputLazy(const vortex::Graphics& gfx)
+{
+    wis::Result result = wis::success;
+    auto& device = gfx.GetDevice();
+    auto& desc_buf = gfx.GetDescriptorBufferExtension();
+
+    // Create root signature
+    wis::DescriptorTableEntry entries[] = {
+        {  .type = wis::DescriptorType::Texture,
+         .bind_register = 0,
+         .binding = 0,
+         .count = 1,
+         .binding_space = 0 },
+        { .type = wis::DescriptorType::RWBuffer,
+         .bind_register = 0,
+         .binding = 1,
+         .count = 1,
+         .binding_space = 0 }
+    };
+    wis::DescriptorTable table{
+        .type = wis::DescriptorHeapType::Descriptor,
+        .entries = entries,
+        .entry_count = std::size(entries),
+        .stage = wis::ShaderStages::All,
+    };
+    _root_signature = desc_buf.CreateRootSignature(result, nullptr, 0, nullptr, 0, &table, 1);
+    if (!vortex::success(result)) {
+        vortex::error("Failed to create EncoderOutput conversion root signature: {}", result.error);
+        return;
+    }
+
+    auto shader = gfx.LoadShader("shaders/rgba_to_nv12.cs");
+
+    wis::ComputePipelineDesc pipeline_desc{ .root_signature = _root_signature, .shader = shader };
+    _pipeline_state = device.CreateComputePipeline(result, pipeline_desc);
+    if (!vortex::success(result)) {
+        vortex::error("Failed to create EncoderOutput conversion pipeline state: {}", result.error);
+        return;
+    }
+}
@@ -0,0 +1,153 @@
+#pragma once
+#include <vortex/graph/interfaces.h>
+#include <vortex/properties/props.hpp>
+#include <vortex/codec/ffmpeg/video_encoder.h>
+#include <vortex/gfx/descriptor_buffer.h>
+#include <vortex/gfx/texture_pool.h>
+#include <vortex/util/lazy.h>
+#include <vortex/util/lib/SPSC-Queue.h>
+#include <vortex/util/wake_signal.h>
+#include <atomic>
+#include <thread>
+
+namespace vortex {
+// RGBA to NV12 conversion shared by all encoder outputs
+struct EncoderOutputLazy {
+public:
+    EncoderOutputLazy(const vortex::Graphics& gfx);
+
+public:
+    wis::RootSignature _root_signature; // Texture in, NV12 buffer out
+    wis::PipelineState _pipeline_state; // Compute pipeline state for conversion
+};
+
+// Layout of the NV12 frames written by the conversion and read back for the encoder
+struct NV12Layout {
+    uint32_t width = 0; // Encoded size, rounded down to even
+    uint32_t height = 0;
+    uint32_t row_pitch = 0; // Bytes, rows are padded to whole uints by the conversion
+
+    static NV12Layout FromSize(uint32_t width, uint32_t height) noexcept
+    {
+        return { width & ~1u, height & ~1u, (width + 3) / 4 * 4 };
+    }
+    uint32_t SizeBytes() const noexcept { return row_pitch * height / 2 * 3; } // Luma and half height chroma
+};
+
+// Encodes the graph to a file or a network stream. Frames are rendered and converted to NV12 on the GPU,
+// copied to a ring of readback slots and encoded on a thread of the node. A frame whose slot is still
+// held by the encoder is dropped, so a slow encoder never stalls the render loop.
+class EncoderOutput : public vortex::graph::OutputImpl<EncoderOutput, EncoderOutputProperties>
+{
+    static constexpr wis::DataFormat format = wis::DataFormat::RGBA8Unorm; // Default format for
+                                                                           // render targets
+    static constexpr uint32_t readback_slots = 4; // Frames between the render loop and the encoder
+
+    struct ReadbackSlot {
+        wis::Buffer buffer; // NV12 copied from the GPU, mapped for the encode thread
+        const uint8_t* data = nullptr;
+        std::atomic<bool> busy{ false }; // Held by the encode thread until the frame is copied out
+    };
+    struct EncodeJob {
+        uint32_t slot = 0;
+        uint64_t fence_value = 0; // Signalled once the readback is complete
+        int64_t frame_index = 0; // Presentation time in frames of the framerate
+    };
+
+public:
+    EncoderOutput(const vortex::Graphics& gfx, SerializedProperties props);
+    ~EncoderOutput()
+    {
+        StopEncoding(); // Finalizes the file
+        Throttle(_fence_value - 1); // Wait for GPU to finish before destroying resources
+    }
+
+public:
+    // Properties, the encoder is restarted with the new settings
+    void SetOutputUrl(std::string_view value, bool notify = false)
+    {
+        EncoderOutputProperties::SetOutputUrl(value, notify);
+        _settings_changed = true;
+    }
+    void SetWindowSize(DirectX::XMUINT2 value, bool notify = false)
+    {
+        EncoderOutputProperties::SetWindowSize(value, notify);
+        _resized = IsInitialized();
+    }
+    void SetFramerate(vortex::ratio32_t value, bool notify = false)
+    {
+        EncoderOutputProperties::SetFramerate(value, notify);
+        _settings_changed = true;
+    }
+    void SetBitrate(int32_t value, bool notify = false)
+    {
+        EncoderOutputProperties::SetBitrate(value, notify);
+        _settings_changed = true;
+    }
+    void SetVideoCodec(VideoCodec value, bool notify = false)
+    {
+        EncoderOutputProperties::SetVideoCodec(value, notify);
+        _settings_changed = true;
+    }
+    void SetEncoderBackend(EncoderBackend value, bool notify = false)
+    {
+        EncoderOutputProperties::SetEncoderBackend(value, notify);
+        _settings_changed = true;
+    }
+
+public:
+    virtual vortex::ratio32_t GetOutputFPS() const noexcept { return GetFramerate(); }
+    virtual wis::Size2D GetOutputSize() const noexcept { return { window_size.x, window_size.y }; }
+
+    virtual void Update(const vortex::Graphics& gfx) override;
+    virtual bool Evaluate(const vortex::Graphics& gfx, int64_t pts) override;
+
+    uint64_t GetFramesEncoded() const noexcept { return _frames_encoded.load(std::memory_order::relaxed); }
+    uint64_t GetFramesDropped() const noexcept { return _frames_dropped; }
+
+private:
+    void Throttle(uint64_t fence_value) const;
+    bool CreateResources(const vortex::Graphics& gfx);
+    void ConvertToNV12(const vortex::Graphics& gfx,
+                       wis::CommandList& cmd_list,
+                       vortex::DescriptorBufferView dbv,
+                       ReadbackSlot& slot);
+
+    void StartEncoding();
+    void StopEncoding();
+    void EncodeLoop(std::stop_token stop, ffmpeg::VideoEncoderDesc desc, NV12Layout layout);
+
+private:
+    [[no_unique_address]] vortex::lazy_ptr<EncoderOutputLazy> _lazy_data;
+
+    wis::CommandList _command_lists[vortex::max_frames_in_flight];
+    wis::CommandList _command_list_aux; // Initial transitions of the textures
+    wis::Texture _textures[vortex::max_frames_in_flight]; // Rendered frames
+    wis::RenderTarget _render_targets[vortex::max_frames_in_flight];
+    wis::ShaderResource _srvs[vortex::max_frames_in_flight]; // Conversion input
+    wis::Buffer _nv12_buffers[vortex::max_frames_in_flight]; // Conversion output
+    ReadbackSlot _slots[readback_slots];
+    NV12Layout _layout;
+
+    wis::Fence _fence; ///< Fence for synchronization
+    uint64_t _fence_value = 1; ///< Current fence value for synchronization
+    uint64_t _fence_values[vortex::max_frames_in_flight] = {}; ///< Last fence value of each frame in flight
+    uint32_t _frame_index = 0; ///< Current frame in flight
+    uint32_t _slot_index = 0; ///< Next readback slot
+
+    int64_t _first_pts = invalid_pts; ///< Output PTS of the first encoded frame
+    int64_t _last_frame = -1; ///< Last frame index sent to the encoder
+    uint64_t _frames_dropped = 0;
+    bool _resized = false; ///< Flag to indicate if the output has been resized
+    bool _settings_changed = false; ///< Encoder settings changed, restarted by Update
+
+    vortex::DescriptorBuffer _desc_buffer;
+    vortex::TexturePool _texture_pool;
+
+    dro::SPSCQueue<EncodeJob, readback_slots> _jobs; // Render loop to encode thread
+    vortex::wake_signal _jobs_signal;
+    std::atomic<EncoderState> _state{ EncoderState::Stopped }; // Published by the encode thread
+    std::atomic<uint64_t> _frames_encoded{ 0 };
+    std::jthread _encode_thread; // Declared last, stopped before the slots are freed
+};
+} // namespace vortex
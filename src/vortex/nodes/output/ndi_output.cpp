@@ -94,7 +94,7 @@ void vortex::NDIOutput::Update(const vortex::Graphics& gfx)
 bool vortex::NDIOutput::Evaluate(const vortex::Graphics& gfx, int64_t pts)
 {
     bool video = EvaluateVideo(gfx, _desc_buffer, pts);
-    bool audio = EvaluateAudio();
+    bool audio = EvaluateAudio(pts);
 
     // Return true if either video or audio was processed
     // The scheduler will mark this output as presented after this call
@@ -113,7 +113,7 @@ void vortex::NDIOutput::Throttle() const
     }
 }
 
-bool vortex::NDIOutput::EvaluateAudio()
+bool vortex::NDIOutput::EvaluateAudio(int64_t pts)
 {
     auto sinks = _sinks.GetSinks();
     if (!sinks[1]) {
@@ -126,6 +126,7 @@ bool vortex::NDIOutput::EvaluateAudio()
     audio_probe.audio_sample_rate = audio_sample_rate; // 48 kHz (Used to determine if input is
                                                        // needed)
     audio_probe.last_audio_pts = _last_audio_pts; // Start from the last PTS
+    audio_probe.current_pts = pts;
     sinks[1].source_node->EvaluateAudio(audio_probe);
 
     if (!audio_probe.audio_data.empty()) {
@@ -179,6 +180,7 @@ bool vortex::NDIOutput::EvaluateVideo(const vortex::Graphics& gfx,
         // PTS timing information
         .current_pts = pts,
         .output_base_pts = GetBasePTS(),
+        .output = this,
     };
 
     // Pass to the sink nodes for post-order processing
@@ -204,7 +206,7 @@ bool vortex::NDIOutput::EvaluateVideo(const vortex::Graphics& gfx,
             },
             current_texture);
 
-    bool res = sink.source_node->Evaluate(gfx, probe, &desc);
+    bool res = sink.source_node->EvaluateThrough(gfx, probe, &desc);
     if (!res) {
         // Nothing to do, just return
         return false;
@@ -221,12 +223,8 @@ bool vortex::NDIOutput::EvaluateVideo(const vortex::Graphics& gfx,
         return false;
     }
 
-    auto& queue = gfx.GetMainQueue();
-    wis::CommandListView views[]{ cmd_list };
-    queue.ExecuteCommandLists(views, std::size(views));
-
     // Signal the fence for the current frame
-    result = queue.SignalQueue(_fence, _fence_value);
+    result = gfx.Submit({ cmd_list }, _fence, _fence_value);
     if (!vortex::success(result)) {
         vortex::error("Failed to signal fence for NDIOutput: {}", result.error);
         return false;
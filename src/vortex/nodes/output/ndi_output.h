@@ -61,7 +61,7 @@ public:
 
 private:
     void Throttle() const;
-    bool EvaluateAudio();
+    bool EvaluateAudio(int64_t pts);
     bool EvaluateVideo(const vortex::Graphics& gfx,
                        vortex::DescriptorBuffer& desc_buffer,
                        int64_t pts);
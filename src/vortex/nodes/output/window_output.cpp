@@ -69,13 +69,15 @@ void vortex::WindowOutput::Throttle() noexcept
 void vortex::WindowOutput::Present(const vortex::Graphics& gfx) noexcept
 {
     // Present the swapchain (non-blocking for window output)
-    if (auto result = _swapchain.Present(); !vortex::success(result)) {
-        vortex::error("Failed to present swapchain: {}", result.error);
-        return;
+    {
+        auto lock = gfx.LockMainQueue();
+        if (auto result = _swapchain.Present(); !vortex::success(result)) {
+            vortex::error("Failed to present swapchain: {}", result.error);
+            return;
+        }
     }
 
-    auto& queue = gfx.GetMainQueue();
-    auto result = queue.SignalQueue(_fence, _fence_value);
+    auto result = gfx.SignalQueue(_fence, _fence_value);
     if (!vortex::success(result)) {
         vortex::error("Failed to signal queue for WindowOutput: {}", result.error);
         return;
@@ -99,7 +101,10 @@ void vortex::WindowOutput::Update(const vortex::Graphics& gfx)
         auto [width, height] = _window.PixelSize();
         Throttle(); // Ensure the GPU is ready for the resize operation
 
-        std::ignore = _swapchain.Resize(width, height);
+        {
+            auto lock = gfx.LockMainQueue();
+            std::ignore = _swapchain.Resize(width, height);
+        }
         // Recreate the render targets after resizing the swapchain
         wis::Result result = wis::success;
         for (size_t i = 0; i < _textures.size(); ++i) {
@@ -145,6 +150,7 @@ bool vortex::WindowOutput::Evaluate(const vortex::Graphics& gfx, int64_t pts)
         // PTS timing information (90kHz timebase)
         .current_pts = pts,
         .output_base_pts = GetBasePTS(),
+        .output = this,
     };
 
     // Barrier to ensure the render target is ready for rendering
@@ -164,7 +170,7 @@ bool vortex::WindowOutput::Evaluate(const vortex::Graphics& gfx, int64_t pts)
             _textures[_frame_index]);
 
     // Pass to the next nodes in the graph
-    bool rendered = sink.source_node->Evaluate(gfx, probe, &desc);
+    bool rendered = sink.source_node->EvaluateThrough(gfx, probe, &desc);
     if (!rendered) {
         return false; // Rendering failed
     }
@@ -1,9 +1,13 @@
 #pragma once
 #include <wisdom/wisdom.hpp>
+#include <DirectXMath.h>
+#include <algorithm>
+#include <cmath>
 #include <vector>
 #include <vortex/util/rational.h>
 #include <vortex/gfx/descriptor_buffer.h>
 #include <vortex/gfx/texture_pool.h>
+#include <vortex/util/rect.h>
 
 struct SDL_AudioStream;
 
@@ -21,6 +25,8 @@ struct RenderProbe
     vortex::ratio32_t output_framerate = { 60, 1 }; // Default 60 FPS
     int64_t current_pts = invalid_pts;     // Current presentation timestamp
     int64_t output_base_pts = invalid_pts; // Target presentation timestamp for this frame
+
+    const void* output = nullptr; // Output the frame is rendered for, keys per-output state of nodes
 };
 
 struct AudioProbe {
@@ -29,6 +35,7 @@ struct AudioProbe {
     uint32_t audio_channels = 2; // Default stereo
     int64_t first_audio_pts = invalid_pts; // First audio PTS for synchronization
     int64_t last_audio_pts = invalid_pts; // Last audio PTS for synchronization
+    int64_t current_pts = invalid_pts; // Presentation time of the output frame on the master timeline (90kHz)
 };
 
 struct RenderPassForwardDesc {
@@ -38,5 +45,57 @@ struct RenderPassForwardDesc {
     uint32_t rt_index = invalid_property_index; // Index of the render target if allocated from pool (for blocking)
     uint32_t rt_generation = invalid_generation; // Generation of the render target
     uint32_t depth = 0; // Depth of the graph
+
+    // Region of the target the result is kept in (x, y, width, height; normalized 0-1).
+    // Everything outside is left transparent, consumers fold crops into it instead of masking.
+    DirectX::XMFLOAT4 clip_rect{ 0.0f, 0.0f, 1.0f, 1.0f };
+
+public:
+    bool IsClipped() const noexcept
+    {
+        return clip_rect.x > 0.0f || clip_rect.y > 0.0f || clip_rect.x + clip_rect.z < 1.0f ||
+                clip_rect.y + clip_rect.w < 1.0f;
+    }
+
+    // Pixels whose centers lie strictly inside the clip rect, same as the crop test in shaders
+    wis::Scissor GetScissor() const noexcept
+    {
+        return { PixelEdge(clip_rect.x, output_size.width, true),
+                 PixelEdge(clip_rect.y, output_size.height, true),
+                 PixelEdge(clip_rect.x + clip_rect.z, output_size.width, false),
+                 PixelEdge(clip_rect.y + clip_rect.w, output_size.height, false) };
+    }
+
+    // Clip scissor narrowed to the bounds a node writes. Bounds are rounded like the clip rect,
+    // which matches rasterization, so equal edges land on the same pixel.
+    wis::Scissor GetScissor(DirectX::XMFLOAT4 bounds) const noexcept
+    {
+        auto clip = GetScissor();
+        int left = std::max(clip.left, PixelEdge(bounds.x, output_size.width, true));
+        int top = std::max(clip.top, PixelEdge(bounds.y, output_size.height, true));
+        int right = std::min(clip.right, PixelEdge(bounds.x + bounds.z, output_size.width, false));
+        int bottom = std::min(clip.bottom, PixelEdge(bounds.y + bounds.w, output_size.height, false));
+        return { left, top, std::max(right, left), std::max(bottom, top) }; // Empty, never inverted
+    }
+
+    // Load operation of a pass that draws every pixel inside the clip scissor. Render pass clears
+    // can't be limited to a rect, so the target is only cleared to transparent when it is clipped,
+    // the draw then fills the clip rect and the clear is left visible outside of it only.
+    wis::LoadOperation GetClipLoadOperation() const noexcept
+    {
+        return IsClipped() ? wis::LoadOperation::Clear : wis::LoadOperation::DontCare;
+    }
+
+    // Narrows the clip rect to the intersection with the given normalized rect
+    void ClipTo(DirectX::XMFLOAT4 rect) noexcept { clip_rect = IntersectRect(clip_rect, rect); }
+
+private:
+    // Edge of the first pixel whose center is past a normalized position, clamped to the target
+    static int PixelEdge(float value, uint32_t size, bool begin) noexcept
+    {
+        float px = value * float(size) - 0.5f;
+        int pixel = begin ? int(std::floor(px)) + 1 : int(std::ceil(px));
+        return std::clamp(pixel, 0, int(size));
+    }
 };
 } // namespace vortex
\ No newline at end of file
@@ -37,6 +37,73 @@ struct enum_traits<LUTInterp> {
         "Tetrahedral",
     };
 };
+enum class TransitionType {
+    Cut, //<UI name - Cut:
+    Mix, //<UI name - Mix:
+    Wipe, //<UI name - Wipe:
+};
+template<>
+struct enum_traits<TransitionType> {
+    static constexpr std::string_view strings[] = {
+        "Cut",
+        "Mix",
+        "Wipe",
+    };
+};
+enum class StreamState {
+    Idle, //<UI name - Idle:
+    Connecting, //<UI name - Connecting:
+    Connected, //<UI name - Connected:
+    Reconnecting, //<UI name - Reconnecting:
+};
+template<>
+struct enum_traits<StreamState> {
+    static constexpr std::string_view strings[] = {
+        "Idle",
+        "Connecting",
+        "Connected",
+        "Reconnecting",
+    };
+};
+enum class VideoCodec {
+    H264, //<UI name - H.264:
+    HEVC, //<UI name - HEVC:
+};
+template<>
+struct enum_traits<VideoCodec> {
+    static constexpr std::string_view strings[] = {
+        "H264",
+        "HEVC",
+    };
+};
+enum class EncoderBackend {
+    Auto, //<UI name - Auto:
+    Software, //<UI name - Software:
+    Hardware, //<UI name - Hardware:
+};
+template<>
+struct enum_traits<EncoderBackend> {
+    static constexpr std::string_view strings[] = {
+        "Auto",
+        "Software",
+        "Hardware",
+    };
+};
+enum class EncoderState {
+    Stopped, //<UI name - Stopped:
+    Starting, //<UI name - Starting:
+    Encoding, //<UI name - Encoding:
+    Failed, //<UI name - Failed:
+};
+template<>
+struct enum_traits<EncoderState> {
+    static constexpr std::string_view strings[] = {
+        "Stopped",
+        "Starting",
+        "Encoding",
+        "Failed",
+    };
+};
 struct BlendProperties {
     UpdateNotifier notifier; // Callback for property change notifications
 public:
@@ -200,9 +267,15 @@ public:
     static constexpr auto
             property_map = frozen::make_unordered_map<frozen::string,
                                                       std::pair<uint32_t, PropertyType>>({
-                    { "input_index", { 0, PropertyType::I32 } },
+                    {         "input_index", { 0, PropertyType::I32 } },
+                    {          "transition", { 1, PropertyType::I32 } },
+                    { "transition_duration", { 2, PropertyType::I32 } },
     });
     int32_t input_index{ 0 }; //<UI attribute - Input Index: Index of the input to select.
+    TransitionType transition{ TransitionType::Cut }; //<UI attribute - Transition: How to switch to
+                                                      //the selected input.
+    int32_t transition_duration{ 500 }; //<UI attribute - Transition Duration: Duration of mix and
+                                        //wipe transitions in milliseconds.
 
 public:
     void SetInputIndex(int32_t value, bool notify = false)
@@ -212,6 +285,20 @@ public:
             NotifyPropertyChange(0);
         }
     }
+    void SetTransition(TransitionType value, bool notify = false)
+    {
+        transition = value;
+        if (notify) {
+            NotifyPropertyChange(1);
+        }
+    }
+    void SetTransitionDuration(int32_t value, bool notify = false)
+    {
+        transition_duration = value;
+        if (notify) {
+            NotifyPropertyChange(2);
+        }
+    }
 
 public:
     template<typename Self>
@@ -219,6 +306,16 @@ public:
     {
         return self.input_index;
     }
+    template<typename Self>
+    TransitionType GetTransition(this Self&& self)
+    {
+        return self.transition;
+    }
+    template<typename Self>
+    int32_t GetTransitionDuration(this Self&& self)
+    {
+        return self.transition_duration;
+    }
 
 public:
     template<typename Self>
@@ -232,6 +329,16 @@ public:
         case 0:
             self.notifier(0, vortex::reflection_traits<int32_t>::serialize(self.GetInputIndex()));
             break;
+        case 1:
+            self.notifier(
+                    1,
+                    vortex::reflection_traits<TransitionType>::serialize(self.GetTransition()));
+            break;
+        case 2:
+            self.notifier(
+                    2,
+                    vortex::reflection_traits<int32_t>::serialize(self.GetTransitionDuration()));
+            break;
         default:
             vortex::error("Select: Invalid property index for notification: {}", index);
             break;
@@ -252,6 +359,18 @@ public:
                 self.SetInputIndex(out_value, notify);
             }
             break;
+        case 1:
+            if (TransitionType out_value;
+                vortex::reflection_traits<TransitionType>::deserialize(&out_value, value)) {
+                self.SetTransition(out_value, notify);
+            }
+            break;
+        case 2:
+            if (int32_t out_value;
+                vortex::reflection_traits<int32_t>::deserialize(&out_value, value)) {
+                self.SetTransitionDuration(out_value, notify);
+            }
+            break;
         default:
             vortex::error("Select: Invalid property index: {}", index);
             break; // Invalid index, cannot set property
@@ -269,6 +388,12 @@ public:
         case 0:
             self.SetInputIndex(std::get<int32_t>(value), notify);
             break;
+        case 1:
+            self.SetTransition(static_cast<TransitionType>(std::get<int32_t>(value)), notify);
+            break;
+        case 2:
+            self.SetTransitionDuration(std::get<int32_t>(value), notify);
+            break;
         default:
             vortex::error("Select: Invalid property index: {}", index);
             break; // Invalid index, cannot set property
@@ -277,9 +402,14 @@ public:
     template<typename Self>
     std::string Serialize(this Self& self)
     {
-        return std::format("{{ input_index: {}}}",
-                           vortex::reflection_traits<decltype(self.GetInputIndex())>::serialize(
-                                   self.GetInputIndex()));
+        return std::format(
+                "{{ input_index: {}, transition: {}, transition_duration: {}}}",
+                vortex::reflection_traits<decltype(self.GetInputIndex())>::serialize(
+                        self.GetInputIndex()),
+                vortex::reflection_traits<decltype(self.GetTransition())>::serialize(
+                        self.GetTransition()),
+                vortex::reflection_traits<decltype(self.GetTransitionDuration())>::serialize(
+                        self.GetTransitionDuration()));
     }
     template<typename Self>
     bool Deserialize(this Self& self, SerializedProperties values, bool notify)
@@ -714,232 +844,1213 @@ public:
         return true;
     }
 };
-struct ImageInputProperties {
+struct CompositorProperties {
     UpdateNotifier notifier; // Callback for property change notifications
 public:
     static constexpr auto
             property_map = frozen::make_unordered_map<frozen::string,
                                                       std::pair<uint32_t, PropertyType>>({
-                    { "image_path", { 0, PropertyType::Path } },
+                    {         "background", {  0, PropertyType::Color } },
+                    { "layer0_translation", {  1, PropertyType::F32x2 } },
+                    {       "layer0_scale", {  2, PropertyType::F32x2 } },
+                    {    "layer0_rotation", {  3,   PropertyType::F32 } },
+                    {     "layer0_opacity", {  4,   PropertyType::F32 } },
+                    {  "layer0_blend_mode", {  5,   PropertyType::I32 } },
+                    { "layer1_translation", {  6, PropertyType::F32x2 } },
+                    {       "layer1_scale", {  7, PropertyType::F32x2 } },
+                    {    "layer1_rotation", {  8,   PropertyType::F32 } },
+                    {     "layer1_opacity", {  9,   PropertyType::F32 } },
+                    {  "layer1_blend_mode", { 10,   PropertyType::I32 } },
+                    { "layer2_translation", { 11, PropertyType::F32x2 } },
+                    {       "layer2_scale", { 12, PropertyType::F32x2 } },
+                    {    "layer2_rotation", { 13,   PropertyType::F32 } },
+                    {     "layer2_opacity", { 14,   PropertyType::F32 } },
+                    {  "layer2_blend_mode", { 15,   PropertyType::I32 } },
+                    { "layer3_translation", { 16, PropertyType::F32x2 } },
+                    {       "layer3_scale", { 17, PropertyType::F32x2 } },
+                    {    "layer3_rotation", { 18,   PropertyType::F32 } },
+                    {     "layer3_opacity", { 19,   PropertyType::F32 } },
+                    {  "layer3_blend_mode", { 20,   PropertyType::I32 } },
     });
-    std::string image_path{}; //<UI attribute - Image Path: Path to image file.
+    DirectX::XMFLOAT4 background{ 0.0, 0.0, 0.0, 0.0 }; //<UI attribute - Background: Color the
+                                                        //layers are composited over.
+    DirectX::XMFLOAT2 layer0_translation{ 0.0, 0.0 }; //<UI attribute - Layer 0 Translation:
+                                                      //Translation of the bottom layer in pixels.
+    DirectX::XMFLOAT2 layer0_scale{ 1.0, 1.0 }; //<UI attribute - Layer 0 Scale: Scale of the bottom
+                                                //layer around its center.
+    float layer0_rotation{ 0.0 }; //<UI attribute - Layer 0 Rotation: Rotation of the bottom layer
+                                  //in degrees.
+    float layer0_opacity{ 1.0 }; //<UI attribute - Layer 0 Opacity: Opacity of the bottom layer
+                                 //[0,1].
+    BlendMode layer0_blend_mode{ BlendMode::Normal }; //<UI attribute - Layer 0 Blend Mode: How the
+                                                      //bottom layer is combined with the layers
+                                                      //below.
+    DirectX::XMFLOAT2 layer1_translation{ 0.0, 0.0 }; //<UI attribute - Layer 1 Translation:
+                                                      //Translation of the second layer in pixels.
+    DirectX::XMFLOAT2 layer1_scale{ 1.0, 1.0 }; //<UI attribute - Layer 1 Scale: Scale of the second
+                                                //layer around its center.
+    float layer1_rotation{ 0.0 }; //<UI attribute - Layer 1 Rotation: Rotation of the second layer
+                                  //in degrees.
+    float layer1_opacity{ 1.0 }; //<UI attribute - Layer 1 Opacity: Opacity of the second layer
+                                 //[0,1].
+    BlendMode layer1_blend_mode{ BlendMode::Normal }; //<UI attribute - Layer 1 Blend Mode: How the
+                                                      //second layer is combined with the layers
+                                                      //below.
+    DirectX::XMFLOAT2 layer2_translation{ 0.0, 0.0 }; //<UI attribute - Layer 2 Translation:
+                                                      //Translation of the third layer in pixels.
+    DirectX::XMFLOAT2 layer2_scale{ 1.0, 1.0 }; //<UI attribute - Layer 2 Scale: Scale of the third
+                                                //layer around its center.
+    float layer2_rotation{ 0.0 }; //<UI attribute - Layer 2 Rotation: Rotation of the third layer in
+                                  //degrees.
+    float layer2_opacity{ 1.0 }; //<UI attribute - Layer 2 Opacity: Opacity of the third layer
+                                 //[0,1].
+    BlendMode layer2_blend_mode{ BlendMode::Normal }; //<UI attribute - Layer 2 Blend Mode: How the
+                                                      //third layer is combined with the layers
+                                                      //below.
+    DirectX::XMFLOAT2 layer3_translation{ 0.0, 0.0 }; //<UI attribute - Layer 3 Translation:
+                                                      //Translation of the fourth layer in pixels.
+    DirectX::XMFLOAT2 layer3_scale{ 1.0, 1.0 }; //<UI attribute - Layer 3 Scale: Scale of the fourth
+                                                //layer around its center.
+    float layer3_rotation{ 0.0 }; //<UI attribute - Layer 3 Rotation: Rotation of the fourth layer
+                                  //in degrees.
+    float layer3_opacity{ 1.0 }; //<UI attribute - Layer 3 Opacity: Opacity of the fourth layer
+                                 //[0,1].
+    BlendMode layer3_blend_mode{ BlendMode::Normal }; //<UI attribute - Layer 3 Blend Mode: How the
+                                                      //fourth layer is combined with the layers
+                                                      //below.
 
 public:
-    void SetImagePath(std::string_view value, bool notify = false)
+    void SetBackground(DirectX::XMFLOAT4 value, bool notify = false)
     {
-        image_path = std::string{ value };
+        background = value;
         if (notify) {
             NotifyPropertyChange(0);
         }
     }
-
-public:
-    template<typename Self>
-    std::string_view GetImagePath(this Self&& self)
+    void SetLayer0Translation(DirectX::XMFLOAT2 value, bool notify = false)
     {
-        return self.image_path;
+        layer0_translation = value;
+        if (notify) {
+            NotifyPropertyChange(1);
+        }
     }
-
-public:
-    template<typename Self>
-    void NotifyPropertyChange(this Self&& self, uint32_t index)
+    void SetLayer0Scale(DirectX::XMFLOAT2 value, bool notify = false)
     {
-        if (!self.notifier) {
-            vortex::error("ImageInput: Notifier callback is not set.");
-            return; // No notifier set, cannot notify
-        }
-        switch (index) {
-        case 0:
-            self.notifier(
-                    0,
-                    vortex::reflection_traits<std::string_view>::serialize(self.GetImagePath()));
-            break;
-        default:
-            vortex::error("ImageInput: Invalid property index for notification: {}", index);
-            break;
+        layer0_scale = value;
+        if (notify) {
+            NotifyPropertyChange(2);
         }
     }
-
-public:
-    template<typename Self>
-    void SetPropertyStub(this Self&& self,
-                         uint32_t index,
-                         std::string_view value,
-                         bool notify = false)
+    void SetLayer0Rotation(float value, bool notify = false)
     {
-        switch (index) {
-        case 0:
-            if (std::string_view out_value;
-                vortex::reflection_traits<std::string_view>::deserialize(&out_value, value)) {
-                self.SetImagePath(out_value, notify);
-            }
-            break;
-        default:
-            vortex::error("ImageInput: Invalid property index: {}", index);
-            break; // Invalid index, cannot set property
+        layer0_rotation = value;
+        if (notify) {
+            NotifyPropertyChange(3);
         }
     }
-
-public:
-    template<typename Self>
-    void SetPropertyStub(this Self&& self,
-                         uint32_t index,
-                         const PropertyValue& value,
-                         bool notify = false)
+    void SetLayer0Opacity(float value, bool notify = false)
     {
-        switch (index) {
-        case 0:
-            self.SetImagePath(std::get<std::string>(value), notify);
-            break;
-        default:
-            vortex::error("ImageInput: Invalid property index: {}", index);
-            break; // Invalid index, cannot set property
+        layer0_opacity = value;
+        if (notify) {
+            NotifyPropertyChange(4);
         }
     }
-    template<typename Self>
-    std::string Serialize(this Self& self)
+    void SetLayer0BlendMode(BlendMode value, bool notify = false)
     {
-        return std::format("{{ image_path: {}}}",
-                           vortex::reflection_traits<decltype(self.GetImagePath())>::serialize(
-                                   self.GetImagePath()));
+        layer0_blend_mode = value;
+        if (notify) {
+            NotifyPropertyChange(5);
+        }
     }
-    template<typename Self>
-    bool Deserialize(this Self& self, SerializedProperties values, bool notify)
+    void SetLayer1Translation(DirectX::XMFLOAT2 value, bool notify = false)
     {
-        for (auto&& [k, v] : values) {
-            uint32_t index = self.property_map.at(k).first;
-            self.SetPropertyStub(index, v, notify);
+        layer1_translation = value;
+        if (notify) {
+            NotifyPropertyChange(6);
         }
-        return true;
     }
-};
-struct StreamInputProperties {
-    UpdateNotifier notifier; // Callback for property change notifications
-public:
-    static constexpr auto
-            property_map = frozen::make_unordered_map<frozen::string,
-                                                      std::pair<uint32_t, PropertyType>>({
-                    {       "stream_url", { 0, PropertyType::U8string } },
-                    { "stream_buffering",      { 1, PropertyType::I32 } },
-    });
-    std::string stream_url{}; //<UI attribute - Stream URL: URL of the video stream.
-    int32_t stream_buffering{ 1000 }; //<UI attribute - Buffering: Buffering time in milliseconds.
-
-public:
-    void SetStreamUrl(std::string_view value, bool notify = false)
+    void SetLayer1Scale(DirectX::XMFLOAT2 value, bool notify = false)
     {
-        stream_url = std::string{ value };
+        layer1_scale = value;
         if (notify) {
-            NotifyPropertyChange(0);
+            NotifyPropertyChange(7);
         }
     }
-    void SetStreamBuffering(int32_t value, bool notify = false)
+    void SetLayer1Rotation(float value, bool notify = false)
     {
-        stream_buffering = value;
+        layer1_rotation = value;
         if (notify) {
-            NotifyPropertyChange(1);
+            NotifyPropertyChange(8);
         }
     }
-
-public:
-    template<typename Self>
-    std::string_view GetStreamUrl(this Self&& self)
+    void SetLayer1Opacity(float value, bool notify = false)
     {
-        return self.stream_url;
+        layer1_opacity = value;
+        if (notify) {
+            NotifyPropertyChange(9);
+        }
     }
-    template<typename Self>
-    int32_t GetStreamBuffering(this Self&& self)
+    void SetLayer1BlendMode(BlendMode value, bool notify = false)
     {
-        return self.stream_buffering;
+        layer1_blend_mode = value;
+        if (notify) {
+            NotifyPropertyChange(10);
+        }
     }
-
-public:
-    template<typename Self>
-    void NotifyPropertyChange(this Self&& self, uint32_t index)
+    void SetLayer2Translation(DirectX::XMFLOAT2 value, bool notify = false)
     {
-        if (!self.notifier) {
-            vortex::error("StreamInput: Notifier callback is not set.");
-            return; // No notifier set, cannot notify
+        layer2_translation = value;
+        if (notify) {
+            NotifyPropertyChange(11);
         }
-        switch (index) {
-        case 0:
-            self.notifier(
-                    0,
-                    vortex::reflection_traits<std::string_view>::serialize(self.GetStreamUrl()));
-            break;
-        case 1:
-            self.notifier(1,
-                          vortex::reflection_traits<int32_t>::serialize(self.GetStreamBuffering()));
-            break;
-        default:
-            vortex::error("StreamInput: Invalid property index for notification: {}", index);
-            break;
+    }
+    void SetLayer2Scale(DirectX::XMFLOAT2 value, bool notify = false)
+    {
+        layer2_scale = value;
+        if (notify) {
+            NotifyPropertyChange(12);
         }
     }
-
-public:
-    template<typename Self>
-    void SetPropertyStub(this Self&& self,
-                         uint32_t index,
-                         std::string_view value,
-                         bool notify = false)
+    void SetLayer2Rotation(float value, bool notify = false)
     {
-        switch (index) {
-        case 0:
-            if (std::string_view out_value;
-                vortex::reflection_traits<std::string_view>::deserialize(&out_value, value)) {
-                self.SetStreamUrl(out_value, notify);
-            }
-            break;
-        case 1:
-            if (int32_t out_value;
-                vortex::reflection_traits<int32_t>::deserialize(&out_value, value)) {
-                self.SetStreamBuffering(out_value, notify);
-            }
-            break;
-        default:
-            vortex::error("StreamInput: Invalid property index: {}", index);
-            break; // Invalid index, cannot set property
+        layer2_rotation = value;
+        if (notify) {
+            NotifyPropertyChange(13);
         }
     }
-
-public:
-    template<typename Self>
-    void SetPropertyStub(this Self&& self,
-                         uint32_t index,
-                         const PropertyValue& value,
-                         bool notify = false)
+    void SetLayer2Opacity(float value, bool notify = false)
     {
-        switch (index) {
-        case 0:
-            self.SetStreamUrl(std::get<std::string>(value), notify);
-            break;
-        case 1:
-            self.SetStreamBuffering(std::get<int32_t>(value), notify);
-            break;
-        default:
-            vortex::error("StreamInput: Invalid property index: {}", index);
-            break; // Invalid index, cannot set property
+        layer2_opacity = value;
+        if (notify) {
+            NotifyPropertyChange(14);
         }
     }
-    template<typename Self>
-    std::string Serialize(this Self& self)
+    void SetLayer2BlendMode(BlendMode value, bool notify = false)
     {
-        return std::format(
-                "{{ stream_url: {}, stream_buffering: {}}}",
-                vortex::reflection_traits<decltype(self.GetStreamUrl())>::serialize(
-                        self.GetStreamUrl()),
-                vortex::reflection_traits<decltype(self.GetStreamBuffering())>::serialize(
-                        self.GetStreamBuffering()));
+        layer2_blend_mode = value;
+        if (notify) {
+            NotifyPropertyChange(15);
+        }
     }
-    template<typename Self>
-    bool Deserialize(this Self& self, SerializedProperties values, bool notify)
+    void SetLayer3Translation(DirectX::XMFLOAT2 value, bool notify = false)
     {
-        for (auto&& [k, v] : values) {
-            uint32_t index = self.property_map.at(k).first;
-            self.SetPropertyStub(index, v, notify);
+        layer3_translation = value;
+        if (notify) {
+            NotifyPropertyChange(16);
         }
-        return true;
+    }
+    void SetLayer3Scale(DirectX::XMFLOAT2 value, bool notify = false)
+    {
+        layer3_scale = value;
+        if (notify) {
+            NotifyPropertyChange(17);
+        }
+    }
+    void SetLayer3Rotation(float value, bool notify = false)
+    {
+        layer3_rotation = value;
+        if (notify) {
+            NotifyPropertyChange(18);
+        }
+    }
+    void SetLayer3Opacity(float value, bool notify = false)
+    {
+        layer3_opacity = value;
+        if (notify) {
+            NotifyPropertyChange(19);
+        }
+    }
+    void SetLayer3BlendMode(BlendMode value, bool notify = false)
+    {
+        layer3_blend_mode = value;
+        if (notify) {
+            NotifyPropertyChange(20);
+        }
+    }
+
+public:
+    template<typename Self>
+    DirectX::XMFLOAT4 GetBackground(this Self&& self)
+    {
+        return self.background;
+    }
+    template<typename Self>
+    DirectX::XMFLOAT2 GetLayer0Translation(this Self&& self)
+    {
+        return self.layer0_translation;
+    }
+    template<typename Self>
+    DirectX::XMFLOAT2 GetLayer0Scale(this Self&& self)
+    {
+        return self.layer0_scale;
+    }
+    template<typename Self>
+    float GetLayer0Rotation(this Self&& self)
+    {
+        return self.layer0_rotation;
+    }
+    template<typename Self>
+    float GetLayer0Opacity(this Self&& self)
+    {
+        return self.layer0_opacity;
+    }
+    template<typename Self>
+    BlendMode GetLayer0BlendMode(this Self&& self)
+    {
+        return self.layer0_blend_mode;
+    }
+    template<typename Self>
+    DirectX::XMFLOAT2 GetLayer1Translation(this Self&& self)
+    {
+        return self.layer1_translation;
+    }
+    template<typename Self>
+    DirectX::XMFLOAT2 GetLayer1Scale(this Self&& self)
+    {
+        return self.layer1_scale;
+    }
+    template<typename Self>
+    float GetLayer1Rotation(this Self&& self)
+    {
+        return self.layer1_rotation;
+    }
+    template<typename Self>
+    float GetLayer1Opacity(this Self&& self)
+    {
+        return self.layer1_opacity;
+    }
+    template<typename Self>
+    BlendMode GetLayer1BlendMode(this Self&& self)
+    {
+        return self.layer1_blend_mode;
+    }
+    template<typename Self>
+    DirectX::XMFLOAT2 GetLayer2Translation(this Self&& self)
+    {
+        return self.layer2_translation;
+    }
+    template<typename Self>
+    DirectX::XMFLOAT2 GetLayer2Scale(this Self&& self)
+    {
+        return self.layer2_scale;
+    }
+    template<typename Self>
+    float GetLayer2Rotation(this Self&& self)
+    {
+        return self.layer2_rotation;
+    }
+    template<typename Self>
+    float GetLayer2Opacity(this Self&& self)
+    {
+        return self.layer2_opacity;
+    }
+    template<typename Self>
+    BlendMode GetLayer2BlendMode(this Self&& self)
+    {
+        return self.layer2_blend_mode;
+    }
+    template<typename Self>
+    DirectX::XMFLOAT2 GetLayer3Translation(this Self&& self)
+    {
+        return self.layer3_translation;
+    }
+    template<typename Self>
+    DirectX::XMFLOAT2 GetLayer3Scale(this Self&& self)
+    {
+        return self.layer3_scale;
+    }
+    template<typename Self>
+    float GetLayer3Rotation(this Self&& self)
+    {
+        return self.layer3_rotation;
+    }
+    template<typename Self>
+    float GetLayer3Opacity(this Self&& self)
+    {
+        return self.layer3_opacity;
+    }
+    template<typename Self>
+    BlendMode GetLayer3BlendMode(this Self&& self)
+    {
+        return self.layer3_blend_mode;
+    }
+
+public:
+    template<typename Self>
+    void NotifyPropertyChange(this Self&& self, uint32_t index)
+    {
+        if (!self.notifier) {
+            vortex::error("Compositor: Notifier callback is not set.");
+            return; // No notifier set, cannot notify
+        }
+        switch (index) {
+        case 0:
+            self.notifier(0,
+                          vortex::reflection_traits<DirectX::XMFLOAT4>::serialize(
+                                  self.GetBackground()));
+            break;
+        case 1:
+            self.notifier(1,
+                          vortex::reflection_traits<DirectX::XMFLOAT2>::serialize(
+                                  self.GetLayer0Translation()));
+            break;
+        case 2:
+            self.notifier(2,
+                          vortex::reflection_traits<DirectX::XMFLOAT2>::serialize(
+                                  self.GetLayer0Scale()));
+            break;
+        case 3:
+            self.notifier(3, vortex::reflection_traits<float>::serialize(self.GetLayer0Rotation()));
+            break;
+        case 4:
+            self.notifier(4, vortex::reflection_traits<float>::serialize(self.GetLayer0Opacity()));
+            break;
+        case 5:
+            self.notifier(5,
+                          vortex::reflection_traits<BlendMode>::serialize(
+                                  self.GetLayer0BlendMode()));
+            break;
+        case 6:
+            self.notifier(6,
+                          vortex::reflection_traits<DirectX::XMFLOAT2>::serialize(
+                                  self.GetLayer1Translation()));
+            break;
+        case 7:
+            self.notifier(7,
+                          vortex::reflection_traits<DirectX::XMFLOAT2>::serialize(
+                                  self.GetLayer1Scale()));
+            break;
+        case 8:
+            self.notifier(8, vortex::reflection_traits<float>::serialize(self.GetLayer1Rotation()));
+            break;
+        case 9:
+            self.notifier(9, vortex::reflection_traits<float>::serialize(self.GetLayer1Opacity()));
+            break;
+        case 10:
+            self.notifier(10,
+                          vortex::reflection_traits<BlendMode>::serialize(
+                                  self.GetLayer1BlendMode()));
+            break;
+        case 11:
+            self.notifier(11,
+                          vortex::reflection_traits<DirectX::XMFLOAT2>::serialize(
+                                  self.GetLayer2Translation()));
+            break;
+        case 12:
+            self.notifier(12,
+                          vortex::reflection_traits<DirectX::XMFLOAT2>::serialize(
+                                  self.GetLayer2Scale()));
+            break;
+        case 13:
+            self.notifier(13,
+                          vortex::reflection_traits<float>::serialize(self.GetLayer2Rotation()));
+            break;
+        case 14:
+            self.notifier(14, vortex::reflection_traits<float>::serialize(self.GetLayer2Opacity()));
+            break;
+        case 15:
+            self.notifier(15,
+                          vortex::reflection_traits<BlendMode>::serialize(
+                                  self.GetLayer2BlendMode()));
+            break;
+        case 16:
+            self.notifier(16,
+                          vortex::reflection_traits<DirectX::XMFLOAT2>::serialize(
+                                  self.GetLayer3Translation()));
+            break;
+        case 17:
+            self.notifier(17,
+                          vortex::reflection_traits<DirectX::XMFLOAT2>::serialize(
+                                  self.GetLayer3Scale()));
+            break;
+        case 18:
+            self.notifier(18,
+                          vortex::reflection_traits<float>::serialize(self.GetLayer3Rotation()));
+            break;
+        case 19:
+            self.notifier(19, vortex::reflection_traits<float>::serialize(self.GetLayer3Opacity()));
+            break;
+        case 20:
+            self.notifier(20,
+                          vortex::reflection_traits<BlendMode>::serialize(
+                                  self.GetLayer3BlendMode()));
+            break;
+        default:
+            vortex::error("Compositor: Invalid property index for notification: {}", index);
+            break;
+        }
+    }
+
+public:
+    template<typename Self>
+    void SetPropertyStub(this Self&& self,
+                         uint32_t index,
+                         std::string_view value,
+                         bool notify = false)
+    {
+        switch (index) {
+        case 0:
+            if (DirectX::XMFLOAT4 out_value;
+                vortex::reflection_traits<DirectX::XMFLOAT4>::deserialize(&out_value, value)) {
+                self.SetBackground(out_value, notify);
+            }
+            break;
+        case 1:
+            if (DirectX::XMFLOAT2 out_value;
+                vortex::reflection_traits<DirectX::XMFLOAT2>::deserialize(&out_value, value)) {
+                self.SetLayer0Translation(out_value, notify);
+            }
+            break;
+        case 2:
+            if (DirectX::XMFLOAT2 out_value;
+                vortex::reflection_traits<DirectX::XMFLOAT2>::deserialize(&out_value, value)) {
+                self.SetLayer0Scale(out_value, notify);
+            }
+            break;
+        case 3:
+            if (float out_value; vortex::reflection_traits<float>::deserialize(&out_value, value)) {
+                self.SetLayer0Rotation(out_value, notify);
+            }
+            break;
+        case 4:
+            if (float out_value; vortex::reflection_traits<float>::deserialize(&out_value, value)) {
+                self.SetLayer0Opacity(out_value, notify);
+            }
+            break;
+        case 5:
+            if (BlendMode out_value;
+                vortex::reflection_traits<BlendMode>::deserialize(&out_value, value)) {
+                self.SetLayer0BlendMode(out_value, notify);
+            }
+            break;
+        case 6:
+            if (DirectX::XMFLOAT2 out_value;
+                vortex::reflection_traits<DirectX::XMFLOAT2>::deserialize(&out_value, value)) {
+                self.SetLayer1Translation(out_value, notify);
+            }
+            break;
+        case 7:
+            if (DirectX::XMFLOAT2 out_value;
+                vortex::reflection_traits<DirectX::XMFLOAT2>::deserialize(&out_value, value)) {
+                self.SetLayer1Scale(out_value, notify);
+            }
+            break;
+        case 8:
+            if (float out_value; vortex::reflection_traits<float>::deserialize(&out_value, value)) {
+                self.SetLayer1Rotation(out_value, notify);
+            }
+            break;
+        case 9:
+            if (float out_value; vortex::reflection_traits<float>::deserialize(&out_value, value)) {
+                self.SetLayer1Opacity(out_value, notify);
+            }
+            break;
+        case 10:
+            if (BlendMode out_value;
+                vortex::reflection_traits<BlendMode>::deserialize(&out_value, value)) {
+                self.SetLayer1BlendMode(out_value, notify);
+            }
+            break;
+        case 11:
+            if (DirectX::XMFLOAT2 out_value;
+                vortex::reflection_traits<DirectX::XMFLOAT2>::deserialize(&out_value, value)) {
+                self.SetLayer2Translation(out_value, notify);
+            }
+            break;
+        case 12:
+            if (DirectX::XMFLOAT2 out_value;
+                vortex::reflection_traits<DirectX::XMFLOAT2>::deserialize(&out_value, value)) {
+                self.SetLayer2Scale(out_value, notify);
+            }
+            break;
+        case 13:
+            if (float out_value; vortex::reflection_traits<float>::deserialize(&out_value, value)) {
+                self.SetLayer2Rotation(out_value, notify);
+            }
+            break;
+        case 14:
+            if (float out_value; vortex::reflection_traits<float>::deserialize(&out_value, value)) {
+                self.SetLayer2Opacity(out_value, notify);
+            }
+            break;
+        case 15:
+            if (BlendMode out_value;
+                vortex::reflection_traits<BlendMode>::deserialize(&out_value, value)) {
+                self.SetLayer2BlendMode(out_value, notify);
+            }
+            break;
+        case 16:
+            if (DirectX::XMFLOAT2 out_value;
+                vortex::reflection_traits<DirectX::XMFLOAT2>::deserialize(&out_value, value)) {
+                self.SetLayer3Translation(out_value, notify);
+            }
+            break;
+        case 17:
+            if (DirectX::XMFLOAT2 out_value;
+                vortex::reflection_traits<DirectX::XMFLOAT2>::deserialize(&out_value, value)) {
+                self.SetLayer3Scale(out_value, notify);
+            }
+            break;
+        case 18:
+            if (float out_value; vortex::reflection_traits<float>::deserialize(&out_value, value)) {
+                self.SetLayer3Rotation(out_value, notify);
+            }
+            break;
+        case 19:
+            if (float out_value; vortex::reflection_traits<float>::deserialize(&out_value, value)) {
+                self.SetLayer3Opacity(out_value, notify);
+            }
+            break;
+        case 20:
+            if (BlendMode out_value;
+                vortex::reflection_traits<BlendMode>::deserialize(&out_value, value)) {
+                self.SetLayer3BlendMode(out_value, notify);
+            }
+            break;
+        default:
+            vortex::error("Compositor: Invalid property index: {}", index);
+            break; // Invalid index, cannot set property
+        }
+    }
+
+public:
+    template<typename Self>
+    void SetPropertyStub(this Self&& self,
+                         uint32_t index,
+                         const PropertyValue& value,
+                         bool notify = false)
+    {
+        switch (index) {
+        case 0:
+            self.SetBackground(std::get<DirectX::XMFLOAT4>(value), notify);
+            break;
+        case 1:
+            self.SetLayer0Translation(std::get<DirectX::XMFLOAT2>(value), notify);
+            break;
+        case 2:
+            self.SetLayer0Scale(std::get<DirectX::XMFLOAT2>(value), notify);
+            break;
+        case 3:
+            self.SetLayer0Rotation(std::get<float>(value), notify);
+            break;
+        case 4:
+            self.SetLayer0Opacity(std::get<float>(value), notify);
+            break;
+        case 5:
+            self.SetLayer0BlendMode(static_cast<BlendMode>(std::get<int32_t>(value)), notify);
+            break;
+        case 6:
+            self.SetLayer1Translation(std::get<DirectX::XMFLOAT2>(value), notify);
+            break;
+        case 7:
+            self.SetLayer1Scale(std::get<DirectX::XMFLOAT2>(value), notify);
+            break;
+        case 8:
+            self.SetLayer1Rotation(std::get<float>(value), notify);
+            break;
+        case 9:
+            self.SetLayer1Opacity(std::get<float>(value), notify);
+            break;
+        case 10:
+            self.SetLayer1BlendMode(static_cast<BlendMode>(std::get<int32_t>(value)), notify);
+            break;
+        case 11:
+            self.SetLayer2Translation(std::get<DirectX::XMFLOAT2>(value), notify);
+            break;
+        case 12:
+            self.SetLayer2Scale(std::get<DirectX::XMFLOAT2>(value), notify);
+            break;
+        case 13:
+            self.SetLayer2Rotation(std::get<float>(value), notify);
+            break;
+        case 14:
+            self.SetLayer2Opacity(std::get<float>(value), notify);
+            break;
+        case 15:
+            self.SetLayer2BlendMode(static_cast<BlendMode>(std::get<int32_t>(value)), notify);
+            break;
+        case 16:
+            self.SetLayer3Translation(std::get<DirectX::XMFLOAT2>(value), notify);
+            break;
+        case 17:
+            self.SetLayer3Scale(std::get<DirectX::XMFLOAT2>(value), notify);
+            break;
+        case 18:
+            self.SetLayer3Rotation(std::get<float>(value), notify);
+            break;
+        case 19:
+            self.SetLayer3Opacity(std::get<float>(value), notify);
+            break;
+        case 20:
+            self.SetLayer3BlendMode(static_cast<BlendMode>(std::get<int32_t>(value)), notify);
+            break;
+        default:
+            vortex::error("Compositor: Invalid property index: {}", index);
+            break; // Invalid index, cannot set property
+        }
+    }
+    template<typename Self>
+    std::string Serialize(this Self& self)
+    {
+        return std::format(
+                "{{ background: {}, layer0_translation: {}, layer0_scale: {}, layer0_rotation: {}, "
+                "layer0_opacity: {}, layer0_blend_mode: {}, layer1_translation: {}, "
+                "layer1_scale: {}, layer1_rotation: {}, layer1_opacity: {}, layer1_blend_mode: {}, "
+                "layer2_translation: {}, layer2_scale: {}, layer2_rotation: {}, "
+                "layer2_opacity: {}, layer2_blend_mode: {}, layer3_translation: {}, "
+                "layer3_scale: {}, layer3_rotation: {}, layer3_opacity: {}, "
+                "layer3_blend_mode: {}}}",
+                vortex::reflection_traits<decltype(self.GetBackground())>::serialize(
+                        self.GetBackground()),
+                vortex::reflection_traits<decltype(self.GetLayer0Translation())>::serialize(
+                        self.GetLayer0Translation()),
+                vortex::reflection_traits<decltype(self.GetLayer0Scale())>::serialize(
+                        self.GetLayer0Scale()),
+                vortex::reflection_traits<decltype(self.GetLayer0Rotation())>::serialize(
+                        self.GetLayer0Rotation()),
+                vortex::reflection_traits<decltype(self.GetLayer0Opacity())>::serialize(
+                        self.GetLayer0Opacity()),
+                vortex::reflection_traits<decltype(self.GetLayer0BlendMode())>::serialize(
+                        self.GetLayer0BlendMode()),
+                vortex::reflection_traits<decltype(self.GetLayer1Translation())>::serialize(
+                        self.GetLayer1Translation()),
+                vortex::reflection_traits<decltype(self.GetLayer1Scale())>::serialize(
+                        self.GetLayer1Scale()),
+                vortex::reflection_traits<decltype(self.GetLayer1Rotation())>::serialize(
+                        self.GetLayer1Rotation()),
+                vortex::reflection_traits<decltype(self.GetLayer1Opacity())>::serialize(
+                        self.GetLayer1Opacity()),
+                vortex::reflection_traits<decltype(self.GetLayer1BlendMode())>::serialize(
+                        self.GetLayer1BlendMode()),
+                vortex::reflection_traits<decltype(self.GetLayer2Translation())>::serialize(
+                        self.GetLayer2Translation()),
+                vortex::reflection_traits<decltype(self.GetLayer2Scale())>::serialize(
+                        self.GetLayer2Scale()),
+                vortex::reflection_traits<decltype(self.GetLayer2Rotation())>::serialize(
+                        self.GetLayer2Rotation()),
+                vortex::reflection_traits<decltype(self.GetLayer2Opacity())>::serialize(
+                        self.GetLayer2Opacity()),
+                vortex::reflection_traits<decltype(self.GetLayer2BlendMode())>::serialize(
+                        self.GetLayer2BlendMode()),
+                vortex::reflection_traits<decltype(self.GetLayer3Translation())>::serialize(
+                        self.GetLayer3Translation()),
+                vortex::reflection_traits<decltype(self.GetLayer3Scale())>::serialize(
+                        self.GetLayer3Scale()),
+                vortex::reflection_traits<decltype(self.GetLayer3Rotation())>::serialize(
+                        self.GetLayer3Rotation()),
+                vortex::reflection_traits<decltype(self.GetLayer3Opacity())>::serialize(
+                        self.GetLayer3Opacity()),
+                vortex::reflection_traits<decltype(self.GetLayer3BlendMode())>::serialize(
+                        self.GetLayer3BlendMode()));
+    }
+    template<typename Self>
+    bool Deserialize(this Self& self, SerializedProperties values, bool notify)
+    {
+        for (auto&& [k, v] : values) {
+            uint32_t index = self.property_map.at(k).first;
+            self.SetPropertyStub(index, v, notify);
+        }
+        return true;
+    }
+};
+struct ImageInputProperties {
+    UpdateNotifier notifier; // Callback for property change notifications
+public:
+    static constexpr auto
+            property_map = frozen::make_unordered_map<frozen::string,
+                                                      std::pair<uint32_t, PropertyType>>({
+                    { "image_path", { 0, PropertyType::Path } },
+    });
+    std::string image_path{}; //<UI attribute - Image Path: Path to image file.
+
+public:
+    void SetImagePath(std::string_view value, bool notify = false)
+    {
+        image_path = std::string{ value };
+        if (notify) {
+            NotifyPropertyChange(0);
+        }
+    }
+
+public:
+    template<typename Self>
+    std::string_view GetImagePath(this Self&& self)
+    {
+        return self.image_path;
+    }
+
+public:
+    template<typename Self>
+    void NotifyPropertyChange(this Self&& self, uint32_t index)
+    {
+        if (!self.notifier) {
+            vortex::error("ImageInput: Notifier callback is not set.");
+            return; // No notifier set, cannot notify
+        }
+        switch (index) {
+        case 0:
+            self.notifier(
+                    0,
+                    vortex::reflection_traits<std::string_view>::serialize(self.GetImagePath()));
+            break;
+        default:
+            vortex::error("ImageInput: Invalid property index for notification: {}", index);
+            break;
+        }
+    }
+
+public:
+    template<typename Self>
+    void SetPropertyStub(this Self&& self,
+                         uint32_t index,
+                         std::string_view value,
+                         bool notify = false)
+    {
+        switch (index) {
+        case 0:
+            if (std::string_view out_value;
+                vortex::reflection_traits<std::string_view>::deserialize(&out_value, value)) {
+                self.SetImagePath(out_value, notify);
+            }
+            break;
+        default:
+            vortex::error("ImageInput: Invalid property index: {}", index);
+            break; // Invalid index, cannot set property
+        }
+    }
+
+public:
+    template<typename Self>
+    void SetPropertyStub(this Self&& self,
+                         uint32_t index,
+                         const PropertyValue& value,
+                         bool notify = false)
+    {
+        switch (index) {
+        case 0:
+            self.SetImagePath(std::get<std::string>(value), notify);
+            break;
+        default:
+            vortex::error("ImageInput: Invalid property index: {}", index);
+            break; // Invalid index, cannot set property
+        }
+    }
+    template<typename Self>
+    std::string Serialize(this Self& self)
+    {
+        return std::format("{{ image_path: {}}}",
+                           vortex::reflection_traits<decltype(self.GetImagePath())>::serialize(
+                                   self.GetImagePath()));
+    }
+    template<typename Self>
+    bool Deserialize(this Self& self, SerializedProperties values, bool notify)
+    {
+        for (auto&& [k, v] : values) {
+            uint32_t index = self.property_map.at(k).first;
+            self.SetPropertyStub(index, v, notify);
+        }
+        return true;
+    }
+};
+struct StreamInputProperties {
+    UpdateNotifier notifier; // Callback for property change notifications
+public:
+    static constexpr auto
+            property_map = frozen::make_unordered_map<frozen::string,
+                                                      std::pair<uint32_t, PropertyType>>({
+                    {       "stream_url", { 0, PropertyType::U8string } },
+                    { "stream_buffering",      { 1, PropertyType::I32 } },
+                    {     "stream_state",      { 2, PropertyType::I32 } },
+    });
+    std::string stream_url{}; //<UI attribute - Stream URL: URL of the video stream.
+    int32_t stream_buffering{ 1000 }; //<UI attribute - Buffering: Buffering time in milliseconds.
+    StreamState stream_state{ StreamState::Idle }; //<UI attribute - State: Connection state, reported
+                                                   //by the node.
+
+public:
+    void SetStreamUrl(std::string_view value, bool notify = false)
+    {
+        stream_url = std::string{ value };
+        if (notify) {
+            NotifyPropertyChange(0);
+        }
+    }
+    void SetStreamBuffering(int32_t value, bool notify = false)
+    {
+        stream_buffering = value;
+        if (notify) {
+            NotifyPropertyChange(1);
+        }
+    }
+    void SetStreamState(StreamState value, bool notify = false)
+    {
+        stream_state = value;
+        if (notify) {
+            NotifyPropertyChange(2);
+        }
+    }
+
+public:
+    template<typename Self>
+    std::string_view GetStreamUrl(this Self&& self)
+    {
+        return self.stream_url;
+    }
+    template<typename Self>
+    int32_t GetStreamBuffering(this Self&& self)
+    {
+        return self.stream_buffering;
+    }
+    template<typename Self>
+    StreamState GetStreamState(this Self&& self)
+    {
+        return self.stream_state;
+    }
+
+public:
+    template<typename Self>
+    void NotifyPropertyChange(this Self&& self, uint32_t index)
+    {
+        if (!self.notifier) {
+            vortex::error("StreamInput: Notifier callback is not set.");
+            return; // No notifier set, cannot notify
+        }
+        switch (index) {
+        case 0:
+            self.notifier(
+                    0,
+                    vortex::reflection_traits<std::string_view>::serialize(self.GetStreamUrl()));
+            break;
+        case 1:
+            self.notifier(1,
+                          vortex::reflection_traits<int32_t>::serialize(self.GetStreamBuffering()));
+            break;
+        case 2:
+            self.notifier(2,
+                          vortex::reflection_traits<StreamState>::serialize(self.GetStreamState()));
+            break;
+        default:
+            vortex::error("StreamInput: Invalid property index for notification: {}", index);
+            break;
+        }
+    }
+
+public:
+    template<typename Self>
+    void SetPropertyStub(this Self&& self,
+                         uint32_t index,
+                         std::string_view value,
+                         bool notify = false)
+    {
+        switch (index) {
+        case 0:
+            if (std::string_view out_value;
+                vortex::reflection_traits<std::string_view>::deserialize(&out_value, value)) {
+                self.SetStreamUrl(out_value, notify);
+            }
+            break;
+        case 1:
+            if (int32_t out_value;
+                vortex::reflection_traits<int32_t>::deserialize(&out_value, value)) {
+                self.SetStreamBuffering(out_value, notify);
+            }
+            break;
+        case 2:
+            if (StreamState out_value;
+                vortex::reflection_traits<StreamState>::deserialize(&out_value, value)) {
+                self.SetStreamState(out_value, notify);
+            }
+            break;
+        default:
+            vortex::error("StreamInput: Invalid property index: {}", index);
+            break; // Invalid index, cannot set property
+        }
+    }
+
+public:
+    template<typename Self>
+    void SetPropertyStub(this Self&& self,
+                         uint32_t index,
+                         const PropertyValue& value,
+                         bool notify = false)
+    {
+        switch (index) {
+        case 0:
+            self.SetStreamUrl(std::get<std::string>(value), notify);
+            break;
+        case 1:
+            self.SetStreamBuffering(std::get<int32_t>(value), notify);
+            break;
+        case 2:
+            self.SetStreamState(static_cast<StreamState>(std::get<int32_t>(value)), notify);
+            break;
+        default:
+            vortex::error("StreamInput: Invalid property index: {}", index);
+            break; // Invalid index, cannot set property
+        }
+    }
+    template<typename Self>
+    std::string Serialize(this Self& self)
+    {
+        return std::format(
+                "{{ stream_url: {}, stream_buffering: {}, stream_state: {}}}",
+                vortex::reflection_traits<decltype(self.GetStreamUrl())>::serialize(
+                        self.GetStreamUrl()),
+                vortex::reflection_traits<decltype(self.GetStreamBuffering())>::serialize(
+                        self.GetStreamBuffering()),
+                vortex::reflection_traits<decltype(self.GetStreamState())>::serialize(
+                        self.GetStreamState()));
+    }
+    template<typename Self>
+    bool Deserialize(this Self& self, SerializedProperties values, bool notify)
+    {
+        for (auto&& [k, v] : values) {
+            uint32_t index = self.property_map.at(k).first;
+            self.SetPropertyStub(index, v, notify);
+        }
+        return true;
+    }
+};
+struct SequenceInputProperties {
+    UpdateNotifier notifier; // Callback for property change notifications
+public:
+    static constexpr auto
+            property_map = frozen::make_unordered_map<frozen::string,
+                                                      std::pair<uint32_t, PropertyType>>({
+                    { "sequence_path", { 0, PropertyType::Path } },
+                    {     "framerate",  { 1, PropertyType::I32 } },
+                    {      "in_point",  { 2, PropertyType::I32 } },
+                    {     "out_point",  { 3, PropertyType::I32 } },
+                    {          "loop", { 4, PropertyType::Bool } },
+                    {       "playing", { 5, PropertyType::Bool } },
+    });
+    std::string sequence_path{}; //<UI attribute - Sequence Path: Numbered image sequence (e.g.
+                                 //stinger_%04d.png) or a video clip.
+    vortex::ratio32_t framerate{ 25, 1 }; //<UI attribute - Framerate: Playback rate of image
+                                          //sequences, clips use their own rate.
+    int32_t in_point{ 0 }; //<UI attribute - In Point: First frame to play.
+    int32_t out_point{ -1 }; //<UI attribute - Out Point: Last frame to play, -1 plays to the end.
+    bool loop{ false }; //<UI attribute - Loop: Restart from the in point after the out point.
+    bool playing{ false }; //<UI attribute - Playing: Starts playback from the in point, frames are
+                           //prefetched while stopped.
+
+public:
+    void SetSequencePath(std::string_view value, bool notify = false)
+    {
+        sequence_path = std::string{ value };
+        if (notify) {
+            NotifyPropertyChange(0);
+        }
+    }
+    void SetFramerate(vortex::ratio32_t value, bool notify = false)
+    {
+        framerate = value;
+        if (notify) {
+            NotifyPropertyChange(1);
+        }
+    }
+    void SetInPoint(int32_t value, bool notify = false)
+    {
+        in_point = value;
+        if (notify) {
+            NotifyPropertyChange(2);
+        }
+    }
+    void SetOutPoint(int32_t value, bool notify = false)
+    {
+        out_point = value;
+        if (notify) {
+            NotifyPropertyChange(3);
+        }
+    }
+    void SetLoop(bool value, bool notify = false)
+    {
+        loop = value;
+        if (notify) {
+            NotifyPropertyChange(4);
+        }
+    }
+    void SetPlaying(bool value, bool notify = false)
+    {
+        playing = value;
+        if (notify) {
+            NotifyPropertyChange(5);
+        }
+    }
+
+public:
+    template<typename Self>
+    std::string_view GetSequencePath(this Self&& self)
+    {
+        return self.sequence_path;
+    }
+    template<typename Self>
+    vortex::ratio32_t GetFramerate(this Self&& self)
+    {
+        return self.framerate;
+    }
+    template<typename Self>
+    int32_t GetInPoint(this Self&& self)
+    {
+        return self.in_point;
+    }
+    template<typename Self>
+    int32_t GetOutPoint(this Self&& self)
+    {
+        return self.out_point;
+    }
+    template<typename Self>
+    bool GetLoop(this Self&& self)
+    {
+        return self.loop;
+    }
+    template<typename Self>
+    bool GetPlaying(this Self&& self)
+    {
+        return self.playing;
+    }
+
+public:
+    template<typename Self>
+    void NotifyPropertyChange(this Self&& self, uint32_t index)
+    {
+        if (!self.notifier) {
+            vortex::error("SequenceInput: Notifier callback is not set.");
+            return; // No notifier set, cannot notify
+        }
+        switch (index) {
+        case 0:
+            self.notifier(
+                    0,
+                    vortex::reflection_traits<std::string_view>::serialize(self.GetSequencePath()));
+            break;
+        case 1:
+            self.notifier(
+                    1,
+                    vortex::reflection_traits<vortex::ratio32_t>::serialize(self.GetFramerate()));
+            break;
+        case 2:
+            self.notifier(2, vortex::reflection_traits<int32_t>::serialize(self.GetInPoint()));
+            break;
+        case 3:
+            self.notifier(3, vortex::reflection_traits<int32_t>::serialize(self.GetOutPoint()));
+            break;
+        case 4:
+            self.notifier(4, vortex::reflection_traits<bool>::serialize(self.GetLoop()));
+            break;
+        case 5:
+            self.notifier(5, vortex::reflection_traits<bool>::serialize(self.GetPlaying()));
+            break;
+        default:
+            vortex::error("SequenceInput: Invalid property index for notification: {}", index);
+            break;
+        }
+    }
+
+public:
+    template<typename Self>
+    void SetPropertyStub(this Self&& self,
+                         uint32_t index,
+                         std::string_view value,
+                         bool notify = false)
+    {
+        switch (index) {
+        case 0:
+            if (std::string_view out_value;
+                vortex::reflection_traits<std::string_view>::deserialize(&out_value, value)) {
+                self.SetSequencePath(out_value, notify);
+            }
+            break;
+        case 1:
+            if (vortex::ratio32_t out_value;
+                vortex::reflection_traits<vortex::ratio32_t>::deserialize(&out_value, value)) {
+                self.SetFramerate(out_value, notify);
+            }
+            break;
+        case 2:
+            if (int32_t out_value;
+                vortex::reflection_traits<int32_t>::deserialize(&out_value, value)) {
+                self.SetInPoint(out_value, notify);
+            }
+            break;
+        case 3:
+            if (int32_t out_value;
+                vortex::reflection_traits<int32_t>::deserialize(&out_value, value)) {
+                self.SetOutPoint(out_value, notify);
+            }
+            break;
+        case 4:
+            if (bool out_value; vortex::reflection_traits<bool>::deserialize(&out_value, value)) {
+                self.SetLoop(out_value, notify);
+            }
+            break;
+        case 5:
+            if (bool out_value; vortex::reflection_traits<bool>::deserialize(&out_value, value)) {
+                self.SetPlaying(out_value, notify);
+            }
+            break;
+        default:
+            vortex::error("SequenceInput: Invalid property index: {}", index);
+            break; // Invalid index, cannot set property
+        }
+    }
+
+public:
+    template<typename Self>
+    void SetPropertyStub(this Self&& self,
+                         uint32_t index,
+                         const PropertyValue& value,
+                         bool notify = false)
+    {
+        switch (index) {
+        case 0:
+            self.SetSequencePath(std::get<std::string>(value), notify);
+            break;
+        case 1:
+            self.SetFramerate(static_cast<vortex::ratio32_t>(std::get<int32_t>(value)), notify);
+            break;
+        case 2:
+            self.SetInPoint(std::get<int32_t>(value), notify);
+            break;
+        case 3:
+            self.SetOutPoint(std::get<int32_t>(value), notify);
+            break;
+        case 4:
+            self.SetLoop(std::get<bool>(value), notify);
+            break;
+        case 5:
+            self.SetPlaying(std::get<bool>(value), notify);
+            break;
+        default:
+            vortex::error("SequenceInput: Invalid property index: {}", index);
+            break; // Invalid index, cannot set property
+        }
+    }
+    template<typename Self>
+    std::string Serialize(this Self& self)
+    {
+        return std::format(
+                "{{ sequence_path: {}, framerate: {}, in_point: {}, out_point: {}, loop: {}, playing: {}}}",
+                vortex::reflection_traits<decltype(self.GetSequencePath())>::serialize(
+                        self.GetSequencePath()),
+                vortex::reflection_traits<decltype(self.GetFramerate())>::serialize(
+                        self.GetFramerate()),
+                vortex::reflection_traits<decltype(self.GetInPoint())>::serialize(
+                        self.GetInPoint()),
+                vortex::reflection_traits<decltype(self.GetOutPoint())>::serialize(
+                        self.GetOutPoint()),
+                vortex::reflection_traits<decltype(self.GetLoop())>::serialize(self.GetLoop()),
+                vortex::reflection_traits<decltype(self.GetPlaying())>::serialize(
+                        self.GetPlaying()));
+    }
+    template<typename Self>
+    bool Deserialize(this Self& self, SerializedProperties values, bool notify)
+    {
+        for (auto&& [k, v] : values) {
+            uint32_t index = self.property_map.at(k).first;
+            self.SetPropertyStub(index, v, notify);
+        }
+        return true;
     }
 };
 struct WindowOutputProperties {
@@ -1263,4 +2374,316 @@ public:
         return true;
     }
 };
+struct EncoderOutputProperties {
+    UpdateNotifier notifier; // Callback for property change notifications
+public:
+    static constexpr auto
+            property_map = frozen::make_unordered_map<frozen::string,
+                                                      std::pair<uint32_t, PropertyType>>({
+                    {      "output_url", { 0, PropertyType::U8string } },
+                    {     "window_size",    { 1, PropertyType::Sizeu } },
+                    {       "framerate",      { 2, PropertyType::I32 } },
+                    {         "bitrate",      { 3, PropertyType::I32 } },
+                    {     "video_codec",      { 4, PropertyType::I32 } },
+                    { "encoder_backend",      { 5, PropertyType::I32 } },
+                    {        "encoding",     { 6, PropertyType::Bool } },
+                    {   "encoder_state",      { 7, PropertyType::I32 } },
+    });
+    std::string output_url{}; //<UI attribute - Output: File (.mp4, .mkv, .ts) or a udp:// or rtp://
+                              //URL, network outputs are MPEG-TS.
+    DirectX::XMUINT2 window_size{ 1920, 1080 }; //<UI attribute - Resolution: Resolution of the
+                                                //encoded video.
+    vortex::ratio32_t framerate{ 60,
+                                 1 }; //<UI attribute - Framerate: Framerate of the encoded video.
+    int32_t bitrate{ 8000 }; //<UI attribute - Bitrate: Target bitrate in kbit/s.
+    VideoCodec video_codec{ VideoCodec::H264 }; //<UI attribute - Codec: Video codec of the output.
+    EncoderBackend encoder_backend{ EncoderBackend::Auto }; //<UI attribute - Encoder: Which
+                                                            //encoders may be used.
+    bool encoding{ false }; //<UI attribute - Encoding: Encodes while set, files are finalized when
+                            //cleared.
+    EncoderState encoder_state{ EncoderState::Stopped }; //<UI attribute - State: Encoder state,
+                                                         //reported by the node.
+
+public:
+    void SetOutputUrl(std::string_view value, bool notify = false)
+    {
+        output_url = std::string{ value };
+        if (notify) {
+            NotifyPropertyChange(0);
+        }
+    }
+    void SetWindowSize(DirectX::XMUINT2 value, bool notify = false)
+    {
+        window_size = value;
+        if (notify) {
+            NotifyPropertyChange(1);
+        }
+    }
+    void SetFramerate(vortex::ratio32_t value, bool notify = false)
+    {
+        framerate = value;
+        if (notify) {
+            NotifyPropertyChange(2);
+        }
+    }
+    void SetBitrate(int32_t value, bool notify = false)
+    {
+        bitrate = value;
+        if (notify) {
+            NotifyPropertyChange(3);
+        }
+    }
+    void SetVideoCodec(VideoCodec value, bool notify = false)
+    {
+        video_codec = value;
+        if (notify) {
+            NotifyPropertyChange(4);
+        }
+    }
+    void SetEncoderBackend(EncoderBackend value, bool notify = false)
+    {
+        encoder_backend = value;
+        if (notify) {
+            NotifyPropertyChange(5);
+        }
+    }
+    void SetEncoding(bool value, bool notify = false)
+    {
+        encoding = value;
+        if (notify) {
+            NotifyPropertyChange(6);
+        }
+    }
+    void SetEncoderState(EncoderState value, bool notify = false)
+    {
+        encoder_state = value;
+        if (notify) {
+            NotifyPropertyChange(7);
+        }
+    }
+
+public:
+    template<typename Self>
+    std::string_view GetOutputUrl(this Self&& self)
+    {
+        return self.output_url;
+    }
+    template<typename Self>
+    DirectX::XMUINT2 GetWindowSize(this Self&& self)
+    {
+        return self.window_size;
+    }
+    template<typename Self>
+    vortex::ratio32_t GetFramerate(this Self&& self)
+    {
+        return self.framerate;
+    }
+    template<typename Self>
+    int32_t GetBitrate(this Self&& self)
+    {
+        return self.bitrate;
+    }
+    template<typename Self>
+    VideoCodec GetVideoCodec(this Self&& self)
+    {
+        return self.video_codec;
+    }
+    template<typename Self>
+    EncoderBackend GetEncoderBackend(this Self&& self)
+    {
+        return self.encoder_backend;
+    }
+    template<typename Self>
+    bool GetEncoding(this Self&& self)
+    {
+        return self.encoding;
+    }
+    template<typename Self>
+    EncoderState GetEncoderState(this Self&& self)
+    {
+        return self.encoder_state;
+    }
+
+public:
+    template<typename Self>
+    void NotifyPropertyChange(this Self&& self, uint32_t index)
+    {
+        if (!self.notifier) {
+            vortex::error("EncoderOutput: Notifier callback is not set.");
+            return; // No notifier set, cannot notify
+        }
+        switch (index) {
+        case 0:
+            self.notifier(
+                    0,
+                    vortex::reflection_traits<std::string_view>::serialize(self.GetOutputUrl()));
+            break;
+        case 1:
+            self.notifier(
+                    1,
+                    vortex::reflection_traits<DirectX::XMUINT2>::serialize(self.GetWindowSize()));
+            break;
+        case 2:
+            self.notifier(
+                    2,
+                    vortex::reflection_traits<vortex::ratio32_t>::serialize(self.GetFramerate()));
+            break;
+        case 3:
+            self.notifier(3, vortex::reflection_traits<int32_t>::serialize(self.GetBitrate()));
+            break;
+        case 4:
+            self.notifier(4,
+                          vortex::reflection_traits<VideoCodec>::serialize(self.GetVideoCodec()));
+            break;
+        case 5:
+            self.notifier(
+                    5,
+                    vortex::reflection_traits<EncoderBackend>::serialize(self.GetEncoderBackend()));
+            break;
+        case 6:
+            self.notifier(6, vortex::reflection_traits<bool>::serialize(self.GetEncoding()));
+            break;
+        case 7:
+            self.notifier(
+                    7,
+                    vortex::reflection_traits<EncoderState>::serialize(self.GetEncoderState()));
+            break;
+        default:
+            vortex::error("EncoderOutput: Invalid property index for notification: {}", index);
+            break;
+        }
+    }
+
+public:
+    template<typename Self>
+    void SetPropertyStub(this Self&& self,
+                         uint32_t index,
+                         std::string_view value,
+                         bool notify = false)
+    {
+        switch (index) {
+        case 0:
+            if (std::string_view out_value;
+                vortex::reflection_traits<std::string_view>::deserialize(&out_value, value)) {
+                self.SetOutputUrl(out_value, notify);
+            }
+            break;
+        case 1:
+            if (DirectX::XMUINT2 out_value;
+                vortex::reflection_traits<DirectX::XMUINT2>::deserialize(&out_value, value)) {
+                self.SetWindowSize(out_value, notify);
+            }
+            break;
+        case 2:
+            if (vortex::ratio32_t out_value;
+                vortex::reflection_traits<vortex::ratio32_t>::deserialize(&out_value, value)) {
+                self.SetFramerate(out_value, notify);
+            }
+            break;
+        case 3:
+            if (int32_t out_value;
+                vortex::reflection_traits<int32_t>::deserialize(&out_value, value)) {
+                self.SetBitrate(out_value, notify);
+            }
+            break;
+        case 4:
+            if (VideoCodec out_value;
+                vortex::reflection_traits<VideoCodec>::deserialize(&out_value, value)) {
+                self.SetVideoCodec(out_value, notify);
+            }
+            break;
+        case 5:
+            if (EncoderBackend out_value;
+                vortex::reflection_traits<EncoderBackend>::deserialize(&out_value, value)) {
+                self.SetEncoderBackend(out_value, notify);
+            }
+            break;
+        case 6:
+            if (bool out_value;
+                vortex::reflection_traits<bool>::deserialize(&out_value, value)) {
+                self.SetEncoding(out_value, notify);
+            }
+            break;
+        case 7:
+            if (EncoderState out_value;
+                vortex::reflection_traits<EncoderState>::deserialize(&out_value, value)) {
+                self.SetEncoderState(out_value, notify);
+            }
+            break;
+        default:
+            vortex::error("EncoderOutput: Invalid property index: {}", index);
+            break; // Invalid index, cannot set property
+        }
+    }
+
+public:
+    template<typename Self>
+    void SetPropertyStub(this Self&& self,
+                         uint32_t index,
+                         const PropertyValue& value,
+                         bool notify = false)
+    {
+        switch (index) {
+        case 0:
+            self.SetOutputUrl(std::get<std::string>(value), notify);
+            break;
+        case 1:
+            self.SetWindowSize(std::get<DirectX::XMUINT2>(value), notify);
+            break;
+        case 2:
+            self.SetFramerate(static_cast<vortex::ratio32_t>(std::get<int32_t>(value)), notify);
+            break;
+        case 3:
+            self.SetBitrate(std::get<int32_t>(value), notify);
+            break;
+        case 4:
+            self.SetVideoCodec(static_cast<VideoCodec>(std::get<int32_t>(value)), notify);
+            break;
+        case 5:
+            self.SetEncoderBackend(static_cast<EncoderBackend>(std::get<int32_t>(value)), notify);
+            break;
+        case 6:
+            self.SetEncoding(std::get<bool>(value), notify);
+            break;
+        case 7:
+            self.SetEncoderState(static_cast<EncoderState>(std::get<int32_t>(value)), notify);
+            break;
+        default:
+            vortex::error("EncoderOutput: Invalid property index: {}", index);
+            break; // Invalid index, cannot set property
+        }
+    }
+    template<typename Self>
+    std::string Serialize(this Self& self)
+    {
+        return std::format(
+                "{{ output_url: {}, window_size: {}, framerate: {}, bitrate: {}, video_codec: {}, "
+                "encoder_backend: {}, encoding: {}, encoder_state: {}}}",
+                vortex::reflection_traits<decltype(self.GetOutputUrl())>::serialize(
+                        self.GetOutputUrl()),
+                vortex::reflection_traits<decltype(self.GetWindowSize())>::serialize(
+                        self.GetWindowSize()),
+                vortex::reflection_traits<decltype(self.GetFramerate())>::serialize(
+                        self.GetFramerate()),
+                vortex::reflection_traits<decltype(self.GetBitrate())>::serialize(
+                        self.GetBitrate()),
+                vortex::reflection_traits<decltype(self.GetVideoCodec())>::serialize(
+                        self.GetVideoCodec()),
+                vortex::reflection_traits<decltype(self.GetEncoderBackend())>::serialize(
+                        self.GetEncoderBackend()),
+                vortex::reflection_traits<decltype(self.GetEncoding())>::serialize(
+                        self.GetEncoding()),
+                vortex::reflection_traits<decltype(self.GetEncoderState())>::serialize(
+                        self.GetEncoderState()));
+    }
+    template<typename Self>
+    bool Deserialize(this Self& self, SerializedProperties values, bool notify)
+    {
+        for (auto&& [k, v] : values) {
+            uint32_t index = self.property_map.at(k).first;
+            self.SetPropertyStub(index, v, notify);
+        }
+        return true;
+    }
+};
 } // namespace vortex
@@ -1,6 +1,17 @@
 // Color Correction Pixel Shader
 // Supports both 1D and 3D LUTs with hardware and manual interpolation
 // Also supports brightness, contrast, and saturation adjustments
+// Compiled per LUT type and interpolation, see vortex_add_shader_permutations
+
+// 0 - no LUT, 1 - 1D LUT, 2 - 3D LUT (LutType)
+#ifndef LUT_TYPE
+#define LUT_TYPE 2
+#endif
+
+// 0 - nearest, 1 - trilinear, 2 - tetrahedral (LUTInterp)
+#ifndef LUT_INTERP
+#define LUT_INTERP 1
+#endif
 
 struct PSQuadIn
 {
@@ -8,19 +19,16 @@ struct PSQuadIn
     float4 position : SV_POSITION;
 };
 
-enum LUTInterp
-{
-    LUTInterp_Nearest,
-    LUTInterp_Trilinear,
-    LUTInterp_Tetrahedral,
-};
-
 struct ColorSettings
 {
-    uint interp_method; // LUTInterp enum
     float brightness;
     float contrast;
     float saturation;
+    float padding0;
+    float3 domain_min;   // LUT input domain
+    float padding1;
+    float3 domain_scale; // 1 / (domain_max - domain_min)
+    float padding2;
 };
 
 [[vk::push_constant]] ConstantBuffer<ColorSettings> settings : register(b0);
@@ -98,9 +106,9 @@ float3 Lut3DTetra(const float3 color)
     float3 white = ceil(restored);
     float3 fracts = frac(restored);
 
-    // Normalize to texture coordinates [0,1]
-    float3 blackf = black / re_dims;
-    float3 whitef = white / re_dims;
+    // Texel centers of the grid points, so the linear sampler returns them exactly
+    float3 blackf = (black + 0.5) / dims;
+    float3 whitef = (white + 0.5) / dims;
 
     // Tetrahedral interpolation - select which tetrahedron we're in
     bool3 cmp = fracts.rgb >= fracts.gbr; // (r>g, g>b, b>r)
@@ -148,8 +156,12 @@ float3 Lut3DTetra(const float3 color)
 // 3D LUT with trilinear interpolation or point sampling (hardware)
 float3 Lut3DSampled(const float3 color)
 {
-    // Hardware trilinear filtering handles interpolation
-    return lut3d.Sample(sampler_lut, saturate(color)).rgb;
+    float3 dims;
+    lut3d.GetDimensions(dims.x, dims.y, dims.z);
+
+    // Map [0,1] onto the texel centers like the baked variant, hardware filtering interpolates
+    float3 uvw = saturate(color) * ((dims - 1.0) / dims) + 0.5 / dims;
+    return lut3d.SampleLevel(sampler_lut, uvw, 0).rgb;
 }
 
 // Apply brightness, contrast, and saturation adjustments
@@ -173,31 +185,27 @@ float4 main(PSQuadIn ps_in) : SV_TARGET0
     float4 color = tex.Sample(sampler_tex, ps_in.texcoord);
     
     // Apply basic color adjustments first
-    float3 adjusted_color = ApplyColorAdjustments(color.rgb);
-    
-    // Detect LUT type based on texture dimensions
-    float3 dims;
-    lut3d.GetDimensions(dims.x, dims.y, dims.z);
-    
-    float3 result_color = adjusted_color;
-    
-    // Only apply LUT if dimensions suggest it's a valid LUT texture
-    // (Skip if dimensions are same as input texture, which means no LUT was loaded)
-    if (dims.x >= 16) // Minimum LUT size check
-    {
-        if (dims.y == 1 && dims.z == 1)
-        {
-            // 1D LUT (stored as 3D texture with height=1, depth=1)
-            result_color = (settings.interp_method == LUTInterp_Nearest) ?
-                Lut1DNearest(adjusted_color) : Lut1DLinear(adjusted_color);
-        }
-        else if (dims.y > 1 && dims.z > 1)
-        {
-            // 3D LUT
-            result_color = (settings.interp_method == LUTInterp_Tetrahedral) ?
-                Lut3DTetra(adjusted_color) : Lut3DSampled(adjusted_color);
-        }
-    }
+    float3 result_color = ApplyColorAdjustments(color.rgb);
+
+#if LUT_TYPE != 0
+    float3 lut_color = (result_color - settings.domain_min) * settings.domain_scale;
+#endif
+
+#if LUT_TYPE == 1
+    // 1D LUT (stored as 3D texture with height=1, depth=1)
+#if LUT_INTERP == 0
+    result_color = Lut1DNearest(lut_color);
+#else
+    result_color = Lut1DLinear(lut_color);
+#endif
+#elif LUT_TYPE == 2
+    // 3D LUT, nearest and trilinear differ only by the bound sampler
+#if LUT_INTERP == 2
+    result_color = Lut3DTetra(lut_color);
+#else
+    result_color = Lut3DSampled(lut_color);
+#endif
+#endif
     
     return float4(result_color, color.a);
 }
@@ -0,0 +1,25 @@
+// Color Correction Pixel Shader, baked variant
+// Adjustments and the LUT are baked into a single 3D LUT, applied with one filtered fetch
+
+struct PSQuadIn
+{
+    float2 texcoord : TEXCOORD;
+    float4 position : SV_POSITION;
+};
+
+[[vk::binding(0, 0)]] Texture3D lut3d : register(t0);
+[[vk::binding(1, 0)]] Texture2D tex : register(t1);
+[[vk::binding(0, 1)]] SamplerState sampler_lut : register(s0);
+[[vk::binding(1, 1)]] SamplerState sampler_tex : register(s1);
+
+float4 main(PSQuadIn ps_in) : SV_TARGET0
+{
+    float4 color = tex.Sample(sampler_tex, ps_in.texcoord);
+
+    float3 dims;
+    lut3d.GetDimensions(dims.x, dims.y, dims.z);
+
+    // Map [0,1] onto the texel centers, so grid points are hit exactly
+    float3 uvw = saturate(color.rgb) * ((dims - 1.0) / dims) + 0.5 / dims;
+    return float4(lut3d.SampleLevel(sampler_lut, uvw, 0).rgb, color.a);
+}
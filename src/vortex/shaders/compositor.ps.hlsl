@@ -0,0 +1,41 @@
+// Compositor pixel shader
+// Samples the current layer from the batch texture table and applies its opacity
+
+struct LayerConstants
+{
+    uint texture_index; // Index of the layer in the texture table
+    float opacity;      // Layer opacity
+    float neutral;      // Color that leaves the destination unchanged for the blend mode
+    uint alpha_blend;   // 1 - opacity goes to alpha, 0 - color is faded to neutral
+    float4 fill;        // Written instead of a texture when texture_index is fill_index
+};
+
+static const uint fill_index = 0xFFFFFFFF; // Background drawn inside the clip
+
+[[vk::push_constant]] ConstantBuffer<LayerConstants> layer : register(b0);
+
+struct PSQuadIn
+{
+    float2 texcoord : TEXCOORD;
+    float4 position : SV_POSITION;
+};
+
+[[vk::binding(0, 0)]] Texture2D layer_textures[8] : register(t0);
+[[vk::binding(0, 1)]] SamplerState sampler_tex : register(s0);
+
+float4 main(PSQuadIn ps_in) : SV_TARGET0
+{
+    if (layer.texture_index == fill_index) {
+        return layer.fill;
+    }
+
+    float4 color = layer_textures[layer.texture_index].Sample(sampler_tex, ps_in.texcoord);
+    if (layer.alpha_blend) {
+        color.a *= layer.opacity;
+        return color;
+    }
+
+    // Color blend modes ignore alpha, fade towards the neutral color instead
+    color.rgb = lerp(layer.neutral.xxx, color.rgb, color.a * layer.opacity);
+    return color;
+}
@@ -0,0 +1,50 @@
+// Compositor vertex shader
+// Emits one transformed quad per layer (6 vertices), same transform model as the Transform node
+
+struct LayerTransformConstants
+{
+    float2 translation;   // Translation in normalized coordinates
+    float2 scale;         // Scale factors
+    float2 pivot;         // Pivot point (normalized 0-1)
+    float rotation;       // Rotation angle in radians
+    float aspect_ratio;   // Width / Height of the output
+};
+
+[[vk::push_constant]] ConstantBuffer<LayerTransformConstants> transform : register(b0);
+
+struct VSQuadOut
+{
+    float2 texcoord : TexCoord;
+    float4 position : SV_Position;
+};
+
+static const float2 quad_corners[6] = {
+    float2(0.0f, 0.0f), float2(1.0f, 0.0f), float2(0.0f, 1.0f),
+    float2(0.0f, 1.0f), float2(1.0f, 0.0f), float2(1.0f, 1.0f)
+};
+
+VSQuadOut main(uint VertexID : SV_VertexID)
+{
+    VSQuadOut Out;
+    Out.texcoord = quad_corners[VertexID];
+
+    // Texture space has y down, transform space has y up
+    float2 pos01 = float2(Out.texcoord.x, 1.0f - Out.texcoord.y);
+
+    // Scale and rotate around the pivot with aspect ratio correction
+    pos01 -= transform.pivot;
+    pos01.x *= transform.aspect_ratio;
+    pos01 *= transform.scale;
+
+    float cosR = cos(transform.rotation);
+    float sinR = sin(transform.rotation);
+    float2 rotated;
+    rotated.x = pos01.x * cosR - pos01.y * sinR;
+    rotated.y = pos01.x * sinR + pos01.y * cosR;
+    rotated.x /= transform.aspect_ratio;
+
+    pos01 = rotated + transform.pivot + transform.translation;
+
+    Out.position = float4(pos01 * 2.0f - 1.0f, 0.0f, 1.0f);
+    return Out;
+}
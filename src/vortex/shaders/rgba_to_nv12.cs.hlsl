@@ -0,0 +1,64 @@
+// Compute shader to convert RGBA8 to NV12 for the video encoders
+// NV12 is a 4:2:0 format: a full size Y plane followed by a half height plane of interleaved UV
+// Each thread converts a 4x2 block, two uints of Y and one uint of U0 V0 U1 V1
+// Rows are (width + 3) / 4 uints, the height is rounded down to even as the encoders require
+
+[[vk::binding(0, 0)]] Texture2D<float4> rgbaInput : register(t0);
+[[vk::binding(1, 0)]] RWStructuredBuffer<uint> nv12Output : register(u0);
+
+// BT.709, limited range
+float3 RGBtoYUV(float3 rgb)
+{
+    float3 yuv;
+    yuv.x = dot(rgb, float3(0.2126, 0.7152, 0.0722)); // Y
+    yuv.y = dot(rgb, float3(-0.1146, -0.3854, 0.5000)) + 0.5; // U (normalized to [0,1])
+    yuv.z = dot(rgb, float3(0.5000, -0.4542, -0.0458)) + 0.5; // V (normalized to [0,1])
+
+    yuv.x = yuv.x * (219.0 / 255.0) + (16.0 / 255.0); // Y in [16/255, 235/255]
+    yuv.yz = yuv.yz * (224.0 / 255.0) + (16.0 / 255.0); // UV in [16/255, 240/255]
+    return yuv;
+}
+
+uint ToByte(float value)
+{
+    return uint(saturate(value) * 255.0 + 0.5);
+}
+
+[numthreads(16, 16, 1)]
+void main(uint3 dispatchThreadID : SV_DispatchThreadID)
+{
+    uint width, height;
+    rgbaInput.GetDimensions(width, height);
+    uint rows = height & ~1u;
+    uint rowStride = (width + 3) / 4;
+
+    uint2 block = dispatchThreadID.xy;
+    if (block.x >= rowStride || block.y * 2 >= rows)
+        return;
+
+    uint2 origin = block * uint2(4, 2);
+    uint2 luma = 0;
+    float2 chroma[2] = { float2(0, 0), float2(0, 0) };
+    [unroll]
+    for (uint y = 0; y < 2; y++) {
+        uint packed = 0;
+        [unroll]
+        for (uint x = 0; x < 4; x++) {
+            // Columns past the edge repeat the last pixel, the encoder crops them
+            uint2 position = uint2(min(origin.x + x, width - 1), origin.y + y);
+            float3 yuv = RGBtoYUV(rgbaInput[position].rgb);
+            packed |= ToByte(yuv.x) << (x * 8);
+            chroma[x / 2] += yuv.yz * 0.25;
+        }
+        luma[y] = packed;
+    }
+
+    uint offset = origin.y * rowStride + block.x;
+    nv12Output[offset] = luma.x;
+    nv12Output[offset + rowStride] = luma.y;
+
+    // Chroma plane follows the luma plane, one row per two rows of luma (little endian: U0 V0 U1 V1)
+    uint chromaOffset = rows * rowStride + block.y * rowStride + block.x;
+    nv12Output[chromaOffset] = ToByte(chroma[0].x) | (ToByte(chroma[0].y) << 8) |
+                               (ToByte(chroma[1].x) << 16) | (ToByte(chroma[1].y) << 24);
+}
@@ -4,6 +4,8 @@
 struct CropConstants
 {
     float4 crop_rect; // x, y, width, height (normalized 0-1)
+    float2 uv_scale;  // Part of the texture the source occupies, downscaled levels are smaller
+    float2 uv_max;    // Last texel center of that part, keeps filtering off the unused area
 };
 
 [[vk::push_constant]] ConstantBuffer<CropConstants> crop : register(b0);
@@ -28,6 +30,6 @@ float4 main(PSQuadIn ps_in) : SV_TARGET0
     // if uv in crop rect -> sample texture, else return transparent
     
     return IsPointInRectangleExclusive(ps_in.texcoord, crop.crop_rect.xy, crop.crop_rect.xy + crop.crop_rect.zw) ?
-        tex_b.Sample(sampler_tex, ps_in.texcoord) :
+        tex_b.Sample(sampler_tex, min(ps_in.texcoord * crop.uv_scale, crop.uv_max)) :
         float4(0.0f, 0.0f, 0.0f, 0.0f);
 }
@@ -0,0 +1,44 @@
+// Transition pixel shader
+// Mixes or wipes between the outgoing and the incoming input of the Select node
+
+// Cuts switch inputs without running this pass, the value is kept so the enum matches TransitionType
+enum TransitionType
+{
+    TransitionType_Cut,
+    TransitionType_Mix,
+    TransitionType_Wipe,
+};
+
+struct TransitionConstants
+{
+    float progress; // Transition progress [0,1]
+    uint type;      // TransitionType enum
+    float softness; // Width of the wipe edge (normalized)
+    float padding;
+};
+
+[[vk::push_constant]] ConstantBuffer<TransitionConstants> transition : register(b0);
+
+struct PSQuadIn
+{
+    float2 texcoord : TEXCOORD;
+    float4 position : SV_POSITION;
+};
+
+[[vk::binding(0, 0)]] Texture2D tex_from : register(t0);
+[[vk::binding(1, 0)]] Texture2D tex_to : register(t1);
+[[vk::binding(0, 1)]] SamplerState sampler_tex : register(s0);
+
+float4 main(PSQuadIn ps_in) : SV_TARGET0
+{
+    float4 from = tex_from.Sample(sampler_tex, ps_in.texcoord);
+    float4 to = tex_to.Sample(sampler_tex, ps_in.texcoord);
+
+    float t = transition.progress;
+    if (transition.type == TransitionType_Wipe) {
+        // Edge travels from left to right, extended by the softness so it fully clears both ends
+        float edge = t * (1.0f + transition.softness);
+        t = 1.0f - smoothstep(edge - transition.softness, edge, ps_in.texcoord.x);
+    }
+    return lerp(from, to, t);
+}
@@ -1,9 +1,21 @@
+// NV12 to RGB Pixel Shader
+// Compiled per range and matrix, see vortex_add_shader_permutations
+#include "yuv.hlsli"
+
 struct PSQuadIn
 {
     float2 texcoord : TEXCOORD;
     float4 position : SV_POSITION;
 };
 
+struct PlaneConstants
+{
+    // Visible part of the planes, software frames are uploaded with padded rows
+    float2 uv_scale;
+    float2 padding;
+};
+
+[[vk::push_constant]] ConstantBuffer<PlaneConstants> planes : register(b0);
 [[vk::binding(0, 0)]] Texture2D yTexture : register(t0);
 [[vk::binding(1, 0)]] Texture2D uvTexture : register(t1);
 [[vk::binding(0, 1)]] SamplerState sampler_tex : register(s0);
@@ -12,20 +24,9 @@ float4 main(PSQuadIn ps_in)
     : SV_TARGET0
 {
     // Sample Y and UV components
-    float y = yTexture.Sample(sampler_tex, ps_in.texcoord).r;
-    float2 uv = uvTexture.Sample(sampler_tex, ps_in.texcoord).rg;
-
-    // Convert YUV to RGB using BT.709 coefficients
-    // Normalize Y from [16/255, 235/255] to [0, 1] for limited range
-    y = (y - 16.0 / 255.0) * (255.0 / (235.0 - 16.0));
-
-    // Normalize UV from [16/255, 240/255] to [-0.5, 0.5] for limited range
-    uv = (uv - 128.0 / 255.0);
-
-    float3 color;
-    color.r = y + 1.5748 * uv.y; // V component
-    color.g = y - 0.1873 * uv.x - 0.4681 * uv.y; // U and V components
-    color.b = y + 2.03211 * uv.x; // U component
+    float2 texcoord = ps_in.texcoord * planes.uv_scale;
+    float y = yTexture.Sample(sampler_tex, texcoord).r;
+    float2 uv = uvTexture.Sample(sampler_tex, texcoord).rg;
 
-    return float4(saturate(color), 1.0);
-}
\ No newline at end of file
+    return float4(YUVToRGB(y, uv), 1.0);
+}
@@ -0,0 +1,39 @@
+// YUV to RGB conversion shared by the video and image shaders
+
+// 0 - limited (video) range, 1 - full (JPEG) range
+#ifndef COLOR_RANGE
+#define COLOR_RANGE 0
+#endif
+
+// 0 - BT.709, 1 - BT.601
+#ifndef COLOR_MATRIX
+#define COLOR_MATRIX 0
+#endif
+
+float3 YUVToRGB(float y, float2 uv)
+{
+#if COLOR_RANGE == 0
+    // Normalize Y from [16/255, 235/255] to [0, 1] for limited range
+    y = (y - 16.0 / 255.0) * (255.0 / (235.0 - 16.0));
+
+    // Normalize UV from [16/255, 240/255] to [-0.5, 0.5] for limited range
+    uv = (uv - 128.0 / 255.0) * (255.0 / (240.0 - 16.0));
+#else
+    // Full range only needs the chroma offset
+    uv = uv - 128.0 / 255.0;
+#endif
+
+    float3 color;
+#if COLOR_MATRIX == 0
+    // BT.709 coefficients
+    color.r = y + 1.5748 * uv.y; // V component
+    color.g = y - 0.1873 * uv.x - 0.4681 * uv.y; // U and V components
+    color.b = y + 1.8556 * uv.x; // U component
+#else
+    // BT.601 coefficients
+    color.r = y + 1.402 * uv.y;
+    color.g = y - 0.344136 * uv.x - 0.714136 * uv.y;
+    color.b = y + 1.772 * uv.x;
+#endif
+    return saturate(color);
+}
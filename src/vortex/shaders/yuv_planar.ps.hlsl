@@ -0,0 +1,36 @@
+// Planar YUV to RGB Pixel Shader, used for decoded still images
+// Compiled per range and matrix, see vortex_add_shader_permutations
+#include "yuv.hlsli"
+
+struct PSQuadIn
+{
+    float2 texcoord : TEXCOORD;
+    float4 position : SV_POSITION;
+};
+
+struct PlaneConstants
+{
+    // Planes are uploaded with their padded rows, the visible part is [0, scale) horizontally
+    float luma_scale;
+    float chroma_scale;
+    float2 padding;
+};
+
+[[vk::push_constant]] ConstantBuffer<PlaneConstants> planes : register(b0);
+[[vk::binding(0, 0)]] Texture2D yTexture : register(t0);
+[[vk::binding(1, 0)]] Texture2D uTexture : register(t1);
+[[vk::binding(2, 0)]] Texture2D vTexture : register(t2);
+[[vk::binding(0, 1)]] SamplerState sampler_tex : register(s0);
+
+float4 main(PSQuadIn ps_in)
+    : SV_TARGET0
+{
+    float2 luma_coord = float2(ps_in.texcoord.x * planes.luma_scale, ps_in.texcoord.y);
+    float2 chroma_coord = float2(ps_in.texcoord.x * planes.chroma_scale, ps_in.texcoord.y);
+
+    float y = yTexture.Sample(sampler_tex, luma_coord).r;
+    float2 uv = float2(uTexture.Sample(sampler_tex, chroma_coord).r,
+                       vTexture.Sample(sampler_tex, chroma_coord).r);
+
+    return float4(YUVToRGB(y, uv), 1.0);
+}
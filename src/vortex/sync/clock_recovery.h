@@ -0,0 +1,91 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+
+namespace vortex::sync {
+// Recovers the rate of a sender's media clock against the local clock, in microseconds.
+// Network jitter only ever delays packets, so the fastest arrival of each window lies on the
+// sender's clock. The slope between the fastest arrivals of consecutive windows is the skew,
+// smoothed over several windows. Media time maps to local time through the recovered rate,
+// the mapping is re-anchored on every rate change so it stays continuous.
+class ClockRecovery
+{
+public:
+    static constexpr int64_t window_us = 10'000'000; // Fastest arrival is taken over 10 s windows
+    static constexpr double max_skew = 0.005; // Clocks off by more than 0.5% are not followed
+    static constexpr double smoothing = 1.0 / 8.0; // Weight of a new window in the estimate
+
+public:
+    void Reset() noexcept { *this = {}; }
+
+    // Media clock ticks per local clock tick, 1 until the first two windows are complete
+    [[nodiscard]] double Rate() const noexcept { return _rate; }
+
+    [[nodiscard]] int64_t ToLocal(int64_t media_us) const noexcept
+    {
+        return _anchor_local_us + int64_t(double(media_us - _anchor_media_us) / _rate);
+    }
+    [[nodiscard]] int64_t ToMedia(int64_t local_us) const noexcept
+    {
+        return _anchor_media_us + int64_t(double(local_us - _anchor_local_us) * _rate);
+    }
+
+    // A packet with the media time was received at local_us
+    void Observe(int64_t media_us, int64_t local_us) noexcept
+    {
+        int64_t transit = local_us - media_us;
+        if (!_started) {
+            _started = true;
+            _anchor_media_us = media_us;
+            _anchor_local_us = local_us;
+            StartWindow(local_us, transit);
+            return;
+        }
+
+        if (transit < _window_min) {
+            _window_min = transit;
+            _window_min_local_us = local_us;
+        }
+        if (local_us - _window_start_us < window_us) {
+            return;
+        }
+
+        // Transit grows by 1 - rate per local tick when the sender runs slow
+        int64_t elapsed = _window_min_local_us - _previous_min_local_us;
+        if (_has_previous && elapsed >= window_us / 2) {
+            double rate = 1.0 - double(_window_min - _previous_min) / double(elapsed);
+            rate = std::clamp(rate, 1.0 - max_skew, 1.0 + max_skew);
+
+            // Keep the current media position where it is on the local clock
+            _anchor_local_us = ToLocal(media_us);
+            _anchor_media_us = media_us;
+            _rate += (rate - _rate) * smoothing;
+        }
+        _has_previous = true;
+        _previous_min = _window_min;
+        _previous_min_local_us = _window_min_local_us;
+        StartWindow(local_us, transit);
+    }
+
+private:
+    void StartWindow(int64_t local_us, int64_t transit) noexcept
+    {
+        _window_start_us = local_us;
+        _window_min = transit;
+        _window_min_local_us = local_us;
+    }
+
+private:
+    bool _started = false;
+    bool _has_previous = false;
+    double _rate = 1.0;
+    int64_t _anchor_media_us = 0;
+    int64_t _anchor_local_us = 0;
+
+    int64_t _window_start_us = 0;
+    int64_t _window_min = 0; // Fastest transit of the current window
+    int64_t _window_min_local_us = 0;
+    int64_t _previous_min = 0; // Fastest transit of the previous window
+    int64_t _previous_min_local_us = 0;
+};
+} // namespace vortex::sync
@@ -0,0 +1,175 @@
+#pragma once
+#include <vortex/sync/clock_recovery.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+
+namespace vortex::sync {
+// Playout delay of a network stream, in microseconds of media time.
+// Media is played out a delay after the earliest it could have arrived. The delay starts at the
+// configured buffering and follows the measured arrival jitter within the limits: it grows right
+// away when frames come in late and shrinks slowly while arrivals stay steady.
+// Arrivals are compared on the sender's recovered clock, so a sender running fast or slow
+// is played out at its own rate instead of slowly draining or overfilling the buffer.
+class JitterBuffer
+{
+public:
+    static constexpr int64_t slew_divisor = 32; // Delay changes by at most 1/32 of the elapsed time
+    static constexpr int64_t peak_decay_divisor = 64; // Worst arrival is forgotten at 1/64 of real time
+    static constexpr int64_t jitter_factor = 3; // Headroom over the worst arrival, in jitter estimates
+    static constexpr int64_t discontinuity_us = 10'000'000; // Timestamp jumps past this restart the timeline
+
+    struct Limits {
+        int64_t min_delay_us = 40'000;
+        int64_t max_delay_us = 10'000'000;
+    };
+    struct Stats {
+        int64_t target_delay_us = 0; // Delay the buffer converges to
+        int64_t delay_us = 0; // Delay currently played out with
+        int64_t jitter_us = 0; // Smoothed arrival jitter, RFC 3550
+        int64_t depth_us = 0; // Media buffered ahead of the playout position
+        uint64_t underruns = 0; // Times the playout position ran past the newest frame
+        uint64_t late_frames = 0; // Frames that arrived after their playout time
+        uint64_t discontinuities = 0; // Timestamp jumps the timeline was restarted on
+        double clock_rate = 1.0; // Recovered sender clock rate against the local clock
+    };
+
+public:
+    JitterBuffer() = default;
+    explicit JitterBuffer(int64_t initial_delay_us) noexcept
+        : JitterBuffer(initial_delay_us, Limits{})
+    {
+    }
+    JitterBuffer(int64_t initial_delay_us, Limits limits) noexcept
+        : _limits(limits)
+    {
+        Reset(initial_delay_us);
+    }
+
+public:
+    // Starts over from the initial delay, statistics are kept
+    void Reset(int64_t initial_delay_us) noexcept
+    {
+        _started = false;
+        _clock.Reset();
+        _stats.clock_rate = 1.0;
+        _stats.delay_us = _stats.target_delay_us = Clamp(initial_delay_us);
+        _stats.jitter_us = 0;
+        _stats.depth_us = 0;
+        _peak_us = 0;
+        _last_relative_us = 0;
+        _underrun = false;
+    }
+    [[nodiscard]] bool Started() const noexcept { return _started; }
+    [[nodiscard]] const Stats& GetStats() const noexcept { return _stats; }
+
+    // A frame with the media time was read from the network at arrival_us
+    void Arrive(int64_t media_us, int64_t arrival_us) noexcept
+    {
+        if (_started && std::abs(arrival_us - _clock.ToLocal(media_us) - _base_us) > discontinuity_us) {
+            // Source restarted or its timestamps wrapped, keep the delay and start a new timeline
+            _stats.discontinuities++;
+            _started = false;
+            _clock.Reset();
+        }
+        _clock.Observe(media_us, arrival_us);
+        _stats.clock_rate = _clock.Rate();
+
+        int64_t transit = arrival_us - _clock.ToLocal(media_us);
+        if (!_started) {
+            _started = true;
+            _base_us = transit;
+            _last_arrival_us = _last_playout_us = arrival_us;
+            _newest_media_us = media_us;
+            _last_relative_us = 0;
+        }
+
+        // Earliest arrival so far defines the base, keep the playout position where it is
+        if (transit < _base_us) {
+            int64_t shift = _base_us - transit;
+            _base_us = transit;
+            _stats.delay_us += shift;
+            _peak_us += shift;
+            _last_relative_us += shift;
+        }
+
+        int64_t relative = transit - _base_us;
+        _stats.jitter_us += (std::abs(relative - _last_relative_us) - _stats.jitter_us) / 16;
+        _last_relative_us = relative;
+
+        int64_t elapsed = std::max<int64_t>(arrival_us - _last_arrival_us, 0);
+        _peak_us = std::max(relative, _peak_us - elapsed / peak_decay_divisor);
+        _last_arrival_us = arrival_us;
+        _newest_media_us = std::max(_newest_media_us, media_us);
+
+        _stats.target_delay_us = Clamp(_peak_us + jitter_factor * _stats.jitter_us);
+        if (relative > _stats.delay_us) {
+            // Already past its playout time, catch up at once instead of dropping what follows
+            _stats.late_frames++;
+            _stats.delay_us = _stats.target_delay_us;
+        }
+    }
+
+    // Media time to present at now_us, moves the delay toward the target.
+    // Called once per frame, the delay only moves forward in time
+    [[nodiscard]] int64_t Playout(int64_t now_us) noexcept
+    {
+        if (!_started) {
+            return std::numeric_limits<int64_t>::min();
+        }
+        if (now_us > _last_playout_us) {
+            int64_t step = (now_us - _last_playout_us) / slew_divisor;
+            _last_playout_us = now_us;
+            if (_stats.delay_us > _stats.target_delay_us) {
+                _stats.delay_us = std::max(_stats.target_delay_us, _stats.delay_us - step);
+            } else {
+                _stats.delay_us = std::min(_stats.target_delay_us, _stats.delay_us + step);
+            }
+        }
+
+        int64_t media_us = MediaAt(now_us);
+        _stats.depth_us = std::max<int64_t>(_newest_media_us - media_us, 0);
+        return media_us;
+    }
+
+    // Media time at now_us with the current delay, for outputs presenting at their own times
+    [[nodiscard]] int64_t MediaAt(int64_t now_us) const noexcept
+    {
+        if (!_started) {
+            return std::numeric_limits<int64_t>::min();
+        }
+        return _clock.ToMedia(now_us - _base_us - _stats.delay_us);
+    }
+
+    // Reports whether a frame was available for the last playout position
+    void Present(bool available) noexcept
+    {
+        if (!available && !_underrun) {
+            _stats.underruns++;
+            _peak_us = std::max(_peak_us, _stats.delay_us + _stats.delay_us / 8); // Needs more delay
+            _stats.target_delay_us = Clamp(_peak_us + jitter_factor * _stats.jitter_us);
+        }
+        _underrun = !available;
+    }
+
+private:
+    int64_t Clamp(int64_t delay_us) const noexcept
+    {
+        return std::clamp(delay_us, _limits.min_delay_us, _limits.max_delay_us);
+    }
+
+private:
+    Limits _limits;
+    Stats _stats;
+    ClockRecovery _clock; // Sender clock, transit and playout are measured on it
+    bool _started = false;
+    bool _underrun = false;
+    int64_t _base_us = 0; // Earliest transit time seen, arrival - local time of the media
+    int64_t _peak_us = 0; // Decaying worst arrival relative to the base
+    int64_t _last_relative_us = 0;
+    int64_t _last_arrival_us = 0;
+    int64_t _last_playout_us = 0;
+    int64_t _newest_media_us = 0;
+};
+} // namespace vortex::sync
@@ -16,6 +16,7 @@ wis::SwapChain vortex::ui::SDLWindow::CreateSwapchain(const vortex::Graphics& gf
     const auto& platform = gfx.GetPlatform();
     const auto& device = gfx.GetDevice();
     const auto& main_queue = gfx.GetMainQueue();
+    auto lock = gfx.LockMainQueue();
     if (platform.current == None) {
         vortex::error("No platform extension found");
         return swapchain;
@@ -1,129 +1,398 @@
 #include "lut_loader.h"
-#include <fstream>
+#include <vortex/util/mapped_file.h>
+#include <vortex/util/log.h>
+#include <algorithm>
+#include <bit>
 #include <charconv>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <random>
+
+static constexpr uint32_t max_lut_3d_size = 256;
+static constexpr uint32_t max_lut_1d_size = 65536;
 
-static std::string_view TrimWhitespace(std::string_view str)
+// Binary cache layout: header followed by EntryCount() RGBA values in the header format
+struct LutCacheHeader {
+    static constexpr uint32_t magic_value = 0x54554C56; // "VLUT"
+    static constexpr uint32_t current_version = 1;
+
+    uint32_t magic = magic_value;
+    uint32_t version = current_version;
+    LutType type = LutType::Undefined;
+    LutCacheFormat format = LutCacheFormat::Float32;
+    uint32_t stride = 0;
+    uint64_t source_size = 0; // Size of the .cube file the cache was made from
+    int64_t source_mtime = 0; // Modification time of the .cube file
+    uint64_t data_hash = 0; // Hash of the payload
+    float domain_min[3]{};
+    float domain_max[3]{};
+};
+
+// FNV-1a over 64 bit words, the payload is always a multiple of 8 bytes
+static uint64_t HashPayload(const void* data, size_t size) noexcept
 {
-    while (!str.empty() && std::isspace(str.front())) {
-        str.remove_prefix(1);
-    }
-    while (!str.empty() && std::isspace(str.back())) {
-        str.remove_suffix(1);
+    uint64_t hash = 0xcbf29ce484222325ull;
+    auto* bytes = static_cast<const char*>(data);
+    for (size_t i = 0; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, bytes + i, sizeof(word));
+        hash = (hash ^ word) * 0x100000001b3ull;
     }
-    return str;
+    return hash;
 }
 
-std::pair<LutData, size_t> ParseHeader(std::string_view text)
+static uint16_t FloatToHalf(float value) noexcept
 {
-    bool terminated = false;
-    LutData data;
-    size_t offset = 0;
-    while (offset < text.size() && !terminated) {
-        auto newline = text.find('\n', offset);
-        if (newline == std::string::npos) {
-            return { std::move(data), offset };
+    uint32_t bits = std::bit_cast<uint32_t>(value);
+    uint32_t sign = (bits >> 16) & 0x8000;
+    int32_t exponent = int32_t((bits >> 23) & 0xff) - 127 + 15;
+    uint32_t mantissa = bits & 0x7fffff;
+
+    if (((bits >> 23) & 0xff) == 0xff) { // Inf and NaN
+        return uint16_t(sign | 0x7c00 | (mantissa ? 0x200 : 0));
+    }
+    if (exponent >= 31) { // Overflow to infinity
+        return uint16_t(sign | 0x7c00);
+    }
+    if (exponent <= 0) { // Subnormal or zero
+        if (exponent < -10) {
+            return uint16_t(sign);
         }
+        mantissa |= 0x800000;
+        uint32_t shift = uint32_t(14 - exponent);
+        uint32_t half = mantissa >> shift;
+        uint32_t rest = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        half += (rest > halfway || (rest == halfway && (half & 1))) ? 1 : 0;
+        return uint16_t(sign | half);
+    }
 
-        std::string_view line{ text.data() + offset, newline - offset };
-        line = TrimWhitespace(line);
+    // Round to nearest even
+    uint32_t half = sign | (uint32_t(exponent) << 10) | (mantissa >> 13);
+    uint32_t rest = mantissa & 0x1fff;
+    half += (rest > 0x1000 || (rest == 0x1000 && (half & 1))) ? 1 : 0;
+    return uint16_t(half);
+}
 
-        if (line.starts_with("LUT_1D_SIZE")) {
-            line.remove_prefix(11);
+static float HalfToFloat(uint16_t value) noexcept
+{
+    uint32_t sign = uint32_t(value & 0x8000) << 16;
+    uint32_t exponent = (value >> 10) & 0x1f;
+    uint32_t mantissa = value & 0x3ff;
 
-            auto xline = TrimWhitespace(line);
+    if (exponent == 0x1f) { // Inf and NaN
+        return std::bit_cast<float>(sign | 0x7f800000 | (mantissa << 13));
+    }
+    if (exponent == 0) {
+        // Subnormals are exact in float, scale by 2^-24
+        float result = float(mantissa) * (1.0f / 16777216.0f);
+        return sign ? -result : result;
+    }
+    return std::bit_cast<float>(sign | ((exponent + 127 - 15) << 23) | (mantissa << 13));
+}
 
-            // use charconv
+static int64_t GetModificationTime(const std::filesystem::path& path) noexcept
+{
+    std::error_code ec;
+    auto time = std::filesystem::last_write_time(path, ec);
+    return ec ? 0 : int64_t(time.time_since_epoch().count());
+}
 
-            uint32_t count;
-            auto err = std::from_chars(xline.data(), xline.data() + xline.size(), count);
+static constexpr bool IsBlank(char c) noexcept
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
 
-            if (err.ec != std::errc()) {
-                return { std::move(data), offset };
-            }
+static constexpr bool IsNumberStart(char c) noexcept
+{
+    return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.';
+}
 
-            data.stride = count;
-            data.type = LutType::Lut1D;
-        } else if (line.starts_with("LUT_3D_SIZE")) {
-            line.remove_prefix(11);
+static const char* SkipLine(const char* it, const char* end) noexcept
+{
+    auto* newline = static_cast<const char*>(std::memchr(it, '\n', size_t(end - it)));
+    return newline ? newline + 1 : end;
+}
 
-            auto xline = TrimWhitespace(line);
+// Parses up to count floats separated by blanks, stops at the end of the line
+static const char* ParseFloats(const char* it, const char* end, float* out, size_t count) noexcept
+{
+    for (size_t i = 0; i < count; i++) {
+        while (it < end && IsBlank(*it)) {
+            ++it;
+        }
+        if (it < end && *it == '+') {
+            ++it; // from_chars does not accept a leading plus
+        }
+        auto [ptr, ec] = std::from_chars(it, end, out[i]);
+        if (ec != std::errc()) {
+            return nullptr;
+        }
+        it = ptr;
+    }
+    return it;
+}
 
-            // use charconv
+LutData LutLoader::ParseCube(std::string_view text)
+{
+    LutData data;
+    size_t count = 0;
+    size_t written = 0;
+    size_t line_number = 1;
 
-            uint32_t count;
-            auto err = std::from_chars(xline.data(), xline.data() + xline.size(), count);
+    const char* it = text.data();
+    const char* end = it + text.size();
+    while (it < end) {
+        char c = *it;
+        if (IsBlank(c)) {
+            ++it;
+            continue;
+        }
+        if (c == '\n') {
+            ++it;
+            ++line_number;
+            continue;
+        }
+        if (c == '#') {
+            it = SkipLine(it, end);
+            ++line_number;
+            continue;
+        }
 
-            if (err.ec != std::errc()) {
-                return { std::move(data), offset };
+        if (IsNumberStart(c)) {
+            if (written >= count) {
+                vortex::warn("LutLoader: Unexpected data on line {}", line_number);
+                return {};
+            }
+            float* entry = &data.data[written * 4];
+            it = ParseFloats(it, end, entry, 3);
+            if (!it) {
+                vortex::warn("LutLoader: Invalid value on line {}", line_number);
+                return {};
             }
+            entry[3] = 1.0f;
+            ++written;
+            continue; // Rest of the line is handled as blanks
+        }
 
-            data.stride = count;
-            data.type = LutType::Lut3D;
-        } else if (line.starts_with("LUT_3D_INPUT_RANGE") ||
-                   line.starts_with("LUT_1D_INPUT_RANGE")) {
-            terminated = true;
+        // Keyword line
+        const char* line_end = SkipLine(it, end);
+        const char* keyword_end = it;
+        while (keyword_end < line_end && !IsBlank(*keyword_end) && *keyword_end != '\n') {
+            ++keyword_end;
         }
+        std::string_view keyword{ it, size_t(keyword_end - it) };
+        const char* args = keyword_end;
 
-        if (!line.empty() && isdigit(line[0])) {
-            return { std::move(data), offset };
+        if (keyword == "LUT_1D_SIZE" || keyword == "LUT_3D_SIZE") {
+            bool is_3d = keyword == "LUT_3D_SIZE";
+            while (args < line_end && IsBlank(*args)) {
+                ++args;
+            }
+            uint32_t size = 0;
+            auto [ptr, ec] = std::from_chars(args, line_end, size);
+            uint32_t max_size = is_3d ? max_lut_3d_size : max_lut_1d_size;
+            if (ec != std::errc() || size < 2 || size > max_size) {
+                vortex::warn("LutLoader: Invalid {} on line {}", keyword, line_number);
+                return {};
+            }
+            if (data.data) {
+                vortex::warn("LutLoader: Duplicate LUT size on line {}", line_number);
+                return {};
+            }
+            data.stride = size;
+            data.type = is_3d ? LutType::Lut3D : LutType::Lut1D;
+            count = data.EntryCount();
+            data.data = std::make_unique_for_overwrite<float[]>(count * 4);
+        } else if (keyword == "DOMAIN_MIN" || keyword == "DOMAIN_MAX") {
+            auto& domain = keyword == "DOMAIN_MIN" ? data.domain_min : data.domain_max;
+            if (!ParseFloats(args, line_end, domain.data(), 3)) {
+                vortex::warn("LutLoader: Invalid {} on line {}", keyword, line_number);
+                return {};
+            }
+        } else if (keyword == "LUT_1D_INPUT_RANGE" || keyword == "LUT_3D_INPUT_RANGE") {
+            float range[2];
+            if (!ParseFloats(args, line_end, range, 2)) {
+                vortex::warn("LutLoader: Invalid {} on line {}", keyword, line_number);
+                return {};
+            }
+            data.domain_min = { range[0], range[0], range[0] };
+            data.domain_max = { range[1], range[1], range[1] };
         }
+        // TITLE and unknown keywords are skipped with the rest of the line
 
-        offset = newline + 1;
+        it = line_end;
+        ++line_number;
+    }
+
+    if (count == 0 || written != count) {
+        vortex::warn("LutLoader: Expected {} entries, got {}", count, written);
+        return {};
     }
-    return { std::move(data), offset };
+    for (size_t i = 0; i < 3; i++) {
+        if (!(data.domain_max[i] > data.domain_min[i])) {
+            vortex::warn("LutLoader: Invalid domain [{}, {}]",
+                         data.domain_min[i],
+                         data.domain_max[i]);
+            return {};
+        }
+    }
+    return data;
 }
 
-std::unique_ptr<float[]> ParseLutData(std::string_view text, size_t count)
+bool LutLoader::WriteCache(const std::filesystem::path& cache_path,
+                           const std::filesystem::path& source_path,
+                           const LutData& data,
+                           LutCacheFormat format)
 {
-    std::unique_ptr<float[]> data = std::make_unique_for_overwrite<float[]>(count * 4);
-
-    auto tr_text = TrimWhitespace(text);
-    for (size_t i = 0; i < count; i++) {
-        for (size_t j = 0; j < 4; j++) {
-            if (j == 3) {
-                data[i * 4 + j] = 1.0f;
-                break;
-            }
-
-            float value;
-            auto err = std::from_chars(tr_text.data(), tr_text.data() + tr_text.size(), value);
+    if (data.type == LutType::Undefined || !data.data) {
+        return false;
+    }
 
-            data[i * 4 + j] = value;
+    std::error_code ec;
+    LutCacheHeader header{
+        .type = data.type,
+        .format = format,
+        .stride = data.stride,
+        .source_size = uint64_t(std::filesystem::file_size(source_path, ec)),
+        .source_mtime = GetModificationTime(source_path),
+    };
+    if (ec) {
+        return false;
+    }
+    std::copy_n(data.domain_min.data(), 3, header.domain_min);
+    std::copy_n(data.domain_max.data(), 3, header.domain_max);
 
-            tr_text = TrimWhitespace(tr_text.substr(tr_text.find_first_of(" \n") + 1));
+    size_t values = data.EntryCount() * 4;
+    std::unique_ptr<uint16_t[]> half_data;
+    const void* payload = data.data.get();
+    size_t payload_size = values * sizeof(float);
+    if (format == LutCacheFormat::Float16) {
+        half_data = std::make_unique_for_overwrite<uint16_t[]>(values);
+        for (size_t i = 0; i < values; i++) {
+            half_data[i] = FloatToHalf(data.data[i]);
         }
+        payload = half_data.get();
+        payload_size = values * sizeof(uint16_t);
     }
+    header.data_hash = HashPayload(payload, payload_size);
 
-    return data;
+    // Write next to the final file and rename, so readers never see a partial cache.
+    // Writers of the same LUT, in this or another process, each use their own file
+    std::filesystem::create_directories(cache_path.parent_path(), ec);
+    auto temp_path = cache_path;
+    temp_path += std::format(".{:08x}.tmp", std::random_device{}());
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(static_cast<const char*>(payload), std::streamsize(payload_size));
+        if (!file.good()) {
+            file.close();
+            std::filesystem::remove(temp_path, ec);
+            return false;
+        }
+    }
+    std::filesystem::rename(temp_path, cache_path, ec);
+    if (ec) {
+        std::filesystem::remove(temp_path, ec);
+        return false;
+    }
+    return true;
 }
 
-LutData LutLoader::LoadLut(std::filesystem::path path)
+LutData LutLoader::ReadCache(const std::filesystem::path& cache_path,
+                             const std::filesystem::path& source_path)
 {
-    if (!std::filesystem::exists(path)) {
+    vortex::mapped_file file(cache_path);
+    if (!file || file.size() < sizeof(LutCacheHeader)) {
+        return {};
+    }
+
+    LutCacheHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (header.magic != LutCacheHeader::magic_value ||
+        header.version != LutCacheHeader::current_version) {
+        return {};
+    }
+
+    // The cache is stale if the source has changed since it was written
+    std::error_code ec;
+    if (header.source_size != uint64_t(std::filesystem::file_size(source_path, ec)) || ec ||
+        header.source_mtime != GetModificationTime(source_path)) {
+        return {};
+    }
+
+    LutData data;
+    data.type = header.type;
+    data.stride = header.stride;
+    if ((data.type != LutType::Lut1D && data.type != LutType::Lut3D) || data.stride < 2 ||
+        data.stride > (data.type == LutType::Lut3D ? max_lut_3d_size : max_lut_1d_size)) {
         return {};
     }
 
-    // regular text file
-    std::ifstream file(path);
-    if (!file.is_open()) {
+    size_t values = data.EntryCount() * 4;
+    size_t element_size = header.format == LutCacheFormat::Float16 ? sizeof(uint16_t)
+                                                                    : sizeof(float);
+    size_t payload_size = values * element_size;
+    const char* payload = file.data() + sizeof(header);
+    if (file.size() - sizeof(header) != payload_size ||
+        HashPayload(payload, payload_size) != header.data_hash) {
         return {};
     }
 
-    // load entire file into memory
-    std::string text;
-    file.seekg(0, std::ios::end);
-    text.resize(file.tellg());
-    file.seekg(0, std::ios::beg);
+    data.data = std::make_unique_for_overwrite<float[]>(values);
+    if (header.format == LutCacheFormat::Float16) {
+        for (size_t i = 0; i < values; i++) {
+            uint16_t half;
+            std::memcpy(&half, payload + i * sizeof(uint16_t), sizeof(half));
+            data.data[i] = HalfToFloat(half);
+        }
+    } else {
+        std::memcpy(data.data.get(), payload, payload_size);
+    }
+    std::copy_n(header.domain_min, 3, data.domain_min.data());
+    std::copy_n(header.domain_max, 3, data.domain_max.data());
+    return data;
+}
 
-    file.read(text.data(), text.size());
-    file.close();
+std::filesystem::path LutLoader::GetCachePath(const std::filesystem::path& source_path)
+{
+    std::error_code ec;
+    auto absolute = std::filesystem::absolute(source_path, ec);
+    auto key = std::hash<std::filesystem::path::string_type>{}(
+            (ec ? source_path : absolute).native());
+    auto temp = std::filesystem::temp_directory_path(ec);
+    if (ec) {
+        return {};
+    }
+    return temp / "vortex" / "lut_cache" / std::format("{:016x}.vlut", key);
+}
 
-    // parse the file using string_view by line
-    auto [data, offset] = ParseHeader(text);
+LutData LutLoader::LoadLut(std::filesystem::path path)
+{
+    if (!std::filesystem::exists(path)) {
+        return {};
+    }
 
-    data.data = ParseLutData(std::string_view(text.data() + offset, text.size() - offset),
-                             data.type == LutType::Lut1D ? data.stride
-                                                         : data.stride * data.stride * data.stride);
+    auto cache_path = GetCachePath(path);
+    if (!cache_path.empty()) {
+        if (auto cached = ReadCache(cache_path, path); cached.type != LutType::Undefined) {
+            return cached;
+        }
+    }
 
-    return std::move(data);
+    vortex::mapped_file file(path);
+    if (!file) {
+        return {};
+    }
+
+    auto data = ParseCube(file.view());
+    if (data.type != LutType::Undefined && !cache_path.empty()) {
+        WriteCache(cache_path, path, data);
+    }
+    return data;
 }
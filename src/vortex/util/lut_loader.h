@@ -2,6 +2,7 @@
 #include <string_view>
 #include <memory>
 #include <filesystem>
+#include <array>
 
 enum class LutType {
     Undefined,
@@ -11,19 +12,64 @@ enum class LutType {
 
 // assume equal dimensions for 3D LUT
 struct LutData {
-    std::unique_ptr<float[]> data;
+    std::unique_ptr<float[]> data; // RGBA, alpha is always 1
     uint32_t stride = 0;
     LutType type = LutType::Undefined;
+    std::array<float, 3> domain_min{ 0.0f, 0.0f, 0.0f }; // Input value mapped to the first entry
+    std::array<float, 3> domain_max{ 1.0f, 1.0f, 1.0f }; // Input value mapped to the last entry
+
+public:
+    size_t EntryCount() const noexcept
+    {
+        return type == LutType::Lut1D ? size_t(stride) : size_t(stride) * stride * stride;
+    }
+};
+
+// Element format of the binary LUT cache
+enum class LutCacheFormat : uint8_t {
+    Float32,
+    Float16,
 };
 
 class LutLoader
 {
 public:
     /**
-     * Parses the LUT file. Logging the file information.
-     * @param fileName Path to LUT file, including file name.
-     * @throws When input file does not exist or contained data are not valid.
-     * @return LUT data.
+     * Loads the LUT file. A valid binary cache of the file is used if present,
+     * otherwise the file is parsed and the cache is written for the next load.
+     * @param path Path to LUT file, including file name.
+     * @return LUT data, type is Undefined on failure.
      */
     static LutData LoadLut(std::filesystem::path path);
+
+    /**
+     * Parses the contents of a .cube file in a single pass.
+     * Handles TITLE, comments, LUT_1D_SIZE/LUT_3D_SIZE, DOMAIN_MIN/DOMAIN_MAX
+     * and the legacy LUT_1D_INPUT_RANGE/LUT_3D_INPUT_RANGE keywords.
+     * @param text File contents.
+     * @return LUT data, type is Undefined if the text is not a valid LUT.
+     */
+    static LutData ParseCube(std::string_view text);
+
+    /**
+     * Writes a binary cache of a parsed LUT.
+     * The cache is bound to the source file by its size and modification time.
+     * @param cache_path Path of the cache file to write.
+     * @param source_path Path of the .cube file the data was parsed from.
+     * @return true if the cache was written.
+     */
+    static bool WriteCache(const std::filesystem::path& cache_path,
+                           const std::filesystem::path& source_path,
+                           const LutData& data,
+                           LutCacheFormat format = LutCacheFormat::Float32);
+
+    /**
+     * Reads a binary cache written by WriteCache.
+     * @return LUT data, type is Undefined if the cache is missing, corrupted or stale.
+     */
+    static LutData ReadCache(const std::filesystem::path& cache_path,
+                             const std::filesystem::path& source_path);
+
+    // Location of the cache for a given LUT file in the temporary directory
+    static std::filesystem::path GetCachePath(const std::filesystem::path& source_path);
 };
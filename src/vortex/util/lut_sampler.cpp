@@ -0,0 +1,147 @@
+#include <vortex/util/lut_sampler.h>
+#include <algorithm>
+#include <cmath>
+
+auto vortex::LutSampler::ApplyAdjustments(std::array<float, 3> color,
+                                          const ColorAdjustments& adjustments) noexcept
+        -> std::array<float, 3>
+{
+    for (auto& c : color) {
+        c = (c + adjustments.brightness - 0.5f) * adjustments.contrast + 0.5f;
+    }
+    float luminance = color[0] * 0.2126f + color[1] * 0.7152f + color[2] * 0.0722f;
+    for (auto& c : color) {
+        c = luminance + (c - luminance) * adjustments.saturation;
+    }
+    return color;
+}
+
+static const float* LutEntry(const LutData& lut, uint32_t r, uint32_t g, uint32_t b) noexcept
+{
+    return &lut.data[(size_t(b) * lut.stride * lut.stride + size_t(g) * lut.stride + r) * 4];
+}
+
+auto vortex::LutSampler::Sample(const LutData& lut, std::array<float, 3> color, LUTInterp interp) noexcept
+        -> std::array<float, 3>
+{
+    float last = float(lut.stride - 1);
+    std::array<float, 3> scaled;
+    for (size_t i = 0; i < 3; i++) {
+        scaled[i] = std::clamp(color[i], 0.0f, 1.0f) * last;
+    }
+
+    if (lut.type == LutType::Lut1D) {
+        std::array<float, 3> result;
+        for (size_t i = 0; i < 3; i++) {
+            if (interp == LUTInterp::Nearest) {
+                result[i] = lut.data[size_t(std::round(scaled[i])) * 4 + i];
+                continue;
+            }
+            uint32_t index = std::min(uint32_t(scaled[i]), lut.stride - 2);
+            float t = scaled[i] - float(index);
+            result[i] = std::lerp(lut.data[index * 4 + i], lut.data[(index + 1) * 4 + i], t);
+        }
+        return result;
+    }
+
+    if (interp == LUTInterp::Nearest) {
+        auto* entry = LutEntry(lut,
+                               uint32_t(std::round(scaled[0])),
+                               uint32_t(std::round(scaled[1])),
+                               uint32_t(std::round(scaled[2])));
+        return { entry[0], entry[1], entry[2] };
+    }
+
+    uint32_t base[3];
+    float f[3];
+    for (size_t i = 0; i < 3; i++) {
+        base[i] = std::min(uint32_t(scaled[i]), lut.stride - 2);
+        f[i] = scaled[i] - float(base[i]);
+    }
+    auto corner = [&](uint32_t r, uint32_t g, uint32_t b) {
+        return LutEntry(lut, base[0] + r, base[1] + g, base[2] + b);
+    };
+
+    std::array<float, 3> result{};
+    if (interp == LUTInterp::Trilinear) {
+        for (uint32_t i = 0; i < 8; i++) {
+            uint32_t r = i & 1, g = (i >> 1) & 1, b = (i >> 2) & 1;
+            float weight = (r ? f[0] : 1.0f - f[0]) * (g ? f[1] : 1.0f - f[1]) *
+                    (b ? f[2] : 1.0f - f[2]);
+            auto* entry = corner(r, g, b);
+            for (size_t c = 0; c < 3; c++) {
+                result[c] += entry[c] * weight;
+            }
+        }
+        return result;
+    }
+
+    // Tetrahedral, walk from black to white through the two corners picked by the fraction order
+    const float* c1;
+    const float* c2;
+    float w[4];
+    float fr = f[0], fg = f[1], fb = f[2];
+    if (fr > fg) {
+        if (fg > fb) {
+            c1 = corner(1, 0, 0), c2 = corner(1, 1, 0);
+            w[0] = 1.0f - fr, w[1] = fr - fg, w[2] = fg - fb, w[3] = fb;
+        } else if (fr > fb) {
+            c1 = corner(1, 0, 0), c2 = corner(1, 0, 1);
+            w[0] = 1.0f - fr, w[1] = fr - fb, w[2] = fb - fg, w[3] = fg;
+        } else {
+            c1 = corner(0, 0, 1), c2 = corner(1, 0, 1);
+            w[0] = 1.0f - fb, w[1] = fb - fr, w[2] = fr - fg, w[3] = fg;
+        }
+    } else {
+        if (fb > fg) {
+            c1 = corner(0, 0, 1), c2 = corner(0, 1, 1);
+            w[0] = 1.0f - fb, w[1] = fb - fg, w[2] = fg - fr, w[3] = fr;
+        } else if (fb > fr) {
+            c1 = corner(0, 1, 0), c2 = corner(0, 1, 1);
+            w[0] = 1.0f - fg, w[1] = fg - fb, w[2] = fb - fr, w[3] = fr;
+        } else {
+            c1 = corner(0, 1, 0), c2 = corner(1, 1, 0);
+            w[0] = 1.0f - fg, w[1] = fg - fr, w[2] = fr - fb, w[3] = fb;
+        }
+    }
+    auto* c0 = corner(0, 0, 0);
+    auto* c3 = corner(1, 1, 1);
+    for (size_t c = 0; c < 3; c++) {
+        result[c] = c0[c] * w[0] + c1[c] * w[1] + c2[c] * w[2] + c3[c] * w[3];
+    }
+    return result;
+}
+
+LutData vortex::LutSampler::Bake(const LutData& source, const ColorAdjustments& adjustments)
+{
+    // 1D LUTs become 3D, saturation mixes the channels
+    LutData baked;
+    baked.type = LutType::Lut3D;
+    baked.stride = source.type == LutType::Lut3D ? source.stride : baked_1d_stride;
+    baked.data = std::make_unique_for_overwrite<float[]>(baked.EntryCount() * 4);
+
+    std::array<float, 3> domain_scale;
+    for (size_t i = 0; i < 3; i++) {
+        domain_scale[i] = 1.0f / (source.domain_max[i] - source.domain_min[i]);
+    }
+
+    float step = 1.0f / float(baked.stride - 1);
+    float* out = baked.data.get();
+    for (uint32_t b = 0; b < baked.stride; b++) {
+        for (uint32_t g = 0; g < baked.stride; g++) {
+            for (uint32_t r = 0; r < baked.stride; r++) {
+                auto color = ApplyAdjustments({ r * step, g * step, b * step }, adjustments);
+                for (size_t i = 0; i < 3; i++) {
+                    color[i] = (color[i] - source.domain_min[i]) * domain_scale[i];
+                }
+                auto result = Sample(source, color, adjustments.interp);
+                out[0] = result[0];
+                out[1] = result[1];
+                out[2] = result[2];
+                out[3] = 1.0f;
+                out += 4;
+            }
+        }
+    }
+    return baked;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <vortex/properties/props.hpp>
+#include <vortex/util/lut_loader.h>
+#include <algorithm>
+#include <array>
+
+namespace vortex {
+// Brightness, contrast and saturation, in the order the shader applies them
+struct ColorAdjustments {
+    float brightness = 0.0f;
+    float contrast = 1.0f;
+    float saturation = 1.0f;
+    LUTInterp interp = LUTInterp::Trilinear;
+
+public:
+    bool operator==(const ColorAdjustments&) const noexcept = default;
+};
+
+// CPU equivalents of the lookups in color_correction.ps, used to bake adjustments into a LUT.
+// Grid point i of a LUT is at i / (stride - 1) in LUT domain on both paths.
+class LutSampler
+{
+public:
+    static constexpr uint32_t baked_1d_stride = 33; // Size of the cube a 1D LUT is baked into
+
+public:
+    // Same arithmetic as ApplyColorAdjustments in color_correction.ps
+    static std::array<float, 3> ApplyAdjustments(std::array<float, 3> color,
+                                                 const ColorAdjustments& adjustments) noexcept;
+
+    // Looks up a color in LUT domain with the interpolation of the shader
+    static std::array<float, 3> Sample(const LutData& lut,
+                                       std::array<float, 3> color,
+                                       LUTInterp interp) noexcept;
+
+    // Bakes the adjustments and the domain of the source into a 3D LUT,
+    // sampled at TexelCenter it gives the same result as the arithmetic
+    static LutData Bake(const LutData& source, const ColorAdjustments& adjustments);
+
+    // Texture coordinate of a [0,1] value, grid points land on texel centers.
+    // The 3D lookups in color_correction.ps and color_correction_baked.ps address the LUT this way.
+    static float TexelCenter(float value, uint32_t stride) noexcept
+    {
+        float size = float(stride);
+        return std::clamp(value, 0.0f, 1.0f) * ((size - 1.0f) / size) + 0.5f / size;
+    }
+};
+} // namespace vortex
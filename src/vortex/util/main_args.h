@@ -1,4 +1,6 @@
 #pragma once
+#include <charconv>
+#include <cstdint>
 #include <span>
 #include <string_view>
 
@@ -6,6 +8,8 @@
 namespace vortex {
 struct MainArgs {
     bool headless = false;
+    bool software_decode = false; // Streams are decoded on the CPU only
+    uint32_t decode_threads = 0; // Threads per software video decoder, 0 lets FFmpeg decide
 };
 
 inline MainArgs ParseArgs(std::span<std::string_view> args) noexcept
@@ -14,6 +18,10 @@ inline MainArgs ParseArgs(std::span<std::string_view> args) noexcept
     for (const auto& arg : args) {
         if (arg == "--headless") {
             result.headless = true;
+        } else if (arg == "--software-decode") {
+            result.software_decode = true;
+        } else if (constexpr std::string_view prefix = "--decode-threads="; arg.starts_with(prefix)) {
+            std::from_chars(arg.data() + prefix.size(), arg.data() + arg.size(), result.decode_threads);
         }
     }
     return result;
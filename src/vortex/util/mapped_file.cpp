@@ -0,0 +1,85 @@
+#include "mapped_file.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__APPLE__) || defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+vortex::mapped_file::mapped_file(const std::filesystem::path& path) noexcept
+{
+#if defined(_WIN32)
+    HANDLE file = CreateFileW(path.c_str(),
+                              GENERIC_READ,
+                              FILE_SHARE_READ,
+                              nullptr,
+                              OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                              nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return;
+    }
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return;
+    }
+
+    // The mapping keeps the file open, the file handle is not needed after this
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping) {
+        return;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        return;
+    }
+    _data = static_cast<const char*>(view);
+    _size = static_cast<size_t>(size.QuadPart);
+    _mapping = mapping;
+#elif defined(__APPLE__) || defined(__linux__)
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return;
+    }
+
+    // The mapping keeps the file open, the descriptor is not needed after this
+    void* view = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        return;
+    }
+    madvise(view, size_t(st.st_size), MADV_SEQUENTIAL);
+    _data = static_cast<const char*>(view);
+    _size = size_t(st.st_size);
+#endif
+}
+
+void vortex::mapped_file::close() noexcept
+{
+    if (!_data) {
+        return;
+    }
+#if defined(_WIN32)
+    UnmapViewOfFile(_data);
+    CloseHandle(static_cast<HANDLE>(_mapping));
+#elif defined(__APPLE__) || defined(__linux__)
+    munmap(const_cast<char*>(_data), _size);
+#endif
+    _data = nullptr;
+    _size = 0;
+    _mapping = nullptr;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <filesystem>
+#include <string_view>
+#include <utility>
+
+namespace vortex {
+// Read-only memory mapping of a whole file
+class mapped_file
+{
+public:
+    mapped_file() noexcept = default;
+    explicit mapped_file(const std::filesystem::path& path) noexcept;
+    mapped_file(mapped_file&& other) noexcept
+        : _data(std::exchange(other._data, nullptr))
+        , _size(std::exchange(other._size, 0))
+        , _mapping(std::exchange(other._mapping, nullptr))
+    {
+    }
+    mapped_file& operator=(mapped_file&& other) noexcept
+    {
+        if (this != &other) {
+            close();
+            _data = std::exchange(other._data, nullptr);
+            _size = std::exchange(other._size, 0);
+            _mapping = std::exchange(other._mapping, nullptr);
+        }
+        return *this;
+    }
+    ~mapped_file() noexcept { close(); }
+
+public:
+    explicit operator bool() const noexcept { return _data != nullptr; }
+    const char* data() const noexcept { return _data; }
+    size_t size() const noexcept { return _size; }
+    std::string_view view() const noexcept { return { _data, _size }; }
+
+private:
+    void close() noexcept;
+
+private:
+    const char* _data = nullptr;
+    size_t _size = 0;
+    void* _mapping = nullptr; // Mapping handle on Windows, unused on POSIX
+};
+} // namespace vortex
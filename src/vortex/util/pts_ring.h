@@ -0,0 +1,102 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace vortex {
+// Fixed capacity ring of values ordered by PTS, storage is inline and never reallocated.
+// Decoders deliver frames in order, so inserts append at the tail in O(1); late frames are
+// shifted into place. When full, the oldest entry is evicted to make room.
+template<typename T, std::size_t Capacity>
+class pts_ring
+{
+    static_assert(Capacity > 0, "pts_ring needs room for at least one entry");
+
+public:
+    struct entry {
+        int64_t pts = 0;
+        T value{};
+    };
+
+public:
+    constexpr pts_ring() noexcept = default;
+
+public:
+    [[nodiscard]] constexpr std::size_t size() const noexcept { return _size; }
+    [[nodiscard]] constexpr bool empty() const noexcept { return _size == 0; }
+    [[nodiscard]] static constexpr std::size_t capacity() noexcept { return Capacity; }
+
+    // Entries in PTS order, 0 is the oldest
+    [[nodiscard]] constexpr entry& operator[](std::size_t index) noexcept { return _data[slot(index)]; }
+    [[nodiscard]] constexpr const entry& operator[](std::size_t index) const noexcept
+    {
+        return _data[slot(index)];
+    }
+    [[nodiscard]] constexpr entry& front() noexcept { return (*this)[0]; }
+    [[nodiscard]] constexpr entry& back() noexcept { return (*this)[_size - 1]; }
+
+    // Index of the first entry with a PTS not less than pts, size() if there is none
+    [[nodiscard]] constexpr std::size_t lower_bound(int64_t pts) const noexcept
+    {
+        std::size_t first = 0;
+        std::size_t count = _size;
+        while (count > 0) {
+            std::size_t step = count / 2;
+            if ((*this)[first + step].pts < pts) {
+                first += step + 1;
+                count -= step + 1;
+            } else {
+                count = step;
+            }
+        }
+        return first;
+    }
+
+    // Inserts in PTS order, an entry with the same PTS is replaced.
+    // Returns false if the ring is full and the value is older than everything in it.
+    constexpr bool push(int64_t pts, T value) noexcept
+    {
+        std::size_t index = _size == 0 || back().pts < pts ? _size : lower_bound(pts);
+        if (index < _size && (*this)[index].pts == pts) {
+            (*this)[index].value = std::move(value);
+            return true;
+        }
+        if (_size == Capacity) {
+            if (index == 0) {
+                return false; // Would be evicted right away
+            }
+            pop_front();
+            index--;
+        }
+
+        // Shift late arrivals into place, usually nothing moves
+        _size++;
+        for (std::size_t i = _size - 1; i > index; i--) {
+            (*this)[i] = std::move((*this)[i - 1]);
+        }
+        (*this)[index] = { pts, std::move(value) };
+        return true;
+    }
+
+    // Releases the oldest count entries
+    constexpr void pop_front(std::size_t count = 1) noexcept
+    {
+        count = count < _size ? count : _size;
+        for (std::size_t i = 0; i < count; i++) {
+            _data[_head].value = T{}; // Release resources right away, not when the slot is reused
+            _head = (_head + 1) % Capacity;
+        }
+        _size -= count;
+    }
+    constexpr void clear() noexcept { pop_front(_size); }
+
+private:
+    constexpr std::size_t slot(std::size_t index) const noexcept { return (_head + index) % Capacity; }
+
+private:
+    std::array<entry, Capacity> _data{};
+    std::size_t _head = 0;
+    std::size_t _size = 0;
+};
+} // namespace vortex
@@ -0,0 +1,75 @@
+#pragma once
+#include <DirectXMath.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace vortex {
+// Normalized rects are x, y, width, height in 0-1 of the output, y down
+inline constexpr DirectX::XMFLOAT4 full_rect{ 0.0f, 0.0f, 1.0f, 1.0f };
+inline constexpr DirectX::XMFLOAT4 empty_rect{ 0.0f, 0.0f, 0.0f, 0.0f };
+
+inline bool IsEmptyRect(DirectX::XMFLOAT4 rect) noexcept
+{
+    return rect.z <= 0.0f || rect.w <= 0.0f;
+}
+
+inline DirectX::XMFLOAT4 IntersectRect(DirectX::XMFLOAT4 a, DirectX::XMFLOAT4 b) noexcept
+{
+    float left = std::max(a.x, b.x);
+    float top = std::max(a.y, b.y);
+    float right = std::min(a.x + a.z, b.x + b.z);
+    float bottom = std::min(a.y + a.w, b.y + b.w);
+    return { left, top, std::max(right - left, 0.0f), std::max(bottom - top, 0.0f) };
+}
+
+inline DirectX::XMFLOAT4 UnionRect(DirectX::XMFLOAT4 a, DirectX::XMFLOAT4 b) noexcept
+{
+    if (IsEmptyRect(a)) {
+        return b;
+    }
+    if (IsEmptyRect(b)) {
+        return a;
+    }
+    float left = std::min(a.x, b.x);
+    float top = std::min(a.y, b.y);
+    float right = std::max(a.x + a.z, b.x + b.z);
+    float bottom = std::max(a.y + a.w, b.y + b.w);
+    return { left, top, right - left, bottom - top };
+}
+
+// Bounds of a rect of a full screen quad after the 2D transform of the Transform and
+// Compositor vertex shaders. Translation is normalized, rotation in radians, the pivot has y up.
+inline DirectX::XMFLOAT4 TransformRect(DirectX::XMFLOAT4 rect,
+                                       DirectX::XMFLOAT2 translation,
+                                       DirectX::XMFLOAT2 scale,
+                                       DirectX::XMFLOAT2 pivot,
+                                       float rotation,
+                                       float aspect_ratio) noexcept
+{
+    if (IsEmptyRect(rect)) {
+        return empty_rect;
+    }
+
+    float cos_r = std::cos(rotation);
+    float sin_r = std::sin(rotation);
+    float left = std::numeric_limits<float>::max(), top = left;
+    float right = std::numeric_limits<float>::lowest(), bottom = right;
+    for (int corner = 0; corner < 4; corner++) {
+        float u = rect.x + ((corner & 1) ? rect.z : 0.0f);
+        float v = rect.y + ((corner & 2) ? rect.w : 0.0f);
+
+        // Same steps as the shaders, in y up space
+        float x = (u - pivot.x) * aspect_ratio * scale.x;
+        float y = (1.0f - v - pivot.y) * scale.y;
+        float rx = (x * cos_r - y * sin_r) / aspect_ratio + pivot.x + translation.x;
+        float ry = x * sin_r + y * cos_r + pivot.y + translation.y;
+
+        left = std::min(left, rx);
+        right = std::max(right, rx);
+        top = std::min(top, 1.0f - ry);
+        bottom = std::max(bottom, 1.0f - ry);
+    }
+    return IntersectRect({ left, top, right - left, bottom - top }, full_rect);
+}
+} // namespace vortex
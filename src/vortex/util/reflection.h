@@ -88,6 +88,10 @@ struct reflection_traits<bool> : reflection_traits_base<bool> {
         }
         return true;
     }
+    static std::string serialize(bool obj) noexcept
+    {
+        return obj ? "true" : "false";
+    }
 };
 
 // Specialization for DirectX:: vector types
@@ -302,6 +306,7 @@ using SerializedProperties = std::span<const std::pair<std::string_view, std::st
 struct StaticNodeInfo {
     std::uint32_t sinks = 0;
     std::uint32_t sources = 0;
+    bool dynamic_sinks = false; // Sinks are added on connection, sinks is the initial count
 };
 
 template<>
@@ -0,0 +1,26 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+namespace vortex {
+// Wakes a waiting thread when work is published, built on std::atomic::wait (a futex on Linux).
+// Waiters read value() before checking for work and wait on what they read,
+// so a notify between the check and the wait is never missed.
+class wake_signal
+{
+public:
+    [[nodiscard]] uint32_t value() const noexcept { return _value.load(std::memory_order::acquire); }
+
+    void notify() noexcept
+    {
+        _value.fetch_add(1, std::memory_order::release);
+        _value.notify_all();
+    }
+
+    // Returns once value() differs from observed
+    void wait(uint32_t observed) const noexcept { _value.wait(observed, std::memory_order::acquire); }
+
+private:
+    std::atomic<uint32_t> _value{ 0 };
+};
+} // namespace vortex
@@ -11,6 +11,10 @@ static const vortex::LogOptions options_gfx{
     .name = vortex::graphics_log_name,
     .pattern_prefix = "vortex.graphics",
 };
+static const vortex::LogOptions options_stream{
+    .name = vortex::stream_log_name,
+    .pattern_prefix = "vortex.stream",
+};
 
 class Initializer
 {
@@ -30,6 +34,7 @@ private:
     }
     vortex::Log log_global{ options };
     vortex::Log log_graphics{ options_gfx };
+    vortex::Log log_stream{ options_stream };
 };
 struct InitToken {
     InitToken()
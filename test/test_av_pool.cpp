@@ -0,0 +1,44 @@
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+#include <vortex/codec/ffmpeg/av_pool.h>
+
+TEST_CASE("AvPool.Recycle", "[av_pool]")
+{
+    auto pool = std::make_shared<vortex::ffmpeg::packet_pool>(2);
+    AVPacket* raw = nullptr;
+    {
+        auto packet = pool->acquire();
+        REQUIRE(packet);
+        REQUIRE(av_new_packet(packet.get(), 128) == 0);
+        raw = packet.get();
+    }
+
+    // Released packets are unreferenced and reused
+    REQUIRE(pool->size() == 1);
+    auto packet = pool->acquire();
+    REQUIRE(packet.get() == raw);
+    REQUIRE(packet->buf == nullptr);
+    REQUIRE(packet->size == 0);
+    REQUIRE(pool->size() == 0);
+}
+
+TEST_CASE("AvPool.Bounded", "[av_pool]")
+{
+    auto pool = std::make_shared<vortex::ffmpeg::frame_pool>(2);
+    std::vector<vortex::ffmpeg::pooled_frame> frames;
+    for (int i = 0; i < 4; i++) {
+        frames.push_back(pool->acquire());
+    }
+    frames.clear();
+    REQUIRE(pool->size() == pool->capacity());
+
+    // Handles keep the pool alive
+    std::weak_ptr<vortex::ffmpeg::frame_pool> watch = pool;
+    {
+        auto frame = pool->acquire();
+        pool.reset();
+        REQUIRE(!watch.expired());
+    }
+    REQUIRE(watch.expired());
+}
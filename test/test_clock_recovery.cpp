@@ -0,0 +1,42 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <tuple>
+
+#include <vortex/sync/clock_recovery.h>
+#include <vortex/sync/jitter_buffer.h>
+
+TEST_CASE("ClockRecovery.EstimatesSkew", "[clock_recovery]")
+{
+    vortex::sync::ClockRecovery clock;
+    REQUIRE(clock.Rate() == 1.0);
+
+    // Sender runs 200 ppm fast, packets are delayed by up to 30 ms
+    constexpr double rate = 1.0002;
+    for (int64_t local = 0; local < 600'000'000; local += 20'000) {
+        int64_t media = int64_t(double(local) * rate);
+        int64_t jitter = (local / 20'000 * 7919) % 30'000;
+        clock.Observe(media, local + jitter);
+    }
+    REQUIRE(std::abs(clock.Rate() - rate) < 20e-6);
+
+    // The mapping is continuous and follows the recovered rate
+    int64_t media = int64_t(600'000'000 * rate);
+    REQUIRE(std::abs(clock.ToMedia(clock.ToLocal(media)) - media) <= 1);
+    REQUIRE(std::abs(clock.ToLocal(media + 1'000'000) - clock.ToLocal(media) - int64_t(1'000'000 / rate)) <= 1);
+}
+
+TEST_CASE("ClockRecovery.BufferHoldsAgainstDrift", "[clock_recovery]")
+{
+    // An hour of a sender 500 ppm slow, the delay settles instead of running away
+    vortex::sync::JitterBuffer buffer(200'000);
+    int64_t local = 0;
+    for (int64_t media = 0; media < 3600'000'000; media += 40'000) {
+        local = int64_t(double(media) / 0.9995) + (media / 40'000 % 5) * 2'000;
+        buffer.Arrive(media, local);
+        std::ignore = buffer.Playout(local);
+    }
+    auto& stats = buffer.GetStats();
+    REQUIRE(stats.late_frames == 0);
+    REQUIRE(stats.delay_us < 100'000);
+    REQUIRE(std::abs(stats.clock_rate - 0.9995) < 20e-6);
+}
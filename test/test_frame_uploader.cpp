@@ -0,0 +1,58 @@
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+#include <vortex/codec/ffmpeg/frame_uploader.h>
+
+using vortex::ffmpeg::FrameUploader;
+
+TEST_CASE("FrameUploader.Layout", "[frame_uploader]")
+{
+    auto layout = FrameUploader::ComputeLayout(1920, 1080);
+    REQUIRE(layout.row_pitch == 2048);
+    REQUIRE(layout.chroma_height == 540);
+    REQUIRE(layout.chroma_offset == 2048 * 1080);
+    REQUIRE(layout.slot_size % vortex::UploadRing::placement_alignment == 0);
+    REQUIRE(layout.UVScale()[0] == 1920.0f / 2048.0f);
+
+    // Odd sizes round the chroma up and keep the planes placed on copy boundaries
+    auto odd = FrameUploader::ComputeLayout(101, 33);
+    REQUIRE(odd.row_pitch == 256);
+    REQUIRE(odd.chroma_height == 17);
+    REQUIRE(odd.chroma_offset % vortex::UploadRing::placement_alignment == 0);
+    REQUIRE(odd.chroma_offset >= uint64_t(odd.row_pitch) * odd.height);
+    REQUIRE(odd.slot_size >= odd.chroma_offset + uint64_t(odd.row_pitch) * odd.chroma_height);
+}
+
+TEST_CASE("FrameUploader.InterleavePlanar", "[frame_uploader]")
+{
+    constexpr int width = 5;
+    constexpr int height = 3;
+    std::vector<uint8_t> y(8 * height, 0x10);
+    std::vector<uint8_t> u(4 * 2, 0x20);
+    std::vector<uint8_t> v(4 * 2, 0x30);
+
+    AVFrame frame{};
+    frame.format = AV_PIX_FMT_YUV420P;
+    frame.width = width;
+    frame.height = height;
+    frame.data[0] = y.data();
+    frame.data[1] = u.data();
+    frame.data[2] = v.data();
+    frame.linesize[0] = 8;
+    frame.linesize[1] = 4;
+    frame.linesize[2] = 4;
+
+    auto layout = FrameUploader::ComputeLayout(width, height);
+    std::vector<std::byte> slot(layout.slot_size, std::byte{ 0xff });
+    FrameUploader::WritePlanes(slot, layout, frame);
+
+    // Rows land on the pitch, the padding is left as it was
+    REQUIRE(slot[layout.row_pitch * 2 + 4] == std::byte{ 0x10 });
+    REQUIRE(slot[layout.row_pitch * 2 + 5] == std::byte{ 0xff });
+
+    // Chroma is written as UV pairs
+    const std::byte* chroma = slot.data() + layout.chroma_offset;
+    REQUIRE(chroma[layout.row_pitch + 4] == std::byte{ 0x20 });
+    REQUIRE(chroma[layout.row_pitch + 5] == std::byte{ 0x30 });
+    REQUIRE(chroma[layout.row_pitch + 6] == std::byte{ 0xff });
+}
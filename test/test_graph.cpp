@@ -1,5 +1,7 @@
 #include <catch2/catch_test_macros.hpp>
 #include "mock_model.h"
+#include <vortex/probe.h>
+#include <vortex/nodes/filter/compositor.h>
 
 class GraphTest
 {
@@ -101,3 +103,99 @@ TEST_CASE_METHOD(GraphTest, "Connection.DeleteNodeRemovesAllConnections", "[conn
     auto deleted_node = model.GetNode(n1);
     REQUIRE(deleted_node == nullptr);
 }
+
+TEST_CASE_METHOD(GraphTest, "Connection.DynamicSinksGrowOnConnect", "[connect]")
+{
+    auto compositor = CreateNode("Compositor");
+    REQUIRE(compositor != 0);
+    auto node = model.GetNode(compositor);
+    REQUIRE(node->GetSinks().size() == 0);
+
+    auto n1 = CreateNode("ImageInput");
+    auto n2 = CreateNode("ImageInput");
+    REQUIRE(model.ConnectNodes(n1, 0, compositor, 0));
+    REQUIRE(model.ConnectNodes(n2, 0, compositor, 3));
+
+    auto sinks = node->GetSinks();
+    REQUIRE(sinks.size() == 4);
+    REQUIRE(sinks[0].source_node == std::bit_cast<vortex::graph::INode*>(n1));
+    REQUIRE(!sinks[1]);
+    REQUIRE(sinks[3].source_node == std::bit_cast<vortex::graph::INode*>(n2));
+
+    // Growth is bounded
+    REQUIRE_FALSE(model.ConnectNodes(n1, 0, compositor, vortex::graph::max_dynamic_ports));
+
+    // Fixed sink nodes do not grow
+    auto out = CreateNode("MockOutput");
+    REQUIRE_FALSE(model.ConnectNodes(n1, 0, out, 1));
+}
+
+TEST_CASE_METHOD(GraphTest, "Compositor.LayerSettingsFromProperties", "[compositor]")
+{
+    auto compositor = CreateNode("Compositor");
+    REQUIRE(compositor != 0);
+    model.SetNodePropertyByName(compositor, "layer1_translation", "10.0,20.0");
+    model.SetNodePropertyByName(compositor, "layer1_opacity", "2.0");
+    model.SetNodePropertyByName(compositor, "layer1_blend_mode", "3");
+
+    auto& node = *static_cast<vortex::Compositor*>(model.GetNode(compositor));
+    REQUIRE(node.GetLayerSettings(0).IsIdentity());
+
+    auto layer = node.GetLayerSettings(1);
+    REQUIRE(layer.translation.x == 10.0f);
+    REQUIRE(layer.translation.y == 20.0f);
+    REQUIRE(layer.opacity == 1.0f); // Clamped to [0,1]
+    REQUIRE(layer.blend_mode == vortex::BlendMode::Add);
+
+    // Layers without their own properties are drawn unchanged
+    REQUIRE(node.GetLayerSettings(vortex::Compositor::max_layer_settings).IsIdentity());
+}
+
+
+TEST_CASE_METHOD(GraphTest, "Node.IdentityFilterIsPassThrough", "[pass_through]")
+{
+    auto transform = CreateNode("Transform");
+    REQUIRE(transform != 0);
+    auto node = model.GetNode(transform);
+    REQUIRE(node->IsPassThrough());
+
+    // A crop alone is folded into the clip rect, so the node is no longer a plain forward
+    node->SetProperty(node->GetPropertyDesc("crop_rect").first, "[0.25,0.0,0.5,1.0]");
+    REQUIRE_FALSE(node->IsPassThrough());
+
+    node->SetProperty(node->GetPropertyDesc("crop_rect").first, "[0.0,0.0,1.0,1.0]");
+    node->SetProperty(node->GetPropertyDesc("rotation").first, "15.0");
+    REQUIRE_FALSE(node->IsPassThrough());
+
+    auto input = CreateNode("ImageInput");
+    REQUIRE_FALSE(model.GetNode(input)->IsPassThrough());
+}
+
+TEST_CASE("RenderPassForwardDesc.ClipScissor", "[pass_through]")
+{
+    vortex::RenderPassForwardDesc desc{ .output_size = { 100, 50 } };
+    REQUIRE_FALSE(desc.IsClipped());
+    auto full = desc.GetScissor();
+    REQUIRE(full.left == 0);
+    REQUIRE(full.top == 0);
+    REQUIRE(full.right == 100);
+    REQUIRE(full.bottom == 50);
+
+    desc.ClipTo({ 0.25f, 0.0f, 0.5f, 1.0f });
+    desc.ClipTo({ 0.0f, 0.5f, 0.5f, 0.5f });
+    REQUIRE(desc.IsClipped());
+    auto clipped = desc.GetScissor();
+    REQUIRE(clipped.left == 25);
+    REQUIRE(clipped.top == 25);
+    REQUIRE(clipped.right == 50);
+    REQUIRE(clipped.bottom == 50);
+
+    // Bounds on the clip edges land on the same pixels, fractional edges round like the clip
+    vortex::RenderPassForwardDesc fractional{ .output_size = { 100, 50 }, .clip_rect = { 0.104f, 0.0f, 0.792f, 1.0f } };
+    auto clip = fractional.GetScissor();
+    auto bounded = fractional.GetScissor(fractional.clip_rect);
+    REQUIRE(bounded.left == clip.left);
+    REQUIRE(bounded.right == clip.right);
+    REQUIRE(clip.left == 10);
+    REQUIRE(clip.right == 90);
+}
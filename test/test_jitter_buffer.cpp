@@ -0,0 +1,78 @@
+#include <catch2/catch_test_macros.hpp>
+#include <tuple>
+
+#include <vortex/sync/jitter_buffer.h>
+
+using vortex::sync::JitterBuffer;
+
+TEST_CASE("JitterBuffer.ConvergesOnSteadyArrivals", "[jitter_buffer]")
+{
+    JitterBuffer buffer(1'000'000);
+    REQUIRE(!buffer.Started());
+
+    // 25 fps with up to 2 ms of jitter, played out once per frame
+    int64_t now = 0;
+    for (int i = 0; i < 25 * 120; i++) {
+        int64_t media = i * 40'000;
+        now = media + (i % 3) * 1'000;
+        buffer.Arrive(media, now);
+        std::ignore = buffer.Playout(now);
+    }
+
+    // Starts from the configured delay and shrinks down to the floor
+    auto& stats = buffer.GetStats();
+    REQUIRE(stats.delay_us == stats.target_delay_us);
+    REQUIRE(stats.delay_us < 100'000);
+    REQUIRE(stats.late_frames == 0);
+    REQUIRE(stats.underruns == 0);
+    REQUIRE(stats.depth_us >= stats.delay_us - 40'000);
+}
+
+TEST_CASE("JitterBuffer.GrowsOnLateFrames", "[jitter_buffer]")
+{
+    JitterBuffer buffer(100'000, { .min_delay_us = 40'000, .max_delay_us = 2'000'000 });
+    buffer.Arrive(0, 0);
+    REQUIRE(buffer.Playout(0) == -100'000);
+
+    // A burst delayed by half a second is late, the delay catches up right away
+    buffer.Arrive(40'000, 540'000);
+    auto& stats = buffer.GetStats();
+    REQUIRE(stats.late_frames == 1);
+    REQUIRE(stats.delay_us >= 500'000);
+    REQUIRE(buffer.Playout(540'000) <= 40'000);
+
+    // Earlier arrivals lower the base without moving the playout position
+    int64_t before = buffer.Playout(600'000);
+    buffer.Arrive(600'000, 580'000);
+    REQUIRE(buffer.Playout(600'000) == before);
+
+    // Underruns are counted once per episode
+    buffer.Present(false);
+    buffer.Present(false);
+    buffer.Present(true);
+    REQUIRE(stats.underruns == 1);
+
+    // Limits hold and a reset starts over from the configured delay
+    buffer.Arrive(80'000, 10'000'000);
+    REQUIRE(stats.target_delay_us == 2'000'000);
+    buffer.Reset(300'000);
+    REQUIRE(!buffer.Started());
+    REQUIRE(stats.delay_us == 300'000);
+    REQUIRE(stats.late_frames == 2);
+}
+
+TEST_CASE("JitterBuffer.MediaAtKeepsTheDelay", "[jitter_buffer]")
+{
+    JitterBuffer buffer(500'000, { .min_delay_us = 40'000, .max_delay_us = 2'000'000 });
+    REQUIRE(buffer.MediaAt(0) == std::numeric_limits<int64_t>::min());
+    buffer.Arrive(0, 0);
+    buffer.Arrive(40'000, 40'000);
+    std::ignore = buffer.Playout(40'000);
+
+    // Lookups at other times follow the played out position without slewing the delay
+    auto& stats = buffer.GetStats();
+    int64_t delay = stats.delay_us;
+    REQUIRE(buffer.MediaAt(1'040'000) - buffer.MediaAt(40'000) == 1'000'000);
+    REQUIRE(stats.delay_us == delay);
+    REQUIRE(buffer.Playout(1'040'000) != buffer.MediaAt(40'000) + 1'000'000); // Playout moves it
+}
@@ -0,0 +1,119 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#include <vortex/util/lut_loader.h>
+
+static std::string MakeCube(uint32_t size)
+{
+    std::string text = "TITLE \"Generated\"\n# identity LUT\nLUT_3D_SIZE " + std::to_string(size) +
+            "\n";
+    float step = 1.0f / float(size - 1);
+    for (uint32_t b = 0; b < size; b++) {
+        for (uint32_t g = 0; g < size; g++) {
+            for (uint32_t r = 0; r < size; r++) {
+                text += std::to_string(r * step) + " " + std::to_string(g * step) + " " +
+                        std::to_string(b * step) + "\n";
+            }
+        }
+    }
+    return text;
+}
+
+TEST_CASE("LutLoader.ParseCube", "[lut]")
+{
+    constexpr std::string_view cube = "# comment before the header\n"
+                                      "TITLE \"Test LUT 1\"\n"
+                                      "LUT_3D_SIZE 2\n"
+                                      "DOMAIN_MIN 0 0 -1\n"
+                                      "DOMAIN_MAX 1 1 2\n"
+                                      "\n"
+                                      "0 0 0\n"
+                                      "1.0 0 0 # trailing comment\n"
+                                      "0 1 0\r\n"
+                                      "1 1 0\n"
+                                      "0 0 1\n"
+                                      "1 0 1\n"
+                                      "0 1 1\n"
+                                      "1 1 1";
+    auto data = LutLoader::ParseCube(cube);
+    REQUIRE(data.type == LutType::Lut3D);
+    REQUIRE(data.stride == 2);
+    REQUIRE(data.data[4] == 1.0f); // Second entry red
+    REQUIRE(data.data[7] == 1.0f); // Alpha is always 1
+    REQUIRE(data.data[31] == 1.0f);
+    REQUIRE(data.domain_min[2] == -1.0f);
+    REQUIRE(data.domain_max[2] == 2.0f);
+
+    auto legacy = LutLoader::ParseCube("LUT_1D_SIZE 2\nLUT_1D_INPUT_RANGE 0 4\n0 0 0\n1 1 1\n");
+    REQUIRE(legacy.type == LutType::Lut1D);
+    REQUIRE(legacy.domain_max[1] == 4.0f);
+
+    // Malformed files are rejected instead of producing garbage
+    REQUIRE(LutLoader::ParseCube("LUT_1D_SIZE 2\n0 0\n1 1 1\n").type == LutType::Undefined);
+    REQUIRE(LutLoader::ParseCube("LUT_1D_SIZE 2\n0 0 0\n").type == LutType::Undefined);
+    REQUIRE(LutLoader::ParseCube("0 0 0\nLUT_1D_SIZE 2\n").type == LutType::Undefined);
+}
+
+TEST_CASE("LutLoader.BinaryCache", "[lut]")
+{
+    auto dir = std::filesystem::temp_directory_path() / "vortex_lut_test";
+    std::filesystem::create_directories(dir);
+    auto source = dir / "identity.cube";
+    std::ofstream(source) << MakeCube(17);
+
+    auto parsed = LutLoader::ParseCube(MakeCube(17));
+    REQUIRE(parsed.type == LutType::Lut3D);
+    size_t values = parsed.EntryCount() * 4;
+
+    auto cache32 = dir / "identity32.vlut";
+    REQUIRE(LutLoader::WriteCache(cache32, source, parsed));
+    auto read32 = LutLoader::ReadCache(cache32, source);
+    REQUIRE(read32.type == LutType::Lut3D);
+    REQUIRE(std::memcmp(read32.data.get(), parsed.data.get(), values * sizeof(float)) == 0);
+
+    auto cache16 = dir / "identity16.vlut";
+    REQUIRE(LutLoader::WriteCache(cache16, source, parsed, LutCacheFormat::Float16));
+    auto read16 = LutLoader::ReadCache(cache16, source);
+    REQUIRE(read16.type == LutType::Lut3D);
+    for (size_t i = 0; i < values; i++) {
+        REQUIRE(std::abs(read16.data[i] - parsed.data[i]) < 1e-3f);
+    }
+
+    // A changed source invalidates the cache
+    std::ofstream(source, std::ios::app) << "# edited\n";
+    REQUIRE(LutLoader::ReadCache(cache32, source).type == LutType::Undefined);
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("LutLoader.Throughput", "[.][benchmark][lut]")
+{
+    auto dir = std::filesystem::temp_directory_path() / "vortex_lut_bench";
+    std::filesystem::create_directories(dir);
+    auto source = dir / "identity65.cube";
+    auto text = MakeCube(65);
+    std::ofstream(source, std::ios::binary) << text;
+    auto cache = LutLoader::GetCachePath(source);
+
+    BENCHMARK("Parse 65^3 from memory")
+    {
+        return LutLoader::ParseCube(text);
+    };
+    BENCHMARK("Load 65^3 without cache")
+    {
+        std::filesystem::remove(cache);
+        return LutLoader::LoadLut(source);
+    };
+    LutLoader::LoadLut(source); // Make sure the cache exists
+    BENCHMARK("Load 65^3 from cache")
+    {
+        return LutLoader::LoadLut(source);
+    };
+
+    std::filesystem::remove(cache);
+    std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,164 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <cmath>
+
+#include <vortex/util/lut_sampler.h>
+
+using vortex::LutSampler;
+using vortex::LUTInterp;
+using Catch::Matchers::WithinAbs;
+
+static LutData MakeLut(LutType type, uint32_t stride)
+{
+    LutData lut;
+    lut.type = type;
+    lut.stride = stride;
+    lut.data = std::make_unique<float[]>(lut.EntryCount() * 4);
+
+    // Curved in every channel, so interpolation errors show up
+    float step = 1.0f / float(stride - 1);
+    for (size_t i = 0; i < lut.EntryCount(); i++) {
+        float r = float(i % stride) * step;
+        float g = float(i / stride % stride) * step;
+        float b = float(i / stride / stride) * step;
+        float* entry = &lut.data[i * 4];
+        if (type == LutType::Lut1D) {
+            entry[0] = r * r, entry[1] = std::sqrt(r), entry[2] = 1.0f - r;
+        } else {
+            entry[0] = r * r, entry[1] = std::sqrt(g) * 0.5f + b * 0.5f, entry[2] = 1.0f - r * b;
+        }
+        entry[3] = 1.0f;
+    }
+    return lut;
+}
+
+// Fetch of a 3D LUT texture the way the sampler does it: texel centers at (i + 0.5) / size,
+// clamp to edge, linear or point filtering
+static std::array<float, 3> Fetch(const LutData& lut, std::array<float, 3> uvw, bool point = false)
+{
+    uint32_t base[3];
+    float f[3];
+    for (size_t i = 0; i < 3; i++) {
+        float texel = std::clamp(uvw[i] * float(lut.stride) - 0.5f, 0.0f, float(lut.stride - 1));
+        if (point) {
+            base[i] = std::min(uint32_t(uvw[i] * float(lut.stride)), lut.stride - 1);
+            f[i] = 0.0f;
+            continue;
+        }
+        base[i] = std::min(uint32_t(texel), lut.stride - 2);
+        f[i] = texel - float(base[i]);
+    }
+
+    std::array<float, 3> result{};
+    for (uint32_t corner = 0; corner < 8; corner++) {
+        uint32_t r = corner & 1, g = (corner >> 1) & 1, b = (corner >> 2) & 1;
+        float weight = (r ? f[0] : 1.0f - f[0]) * (g ? f[1] : 1.0f - f[1]) * (b ? f[2] : 1.0f - f[2]);
+        if (weight == 0.0f) {
+            continue; // Point sampling never reads past the base texel
+        }
+        size_t index = (size_t(base[2] + b) * lut.stride + base[1] + g) * lut.stride + base[0] + r;
+        for (size_t c = 0; c < 3; c++) {
+            result[c] += lut.data[index * 4 + c] * weight;
+        }
+    }
+    return result;
+}
+
+static std::array<float, 3> TexelCenters(std::array<float, 3> color, uint32_t stride)
+{
+    return { LutSampler::TexelCenter(color[0], stride),
+             LutSampler::TexelCenter(color[1], stride),
+             LutSampler::TexelCenter(color[2], stride) };
+}
+
+static void RequireClose(std::array<float, 3> a, std::array<float, 3> b)
+{
+    for (size_t c = 0; c < 3; c++) {
+        REQUIRE_THAT(a[c], WithinAbs(b[c], 1e-5));
+    }
+}
+
+TEST_CASE("LutSampler.TexelCenter", "[lut]")
+{
+    uint32_t stride = GENERATE(2u, 17u, 33u);
+    for (uint32_t i = 0; i < stride; i++) {
+        float texel = LutSampler::TexelCenter(float(i) / float(stride - 1), stride) * float(stride) - 0.5f;
+        REQUIRE_THAT(texel, WithinAbs(float(i), 1e-4));
+    }
+    REQUIRE(LutSampler::TexelCenter(-1.0f, stride) == LutSampler::TexelCenter(0.0f, stride));
+    REQUIRE(LutSampler::TexelCenter(2.0f, stride) == LutSampler::TexelCenter(1.0f, stride));
+}
+
+TEST_CASE("LutSampler.SampledMatchesArithmetic", "[lut]")
+{
+    // The hardware paths of color_correction.ps, fetched at texel centers
+    auto lut = MakeLut(LutType::Lut3D, 9);
+    constexpr int steps = 12;
+    for (int r = 0; r <= steps; r++) {
+        for (int g = 0; g <= steps; g++) {
+            for (int b = 0; b <= steps; b++) {
+                // Slightly outside [0,1] on both ends, the shader saturates
+                std::array<float, 3> color{ r * 1.2f / steps - 0.1f,
+                                            g * 1.2f / steps - 0.1f,
+                                            b * 1.2f / steps - 0.1f };
+                auto uvw = TexelCenters(color, lut.stride);
+                RequireClose(Fetch(lut, uvw), LutSampler::Sample(lut, color, LUTInterp::Trilinear));
+                RequireClose(Fetch(lut, uvw, true), LutSampler::Sample(lut, color, LUTInterp::Nearest));
+            }
+        }
+    }
+}
+
+TEST_CASE("LutSampler.BakedMatchesArithmetic", "[lut]")
+{
+    auto type = GENERATE(LutType::Lut1D, LutType::Lut3D);
+    auto interp = GENERATE(LUTInterp::Nearest, LUTInterp::Trilinear, LUTInterp::Tetrahedral);
+    auto source = MakeLut(type, type == LutType::Lut3D ? 9 : 64);
+    source.domain_min = { -0.1f, 0.0f, 0.0f };
+    source.domain_max = { 1.2f, 1.0f, 2.0f };
+    vortex::ColorAdjustments adjustments{
+        .brightness = 0.05f,
+        .contrast = 1.2f,
+        .saturation = 0.8f,
+        .interp = interp,
+    };
+
+    auto baked = LutSampler::Bake(source, adjustments);
+    REQUIRE(baked.type == LutType::Lut3D);
+    REQUIRE(baked.stride == (type == LutType::Lut3D ? source.stride : LutSampler::baked_1d_stride));
+
+    // Every grid point of the baked LUT, fetched by color_correction_baked.ps, gives what the
+    // arithmetic path of color_correction.ps computes for the same color
+    float step = 1.0f / float(baked.stride - 1);
+    for (uint32_t r = 0; r < baked.stride; r++) {
+        for (uint32_t g = 0; g < baked.stride; g++) {
+            for (uint32_t b = 0; b < baked.stride; b++) {
+                std::array<float, 3> color{ r * step, g * step, b * step };
+                auto adjusted = LutSampler::ApplyAdjustments(color, adjustments);
+                for (size_t i = 0; i < 3; i++) { // domain_min and domain_scale of the shader
+                    adjusted[i] = (adjusted[i] - source.domain_min[i]) *
+                            (1.0f / (source.domain_max[i] - source.domain_min[i]));
+                }
+                RequireClose(Fetch(baked, TexelCenters(color, baked.stride)),
+                             LutSampler::Sample(source, adjusted, interp));
+            }
+        }
+    }
+}
+
+TEST_CASE("LutSampler.BakedIdentityMatchesEverywhere", "[lut]")
+{
+    // Without adjustments a baked 3D LUT is the source, so both paths agree between grid points too
+    auto source = MakeLut(LutType::Lut3D, 5);
+    auto baked = LutSampler::Bake(source, {});
+    for (float r = 0.0f; r <= 1.0f; r += 0.07f) {
+        for (float g = 0.0f; g <= 1.0f; g += 0.11f) {
+            for (float b = 0.0f; b <= 1.0f; b += 0.13f) {
+                std::array<float, 3> color{ r, g, b };
+                RequireClose(Fetch(baked, TexelCenters(color, baked.stride)),
+                             LutSampler::Sample(source, color, LUTInterp::Trilinear));
+            }
+        }
+    }
+}
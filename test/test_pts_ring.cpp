@@ -0,0 +1,92 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <map>
+#include <memory>
+
+#include <vortex/util/pts_ring.h>
+
+TEST_CASE("PtsRing.InsertAndLookup", "[pts_ring]")
+{
+    vortex::pts_ring<int, 4> ring;
+    REQUIRE(ring.empty());
+    REQUIRE(ring.lower_bound(0) == 0);
+
+    for (int i = 0; i < 4; i++) {
+        REQUIRE(ring.push(i * 100, i));
+    }
+    REQUIRE(ring.size() == 4);
+    REQUIRE(ring.lower_bound(-5) == 0);
+    REQUIRE(ring.lower_bound(100) == 1);
+    REQUIRE(ring.lower_bound(150) == 2);
+    REQUIRE(ring.lower_bound(1000) == 4);
+
+    // Full ring evicts the oldest entry, the head wraps around
+    REQUIRE(ring.push(400, 4));
+    REQUIRE(ring.size() == 4);
+    REQUIRE(ring.front().pts == 100);
+    REQUIRE(ring.back().value == 4);
+
+    // Late frames are shifted into order, equal PTS replaces
+    REQUIRE(ring.push(250, 25));
+    REQUIRE(ring.front().pts == 200);
+    REQUIRE(ring[1].pts == 250);
+    REQUIRE(ring[2].pts == 300);
+    REQUIRE(ring.push(300, 33));
+    REQUIRE(ring.size() == 4);
+    REQUIRE(ring[2].value == 33);
+
+    // Older than everything in a full ring
+    REQUIRE(!ring.push(50, 5));
+    REQUIRE(ring.front().pts == 200);
+}
+
+TEST_CASE("PtsRing.PopReleases", "[pts_ring]")
+{
+    vortex::pts_ring<std::shared_ptr<int>, 3> ring;
+    auto first = std::make_shared<int>(1);
+    std::weak_ptr<int> watch = first;
+    ring.push(0, std::move(first));
+    ring.push(10, std::make_shared<int>(2));
+    ring.push(20, std::make_shared<int>(3));
+
+    ring.pop_front();
+    REQUIRE(watch.expired()); // Not kept alive by the free slot
+    REQUIRE(ring.size() == 2);
+    REQUIRE(*ring.front().value == 2);
+
+    ring.pop_front(10);
+    REQUIRE(ring.empty());
+    REQUIRE(ring.push(30, std::make_shared<int>(4)));
+    REQUIRE(ring.lower_bound(30) == 0);
+}
+
+TEST_CASE("PtsRing.Throughput", "[.][benchmark][pts_ring]")
+{
+    // One input at 60 fps in a 90kHz timebase, keeping the newest 16 frames
+    constexpr int64_t frame_pts = 1500;
+    constexpr int frames = 600;
+
+    BENCHMARK("std::map")
+    {
+        std::map<int64_t, int> map;
+        int64_t sum = 0;
+        for (int i = 0; i < frames; i++) {
+            map[i * frame_pts] = i;
+            while (map.size() > 16) {
+                map.erase(map.begin());
+            }
+            sum += map.lower_bound(i * frame_pts - 4 * frame_pts)->second;
+        }
+        return sum;
+    };
+    BENCHMARK("pts_ring")
+    {
+        vortex::pts_ring<int, 16> ring;
+        int64_t sum = 0;
+        for (int i = 0; i < frames; i++) {
+            ring.push(i * frame_pts, i);
+            sum += ring[ring.lower_bound(i * frame_pts - 4 * frame_pts)].value;
+        }
+        return sum;
+    };
+}
@@ -0,0 +1,53 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <numbers>
+
+#include <vortex/util/rect.h>
+
+using Catch::Matchers::WithinAbs;
+
+static void RequireRect(DirectX::XMFLOAT4 rect, float x, float y, float z, float w)
+{
+    REQUIRE_THAT(rect.x, WithinAbs(x, 1e-5));
+    REQUIRE_THAT(rect.y, WithinAbs(y, 1e-5));
+    REQUIRE_THAT(rect.z, WithinAbs(z, 1e-5));
+    REQUIRE_THAT(rect.w, WithinAbs(w, 1e-5));
+}
+
+TEST_CASE("Rect.UnionIntersect", "[rect]")
+{
+    DirectX::XMFLOAT4 a{ 0.0f, 0.0f, 0.5f, 0.5f };
+    DirectX::XMFLOAT4 b{ 0.25f, 0.25f, 0.5f, 0.5f };
+    RequireRect(vortex::IntersectRect(a, b), 0.25f, 0.25f, 0.25f, 0.25f);
+    RequireRect(vortex::UnionRect(a, b), 0.0f, 0.0f, 0.75f, 0.75f);
+
+    // Empty rects do not grow a union
+    RequireRect(vortex::UnionRect(vortex::empty_rect, b), 0.25f, 0.25f, 0.5f, 0.5f);
+    REQUIRE(vortex::IsEmptyRect(vortex::IntersectRect(a, { 0.6f, 0.6f, 0.1f, 0.1f })));
+}
+
+TEST_CASE("Rect.TransformRect", "[rect]")
+{
+    constexpr float aspect = 16.0f / 9.0f;
+
+    // Picture in picture in the top right quarter
+    auto pip = vortex::TransformRect(vortex::full_rect, { 0.25f, 0.25f }, { 0.5f, 0.5f },
+                                     { 0.5f, 0.5f }, 0.0f, aspect);
+    RequireRect(pip, 0.5f, 0.0f, 0.5f, 0.5f);
+
+    // Cropped to the lower half before scaling around the bottom left corner
+    auto lower = vortex::TransformRect({ 0.0f, 0.5f, 1.0f, 0.5f }, { 0.0f, 0.0f }, { 0.5f, 0.5f },
+                                       { 0.0f, 0.0f }, 0.0f, aspect);
+    RequireRect(lower, 0.0f, 0.75f, 0.5f, 0.25f);
+
+    // A quarter turn of a square region keeps it square on a wide output
+    auto turned = vortex::TransformRect({ 0.5f - 0.5f / aspect, 0.0f, 1.0f / aspect, 1.0f },
+                                        { 0.0f, 0.0f }, { 1.0f, 1.0f }, { 0.5f, 0.5f },
+                                        std::numbers::pi_v<float> / 2.0f, aspect);
+    RequireRect(turned, 0.5f - 0.5f / aspect, 0.0f, 1.0f / aspect, 1.0f);
+
+    // Moved out of the frame
+    REQUIRE(vortex::IsEmptyRect(vortex::TransformRect(vortex::full_rect, { 2.0f, 0.0f },
+                                                      { 1.0f, 1.0f }, { 0.5f, 0.5f }, 0.0f,
+                                                      aspect)));
+}
@@ -0,0 +1,53 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <vortex/codec/ffmpeg/sequence_reader.h>
+
+using vortex::ffmpeg::SequencePattern;
+using vortex::ffmpeg::SequenceReader;
+
+TEST_CASE("SequenceReader.Pattern", "[sequence]")
+{
+    auto padded = SequencePattern::Parse("stinger_%04d.png");
+    REQUIRE(padded);
+    REQUIRE(padded->prefix == "stinger_");
+    REQUIRE(padded->suffix == ".png");
+    REQUIRE(padded->width == 4);
+    REQUIRE(padded->Format(7) == "stinger_0007.png");
+    REQUIRE(padded->Format(12345) == "stinger_12345.png");
+    REQUIRE(padded->Match("stinger_0042.png") == 42);
+    REQUIRE(padded->Match("stinger_12345.png") == 12345);
+    REQUIRE(!padded->Match("stinger_42.png")); // Not padded
+    REQUIRE(!padded->Match("stinger_00a2.png"));
+    REQUIRE(!padded->Match("stinger_.png"));
+    REQUIRE(!padded->Match("other_0042.png"));
+
+    auto plain = SequencePattern::Parse("100%%_%d.tga");
+    REQUIRE(plain);
+    REQUIRE(plain->prefix == "100%_");
+    REQUIRE(plain->width == 0);
+    REQUIRE(plain->Match("100%_3.tga") == 3);
+
+    // Clips and unsupported specifiers are not sequences
+    REQUIRE(!SequencePattern::Parse("clip.mov"));
+    REQUIRE(!SequencePattern::Parse("frame_%s.png"));
+    REQUIRE(!SequencePattern::Parse("frame_%4d.png"));
+    REQUIRE(!SequencePattern::Parse("frame_%d_%d.png"));
+}
+
+TEST_CASE("SequenceReader.FrameIndexAt", "[sequence]")
+{
+    constexpr int64_t second = 90000;
+    vortex::ratio32_t rate{ 25, 1 };
+
+    REQUIRE(SequenceReader::FrameIndexAt(0, rate, 10, 19, false) == 10);
+    REQUIRE(SequenceReader::FrameIndexAt(second / 25 - 1, rate, 10, 19, false) == 10);
+    REQUIRE(SequenceReader::FrameIndexAt(second / 25, rate, 10, 19, false) == 11);
+
+    // Holds the out point, or wraps to the in point when looping
+    REQUIRE(SequenceReader::FrameIndexAt(second, rate, 10, 19, false) == 19);
+    REQUIRE(SequenceReader::FrameIndexAt(second, rate, 10, 19, true) == 15);
+
+    // NTSC rates do not drift
+    vortex::ratio32_t ntsc{ 30000, 1001 };
+    REQUIRE(SequenceReader::FrameIndexAt(int64_t(1001) * 3 * 9000, ntsc, 0, 100000, false) == 9000);
+}
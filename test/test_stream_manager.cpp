@@ -0,0 +1,346 @@
+#include <catch2/catch_test_macros.hpp>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <random>
+#include <span>
+#include <thread>
+#include <vector>
+#include "mock_model.h"
+
+#include <vortex/codec/ffmpeg/stream_manager.h>
+#include <vortex/codec/ffmpeg/synthetic_source.h>
+
+using vortex::ffmpeg::ChannelStorage;
+using vortex::ffmpeg::StreamConsumer;
+using vortex::ffmpeg::StreamManager;
+
+namespace {
+constexpr int raw_size = 64; // Gray frames of the raw decoder
+constexpr int clip_frames = 10; // Fewer than a frame queue holds, the whole clip ends up queued
+constexpr std::array all_channels = { -1 };
+
+// Raw video needs no bitstream, every packet is decoded into one frame with its pts
+vortex::ffmpeg::unique_codec_context OpenRawDecoder()
+{
+    vortex::ffmpeg::unique_codec_context decoder{ avcodec_alloc_context3(avcodec_find_decoder(AV_CODEC_ID_RAWVIDEO)) };
+    REQUIRE(decoder);
+    decoder->width = raw_size;
+    decoder->height = raw_size;
+    decoder->pix_fmt = AV_PIX_FMT_GRAY8;
+    REQUIRE(avcodec_open2(decoder.get(), decoder->codec, nullptr) >= 0);
+    return decoder;
+}
+vortex::ffmpeg::pooled_packet MakeRawPacket(vortex::ffmpeg::packet_pool& pool, int64_t pts)
+{
+    auto packet = pool.acquire();
+    REQUIRE(av_new_packet(packet.get(), raw_size * raw_size) == 0);
+    std::memset(packet->data, int(pts), raw_size * raw_size);
+    packet->pts = packet->dts = pts;
+    packet->flags |= AV_PKT_FLAG_KEY;
+    return packet;
+}
+
+// Short clip of the synthetic pattern on disk, so connections never touch the network
+struct ClipFile {
+    std::filesystem::path path = std::filesystem::temp_directory_path() /
+            std::format("vortex_stream_manager_{:08x}.mkv", std::random_device{}()); // Unique per run
+
+    ClipFile()
+    {
+        auto encoder = vortex::ffmpeg::VideoEncoder::Open({
+                .url = path.string(),
+                .width = 320,
+                .height = 180,
+                .rate = { 30, 1 },
+                .bitrate = 1'000'000,
+                .input_format = AV_PIX_FMT_YUV420P,
+                .kind = vortex::ffmpeg::EncoderKind::Software,
+        });
+        REQUIRE(encoder);
+
+        vortex::ffmpeg::unique_frame frame{ av_frame_alloc() };
+        frame->format = AV_PIX_FMT_YUV420P;
+        frame->width = 320;
+        frame->height = 180;
+        REQUIRE(av_frame_get_buffer(frame.get(), 0) >= 0);
+        for (int i = 0; i < clip_frames; i++) {
+            REQUIRE(av_frame_make_writable(frame.get()) >= 0);
+            vortex::ffmpeg::SyntheticPattern::Draw(*frame, i, { 30, 1 });
+            frame->pts = i;
+            REQUIRE((*encoder)->Encode(*frame));
+        }
+        REQUIRE((*encoder)->Finish());
+    }
+    ~ClipFile() { std::filesystem::remove(path); }
+};
+
+StreamManager::StreamHandle Connect(StreamManager& manager,
+                                    const std::filesystem::path& path,
+                                    vortex::ffmpeg::unique_dictionary options = {},
+                                    std::span<const int> active_indices = all_channels)
+{
+    using namespace std::chrono_literals;
+    auto connection = manager.ConnectStream(path.string(), std::move(options), active_indices);
+    auto deadline = std::chrono::steady_clock::now() + 10s;
+    while (!connection->done.load(std::memory_order::acquire) && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(1ms);
+    }
+    REQUIRE(!connection->error);
+    return StreamManager::TakeConnection(*connection);
+}
+StreamConsumer& GetConsumer(StreamManager::StreamHandle handle)
+{
+    return *std::bit_cast<StreamConsumer*>(handle);
+}
+// Waits for the I/O thread to open or close decoders
+bool WaitForChannels(StreamManager& manager, StreamManager::StreamHandle handle, std::size_t count)
+{
+    using namespace std::chrono_literals;
+    auto deadline = std::chrono::steady_clock::now() + 10s;
+    while (manager.GetStats(handle)->channels.size() != count && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(1ms);
+    }
+    return manager.GetStats(handle)->channels.size() == count;
+}
+} // namespace
+
+TEST_CASE("ChannelStorage.FanOut", "[stream_manager]")
+{
+    vortex::wake_signal wake;
+    std::atomic<uint32_t> consumer_mask{ 0b101 };
+    ChannelStorage channel(OpenRawDecoder(), wake, consumer_mask);
+    REQUIRE(channel.IsValid());
+    auto packets = std::make_shared<vortex::ffmpeg::packet_pool>(4);
+    constexpr int64_t frames = ChannelStorage::max_frames;
+    constexpr int64_t overrun = 4;
+
+    // Slot 0 keeps up, slot 2 never reads and misses the frames past its queue
+    for (int64_t i = 0; i < frames + overrun; i++) {
+        REQUIRE(channel.SendPacket(MakeRawPacket(*packets, i), {}));
+        REQUIRE(channel.TryDecodeFrame());
+        auto frame = channel.GetDecodedFrame(0);
+        REQUIRE(frame);
+        REQUIRE((*frame)->pts == i);
+    }
+    auto stats = channel.GetStats(0);
+    REQUIRE(stats.frames == frames + overrun);
+    REQUIRE(stats.dropped_frames == overrun);
+    REQUIRE(stats.frame_queue_depth == frames);
+    REQUIRE(!channel.IsFrameQueueFull());
+
+    // Decoding only waits once no consumer has room
+    for (int64_t i = frames + overrun; i < 2 * frames + overrun; i++) {
+        REQUIRE(channel.SendPacket(MakeRawPacket(*packets, i), {}));
+        REQUIRE(channel.TryDecodeFrame());
+    }
+    REQUIRE(channel.IsFrameQueueFull());
+    REQUIRE(channel.SendPacket(MakeRawPacket(*packets, 2 * frames + overrun), {}));
+    REQUIRE(!channel.TryDecodeFrame());
+    REQUIRE(channel.GetStats(0).frames == 2 * frames + overrun);
+    REQUIRE(channel.GetStats(0).dropped_frames == frames + overrun);
+
+    // The slow consumer kept the oldest frames, sharing data with the frames of slot 0
+    auto oldest = channel.GetDecodedFrame(2);
+    REQUIRE(oldest);
+    REQUIRE((*oldest)->pts == 0);
+    REQUIRE(channel.TryDecodeFrame());
+    REQUIRE(channel.GetStats(0).dropped_frames == frames + overrun + 1); // Slot 0 was full
+    for (int64_t i = 1; i < frames; i++) {
+        auto frame = channel.GetDecodedFrame(2);
+        REQUIRE(frame);
+        REQUIRE((*frame)->pts == i);
+    }
+    auto newest = channel.GetDecodedFrame(2);
+    REQUIRE(newest);
+    REQUIRE((*newest)->pts == 2 * frames + overrun);
+    REQUIRE(!channel.GetDecodedFrame(2));
+    REQUIRE(!channel.GetDecodedFrame(1)); // Not attached
+}
+
+TEST_CASE("ChannelStorage.ResetConsumer", "[stream_manager]")
+{
+    vortex::wake_signal wake;
+    std::atomic<uint32_t> consumer_mask{ 0b11 };
+    ChannelStorage channel(OpenRawDecoder(), wake, consumer_mask);
+    auto packets = std::make_shared<vortex::ffmpeg::packet_pool>(4);
+
+    REQUIRE(channel.SendPacket(MakeRawPacket(*packets, 0), {}));
+    REQUIRE(channel.TryDecodeFrame());
+    auto frame = channel.GetDecodedFrame(0);
+    REQUIRE(frame);
+    int references = av_buffer_get_ref_count((*frame)->buf[0]);
+
+    // What the detached consumer left queued lets go of the frame data
+    consumer_mask.store(0b01);
+    channel.ResetConsumer(1);
+    REQUIRE(av_buffer_get_ref_count((*frame)->buf[0]) == references - 1);
+    REQUIRE(!channel.GetDecodedFrame(1));
+
+    // Frames are not fanned out to the slot anymore and not counted as missed
+    REQUIRE(channel.SendPacket(MakeRawPacket(*packets, 1), {}));
+    REQUIRE(channel.TryDecodeFrame());
+    REQUIRE(!channel.GetDecodedFrame(1));
+    REQUIRE(channel.GetDecodedFrame(0));
+    REQUIRE(channel.GetStats(0).dropped_frames == 0);
+}
+
+TEST_CASE("StreamManager.SharesSource", "[stream_manager]")
+{
+    InitToken initializer;
+    ClipFile clip;
+    vortex::Graphics gfx{ true };
+    StreamManager manager(gfx, { .force_software_decode = true });
+
+    auto first = Connect(manager, clip.path);
+    auto second = Connect(manager, clip.path);
+    REQUIRE(first);
+    REQUIRE(second);
+    REQUIRE(GetConsumer(first).stream == GetConsumer(second).stream);
+    REQUIRE(GetConsumer(first).slot != GetConsumer(second).slot);
+    REQUIRE(manager.GetStats(first)->consumers == 2);
+
+    // Options are part of the key, the same source opened with others is not shared
+    vortex::ffmpeg::unique_dictionary options;
+    REQUIRE(av_dict_set(options.address_of(), "probesize", "65536", 0) >= 0);
+    auto other = Connect(manager, clip.path, std::move(options));
+    REQUIRE(other);
+    REQUIRE(GetConsumer(other).stream != GetConsumer(first).stream);
+    REQUIRE(manager.GetAllStats().size() == 2);
+
+    manager.UnregisterStream(first);
+    manager.UnregisterStream(second);
+    manager.UnregisterStream(other);
+    REQUIRE(manager.GetAllStats().empty());
+}
+
+TEST_CASE("StreamManager.ConsumerSlots", "[stream_manager]")
+{
+    InitToken initializer;
+    ClipFile clip;
+    vortex::Graphics gfx{ true };
+    StreamManager manager(gfx, { .force_software_decode = true });
+
+    std::vector<StreamManager::StreamHandle> handles;
+    for (uint32_t i = 0; i < ChannelStorage::max_consumers; i++) {
+        handles.push_back(Connect(manager, clip.path));
+        REQUIRE(handles.back());
+        REQUIRE(GetConsumer(handles.back()).stream == GetConsumer(handles.front()).stream);
+        REQUIRE(GetConsumer(handles.back()).slot == i); // Lowest free slot
+    }
+    auto shared = GetConsumer(handles.front()).stream;
+    REQUIRE(shared->consumer_mask.load() == 0xFF);
+
+    // A full stream is not joined, the source is opened again
+    auto overflow = Connect(manager, clip.path);
+    REQUIRE(overflow);
+    REQUIRE(GetConsumer(overflow).stream != shared);
+    REQUIRE(GetConsumer(overflow).slot == 0);
+    REQUIRE(manager.GetAllStats().size() == 2);
+    manager.UnregisterStream(overflow);
+
+    // A freed slot is handed to the next connection
+    manager.UnregisterStream(handles[3]);
+    REQUIRE(shared->consumer_mask.load() == 0xF7);
+    handles[3] = Connect(manager, clip.path);
+    REQUIRE(handles[3]);
+    REQUIRE(GetConsumer(handles[3]).stream == shared);
+    REQUIRE(GetConsumer(handles[3]).slot == 3);
+
+    for (auto handle : handles) {
+        manager.UnregisterStream(handle);
+    }
+    REQUIRE(manager.GetAllStats().empty());
+}
+
+TEST_CASE("StreamManager.UnregisterStream", "[stream_manager]")
+{
+    using namespace std::chrono_literals;
+    InitToken initializer;
+    ClipFile clip;
+    vortex::Graphics gfx{ true };
+    StreamManager manager(gfx, { .force_software_decode = true });
+
+    auto reader = Connect(manager, clip.path);
+    auto idle = Connect(manager, clip.path);
+    REQUIRE(reader);
+    REQUIRE(idle);
+    auto stream = GetConsumer(reader).stream;
+    uint32_t idle_slot = GetConsumer(idle).slot;
+    auto video = stream->channels.begin();
+    REQUIRE(video != stream->channels.end());
+    auto& channel = video->second;
+
+    // The whole clip is decoded, the reader takes its frames and the idle consumer holds on to them
+    int received = 0;
+    auto deadline = std::chrono::steady_clock::now() + 10s;
+    while ((received < clip_frames || channel.GetStats(video->first).frame_queue_depth < clip_frames) &&
+           std::chrono::steady_clock::now() < deadline) {
+        while (channel.GetDecodedFrame(GetConsumer(reader).slot)) {
+            received++;
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+    REQUIRE(received == clip_frames);
+    REQUIRE(channel.GetStats(video->first).frame_queue_depth == clip_frames);
+
+    // The stream stays open for the other consumer, the frames queued for this one are released
+    manager.UnregisterStream(idle);
+    REQUIRE(!manager.GetStats(idle));
+    REQUIRE(!stream->closing.load());
+    REQUIRE(manager.GetStats(reader)->consumers == 1);
+    REQUIRE(!channel.GetDecodedFrame(idle_slot));
+    REQUIRE(channel.GetStats(video->first).frame_queue_depth == 0);
+
+    // Closed with its last consumer
+    manager.UnregisterStream(reader);
+    REQUIRE(stream->closing.load());
+    REQUIRE(manager.GetAllStats().empty());
+}
+
+TEST_CASE("StreamManager.SharedChannels", "[stream_manager]")
+{
+    InitToken initializer;
+    ClipFile clip;
+    vortex::Graphics gfx{ true };
+    StreamManager manager(gfx, { .force_software_decode = true });
+
+    // The second consumer shares the stream without using its video
+    auto full = Connect(manager, clip.path);
+    auto none = Connect(manager, clip.path, {}, {});
+    REQUIRE(full);
+    REQUIRE(none);
+    auto stream = GetConsumer(full).stream;
+    REQUIRE(GetConsumer(none).stream == stream);
+    REQUIRE(WaitForChannels(manager, full, 1));
+    int video = manager.GetStats(full)->channels[0].stream_index;
+
+    std::array indices = { video };
+    manager.ActivateChannels(none, indices);
+    REQUIRE(stream->IsChannelUsed(video));
+
+    // Deactivated by one consumer, the decoder keeps running for the other
+    manager.DeactivateChannels(full, indices);
+    REQUIRE(stream->IsChannelUsed(video));
+    REQUIRE(WaitForChannels(manager, full, 1));
+
+    // Closed with its last user, and opened again on demand
+    manager.SetChannelActive(none, video, false);
+    REQUIRE(!stream->IsChannelUsed(video));
+    REQUIRE(WaitForChannels(manager, full, 0));
+    manager.SetChannelActive(full, video, true);
+    REQUIRE(WaitForChannels(manager, full, 1));
+
+    // Unregistering releases the consumer's channels
+    manager.SetChannelActive(none, video, true);
+    manager.DeactivateChannels(full, indices);
+    manager.UnregisterStream(none);
+    REQUIRE(!stream->IsChannelUsed(video));
+    REQUIRE(WaitForChannels(manager, full, 0));
+
+    manager.UnregisterStream(full);
+    REQUIRE(manager.GetAllStats().empty());
+}
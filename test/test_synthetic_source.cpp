@@ -0,0 +1,150 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <format>
+#include <thread>
+#include <vector>
+#include "mock_model.h"
+
+#include <vortex/codec/ffmpeg/synthetic_source.h>
+#include <vortex/codec/ffmpeg/stream_manager.h>
+
+using vortex::ffmpeg::SyntheticPattern;
+using vortex::ffmpeg::SyntheticSource;
+
+namespace {
+vortex::ffmpeg::unique_frame MakeFrame(int width, int height)
+{
+    vortex::ffmpeg::unique_frame frame{ av_frame_alloc() };
+    frame->format = AV_PIX_FMT_YUV420P;
+    frame->width = width;
+    frame->height = height;
+    REQUIRE(av_frame_get_buffer(frame.get(), 0) >= 0);
+    return frame;
+}
+} // namespace
+
+TEST_CASE("SyntheticPattern.StampRoundTrip", "[synthetic_source]")
+{
+    auto frame = MakeFrame(1280, 720);
+    constexpr int64_t stamp = 0x123456789AB;
+    SyntheticPattern::Draw(*frame, 42, { 30000, 1001 });
+    REQUIRE(!SyntheticPattern::ReadStamp(*frame)); // Not stamped yet
+    SyntheticPattern::WriteStamp(*frame, stamp);
+    REQUIRE(SyntheticPattern::ReadStamp(*frame) == stamp);
+
+    // Coding noise does not flip the cells
+    uint32_t seed = 1;
+    for (int y = 0; y < frame->height; y++) {
+        for (int x = 0; x < frame->width; x++) {
+            seed = seed * 1103515245 + 12345;
+            auto& luma = frame->data[0][y * frame->linesize[0] + x];
+            luma = uint8_t(std::clamp(int(luma) + int(seed >> 16) % 41 - 20, 0, 255));
+        }
+    }
+    REQUIRE(SyntheticPattern::ReadStamp(*frame) == stamp);
+
+    // A damaged cell fails the check instead of giving a wrong time
+    int cell = frame->width / SyntheticPattern::stamp_cells;
+    for (int y = 0; y < frame->height / 16; y++) {
+        for (int x = 3 * cell; x < 4 * cell; x++) {
+            frame->data[0][y * frame->linesize[0] + x] ^= 0xFF;
+        }
+    }
+    REQUIRE(!SyntheticPattern::ReadStamp(*frame));
+
+    // Too narrow for the stamp
+    auto small = MakeFrame(160, 90);
+    SyntheticPattern::WriteStamp(*small, stamp);
+    REQUIRE(!SyntheticPattern::ReadStamp(*small));
+}
+
+TEST_CASE("SyntheticPattern.Timecode", "[synthetic_source]")
+{
+    REQUIRE(SyntheticPattern::Timecode(0, { 30, 1 }) == "00:00:00:00");
+    REQUIRE(SyntheticPattern::Timecode(3661 * 30 + 5, { 30, 1 }) == "01:01:01:05");
+    REQUIRE(SyntheticPattern::Timecode(59, { 30000, 1001 }) == "00:00:01:29"); // Non-drop, counted at 30
+    REQUIRE(SyntheticPattern::Timecode(24 * 3600 * 25, { 25, 1 }) == "00:00:00:00");
+}
+
+TEST_CASE("SyntheticSource.IngestLatency", "[.][benchmark][ingest]")
+{
+    // N sources on localhost, decoded in software so the stamp can be read from system memory
+    using namespace std::chrono_literals;
+    constexpr auto measure_time = 10s;
+    int stream_count = GENERATE(1, 4, 8);
+
+    InitToken initializer;
+    vortex::Graphics gfx{ true };
+    vortex::ffmpeg::StreamManager manager(gfx, { .force_software_decode = true });
+
+    std::vector<std::unique_ptr<SyntheticSource>> sources;
+    std::vector<std::shared_ptr<vortex::ffmpeg::StreamConnection>> connections;
+    constexpr std::array active_indices = { -1 };
+    for (int i = 0; i < stream_count; i++) {
+        auto url = std::format("udp://127.0.0.1:{}", 23000 + i);
+        auto source = SyntheticSource::Start({ .url = url + "?pkt_size=1316", .width = 1920, .height = 1080 });
+        REQUIRE(source);
+        sources.push_back(std::move(source.value()));
+        connections.push_back(manager.ConnectStream(url, vortex::ffmpeg::unique_dictionary{}, active_indices));
+    }
+
+    struct Consumer {
+        vortex::ffmpeg::StreamManager::StreamHandle handle;
+        vortex::ffmpeg::ChannelStorage* video;
+        uint32_t slot;
+    };
+    std::vector<Consumer> consumers;
+    for (auto& connection : connections) {
+        auto deadline = std::chrono::steady_clock::now() + 10s;
+        while (!connection->done.load(std::memory_order::acquire) && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(10ms);
+        }
+        auto handle = vortex::ffmpeg::StreamManager::TakeConnection(*connection);
+        REQUIRE(handle);
+        REQUIRE(!connection->channels.video_channels.empty());
+        auto& consumer = *std::bit_cast<vortex::ffmpeg::StreamConsumer*>(handle);
+        auto* video = consumer.FindChannel(connection->channels.video_channels[0]->index);
+        REQUIRE(video);
+        consumers.push_back({ handle, video, consumer.slot });
+    }
+
+    uint64_t frames = 0;
+    std::vector<int64_t> latencies;
+    auto start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < measure_time) {
+        for (auto& consumer : consumers) {
+            while (auto frame = consumer.video->GetDecodedFrame(consumer.slot)) {
+                frames++;
+                if (auto age = SyntheticPattern::StampAge(*frame->get())) {
+                    latencies.push_back(*age);
+                }
+            }
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+
+    int64_t decode_us = 0;
+    for (auto& stats : manager.GetAllStats()) {
+        for (auto& channel : stats.channels) {
+            decode_us = std::max(decode_us, channel.decode_time_us);
+        }
+    }
+    for (auto& consumer : consumers) {
+        manager.UnregisterStream(consumer.handle);
+    }
+
+    REQUIRE(frames > 0);
+    REQUIRE(!latencies.empty());
+    std::ranges::sort(latencies);
+    auto seconds = std::chrono::duration<double>(measure_time).count();
+    vortex::info("{} streams: {:.1f} fps decoded, glass to glass p50 {:.1f} ms, p95 {:.1f} ms, max {:.1f} ms, slowest decoder {} us/frame",
+                 stream_count, double(frames) / seconds,
+                 latencies[latencies.size() / 2] / 1000.0,
+                 latencies[latencies.size() * 95 / 100] / 1000.0,
+                 latencies.back() / 1000.0,
+                 decode_us);
+}
@@ -0,0 +1,75 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <random>
+
+#include <vortex/codec/ffmpeg/video_encoder.h>
+#include <vortex/codec/ffmpeg/synthetic_source.h>
+
+using vortex::ffmpeg::VideoEncoder;
+
+TEST_CASE("VideoEncoder.GuessFormat", "[video_encoder]")
+{
+    REQUIRE(std::strcmp(VideoEncoder::GuessFormat("udp://127.0.0.1:5000?pkt_size=1316"), "mpegts") == 0);
+    REQUIRE(std::strcmp(VideoEncoder::GuessFormat("rtp://239.0.0.1:5004"), "rtp_mpegts") == 0);
+    REQUIRE(std::strcmp(VideoEncoder::GuessFormat("pipe:1"), "mpegts") == 0);
+    REQUIRE(VideoEncoder::GuessFormat("recording.mp4") == nullptr); // Guessed by FFmpeg from the extension
+}
+
+TEST_CASE("VideoEncoder.WritesFile", "[video_encoder]")
+{
+    // NV12 frames go through the converter when the encoder only takes YUV 4:2:0 planar
+    AVPixelFormat input_format = GENERATE(AV_PIX_FMT_YUV420P, AV_PIX_FMT_NV12);
+    // Test runs in parallel must not write to each other's file
+    auto path = std::filesystem::temp_directory_path() /
+            std::format("vortex_video_encoder_{:08x}.mkv", std::random_device{}());
+    constexpr int frame_count = 30;
+
+    {
+        auto encoder = VideoEncoder::Open({
+                .url = path.string(),
+                .width = 321, // Rounded down to even
+                .height = 180,
+                .rate = { 30, 1 },
+                .bitrate = 1'000'000,
+                .input_format = input_format,
+                .kind = vortex::ffmpeg::EncoderKind::Software,
+        });
+        REQUIRE(encoder);
+
+        vortex::ffmpeg::unique_frame frame{ av_frame_alloc() };
+        frame->format = input_format;
+        frame->width = 320;
+        frame->height = 180;
+        REQUIRE(av_frame_get_buffer(frame.get(), 0) >= 0);
+        for (int i = 0; i < frame_count; i++) {
+            REQUIRE(av_frame_make_writable(frame.get()) >= 0);
+            vortex::ffmpeg::SyntheticPattern::Draw(*frame, i, { 30, 1 }); // Leaves NV12 untouched
+            frame->pts = i;
+            REQUIRE((*encoder)->Encode(*frame));
+        }
+        REQUIRE((*encoder)->Finish());
+        REQUIRE((*encoder)->GetBytesWritten() > 0);
+        REQUIRE(!(*encoder)->Encode(*frame)); // Finished
+    }
+
+    vortex::ffmpeg::unique_context input;
+    REQUIRE(avformat_open_input(input.address_of(), path.string().c_str(), nullptr, nullptr) >= 0);
+    REQUIRE(avformat_find_stream_info(input.get(), nullptr) >= 0);
+    REQUIRE(input->nb_streams == 1);
+    REQUIRE(input->streams[0]->codecpar->width == 320);
+    REQUIRE(input->streams[0]->codecpar->height == 180);
+
+    int packets = 0;
+    vortex::ffmpeg::unique_packet packet{ av_packet_alloc() };
+    while (av_read_frame(input.get(), packet.get()) >= 0) {
+        packets++;
+        av_packet_unref(packet.get());
+    }
+    REQUIRE(packets == frame_count);
+
+    input.reset();
+    std::filesystem::remove(path);
+}
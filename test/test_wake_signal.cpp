@@ -0,0 +1,40 @@
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <thread>
+
+#include <vortex/util/wake_signal.h>
+
+TEST_CASE("WakeSignal.WakesWaiter", "[wake_signal]")
+{
+    vortex::wake_signal signal;
+    std::atomic<int> work{ 0 };
+    std::atomic<int> seen{ 0 };
+
+    std::jthread consumer([&] {
+        while (seen.load() < 3) {
+            uint32_t observed = signal.value();
+            if (int available = work.load(); available > seen.load()) {
+                seen.store(available);
+                continue;
+            }
+            signal.wait(observed);
+        }
+    });
+
+    for (int i = 1; i <= 3; i++) {
+        work.store(i);
+        signal.notify();
+    }
+    consumer.join();
+    REQUIRE(seen.load() == 3);
+}
+
+TEST_CASE("WakeSignal.NoLostNotify", "[wake_signal]")
+{
+    // A notify after value() was observed makes the wait return right away
+    vortex::wake_signal signal;
+    uint32_t observed = signal.value();
+    signal.notify();
+    signal.wait(observed);
+    REQUIRE(signal.value() != observed);
+}